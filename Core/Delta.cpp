@@ -0,0 +1,272 @@
+#include "stdafx.h"
+
+#include <cstring>
+
+#include "Delta.h"
+#include "File.h"
+#include "Sha256.h"
+
+namespace {
+    constexpr char DeltaMagic[4] = {'G', 'W', 'D', 'L'};
+    constexpr uint32_t DeltaVersion = 1;
+    // Length of the runs of bytes that are looked up in the source; shorter matches are sent as new bytes
+    constexpr size_t BlockSize = 16;
+    // An edit in place (e.g. a changed address) usually only breaks a copy for a few bytes
+    constexpr size_t ResumeCheckSize = 8;
+    constexpr uint32_t HashMultiplier = 0x01000193;
+
+    #pragma pack(push, 1)
+    struct DeltaHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint8_t SourceSha256[Sha256::DigestSize];
+        uint8_t TargetSha256[Sha256::DigestSize];
+        uint64_t SourceSize;
+        uint64_t TargetSize;
+    };
+    #pragma pack(pop)
+
+    void Digest(const uint8_t* Data, const size_t Size, uint8_t Out[Sha256::DigestSize])
+    {
+        Sha256 Hash;
+        Hash.Update(Data, Size);
+        Hash.Final(Out);
+    }
+
+    void WriteVarint(std::vector<uint8_t>& Out, uint64_t Value)
+    {
+        while (Value >= 0x80) {
+            Out.push_back(static_cast<uint8_t>(Value | 0x80));
+            Value >>= 7;
+        }
+        Out.push_back(static_cast<uint8_t>(Value));
+    }
+
+    bool ReadVarint(const uint8_t*& It, const uint8_t* End, uint64_t* Value)
+    {
+        *Value = 0;
+        for (int Shift = 0; Shift < 64; Shift += 7) {
+            if (It == End) {
+                return false;
+            }
+            const uint8_t Byte = *It++;
+            *Value |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+            if (!(Byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t HashBlock(const uint8_t* Data)
+    {
+        uint32_t Hash = 0;
+        for (size_t i = 0; i < BlockSize; i++) {
+            Hash = Hash * HashMultiplier + Data[i];
+        }
+        return Hash;
+    }
+
+    //
+    // Operations are a varint of (Length << 1 | IsCopy). A copy is followed by where it starts in the source, as a
+    // zigzag varint relative to where the previous copy ended, which keeps copies that carry on after an edit short.
+    // New bytes follow their operation as they are.
+    //
+    class DeltaWriter {
+    public:
+        explicit DeltaWriter(std::vector<uint8_t>& Out)
+            : m_Out(Out) { }
+
+        void Add(const uint8_t* Bytes, const size_t Length)
+        {
+            if (!Length) {
+                return;
+            }
+            WriteVarint(m_Out, static_cast<uint64_t>(Length) << 1);
+            m_Out.insert(m_Out.end(), Bytes, Bytes + Length);
+        }
+
+        void Copy(const size_t Offset, const size_t Length)
+        {
+            WriteVarint(m_Out, (static_cast<uint64_t>(Length) << 1) | 1);
+            const int64_t Relative = static_cast<int64_t>(Offset) - static_cast<int64_t>(m_CopyEnd);
+            WriteVarint(m_Out, (static_cast<uint64_t>(Relative) << 1) ^ static_cast<uint64_t>(Relative >> 63));
+            m_CopyEnd = Offset + Length;
+        }
+
+        size_t CopyEnd() const { return m_CopyEnd; }
+
+    private:
+        std::vector<uint8_t>& m_Out;
+        size_t m_CopyEnd = 0;
+    };
+}
+
+void DeltaCreate(const uint8_t* Source, const size_t SourceSize, const uint8_t* Target, const size_t TargetSize, std::vector<uint8_t>& Delta)
+{
+    Delta.clear();
+    DeltaHeader Header;
+    memcpy(Header.Magic, DeltaMagic, sizeof(DeltaMagic));
+    Header.Version = DeltaVersion;
+    Digest(Source, SourceSize, Header.SourceSha256);
+    Digest(Target, TargetSize, Header.TargetSha256);
+    Header.SourceSize = SourceSize;
+    Header.TargetSize = TargetSize;
+    Delta.resize(sizeof(Header));
+    memcpy(Delta.data(), &Header, sizeof(Header));
+
+    // Source blocks by hash; later blocks with the same hash win, which is as good as any
+    size_t TableSize = 1024;
+    while (TableSize < SourceSize / BlockSize * 2) {
+        TableSize *= 2;
+    }
+    const size_t TableMask = TableSize - 1;
+    std::vector<uint32_t> Table(TableSize, 0);
+    for (size_t Offset = 0; Offset + BlockSize <= SourceSize; Offset += BlockSize) {
+        Table[HashBlock(Source + Offset) & TableMask] = static_cast<uint32_t>(Offset + 1);
+    }
+    uint32_t OutgoingFactor = 1;
+    for (size_t i = 1; i < BlockSize; i++) {
+        OutgoingFactor *= HashMultiplier;
+    }
+
+    DeltaWriter Writer(Delta);
+    size_t Pending = 0;
+    size_t Position = 0;
+    uint32_t Hash = TargetSize >= BlockSize ? HashBlock(Target) : 0;
+    const auto Emit = [&](size_t From, size_t To) {
+        // Grow the match back over bytes that were about to be sent as new
+        while (To > Pending && From > 0 && Source[From - 1] == Target[To - 1]) {
+            From--;
+            To--;
+        }
+        size_t Length = Position - To;
+        while (To + Length < TargetSize && From + Length < SourceSize && Source[From + Length] == Target[To + Length]) {
+            Length++;
+        }
+        Writer.Add(Target + Pending, To - Pending);
+        Writer.Copy(From, Length);
+        Position = Pending = To + Length;
+        if (Position + BlockSize <= TargetSize) {
+            Hash = HashBlock(Target + Position);
+        }
+    };
+    while (Position + BlockSize <= TargetSize) {
+        // Carrying on where the last copy left off, past whatever was edited in between
+        const size_t Resume = Writer.CopyEnd() + (Position - Pending);
+        if (Pending < Position && Resume + ResumeCheckSize <= SourceSize && Position + ResumeCheckSize <= TargetSize
+            && memcmp(Source + Resume, Target + Position, ResumeCheckSize) == 0) {
+            Emit(Resume, Position);
+            continue;
+        }
+        const uint32_t Candidate = Table[Hash & TableMask];
+        if (Candidate && memcmp(Source + Candidate - 1, Target + Position, BlockSize) == 0) {
+            Emit(Candidate - 1, Position);
+            continue;
+        }
+        if (Position + BlockSize < TargetSize) {
+            Hash = (Hash - Target[Position] * OutgoingFactor) * HashMultiplier + Target[Position + BlockSize];
+        }
+        Position++;
+    }
+    Writer.Add(Target + Pending, TargetSize - Pending);
+}
+
+bool DeltaApply(const uint8_t* Source, const size_t SourceSize, const uint8_t* Delta, const size_t DeltaSize, std::vector<uint8_t>& Target)
+{
+    Target.clear();
+    DeltaHeader Header;
+    if (DeltaSize < sizeof(Header)) {
+        return false;
+    }
+    memcpy(&Header, Delta, sizeof(Header));
+    if (memcmp(Header.Magic, DeltaMagic, sizeof(DeltaMagic)) != 0 || Header.Version != DeltaVersion || Header.SourceSize != SourceSize) {
+        return false;
+    }
+    uint8_t Hash[Sha256::DigestSize];
+    Digest(Source, SourceSize, Hash);
+    if (memcmp(Hash, Header.SourceSha256, sizeof(Hash)) != 0) {
+        return false;
+    }
+    // Don't trust the header for an allocation; nothing real comes close to this
+    if (Header.TargetSize > 1ull << 30) {
+        return false;
+    }
+    Target.reserve(static_cast<size_t>(Header.TargetSize));
+
+    const uint8_t* It = Delta + sizeof(Header);
+    const uint8_t* End = Delta + DeltaSize;
+    uint64_t CopyEnd = 0;
+    while (It != End) {
+        uint64_t Operation;
+        if (!ReadVarint(It, End, &Operation)) {
+            return false;
+        }
+        const uint64_t Length = Operation >> 1;
+        if (Length > Header.TargetSize - Target.size()) {
+            return false;
+        }
+        if (Operation & 1) {
+            uint64_t Relative;
+            if (!ReadVarint(It, End, &Relative)) {
+                return false;
+            }
+            const uint64_t Offset = CopyEnd + static_cast<uint64_t>(static_cast<int64_t>(Relative >> 1) ^ -static_cast<int64_t>(Relative & 1));
+            if (Offset > SourceSize || Length > SourceSize - Offset) {
+                return false;
+            }
+            Target.insert(Target.end(), Source + Offset, Source + Offset + Length);
+            CopyEnd = Offset + Length;
+        }
+        else {
+            if (Length > static_cast<uint64_t>(End - It)) {
+                return false;
+            }
+            Target.insert(Target.end(), It, It + Length);
+            It += Length;
+        }
+    }
+    if (Target.size() != Header.TargetSize) {
+        return false;
+    }
+    Digest(Target.data(), Target.size(), Hash);
+    return memcmp(Hash, Header.TargetSha256, sizeof(Hash)) == 0;
+}
+
+bool DeltaApplyFile(const wchar_t* SourcePath, const uint8_t* Delta, const size_t DeltaSize, const wchar_t* TargetPath, const std::string& ExpectedSha256)
+{
+    std::vector<uint8_t> Target;
+    {
+        MappedFile Source;
+        if (!Source.Open(SourcePath) || !DeltaApply(Source.GetData(), Source.GetSize(), Delta, DeltaSize, Target)) {
+            fprintf(stderr, "Failed to apply delta to '%ls'\n", SourcePath);
+            return false;
+        }
+    }
+    if (!ExpectedSha256.empty()) {
+        uint8_t Hash[Sha256::DigestSize];
+        Digest(Target.data(), Target.size(), Hash);
+        if (_stricmp(Sha256Hex(Hash).c_str(), ExpectedSha256.c_str()) != 0) {
+            fprintf(stderr, "Delta applied to '%ls' doesn't give the expected file\n", SourcePath);
+            return false;
+        }
+    }
+
+    std::wstring TempPath = TargetPath;
+    TempPath += L".tmp";
+    if (!WriteEntireFile(TempPath.c_str(), Target.data(), Target.size())) {
+        DeleteFileW(TempPath.c_str());
+        return false;
+    }
+    if (!MoveFileExW(TempPath.c_str(), TargetPath, MOVEFILE_REPLACE_EXISTING)) {
+        fprintf(stderr, "Failed to move '%ls' to '%ls' (%lu)\n", TempPath.c_str(), TargetPath, GetLastError());
+        DeleteFileW(TempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string DeltaFileName(const char* FileName, const std::string& SourceSha256)
+{
+    return std::string(FileName) + "." + SourceSha256.substr(0, 16) + ".delta";
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary delta between two versions of a file, so an update only has to transfer what changed.
+// A delta is a list of copies from the old file and bytes that are new, and carries the SHA-256 of both versions:
+// it's only ever applied to the exact file it was made from, and the result is checked before it's returned.
+
+// Delta turning Source into Target
+void DeltaCreate(const uint8_t* Source, size_t SourceSize, const uint8_t* Target, size_t TargetSize, std::vector<uint8_t>& Delta);
+
+// Rebuilds the target of Delta from Source. False if Delta is malformed, wasn't made from Source or doesn't rebuild
+// the file it was made for.
+bool DeltaApply(const uint8_t* Source, size_t SourceSize, const uint8_t* Delta, size_t DeltaSize, std::vector<uint8_t>& Target);
+
+// Applies Delta to the file at SourcePath and writes the result to TargetPath, through a temporary file so TargetPath
+// is either replaced whole or left alone. ExpectedSha256 (hex), if given, is what the result has to hash to.
+bool DeltaApplyFile(const wchar_t* SourcePath, const uint8_t* Delta, size_t DeltaSize, const wchar_t* TargetPath, const std::string& ExpectedSha256);
+
+// Name a delta from the file with the given SHA-256 is published under, e.g. "GWToolboxdll.dll.1a2b3c4d5e6f7a8b.delta"
+std::string DeltaFileName(const char* FileName, const std::string& SourceSha256);
@@ -51,3 +51,193 @@ bool WriteEntireFile(const wchar_t* FilePath, const void* Content, size_t Length
     CloseHandle(hFile);
     return true;
 }
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const wchar_t* FilePath)
+{
+    Close();
+
+    HANDLE hFile = CreateFileW(
+        FilePath,
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER FileSize;
+    if (!GetFileSizeEx(hFile, &FileSize) || FileSize.QuadPart == 0 || static_cast<uint64_t>(FileSize.QuadPart) > SIZE_MAX) {
+        // Empty files can't be mapped
+        CloseHandle(hFile);
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping) {
+        fprintf(stderr, "Failed to map file '%ls' (%lu)\n", FilePath, GetLastError());
+        CloseHandle(hFile);
+        return false;
+    }
+
+    const void* Data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!Data) {
+        fprintf(stderr, "Failed to map view of file '%ls' (%lu)\n", FilePath, GetLastError());
+        CloseHandle(hMapping);
+        CloseHandle(hFile);
+        return false;
+    }
+
+    m_File = hFile;
+    m_Mapping = hMapping;
+    m_Data = static_cast<const uint8_t*>(Data);
+    m_Size = static_cast<size_t>(FileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data) {
+        UnmapViewOfFile(m_Data);
+        m_Data = nullptr;
+    }
+    if (m_Mapping) {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+    }
+    if (m_File) {
+        CloseHandle(m_File);
+        m_File = nullptr;
+    }
+    m_Size = 0;
+}
+
+FileMapping::View::View(View&& Other) noexcept
+    : m_Base(Other.m_Base)
+    , m_Data(Other.m_Data)
+    , m_Size(Other.m_Size)
+{
+    Other.m_Base = nullptr;
+    Other.m_Data = nullptr;
+    Other.m_Size = 0;
+}
+
+FileMapping::View& FileMapping::View::operator=(View&& Other) noexcept
+{
+    if (this != &Other) {
+        if (m_Base) {
+            UnmapViewOfFile(m_Base);
+        }
+        m_Base = Other.m_Base;
+        m_Data = Other.m_Data;
+        m_Size = Other.m_Size;
+        Other.m_Base = nullptr;
+        Other.m_Data = nullptr;
+        Other.m_Size = 0;
+    }
+    return *this;
+}
+
+FileMapping::View::~View()
+{
+    if (m_Base) {
+        UnmapViewOfFile(m_Base);
+    }
+}
+
+FileMapping::~FileMapping()
+{
+    Close();
+}
+
+bool FileMapping::Open(const wchar_t* FilePath)
+{
+    Close();
+
+    HANDLE hFile = CreateFileW(
+        FilePath,
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER FileSize;
+    if (!GetFileSizeEx(hFile, &FileSize) || FileSize.QuadPart == 0) {
+        CloseHandle(hFile);
+        return false;
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping) {
+        fprintf(stderr, "Failed to map file '%ls' (%lu)\n", FilePath, GetLastError());
+        CloseHandle(hFile);
+        return false;
+    }
+
+    SYSTEM_INFO SystemInfo;
+    GetSystemInfo(&SystemInfo);
+
+    m_File = hFile;
+    m_Mapping = hMapping;
+    m_Size = static_cast<uint64_t>(FileSize.QuadPart);
+    m_Granularity = SystemInfo.dwAllocationGranularity;
+    return true;
+}
+
+void FileMapping::Close()
+{
+    if (m_Mapping) {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+    }
+    if (m_File) {
+        CloseHandle(m_File);
+        m_File = nullptr;
+    }
+    m_Size = 0;
+}
+
+FileMapping::View FileMapping::Map(const uint64_t Offset, const size_t Size) const
+{
+    View Result;
+    if (!m_Mapping || !Size || Offset > m_Size || Size > m_Size - Offset) {
+        return Result;
+    }
+
+    // Views have to start on an allocation granularity boundary
+    const uint64_t Start = Offset - Offset % m_Granularity;
+    const uint64_t Padding = Offset - Start;
+    if (Size > SIZE_MAX - Padding) {
+        return Result;
+    }
+
+    void* Base = MapViewOfFile(
+        m_Mapping,
+        FILE_MAP_READ,
+        static_cast<DWORD>(Start >> 32),
+        static_cast<DWORD>(Start),
+        static_cast<SIZE_T>(Padding + Size));
+
+    if (!Base) {
+        return Result;
+    }
+
+    Result.m_Base = Base;
+    Result.m_Data = static_cast<const uint8_t*>(Base) + Padding;
+    Result.m_Size = Size;
+    return Result;
+}
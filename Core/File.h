@@ -1,3 +1,75 @@
 #pragma once
 
 bool WriteEntireFile(const wchar_t* Path, const void* Content, size_t Length);
+
+// Read-only memory mapped view of a whole file. The file can still be appended to by other handles while mapped,
+// but the view only covers the size it had when opened.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    bool Open(const wchar_t* Path);
+    void Close();
+
+    bool IsOpen() const { return m_Data != nullptr; }
+    const uint8_t* GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+    const uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+};
+
+// Read-only mapping of a file that can be too big to map in one go, e.g. Gw.dat from a 32 bit process.
+// Parts of it are mapped on demand as views; Map can be called from several threads at once.
+class FileMapping {
+public:
+    class View {
+    public:
+        View() = default;
+        View(const View&) = delete;
+        View& operator=(const View&) = delete;
+        View(View&& Other) noexcept;
+        View& operator=(View&& Other) noexcept;
+
+        ~View();
+
+        const uint8_t* GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+        explicit operator bool() const { return m_Data != nullptr; }
+
+    private:
+        friend class FileMapping;
+
+        void* m_Base = nullptr;
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+    };
+
+    FileMapping() = default;
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    ~FileMapping();
+
+    bool Open(const wchar_t* Path);
+    void Close();
+
+    bool IsOpen() const { return m_Mapping != nullptr; }
+    uint64_t GetSize() const { return m_Size; }
+
+    // Map Size bytes starting at Offset. Returns an empty view if the range is out of bounds or couldn't be mapped.
+    View Map(uint64_t Offset, size_t Size) const;
+
+private:
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+    uint64_t m_Size = 0;
+    uint32_t m_Granularity = 0;
+};
@@ -0,0 +1,360 @@
+#include "stdafx.h"
+
+#include <climits>
+#include <cstring>
+#include <vector>
+
+#include "File.h"
+#include "Scan.h"
+
+namespace {
+    constexpr char CacheMagic[4] = {'G', 'W', 'S', 'C'};
+    constexpr uint32_t CacheVersion = 1;
+
+    #pragma pack(push, 1)
+    struct CacheHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint64_t ImageHash;
+        uint32_t Count;
+    };
+
+    struct CacheEntry {
+        uint64_t Key;
+        uint32_t Rva;
+    };
+    #pragma pack(pop)
+
+    // Hashed four byte windows are looked up in a bitmap of this many bits
+    constexpr uint32_t WideKeyBits = 18;
+
+    // Where a pattern is looked for: the window of bytes at Distance from the start of the match
+    struct Anchor {
+        uint32_t Key;
+        uint32_t Pattern;
+        uint32_t Distance;
+    };
+
+    uint32_t WideKey(const uint8_t* At)
+    {
+        uint32_t Word;
+        memcpy(&Word, At, sizeof(Word));
+        return (Word * 0x9E3779B1u) >> (32 - WideKeyBits);
+    }
+
+    uint32_t NarrowKey(const uint8_t First, const uint8_t Second)
+    {
+        return First | (Second << 8);
+    }
+
+    bool IsSet(const std::vector<uint64_t>& Filter, const uint32_t Key)
+    {
+        return (Filter[Key >> 6] >> (Key & 63)) & 1;
+    }
+
+    bool IsExact(const char* Mask, const size_t Index)
+    {
+        return Mask[Index] == 'x';
+    }
+
+    // Rough guess at how often a byte turns up in x86 code and data; anchors on common bytes are checked more often
+    int Commonness(const uint8_t Byte)
+    {
+        switch (Byte) {
+            case 0x00:
+                return 4;
+            case 0xFF:
+            case 0xCC:
+                return 3;
+            case 0x8B:
+            case 0x89:
+            case 0x83:
+            case 0x45:
+            case 0x4D:
+            case 0x55:
+            case 0xE8:
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+    // Pattern as it is searched for: its key doesn't depend on the bytes under wildcards
+    uint64_t PatternKey(const ScanPattern& Pattern)
+    {
+        uint64_t Hash = 0xCBF29CE484222325;
+        const auto Mix = [&Hash](const uint8_t Byte) {
+            Hash = (Hash ^ Byte) * 0x100000001B3;
+        };
+        const size_t Length = strlen(Pattern.Mask);
+        for (size_t i = 0; i < Length; i++) {
+            const bool Exact = IsExact(Pattern.Mask, i);
+            Mix(Exact ? 'x' : '?');
+            Mix(Exact ? static_cast<uint8_t>(Pattern.Pattern[i]) : 0);
+        }
+        for (size_t i = 0; i < sizeof(Pattern.Offset); i++) {
+            Mix(static_cast<uint8_t>(static_cast<uint32_t>(Pattern.Offset) >> (i * 8)));
+        }
+        return Hash;
+    }
+
+    uint64_t Rotl(const uint64_t Value, const int Bits)
+    {
+        return (Value << Bits) | (Value >> (64 - Bits));
+    }
+}
+
+bool ScanMatches(const uint8_t* Image, const size_t Size, const size_t Rva, const ScanPattern& Pattern)
+{
+    const size_t Length = strlen(Pattern.Mask);
+    if (Rva > Size || Length > Size - Rva) {
+        return false;
+    }
+    const auto Bytes = reinterpret_cast<const uint8_t*>(Pattern.Pattern);
+    for (size_t i = 0; i < Length; i++) {
+        if (IsExact(Pattern.Mask, i) && Image[Rva + i] != Bytes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ScanPatterns(const uint8_t* Image, const size_t Size, const ScanPattern* Patterns, const size_t Count, uintptr_t* Rvas)
+{
+    //
+    // Each pattern is anchored on the least common looking run of four exact bytes in it. At each position of the image,
+    // a hash of the four bytes there is checked in a bitmap of every anchor's hash, which only lets a tiny fraction of
+    // positions through to the full comparison however many patterns there are; anchors with that hash are then found
+    // in a sorted list. Patterns without four exact bytes in a row are anchored on two the same way, without the hash,
+    // or failing that on one byte followed by any byte.
+    //
+    std::vector<Anchor> Wide;
+    std::vector<Anchor> Narrow;
+    size_t Remaining = 0;
+    size_t Found = 0;
+    const auto BestRun = [](const ScanPattern& Pattern, const size_t Length, const size_t Run) {
+        const auto Bytes = reinterpret_cast<const uint8_t*>(Pattern.Pattern);
+        size_t Best = Length;
+        int BestScore = INT_MAX;
+        size_t Exact = 0;
+        for (size_t j = 0; j < Length; j++) {
+            Exact = IsExact(Pattern.Mask, j) ? Exact + 1 : 0;
+            if (Exact < Run) {
+                continue;
+            }
+            const size_t Start = j + 1 - Run;
+            int Score = 0;
+            for (size_t k = Start; k <= j; k++) {
+                Score += Commonness(Bytes[k]);
+            }
+            if (Score < BestScore) {
+                Best = Start;
+                BestScore = Score;
+            }
+        }
+        return Best;
+    };
+    for (size_t i = 0; i < Count; i++) {
+        Rvas[i] = ScanNotFound;
+        const auto& Pattern = Patterns[i];
+        const auto Bytes = reinterpret_cast<const uint8_t*>(Pattern.Pattern);
+        const size_t Length = strlen(Pattern.Mask);
+        const auto Index = static_cast<uint32_t>(i);
+        size_t Best = BestRun(Pattern, Length, 4);
+        if (Best < Length) {
+            Wide.push_back({WideKey(Bytes + Best), Index, static_cast<uint32_t>(Best)});
+            Remaining++;
+            continue;
+        }
+        Best = BestRun(Pattern, Length, 2);
+        if (Best < Length) {
+            Narrow.push_back({NarrowKey(Bytes[Best], Bytes[Best + 1]), Index, static_cast<uint32_t>(Best)});
+            Remaining++;
+            continue;
+        }
+        Best = BestRun(Pattern, Length, 1);
+        if (Best < Length) {
+            for (uint32_t Next = 0; Next < 0x100; Next++) {
+                Narrow.push_back({NarrowKey(Bytes[Best], static_cast<uint8_t>(Next)), Index, static_cast<uint32_t>(Best)});
+            }
+            Remaining++;
+            continue;
+        }
+        // Nothing but wildcards
+        if (Length <= Size) {
+            Rvas[i] = static_cast<uintptr_t>(Pattern.Offset);
+            Found++;
+        }
+    }
+    if (Remaining == 0 || Size == 0) {
+        return Found;
+    }
+
+    const auto MakeFilter = [](std::vector<Anchor>& Anchors, const uint32_t Bits) {
+        std::ranges::sort(Anchors, [](const Anchor& A, const Anchor& B) {
+            return A.Key < B.Key || (A.Key == B.Key && A.Pattern < B.Pattern);
+        });
+        std::vector<uint64_t> Filter((size_t{1} << Bits) / 64, 0);
+        for (const auto& Anchor : Anchors) {
+            Filter[Anchor.Key >> 6] |= 1ull << (Anchor.Key & 63);
+        }
+        return Filter;
+    };
+    const auto WideFilter = MakeFilter(Wide, WideKeyBits);
+    const auto NarrowFilter = MakeFilter(Narrow, 16);
+
+    const auto Check = [&](const std::vector<Anchor>& Anchors, const size_t Position, const uint32_t Key) {
+        auto It = std::ranges::lower_bound(Anchors, Key, {}, &Anchor::Key);
+        for (; It != Anchors.end() && It->Key == Key; ++It) {
+            if (Rvas[It->Pattern] != ScanNotFound || Position < It->Distance) {
+                continue;
+            }
+            const size_t Start = Position - It->Distance;
+            const auto& Pattern = Patterns[It->Pattern];
+            if (ScanMatches(Image, Size, Start, Pattern)) {
+                Rvas[It->Pattern] = Start + Pattern.Offset;
+                Found++;
+                Remaining--;
+            }
+        }
+    };
+
+    const bool HasWide = !Wide.empty();
+    const bool HasNarrow = !Narrow.empty();
+    size_t i = 0;
+    for (; i + 3 < Size && Remaining; i++) {
+        if (HasWide) {
+            const uint32_t Key = WideKey(Image + i);
+            if (IsSet(WideFilter, Key)) {
+                Check(Wide, i, Key);
+            }
+        }
+        if (HasNarrow) {
+            const uint32_t Key = NarrowKey(Image[i], Image[i + 1]);
+            if (IsSet(NarrowFilter, Key)) {
+                Check(Narrow, i, Key);
+            }
+        }
+    }
+    // Too close to the end for four byte anchors; one byte anchors can still match the last byte
+    for (; i < Size && Remaining && HasNarrow; i++) {
+        const uint32_t Key = NarrowKey(Image[i], i + 1 < Size ? Image[i + 1] : 0);
+        if (IsSet(NarrowFilter, Key)) {
+            Check(Narrow, i, Key);
+        }
+    }
+    return Found;
+}
+
+bool HashFile(const wchar_t* FilePath, uint64_t* Hash)
+{
+    MappedFile File;
+    if (!File.Open(FilePath)) {
+        return false;
+    }
+    const uint8_t* Data = File.GetData();
+    const size_t Size = File.GetSize();
+
+    constexpr uint64_t Prime1 = 0x9E3779B185EBCA87;
+    constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4F;
+    // Four independent lanes, so that the multiplies don't wait on each other
+    uint64_t Lanes[4] = {Prime1 + Prime2, Prime2, 0, 0 - Prime1};
+    size_t Offset = 0;
+    for (; Offset + 32 <= Size; Offset += 32) {
+        for (size_t Lane = 0; Lane < 4; Lane++) {
+            uint64_t Word;
+            memcpy(&Word, Data + Offset + Lane * 8, sizeof(Word));
+            Lanes[Lane] = Rotl(Lanes[Lane] + Word * Prime2, 31) * Prime1;
+        }
+    }
+    uint64_t Result = Rotl(Lanes[0], 1) + Rotl(Lanes[1], 7) + Rotl(Lanes[2], 12) + Rotl(Lanes[3], 18) + Size;
+    for (; Offset < Size; Offset++) {
+        Result = Rotl(Result ^ (Data[Offset] * Prime1), 11) * Prime2;
+    }
+    Result ^= Result >> 33;
+    Result *= Prime2;
+    Result ^= Result >> 29;
+    *Hash = Result;
+    return true;
+}
+
+bool ScanCache::Load(const std::filesystem::path& FilePath, const uint64_t ImageHash)
+{
+    m_ImageHash = ImageHash;
+    m_Entries.clear();
+    m_Dirty = false;
+
+    MappedFile File;
+    if (!File.Open(FilePath.c_str()) || File.GetSize() < sizeof(CacheHeader)) {
+        return false;
+    }
+    CacheHeader Header;
+    memcpy(&Header, File.GetData(), sizeof(Header));
+    if (memcmp(Header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 || Header.Version != CacheVersion || Header.ImageHash != ImageHash) {
+        return false;
+    }
+    if (Header.Count > (File.GetSize() - sizeof(Header)) / sizeof(CacheEntry)) {
+        return false;
+    }
+    const uint8_t* Data = File.GetData() + sizeof(Header);
+    for (uint32_t i = 0; i < Header.Count; i++) {
+        CacheEntry Entry;
+        memcpy(&Entry, Data + i * sizeof(Entry), sizeof(Entry));
+        m_Entries[Entry.Key] = Entry.Rva;
+    }
+    return true;
+}
+
+bool ScanCache::Save(const std::filesystem::path& FilePath) const
+{
+    std::vector<uint8_t> Content(sizeof(CacheHeader) + m_Entries.size() * sizeof(CacheEntry));
+    CacheHeader Header;
+    memcpy(Header.Magic, CacheMagic, sizeof(CacheMagic));
+    Header.Version = CacheVersion;
+    Header.ImageHash = m_ImageHash;
+    Header.Count = static_cast<uint32_t>(m_Entries.size());
+    memcpy(Content.data(), &Header, sizeof(Header));
+    size_t Offset = sizeof(Header);
+    for (const auto& [Key, Rva] : m_Entries) {
+        const CacheEntry Entry = {Key, Rva};
+        memcpy(Content.data() + Offset, &Entry, sizeof(Entry));
+        Offset += sizeof(Entry);
+    }
+
+    auto TmpPath = FilePath;
+    TmpPath += L".tmp";
+    if (!WriteEntireFile(TmpPath.c_str(), Content.data(), Content.size())) {
+        return false;
+    }
+    if (!MoveFileExW(TmpPath.c_str(), FilePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        fprintf(stderr, "Failed to replace '%ls' (%lu)\n", FilePath.c_str(), GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool ScanCache::Lookup(const ScanPattern& Pattern, uint32_t* Rva) const
+{
+    const auto It = m_Entries.find(PatternKey(Pattern));
+    if (It == m_Entries.end()) {
+        return false;
+    }
+    *Rva = It->second;
+    return true;
+}
+
+void ScanCache::Store(const ScanPattern& Pattern, const uint32_t Rva)
+{
+    const auto [It, Inserted] = m_Entries.try_emplace(PatternKey(Pattern), Rva);
+    if (Inserted || It->second != Rva) {
+        It->second = Rva;
+        m_Dirty = true;
+    }
+}
+
+void ScanCache::Remove(const ScanPattern& Pattern)
+{
+    if (m_Entries.erase(PatternKey(Pattern))) {
+        m_Dirty = true;
+    }
+}
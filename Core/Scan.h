@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+
+// Byte pattern to look for in a module image. Mask has 'x' for bytes that must match and anything else for wildcards,
+// as with GW::Scanner. A search gives the RVA of the match plus Offset.
+struct ScanPattern {
+    const char* Pattern;
+    const char* Mask;
+    int Offset = 0;
+};
+
+constexpr uintptr_t ScanNotFound = static_cast<uintptr_t>(-1);
+
+// Whether Pattern matches Image at Rva (the start of the match, Offset not applied)
+bool ScanMatches(const uint8_t* Image, size_t Size, size_t Rva, const ScanPattern& Pattern);
+
+// First match of each pattern, in a single pass over Image however many patterns there are.
+// Rvas[i] is the RVA of the first match of Patterns[i] plus its offset, or ScanNotFound. Returns how many were found.
+size_t ScanPatterns(const uint8_t* Image, size_t Size, const ScanPattern* Patterns, size_t Count, uintptr_t* Rvas);
+
+// Hash of a whole file, to tell builds of an executable apart
+bool HashFile(const wchar_t* FilePath, uint64_t* Hash);
+
+// Scan results kept between runs for one build of an executable, so they don't have to be searched for again.
+// Entries are only hints: check a cached match with ScanMatches before using it.
+class ScanCache {
+public:
+    // Starts empty if the file is missing, unreadable or for another build
+    bool Load(const std::filesystem::path& FilePath, uint64_t ImageHash);
+    bool Save(const std::filesystem::path& FilePath) const;
+
+    // RVA of the match cached for Pattern, Offset not applied
+    bool Lookup(const ScanPattern& Pattern, uint32_t* Rva) const;
+    void Store(const ScanPattern& Pattern, uint32_t Rva);
+    void Remove(const ScanPattern& Pattern);
+
+    // Whether anything changed since Load
+    bool IsDirty() const { return m_Dirty; }
+
+private:
+    uint64_t m_ImageHash = 0;
+    std::unordered_map<uint64_t, uint32_t> m_Entries;
+    bool m_Dirty = false;
+};
@@ -0,0 +1,145 @@
+#include "stdafx.h"
+
+#include <cstring>
+
+#include "File.h"
+#include "Sha256.h"
+
+namespace {
+    constexpr uint32_t RoundConstants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    uint32_t Rotr(const uint32_t Value, const int Bits)
+    {
+        return (Value >> Bits) | (Value << (32 - Bits));
+    }
+}
+
+Sha256::Sha256()
+    : m_State{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}
+{
+}
+
+void Sha256::Transform(const uint8_t Block[64])
+{
+    uint32_t W[64];
+    for (size_t i = 0; i < 16; i++) {
+        W[i] = (Block[i * 4] << 24) | (Block[i * 4 + 1] << 16) | (Block[i * 4 + 2] << 8) | Block[i * 4 + 3];
+    }
+    for (size_t i = 16; i < 64; i++) {
+        const uint32_t S0 = Rotr(W[i - 15], 7) ^ Rotr(W[i - 15], 18) ^ (W[i - 15] >> 3);
+        const uint32_t S1 = Rotr(W[i - 2], 17) ^ Rotr(W[i - 2], 19) ^ (W[i - 2] >> 10);
+        W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+    }
+
+    uint32_t A = m_State[0], B = m_State[1], C = m_State[2], D = m_State[3];
+    uint32_t E = m_State[4], F = m_State[5], G = m_State[6], H = m_State[7];
+    for (size_t i = 0; i < 64; i++) {
+        const uint32_t S1 = Rotr(E, 6) ^ Rotr(E, 11) ^ Rotr(E, 25);
+        const uint32_t Choose = (E & F) ^ (~E & G);
+        const uint32_t Temp1 = H + S1 + Choose + RoundConstants[i] + W[i];
+        const uint32_t S0 = Rotr(A, 2) ^ Rotr(A, 13) ^ Rotr(A, 22);
+        const uint32_t Majority = (A & B) ^ (A & C) ^ (B & C);
+        const uint32_t Temp2 = S0 + Majority;
+        H = G;
+        G = F;
+        F = E;
+        E = D + Temp1;
+        D = C;
+        C = B;
+        B = A;
+        A = Temp1 + Temp2;
+    }
+    m_State[0] += A;
+    m_State[1] += B;
+    m_State[2] += C;
+    m_State[3] += D;
+    m_State[4] += E;
+    m_State[5] += F;
+    m_State[6] += G;
+    m_State[7] += H;
+}
+
+void Sha256::Update(const void* Data, size_t Size)
+{
+    auto Bytes = static_cast<const uint8_t*>(Data);
+    m_Length += Size;
+    if (m_BufferSize) {
+        const size_t Count = std::min(Size, sizeof(m_Buffer) - m_BufferSize);
+        memcpy(m_Buffer + m_BufferSize, Bytes, Count);
+        m_BufferSize += Count;
+        Bytes += Count;
+        Size -= Count;
+        if (m_BufferSize < sizeof(m_Buffer)) {
+            return;
+        }
+        Transform(m_Buffer);
+        m_BufferSize = 0;
+    }
+    for (; Size >= 64; Bytes += 64, Size -= 64) {
+        Transform(Bytes);
+    }
+    memcpy(m_Buffer, Bytes, Size);
+    m_BufferSize = Size;
+}
+
+void Sha256::Final(uint8_t Digest[DigestSize])
+{
+    const uint64_t BitLength = m_Length * 8;
+    const uint8_t Pad = 0x80;
+    Update(&Pad, 1);
+    const uint8_t Zero = 0;
+    while (m_BufferSize != 56) {
+        Update(&Zero, 1);
+    }
+    uint8_t Length[8];
+    for (size_t i = 0; i < 8; i++) {
+        Length[i] = static_cast<uint8_t>(BitLength >> (56 - i * 8));
+    }
+    Update(Length, sizeof(Length));
+    for (size_t i = 0; i < 8; i++) {
+        Digest[i * 4] = static_cast<uint8_t>(m_State[i] >> 24);
+        Digest[i * 4 + 1] = static_cast<uint8_t>(m_State[i] >> 16);
+        Digest[i * 4 + 2] = static_cast<uint8_t>(m_State[i] >> 8);
+        Digest[i * 4 + 3] = static_cast<uint8_t>(m_State[i]);
+    }
+}
+
+std::string Sha256Hex(const uint8_t Digest[Sha256::DigestSize])
+{
+    constexpr char Digits[] = "0123456789abcdef";
+    std::string Hex(Sha256::DigestSize * 2, '0');
+    for (size_t i = 0; i < Sha256::DigestSize; i++) {
+        Hex[i * 2] = Digits[Digest[i] >> 4];
+        Hex[i * 2 + 1] = Digits[Digest[i] & 0xF];
+    }
+    return Hex;
+}
+
+bool Sha256File(const wchar_t* FilePath, std::string& Hex)
+{
+    Sha256 Hash;
+    MappedFile File;
+    if (File.Open(FilePath)) {
+        Hash.Update(File.GetData(), File.GetSize());
+    }
+    else {
+        // Empty files can't be mapped
+        std::error_code Error;
+        if (std::filesystem::file_size(FilePath, Error) != 0 || Error) {
+            return false;
+        }
+    }
+    uint8_t Digest[Sha256::DigestSize];
+    Hash.Final(Digest);
+    Hex = Sha256Hex(Digest);
+    return true;
+}
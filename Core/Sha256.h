@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class Sha256 {
+public:
+    static constexpr size_t DigestSize = 32;
+
+    Sha256();
+
+    void Update(const void* Data, size_t Size);
+    void Final(uint8_t Digest[DigestSize]);
+
+private:
+    void Transform(const uint8_t Block[64]);
+
+    uint32_t m_State[8];
+    uint8_t m_Buffer[64];
+    size_t m_BufferSize = 0;
+    uint64_t m_Length = 0;
+};
+
+// Lower case hex digest of a whole file
+bool Sha256File(const wchar_t* FilePath, std::string& Hex);
+std::string Sha256Hex(const uint8_t Digest[Sha256::DigestSize]);
@@ -174,6 +174,8 @@ class _DummyWebSocket : public easywsclient::WebSocket
     void close() { }
     void _dispatch(Callback & callable) { }
     readyStateValues getReadyState() const { return CLOSED; }
+    intptr_t getSocket() const { return -1; }
+    bool hasPendingSend() const { return false; }
 };
 
 
@@ -234,6 +236,14 @@ class _RealWebSocket : public easywsclient::WebSocket
       return readyState;
     }
 
+    intptr_t getSocket() const {
+      return readyState == CLOSED ? -1 : (intptr_t)ptConnCtx->sockfd;
+    }
+
+    bool hasPendingSend() const {
+      return !txbuf.empty();
+    }
+
     void poll(int timeout) { // timeout in milliseconds
         if (readyState == CLOSED) {
             if (timeout > 0) {
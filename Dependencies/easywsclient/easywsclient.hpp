@@ -8,6 +8,7 @@
 // wget https://raw.github.com/dhbaird/easywsclient/master/easywsclient.hpp
 // wget https://raw.github.com/dhbaird/easywsclient/master/easywsclient.cpp
 
+#include <stdint.h>
 #include <string>
 
 namespace easywsclient {
@@ -29,6 +30,10 @@ class WebSocket {
     virtual void sendPing() = 0;
     virtual void close() = 0;
     virtual readyStateValues getReadyState() const = 0;
+    // The underlying socket, to wait on several websockets at once with select(); -1 once closed
+    virtual intptr_t getSocket() const = 0;
+    // True while there are frames queued that the socket hasn't taken yet
+    virtual bool hasPendingSend() const = 0;
     template<class Callable>
     void dispatch(Callable callable) { // N.B. this is compatible with both C++11 lambdas, functors and C function pointers
         struct _Callback : public Callback {
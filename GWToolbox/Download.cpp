@@ -1,33 +1,12 @@
 #include "stdafx.h"
 
-#include <File.h>
+#include <Delta.h>
 #include <Path.h>
+#include <Sha256.h>
 
-#include <RestClient.h>
+#include <FileDownloader.h>
 #include "Download.h"
 
-class AsyncFileDownloader : public AsyncRestClient {
-public:
-    AsyncFileDownloader()
-        : m_DownloadLength{0} { }
-
-    AsyncFileDownloader(const AsyncFileDownloader&) = delete;
-
-    size_t GetDownloadCount() const
-    {
-        return m_DownloadLength.load(std::memory_order_relaxed);
-    }
-
-private: // From AsyncRestClient
-    void OnContent(const char* bytes, const size_t count) override
-    {
-        AsyncRestClient::OnContent(bytes, count);
-        m_DownloadLength += count;
-    }
-
-    std::atomic<size_t> m_DownloadLength;
-};
-
 bool Download(std::string& content, const char* url)
 {
     RestClient client;
@@ -48,19 +27,12 @@ bool Download(std::string& content, const char* url)
     return true;
 }
 
-void AsyncDownload(const char* url, AsyncFileDownloader* downloader)
-{
-    downloader->SetUrl(url);
-    downloader->SetVerifyPeer(false);
-    downloader->SetFollowLocation(true);
-    downloader->SetUserAgent("curl/7.71.1");
-    downloader->ExecuteAsync();
-}
-
 struct Asset {
     std::string name{};
     size_t size = 0;
     std::string browser_download_url{};
+    // Hex, if the release lists it
+    std::string sha256{};
 };
 
 struct Release {
@@ -129,6 +101,15 @@ static bool ParseRelease(const std::string& json_text, Release* release)
         asset.size = it_size->get<size_t>();
         asset.browser_download_url = it_browser_download_url->get<std::string>();
 
+        // "sha256:<hex>"
+        auto it_digest = entry.find("digest");
+        if (it_digest != entry.end() && it_digest->is_string()) {
+            const auto digest = it_digest->get<std::string>();
+            if (digest.starts_with("sha256:")) {
+                asset.sha256 = digest.substr(7);
+            }
+        }
+
         release->assets.emplace_back(std::move(asset));
     }
 
@@ -168,6 +149,61 @@ std::string GetDllRelease(const std::filesystem::path& dllpath)
     return {buffer};
 }
 
+// Patch the installed dll up to the release, if it published a delta from this exact build
+static bool UpdateFromDelta(const Release& release, const Asset& dll_asset, const std::filesystem::path& dll_path)
+{
+    std::string installed_sha256;
+    if (!Sha256File(dll_path.wstring().c_str(), installed_sha256)) {
+        return false;
+    }
+    const auto delta_name = DeltaFileName(dll_asset.name.c_str(), installed_sha256);
+    const auto delta_asset = std::ranges::find(release.assets, delta_name, &Asset::name);
+    if (delta_asset == release.assets.end()) {
+        return false;
+    }
+
+    std::string delta;
+    if (!Download(delta, delta_asset->browser_download_url.c_str())) {
+        return false;
+    }
+    if (!DeltaApplyFile(dll_path.wstring().c_str(), reinterpret_cast<const uint8_t*>(delta.data()), delta.size(), dll_path.wstring().c_str(), dll_asset.sha256)) {
+        return false;
+    }
+    fprintf(stderr, "Updated with '%s' (%zu bytes instead of %zu)\n", delta_name.c_str(), delta.size(), dll_asset.size);
+    return true;
+}
+
+bool CreateDelta(const std::filesystem::path& old_dll, const std::filesystem::path& new_dll)
+{
+    const auto read = [](const std::filesystem::path& path, std::vector<uint8_t>& content) {
+        std::ifstream file(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator(file), std::istreambuf_iterator<char>());
+        return static_cast<bool>(file) || file.eof();
+    };
+    std::vector<uint8_t> old_content, new_content;
+    if (!(read(old_dll, old_content) && read(new_dll, new_content))) {
+        fprintf(stderr, "Couldn't read '%ls' or '%ls'\n", old_dll.wstring().c_str(), new_dll.wstring().c_str());
+        return false;
+    }
+    std::string old_sha256;
+    if (!Sha256File(old_dll.wstring().c_str(), old_sha256)) {
+        fprintf(stderr, "Couldn't hash '%ls'\n", old_dll.wstring().c_str());
+        return false;
+    }
+    std::vector<uint8_t> delta;
+    DeltaCreate(old_content.data(), old_content.size(), new_content.data(), new_content.size(), delta);
+
+    const auto delta_path = new_dll.parent_path() / DeltaFileName(new_dll.filename().string().c_str(), old_sha256);
+    std::ofstream out(delta_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(delta.data()), static_cast<std::streamsize>(delta.size()));
+    if (!out) {
+        fprintf(stderr, "Couldn't write '%ls'\n", delta_path.wstring().c_str());
+        return false;
+    }
+    printf("Wrote '%ls' (%zu bytes for a %zu byte dll)\n", delta_path.wstring().c_str(), delta.size(), new_content.size());
+    return true;
+}
+
 bool DownloadWindow::DownloadAllFiles()
 {
     std::string content;
@@ -204,63 +240,89 @@ bool DownloadWindow::DownloadAllFiles()
     snprintf(buffer, 64, "Downloading version '%s'", release.tag_name.c_str());
     MessageBoxA(nullptr, buffer, "Downloading...", 0);
 
-    std::string url;
-    size_t file_size = 0;
-    for (auto& asset : release.assets) {
-        if (asset.name == "GWToolbox.dll" || asset.name == "GWToolboxdll.dll") {
-            fprintf(stderr, "browser_download_url: '%s'\n", asset.browser_download_url.c_str());
-            const char* purl = asset.browser_download_url.c_str();
-            file_size = asset.size;
-            url = std::string(purl, purl + asset.browser_download_url.size());
-            break;
-        }
-    }
-
-    if (url.empty()) {
+    const auto dll_asset = std::ranges::find_if(release.assets, [](const Asset& asset) {
+        return asset.name == "GWToolbox.dll" || asset.name == "GWToolboxdll.dll";
+    });
+    if (dll_asset == release.assets.end()) {
         fprintf(stderr, "Didn't find GWTooolboxdll.dll\n");
         return false;
     }
+    fprintf(stderr, "browser_download_url: '%s'\n", dll_asset->browser_download_url.c_str());
+    const std::string& url = dll_asset->browser_download_url;
+    const size_t file_size = dll_asset->size;
+
+    if (!release_string.empty() && UpdateFromDelta(release, *dll_asset, dll_path)) {
+        return true;
+    }
 
     DownloadWindow window;
     window.Create();
     window.SetChangelog(release.body.c_str(), release.body.size());
 
-    AsyncFileDownloader downloader;
-    AsyncDownload(url.c_str(), &downloader);
+    // Anything left over from an earlier run that got cut short is picked up where it stopped, as long as the release has
+    // a hash to check the result against; the size alone can't tell a leftover from another build apart
+    FileDownloader downloader;
+    downloader.SetUrl(url.c_str());
+    downloader.SetVerifyPeer(false);
+    downloader.SetFollowLocation(true);
+    downloader.SetUserAgent("curl/7.71.1");
+    downloader.SetDestination(dll_path, file_size);
+    if (dll_asset->sha256.empty()) {
+        downloader.Discard();
+    }
+    if (!downloader.BeginAttempt()) {
+        fprintf(stderr, "%s\n", downloader.GetError().c_str());
+        return false;
+    }
+    downloader.ExecuteAsync();
 
+    constexpr int max_attempts = 5;
+    int attempts = 1;
+    bool done = false;
     while (!window.ShouldClose()) {
         window.PollMessages(16);
 
         if (!downloader.IsCompleted()) {
-            size_t BytesDownloaded = downloader.GetDownloadCount();
-            const auto progress = BytesDownloaded * 100 / file_size;
-            SendMessageW(window.m_hProgressBar, PBM_SETPOS, progress, 0);
+            const auto progress = file_size ? downloader.GetReceived() * 100 / file_size : 0;
+            SendMessageW(window.m_hProgressBar, PBM_SETPOS, static_cast<WPARAM>(progress), 0);
+            continue;
+        }
+        if (done) {
+            continue;
         }
-        else {
-            if (!downloader.IsSuccessful()) {
-                fprintf(stderr, "Failed to download '%s'. (Status: %s, StatusCode: %d)\n",
-                        url.c_str(), downloader.GetStatusStr(), downloader.GetStatusCode());
-                return false;
-            }
 
-            std::string& file_content = downloader.GetContent();
-            if (!WriteEntireFile(dll_path.wstring().c_str(), file_content.c_str(), file_content.size())) {
-                fwprintf(stderr, L"WriteEntireFile failed on '%s' with %zu bytes\n",
-                         dll_path.wstring().c_str(), file_content.size());
+        const auto attempt = downloader.EndAttempt();
+        if (attempt == FileDownloader::Attempt::Interrupted && attempts < max_attempts) {
+            fprintf(stderr, "Retrying '%s': %s\n", url.c_str(), downloader.GetError().c_str());
+            Sleep(250 * attempts++);
+            if (!downloader.BeginAttempt()) {
+                fprintf(stderr, "%s\n", downloader.GetError().c_str());
                 return false;
             }
-
-            downloader.Clear();
-            SendMessageW(window.m_hProgressBar, PBM_SETPOS, 100, 0);
-            SendMessageW(window.m_hWnd, WM_CLOSE, 0, 0);
+            downloader.ExecuteAsync();
+            continue;
+        }
+        if (attempt != FileDownloader::Attempt::Complete) {
+            fprintf(stderr, "Failed to download '%s': %s\n", url.c_str(), downloader.GetError().c_str());
+            return false;
         }
+        if (!downloader.Verify(dll_asset->sha256) || !downloader.Commit()) {
+            fprintf(stderr, "%s\n", downloader.GetError().c_str());
+            return false;
+        }
+
+        done = true;
+        SendMessageW(window.m_hProgressBar, PBM_SETPOS, 100, 0);
+        SendMessageW(window.m_hWnd, WM_CLOSE, 0, 0);
     }
 
     //
-    // The user could close the window, before the download is complete
+    // The user could close the window, before the download is complete.
+    // What was downloaded so far stays in the .part file for next time.
     //
-    if (downloader.IsPending()) {
+    if (!done) {
         downloader.Abort();
+        downloader.EndAttempt();
         return false;
     }
 
@@ -4,6 +4,8 @@
 
 bool Download(std::string& content, const wchar_t* url);
 bool Download(const wchar_t* path_to_file, const wchar_t* url);
+// Writes the delta from old_dll to new_dll next to new_dll, named the way UpdateFromDelta looks for it in a release
+bool CreateDelta(const std::filesystem::path& old_dll, const std::filesystem::path& new_dll);
 
 class DownloadWindow : public Window {
 public:
@@ -103,16 +103,17 @@ InjectReply InjectWindow::AskInjectProcess(Process* target_process)
         return InjectReply_NoProcess;
     }
 
-    uintptr_t charname_rva;
-    const ProcessScanner scanner(processes.data());
-    if (!scanner.FindPatternRva("\x8B\xF8\x6A\x03\x68\x0F\x00\x00\xC0\x8B\xCF\xE8", "xxxxxxxxxxxx", -0x42, &charname_rva)) {
-        return InjectReply_PatternError;
-    }
-
-    uintptr_t email_rva;
-    if (!scanner.FindPatternRva("\x33\xC0\x5D\xC2\x10\x00\xCC\x68\x80\x00\x00\x00", "xxxxxxxxxxxx", 0xE, &email_rva)) {
+    const ScanPattern patterns[] = {
+        {"\x8B\xF8\x6A\x03\x68\x0F\x00\x00\xC0\x8B\xCF\xE8", "xxxxxxxxxxxx", -0x42}, // charname
+        {"\x33\xC0\x5D\xC2\x10\x00\xCC\x68\x80\x00\x00\x00", "xxxxxxxxxxxx", 0xE}, // email
+    };
+    uintptr_t rvas[ARRAY_SIZE(patterns)];
+    ProcessScanner scanner(processes.data());
+    if (!scanner.FindPatternsRva(patterns, ARRAY_SIZE(patterns), rvas)) {
         return InjectReply_PatternError;
     }
+    const uintptr_t charname_rva = rvas[0];
+    const uintptr_t email_rva = rvas[1];
 
     std::vector<InjectProcess> inject_processes;
 
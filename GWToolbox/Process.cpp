@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <Path.h>
+
 #include "Process.h"
 
 Process::Process(const uint32_t pid, const DWORD rights) noexcept
@@ -97,29 +99,37 @@ bool Process::Write(const uintptr_t address, const void* buffer, const size_t si
     return true;
 }
 
-bool Process::GetName(std::wstring& name)
+bool Process::GetPath(std::wstring& path)
 {
     assert(m_Rights & (PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_QUERY_INFORMATION));
 
-    std::wstring process_path;
-    process_path.resize(1024);
+    path.resize(1024);
     for (;;) {
-        DWORD size = process_path.size();
-        if (!QueryFullProcessImageNameW(m_hProcess, 0, process_path.data(), &size)) {
+        DWORD size = path.size();
+        if (!QueryFullProcessImageNameW(m_hProcess, 0, path.data(), &size)) {
             const DWORD error = GetLastError();
             if (error != ERROR_INSUFFICIENT_BUFFER) {
                 fprintf(stderr, "QueryFullProcessImageNameW failed: %lu\n", error);
                 Close();
                 return false;
             }
-            const size_t new_size = process_path.size() * 2;
-            process_path.resize(new_size);
+            const size_t new_size = path.size() * 2;
+            path.resize(new_size);
         }
         else {
-            process_path.resize(size);
+            path.resize(size);
             break;
         }
     }
+    return true;
+}
+
+bool Process::GetName(std::wstring& name)
+{
+    std::wstring process_path;
+    if (!GetPath(process_path)) {
+        return false;
+    }
 
     const std::string::size_type pos = process_path.rfind('\\');
     if (pos == std::string::npos) {
@@ -315,14 +325,23 @@ bool GetProcessesFromWindowClass(std::vector<Process>& processes, const wchar_t*
 }
 
 ProcessScanner::ProcessScanner(Process* process)
+    : m_process(process)
 {
     ProcessModule module;
     process->GetModule(&module);
 
     m_base = module.base;
     m_size = module.size;
-    m_buffer = new uint8_t[module.size];
-    process->Read(module.base, m_buffer, m_size);
+
+    std::wstring image_path;
+    uint64_t image_hash;
+    std::filesystem::path cache_path;
+    std::filesystem::path computer_name;
+    if (process->GetPath(image_path) && HashFile(image_path.c_str(), &image_hash)
+        && PathGetDocumentsPath(cache_path, L"GWToolboxpp") && PathGetComputerName(computer_name)) {
+        m_cache_path = cache_path / computer_name / L"cache" / L"launcher_scan.dat";
+        m_cache.Load(m_cache_path, image_hash);
+    }
 }
 
 ProcessScanner::~ProcessScanner()
@@ -330,7 +349,34 @@ ProcessScanner::~ProcessScanner()
     delete[] m_buffer;
 }
 
-uintptr_t ProcessScanner::FindPattern(const char* pattern, const char* mask, const int offset) const
+bool ProcessScanner::ReadModule()
+{
+    if (m_buffer) {
+        return true;
+    }
+    m_buffer = new uint8_t[m_size];
+    if (!m_process->Read(m_base, m_buffer, m_size)) {
+        delete[] m_buffer;
+        m_buffer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ProcessScanner::IsCachedMatch(const ScanPattern& pattern, const uint32_t rva)
+{
+    if (m_buffer) {
+        return ScanMatches(m_buffer, m_size, rva, pattern);
+    }
+    const size_t length = strlen(pattern.Mask);
+    if (rva > m_size || length > m_size - rva) {
+        return false;
+    }
+    std::vector<uint8_t> bytes(length);
+    return m_process->Read(m_base + rva, bytes.data(), length) && ScanMatches(bytes.data(), length, 0, pattern);
+}
+
+uintptr_t ProcessScanner::FindPattern(const char* pattern, const char* mask, const int offset)
 {
     uintptr_t rva;
     if (FindPatternRva(pattern, mask, offset, &rva)) {
@@ -339,21 +385,45 @@ uintptr_t ProcessScanner::FindPattern(const char* pattern, const char* mask, con
     return 0;
 }
 
-bool ProcessScanner::FindPatternRva(const char* pattern, const char* mask, const int offset, uintptr_t* rva) const
+bool ProcessScanner::FindPatternRva(const char* pattern, const char* mask, const int offset, uintptr_t* rva)
 {
-    const size_t length = strlen(mask);
-    const auto upattern = reinterpret_cast<const uint8_t*>(pattern);
-    for (size_t i = 0; i < m_size; i++) {
-        size_t j;
-        for (j = 0; j < length; j++) {
-            if (mask[j] == 'x' && m_buffer[i + j] != upattern[j]) {
-                break;
-            }
+    const ScanPattern scan_pattern = {pattern, mask, offset};
+    return FindPatternsRva(&scan_pattern, 1, rva);
+}
+
+bool ProcessScanner::FindPatternsRva(const ScanPattern* patterns, const size_t count, uintptr_t* rvas)
+{
+    std::vector<ScanPattern> misses;
+    std::vector<size_t> miss_indices;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t rva;
+        if (m_cache.Lookup(patterns[i], &rva) && IsCachedMatch(patterns[i], rva)) {
+            rvas[i] = rva + patterns[i].Offset;
+            continue;
         }
-        if (j == length) {
-            *rva = i + offset;
-            return true;
+        misses.push_back(patterns[i]);
+        miss_indices.push_back(i);
+    }
+    if (misses.empty()) {
+        return true;
+    }
+
+    if (!ReadModule()) {
+        return false;
+    }
+    std::vector<uintptr_t> found(misses.size());
+    const size_t found_count = ScanPatterns(m_buffer, m_size, misses.data(), misses.size(), found.data());
+    for (size_t i = 0; i < misses.size(); i++) {
+        rvas[miss_indices[i]] = found[i];
+        if (found[i] == ScanNotFound) {
+            m_cache.Remove(misses[i]);
+        }
+        else {
+            m_cache.Store(misses[i], static_cast<uint32_t>(found[i] - misses[i].Offset));
         }
     }
-    return false;
+    if (m_cache.IsDirty() && !m_cache_path.empty() && PathCreateDirectorySafe(m_cache_path.parent_path())) {
+        m_cache.Save(m_cache_path);
+    }
+    return found_count == misses.size();
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Scan.h>
+
 struct ProcessModule {
     uintptr_t base = 0;
     size_t size = 0;
@@ -25,6 +27,7 @@ public:
     bool Write(uintptr_t address, const void* buffer, size_t size) const;
 
     bool GetName(std::wstring& name);
+    bool GetPath(std::wstring& path);
     bool GetModule(ProcessModule* module);
     bool GetModule(ProcessModule* module, const wchar_t* module_name) const;
     bool GetModules(std::vector<ProcessModule>& modules) const;
@@ -40,17 +43,28 @@ private:
 bool GetProcesses(std::vector<Process>& processes, const wchar_t* name, DWORD rights = PROCESS_ALL_ACCESS);
 bool GetProcessesFromWindowClass(std::vector<Process>& processes, const wchar_t* classname, DWORD rights = PROCESS_ALL_ACCESS);
 
+// Pattern scanner over the main module of a process. Matches are cached per build of the executable, so that usually
+// only the bytes of each cached match are read back from the process to check it, not the whole module.
 class ProcessScanner {
 public:
     ProcessScanner(Process* process);
     ProcessScanner(const ProcessScanner&) = delete;
     ~ProcessScanner();
 
-    uintptr_t FindPattern(const char* pattern, const char* mask, int Offset) const;
-    bool FindPatternRva(const char* pattern, const char* mask, int offset, uintptr_t* rva) const;
+    uintptr_t FindPattern(const char* pattern, const char* mask, int Offset);
+    bool FindPatternRva(const char* pattern, const char* mask, int offset, uintptr_t* rva);
+    // Patterns that aren't cached are searched for together, in one pass over the module. False unless all are found.
+    bool FindPatternsRva(const ScanPattern* patterns, size_t count, uintptr_t* rvas);
 
 private:
+    bool ReadModule();
+    bool IsCachedMatch(const ScanPattern& pattern, uint32_t rva);
+
+    Process* m_process = nullptr;
     uintptr_t m_base = 0;
     size_t m_size = 0;
+    // Read on the first cache miss
     uint8_t* m_buffer = nullptr;
+    ScanCache m_cache;
+    std::filesystem::path m_cache_path;
 };
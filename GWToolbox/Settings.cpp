@@ -23,7 +23,10 @@ void PrintUsage(const bool terminate)
             "    /noinstall                 Won't try to install if missing\n"
             "    /localdll                  Check launcher directory for toolbox dll, won't try to install or update\n\n"
 
-            "    /pid <process id>          Process id of the target in which to inject\n"
+            "    /pid <process id>          Process id of the target in which to inject\n\n"
+
+            "    /makedelta <old> <new>     Write the update delta from one GWToolboxdll.dll to another, next to the new one,\n"
+            "                               under the name it's published as in a release\n"
     );
 
     if (terminate) {
@@ -125,6 +128,14 @@ void ParseCommandLine()
             }
             settings.pid = static_cast<uint32_t>(pid);
         }
+        else if (wcscmp(arg, L"/makedelta") == 0) {
+            if (i + 2 >= argc) {
+                fprintf(stderr, "'/makedelta' must be followed by the old and new dll\n");
+                PrintUsage(true);
+            }
+            settings.makedelta_old = argv[++i];
+            settings.makedelta_new = argv[++i];
+        }
         else if (wcscmp(arg, L"/asadmin") == 0) {
             settings.asadmin = true;
         }
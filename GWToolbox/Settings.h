@@ -14,6 +14,8 @@ struct Settings {
     bool noinstall = false;
     bool localdll = false;
     uint32_t pid;
+    std::wstring makedelta_old;
+    std::wstring makedelta_new;
 };
 
 extern Settings settings;
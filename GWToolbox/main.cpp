@@ -131,6 +131,9 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
         printf("GWToolbox version %s\n", GWTOOLBOXEXE_VERSION);
         return 0;
     }
+    if (!settings.makedelta_old.empty()) {
+        return CreateDelta(settings.makedelta_old, settings.makedelta_new) ? 0 : 1;
+    }
 
     if (settings.asadmin && !IsRunningAsAdmin()) {
         RestartWithSameArgs(true);
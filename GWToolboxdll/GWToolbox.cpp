@@ -11,6 +11,8 @@
 #include <GWCA/Managers/RenderMgr.h>
 
 #include <Defines.h>
+#include <Utils/AgentSnapshot.h>
+#include <Utils/FrameProfiler.h>
 #include <Utils/GuiUtils.h>
 #include <GWToolbox.h>
 #include <Logger.h>
@@ -28,6 +30,7 @@
 #include "Modules/HallOfMonumentsModule.h"
 #include "Modules/InventoryManager.h"
 #include "Modules/LoginModule.h"
+#include "Modules/ProfilerModule.h"
 #include "Modules/Updater.h"
 #include "Windows/SettingsWindow.h"
 
@@ -147,6 +150,25 @@ namespace {
 
     std::vector<ToolboxModule*> modules_terminating{};
 
+    // Profiler zones that aren't a module; the name doubles as the key
+    constexpr char update_zone[] = "Update";
+    constexpr char draw_zone[] = "Draw";
+    constexpr char minimap_render_zone[] = "Minimap render";
+
+    bool ModuleWndProc(ToolboxModule* m, const UINT Message, const WPARAM wParam, const LPARAM lParam)
+    {
+        FrameProfiler::Zone zone(FrameProfiler::Phase::WndProc, m, m->Name());
+        return m->WndProc(Message, wParam, lParam);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<GWToolbox::ModuleInitTiming> init_timings;
+
+    float MsSince(const Clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    }
+
     void ReorderModules(std::vector<ToolboxModule*>& modules)
     {
         std::ranges::sort(modules, [](const ToolboxModule* lhs, const ToolboxModule* rhs) {
@@ -168,6 +190,23 @@ namespace {
         return inifile.get();
     }
 
+    void InitializeModule(ToolboxModule& m, const float preload_ms)
+    {
+        const auto start = Clock::now();
+        m.Initialize();
+        m.LoadSettings(OpenSettingsFile());
+        const GWToolbox::ModuleInitTiming timing = {m.Name(), preload_ms, MsSince(start)};
+        const auto found = std::ranges::find_if(init_timings, [&m](const GWToolbox::ModuleInitTiming& t) {
+            return strcmp(t.name, m.Name()) == 0;
+        });
+        if (found != init_timings.end()) {
+            *found = timing;
+        }
+        else {
+            init_timings.push_back(timing);
+        }
+    }
+
     bool ToggleTBModule(ToolboxModule& m, std::vector<ToolboxModule*>& vec, const bool enable)
     {
         const auto found = std::ranges::find(vec, &m);
@@ -192,11 +231,52 @@ namespace {
             return false; // Not finished terminating
         }
         vec.push_back(&m);
-        m.Initialize();
-        m.LoadSettings(OpenSettingsFile());
+        const auto preload_start = Clock::now();
+        m.Preload();
+        InitializeModule(m, MsSince(preload_start));
         ReorderModules(vec);
         return true; // Added successfully
     }
+
+    bool Contains(const std::vector<ToolboxModule*>& modules, const ToolboxModule* m)
+    {
+        return std::ranges::find(modules, m) != modules.end();
+    }
+
+    std::vector<ToolboxModule*>& EnabledVector(const ToolboxModule& m)
+    {
+        if (m.IsWidget()) {
+            return reinterpret_cast<std::vector<ToolboxModule*>&>(widgets_enabled);
+        }
+        if (m.IsWindow()) {
+            return reinterpret_cast<std::vector<ToolboxModule*>&>(windows_enabled);
+        }
+        return modules_enabled;
+    }
+
+    // Same order as given, except that each module comes after any of its dependencies that are also in there
+    std::vector<ToolboxModule*> OrderByDependencies(const std::vector<ToolboxModule*>& modules)
+    {
+        std::vector<ToolboxModule*> ordered;
+        std::vector<ToolboxModule*> visiting;
+        const std::function<void(ToolboxModule*)> visit = [&](ToolboxModule* m) {
+            // A module already being visited means a cycle; it's broken here
+            if (Contains(ordered, m) || Contains(visiting, m)) {
+                return;
+            }
+            visiting.push_back(m);
+            for (const auto dependency : m->GetDependencies()) {
+                if (Contains(modules, dependency)) {
+                    visit(dependency);
+                }
+            }
+            ordered.push_back(m);
+        };
+        for (const auto m : modules) {
+            visit(m);
+        }
+        return ordered;
+    }
 }
 
 const std::vector<ToolboxModule*>& GWToolbox::GetAllModules()
@@ -277,6 +357,55 @@ bool GWToolbox::ToggleModule(ToolboxModule& m, const bool enable)
     return added;
 }
 
+void GWToolbox::EnableModules(const std::vector<ToolboxModule*>& modules)
+{
+    const auto start = Clock::now();
+    std::vector<ToolboxModule*> to_enable;
+    for (const auto m : modules) {
+        if (!Contains(all_modules_enabled, m) && !Contains(modules_terminating, m) && !Contains(to_enable, m)) {
+            to_enable.push_back(m);
+        }
+    }
+    to_enable = OrderByDependencies(to_enable);
+
+    // Nothing would run the preloads until Resources has started its workers
+    const bool use_workers = Contains(modules_enabled, &Resources::Instance());
+    std::vector<std::future<float>> preloads;
+    preloads.reserve(to_enable.size());
+    for (const auto m : to_enable) {
+        const auto promise = std::make_shared<std::promise<float>>();
+        preloads.push_back(promise->get_future());
+        const auto preload = [m, promise] {
+            const auto preload_start = Clock::now();
+            m->Preload();
+            promise->set_value(MsSince(preload_start));
+        };
+        if (use_workers) {
+            Resources::EnqueueWorkerTask(preload, TaskPool::Priority::High);
+        }
+        else {
+            preload();
+        }
+    }
+
+    for (size_t i = 0; i < to_enable.size(); i++) {
+        const auto m = to_enable[i];
+        const float preload_ms = preloads[i].get();
+        EnabledVector(*m).push_back(m);
+        InitializeModule(*m, preload_ms);
+        UpdateEnabledWidgetVectors(m, true);
+    }
+    ReorderModules(modules_enabled);
+    ReorderModules(reinterpret_cast<std::vector<ToolboxModule*>&>(widgets_enabled));
+    ReorderModules(reinterpret_cast<std::vector<ToolboxModule*>&>(windows_enabled));
+    Log::Log("Enabled %zu modules in %.1fms\n", to_enable.size(), MsSince(start));
+}
+
+const std::vector<GWToolbox::ModuleInitTiming>& GWToolbox::GetInitTimings()
+{
+    return init_timings;
+}
+
 HMODULE GWToolbox::GetDLLModule()
 {
     return dllmodule;
@@ -403,7 +532,7 @@ LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wPara
         case WM_RBUTTONUP:
         case WM_INPUT:
             for (const auto m : tb.GetAllModules()) {
-                m->WndProc(Message, wParam, lParam);
+                ModuleWndProc(m, Message, wParam, lParam);
             }
             break;
 
@@ -423,7 +552,7 @@ LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wPara
             }
             bool captured = false;
             for (const auto m : tb.GetAllModules()) {
-                if (m->WndProc(Message, wParam, lParam)) {
+                if (ModuleWndProc(m, Message, wParam, lParam)) {
                     captured = true;
                 }
             }
@@ -467,7 +596,7 @@ LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wPara
         {
             bool captured = false;
             for (const auto m : tb.GetAllModules()) {
-                if (m->WndProc(Message, wParam, lParam)) {
+                if (ModuleWndProc(m, Message, wParam, lParam)) {
                     captured = true;
                 }
             }
@@ -488,7 +617,7 @@ LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wPara
             // Custom messages registered via RegisterWindowMessage
             if (Message >= 0xC000 && Message <= 0xFFFF) {
                 for (const auto m : tb.GetAllModules()) {
-                    m->WndProc(Message, wParam, lParam);
+                    ModuleWndProc(m, Message, wParam, lParam);
                 }
             }
             break;
@@ -519,23 +648,26 @@ void GWToolbox::Initialize()
     const auto ini = OpenSettingsFile();
 
     Log::Log("Creating Modules\n");
+    // Resources runs the worker pool the others preload on
     ToggleModule(CrashHandler::Instance());
     ToggleModule(Resources::Instance());
-    ToggleModule(ToolboxTheme::Instance());
-    ToggleModule(ToolboxSettings::Instance());
-    ToggleModule(MainWindow::Instance());
-    ToggleModule(DialogModule::Instance());
-
-    ToggleModule(GwDatTextureModule::Instance());
-    ToggleModule(Updater::Instance());
-    ToggleModule(ChatCommands::Instance());
-    ToggleModule(GameSettings::Instance());
-    ToggleModule(ChatSettings::Instance());
-    ToggleModule(InventoryManager::Instance());
-    ToggleModule(HallOfMonumentsModule::Instance());
-    ToggleModule(LoginModule::Instance());
-    ToggleModule(AprilFools::Instance());
-    ToggleModule(SettingsWindow::Instance());
+    EnableModules({
+        &ToolboxTheme::Instance(),
+        &ToolboxSettings::Instance(),
+        &MainWindow::Instance(),
+        &DialogModule::Instance(),
+        &GwDatTextureModule::Instance(),
+        &Updater::Instance(),
+        &ChatCommands::Instance(),
+        &GameSettings::Instance(),
+        &ChatSettings::Instance(),
+        &InventoryManager::Instance(),
+        &HallOfMonumentsModule::Instance(),
+        &LoginModule::Instance(),
+        &ProfilerModule::Instance(),
+        &AprilFools::Instance(),
+        &SettingsWindow::Instance()
+    });
 
     ToolboxSettings::LoadModules(ini); // initialize all other modules as specified by the user
 
@@ -707,6 +839,8 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
             return; // Fonts not loaded yet.
         }
 
+        FrameProfiler::Zone frame_zone(FrameProfiler::Phase::Frame, draw_zone, draw_zone);
+
         Resources::DxUpdate(device);
 
         ImGui_ImplDX9_NewFrame();
@@ -715,6 +849,7 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
         const bool world_map_showing = GW::UI::GetIsWorldMapShowing();
 
         if (!world_map_showing) {
+            FrameProfiler::Zone zone(FrameProfiler::Phase::Draw, minimap_render_zone, minimap_render_zone);
             Minimap::Render(device);
         }
 
@@ -731,6 +866,10 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
             if (world_map_showing && !uielement->ShowOnWorldMap()) {
                 continue;
             }
+            FrameProfiler::Zone zone(FrameProfiler::Phase::Draw, uielement, uielement->Name());
+            if (uielement->IsWindow() && uielement->visible) {
+                static_cast<ToolboxWindow*>(uielement)->EnsureContentInitialized();
+            }
             uielement->Draw(device);
         }
 
@@ -753,21 +892,26 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
 
 void GWToolbox::Update(GW::HookStatus*)
 {
-    static DWORD last_tick_count;
-    if (last_tick_count == 0) {
-        last_tick_count = GetTickCount();
+    FrameProfiler::Zone frame_zone(FrameProfiler::Phase::Frame, update_zone, update_zone);
+
+    static LARGE_INTEGER frequency;
+    static LARGE_INTEGER last_tick;
+    if (last_tick.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&last_tick);
     }
 
-    // @Enhancement:
-    // Improve precision with QueryPerformanceCounter
-    const auto tick = GetTickCount();
-    const auto delta = tick - last_tick_count;
-    const auto delta_f = static_cast<float>(delta) / 1000.f;
+    LARGE_INTEGER tick;
+    QueryPerformanceCounter(&tick);
+    const auto delta_f = static_cast<float>(static_cast<double>(tick.QuadPart - last_tick.QuadPart) / static_cast<double>(frequency.QuadPart));
+
+    AgentSnapshot::NextFrame();
 
     if (initialized
         && imgui_initialized
         && !must_self_destruct) {
         for (const auto m : all_modules_enabled) {
+            FrameProfiler::Zone zone(FrameProfiler::Phase::Update, m, m->Name());
             m->Update(delta_f);
         }
     }
@@ -782,5 +926,5 @@ void GWToolbox::Update(GW::HookStatus*)
         }
         m->Update(delta_f);
     }
-    last_tick_count = tick;
+    last_tick = tick;
 }
@@ -60,4 +60,17 @@ public:
     static bool ToggleModule(ToolboxWidget& m, bool enable = true);
     static bool ToggleModule(ToolboxWindow& m, bool enable = true);
     static bool ToggleModule(ToolboxModule& m, bool enable = true);
+    // Enable modules of any kind together: every Preload runs on the worker pool at once, then each is initialized in
+    // order, after its dependencies.
+    static void EnableModules(const std::vector<ToolboxModule*>& modules);
+
+    struct ModuleInitTiming {
+        const char* name;
+        float preload_ms;
+        // Initialize and LoadSettings
+        float initialize_ms;
+    };
+
+    // The last time each module was enabled
+    static const std::vector<ModuleInitTiming>& GetInitTimings();
 };
@@ -32,6 +32,7 @@
 #pragma warning(disable: 5039)
 
 #include "IRC.h"
+#include <Modules/Resources.h>
 #ifdef WIN32
 #include <windows.h>
 #include <WS2tcpip.h>
@@ -54,7 +55,6 @@ IRC::IRC()
     sentnick = false;
     sentpass = false;
     sentuser = false;
-    pending_disconnect = false;
     cur_nick = nullptr;
 }
 
@@ -153,10 +153,15 @@ int IRC::start(const char* server, int port, const char* nick, const char* user,
     freeaddrinfo(servinfo);
 
     connected = true;
-    t = std::thread([&] {
-        message_loop();
-    });
-    t.detach();
+    // Replies are read on the network thread, which calls back whenever there's something to fetch
+    if (!Resources::GetNetReactor().Watch(irc_socket, [this] {
+        return message_fetch() == 0;
+    })) {
+        printf("Failed to watch socket\n");
+        connected = false;
+        closesocket(irc_socket);
+        return 1;
+    }
     raw("PASS %s\r\n", pass);
     raw("USER %s\r\n", user);
     raw("NICK %s\r\n", user);
@@ -175,17 +180,12 @@ void IRC::disconnect()
     printf("Disconnected from server.\n");
     connected = false;
     quit("Leaving");
+    // Waits for message_fetch to finish if it's running on the network thread, so the socket isn't closed under it
+    Resources::GetNetReactor().Unwatch(irc_socket);
 #ifdef WIN32
     shutdown(irc_socket, 2);
 #endif
     closesocket(irc_socket);
-    // Destroy thread.
-    pending_disconnect = true;
-    if (t.joinable()) {
-        t.join();
-    }
-    pending_disconnect = false;
-    t.~thread();
 }
 
 void IRC::error(const int err)
@@ -244,6 +244,7 @@ int IRC::ping()
         printf("IRC::ping failed to get pong response after timeout; graceful close?\n");
         connected = false;
         ping_sent = 0;
+        Resources::GetNetReactor().Unwatch(irc_socket);
         closesocket(irc_socket);
         return 1;
     }
@@ -255,21 +256,6 @@ bool IRC::is_connected() const
     return connected;
 }
 
-int IRC::message_loop()
-{
-    while (true) {
-        if (!connected) {
-            continue;
-        }
-        if (pending_disconnect) {
-            return 0;
-        }
-        if (message_fetch() != 0) {
-            return 1;
-        }
-    }
-}
-
 void IRC::split_to_replies(const char* data)
 {
     const char* p;
@@ -27,7 +27,6 @@
 
 #include <stdio.h>
 #include <WinSock2.h>
-#include <thread>
 
 #define __CPIRC_VERSION__   0.1
 #define __IRC_DEBUG__ 0
@@ -79,7 +78,6 @@ public:
     int join(const char* channel) const { return raw("JOIN %s\r\n", channel); }
     int kick(const char* channel, const char* nick) const { return raw("KICK %s %s\r\n", channel, nick); }
     void hook_irc_command(const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*));
-    int message_loop();
     int message_fetch();
     int ping();
     int is_op(const char* channel, const char* nick) const;
@@ -99,7 +97,6 @@ private:
     SOCKET irc_socket{};
     char message_buffer[1024] = {0};
     bool connected;
-    bool pending_disconnect;
     bool sentnick;
     bool sentpass;
     bool sentuser;
@@ -111,5 +108,4 @@ private:
     FILE* datain{};
     channel_user* chan_users;
     irc_command_hook* hooks;
-    std::thread t;
 };
@@ -36,7 +36,9 @@
 #include <GWCA/Utilities/Scanner.h>
 #include <GWCA/Utilities/Hooker.h>
 
+#include <Utils/AgentSnapshot.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/SignatureCache.h>
 #include <GWToolbox.h>
 #include <Keys.h>
 #include <Logger.h>
@@ -985,7 +987,7 @@ void ChatCommands::Initialize()
     uintptr_t address = 0;
 #if _DEBUG
     GW::Chat::CreateCommand(L"skillimage", CmdSkillImage);
-    address = GW::Scanner::Find("\x83\xc4\x04\xc7\x45\x08\x00\x00\x00\x00", "xxxxxxxxxx", -5);
+    address = SignatureCache::Find("\x83\xc4\x04\xc7\x45\x08\x00\x00\x00\x00", "xxxxxxxxxx", -5);
     if (address) {
         SetMuted_Func = (SetMuted_pt)GW::Scanner::FunctionFromNearCall(address);
         PostMuted_Func = (PostMute_pt)GW::Scanner::FunctionFromNearCall(address + 0x10);
@@ -994,7 +996,7 @@ void ChatCommands::Initialize()
     GW::Chat::CreateCommand(L"mute", CmdMute); // Doesn't unmute!
 #endif
 
-    address = GW::Scanner::Find("\x3d\x7d\x00\x00\x10\x0f\x87\xe5\x02\x00\x00", "xxxxxxxxxxx", -0x11);
+    address = SignatureCache::Find("\x3d\x7d\x00\x00\x10\x0f\x87\xe5\x02\x00\x00", "xxxxxxxxxxx", -0x11);
     if (address) {
         OnChatInteraction_Callback_Func = (GW::UI::UIInteractionCallback)address;
         FocusChatTab_Func = (FocusChatTab_pt)GW::Scanner::FunctionFromNearCall(address + 0x248);
@@ -1206,55 +1208,45 @@ void ChatCommands::SearchAgent::Init(const wchar_t* _search, const TargetType ty
     search = GuiUtils::ToLower(_search);
     npc_names.clear();
     started = TIMER_INIT();
-    GW::AgentArray* agents = GW::Agents::GetAgentArray();
-    if (!agents) {
-        return;
-    }
-    for (const GW::Agent* agent : *agents) {
-        if (!agent) {
-            continue;
-        }
-        if (!GW::Agents::GetIsAgentTargettable(agent)) {
+    const auto& agents = AgentSnapshot::Get();
+    for (size_t i = 0; i < agents.size(); i++) {
+        if (!agents.Is(i, AgentSnapshot::Targettable)) {
             continue;
         }
         switch (type) {
             case Item:
-                if (!agent->GetIsItemType()) {
+                if (!agents.Is(i, AgentSnapshot::Item)) {
                     continue;
                 }
                 break;
             case Gadget:
-                if (!agent->GetIsGadgetType()) {
+                if (!agents.Is(i, AgentSnapshot::Gadget)) {
                     continue;
                 }
                 break;
             case Player:
-                if (!agent->GetIsLivingType() || !agent->GetAsAgentLiving()->IsPlayer()) {
+                if (!agents.Is(i, AgentSnapshot::Player)) {
                     continue;
                 }
                 break;
-            case Npc: {
-                const GW::AgentLiving* agent_living = agent->GetAsAgentLiving();
-                if (!agent_living || !agent_living->IsNPC() || !agent_living->GetIsAlive()) {
+            case Npc:
+                if (!agents.Is(i, AgentSnapshot::Npc) || !agents.Is(i, AgentSnapshot::Alive)) {
                     continue;
                 }
-            }
-            break;
-            case Living: {
-                const GW::AgentLiving* agent_living = agent->GetAsAgentLiving();
-                if (!agent_living || !agent_living->GetIsAlive()) {
+                break;
+            case Living:
+                if (!agents.Is(i, AgentSnapshot::Living) || !agents.Is(i, AgentSnapshot::Alive)) {
                     continue;
                 }
-            }
-            break;
+                break;
             default:
                 continue;
         }
-        const wchar_t* enc_name = GW::Agents::GetAgentEncName(agent);
+        const wchar_t* enc_name = GW::Agents::GetAgentEncName(agents.agent_ids[i]);
         if (!enc_name || !enc_name[0]) {
             continue;
         }
-        npc_names.push_back({agent->agent_id, new GuiUtils::EncString(enc_name)});
+        npc_names.push_back({agents.agent_ids[i], new GuiUtils::EncString(enc_name)});
     }
 }
 
@@ -1276,8 +1268,9 @@ void ChatCommands::SearchAgent::Update()
     // Do search
     float distance = GW::Constants::SqrRange::Compass;
     size_t closest = 0;
-    const GW::Agent* me = GW::Agents::GetPlayer();
-    if (!me) {
+    const auto& agents = AgentSnapshot::Get();
+    const size_t me = agents.MyIndex();
+    if (me == AgentSnapshot::npos) {
         return;
     }
     for (const auto& enc_name : npc_names) {
@@ -1285,13 +1278,13 @@ void ChatCommands::SearchAgent::Update()
         if (found == std::wstring::npos) {
             continue;
         }
-        const GW::Agent* agent = GW::Agents::GetAgentByID(enc_name.first);
-        if (!agent) {
+        const size_t agent = agents.IndexOf(enc_name.first);
+        if (agent == AgentSnapshot::npos) {
             continue;
         }
-        const auto dist = GetDistance(me->pos, agent->pos);
+        const auto dist = GetDistance(agents.positions[me], agents.positions[agent]);
         if (dist < distance) {
-            closest = agent->agent_id;
+            closest = enc_name.first;
             distance = dist;
         }
     }
@@ -2506,112 +2499,68 @@ void ChatCommands::TargetNearest(const wchar_t* model_id_or_name, const TargetTy
     }
 
     // target nearest agent
-    const auto agents = GW::Agents::GetAgentArray();
-    const auto me = agents ? GW::Agents::GetPlayerAsAgentLiving() : nullptr;
-    if (me == nullptr) {
+    const auto& agents = AgentSnapshot::Get();
+    const size_t me = agents.MyIndex();
+    if (me == AgentSnapshot::npos) {
         return;
     }
-
-    float distance = GW::Constants::SqrRange::Compass;
-    size_t closest = 0;
-    size_t count = 0;
-
-    for (const GW::Agent* agent : *agents) {
-        if (!agent || agent == me) {
-            continue;
+    const auto is_match = [&](const size_t i) {
+        if (i == me || !agents.Is(i, AgentSnapshot::Targettable)) {
+            return false;
         }
-        if (!GW::Agents::GetIsAgentTargettable(agent)) {
-            continue;
+        if (model_id && agents.model_ids[i] != model_id) {
+            return false;
         }
+        const auto allegiance = static_cast<GW::Constants::Allegiance>(agents.allegiances[i]);
         switch (type) {
-            case Gadget: {
+            case Gadget:
                 // Target gadget by gadget id
-                const auto gadget = agent->GetAsAgentGadget();
-                if (!gadget || (model_id && gadget->gadget_id != model_id)) {
-                    continue;
-                }
-            }
-            break;
-            case Item: {
+                return agents.Is(i, AgentSnapshot::Gadget);
+            case Item:
                 // Target item by model id
-                const auto item_agent = agent->GetAsAgentItem();
-                if (!item_agent) {
-                    continue;
-                }
-                const auto item = GW::Items::GetItemById(item_agent->item_id);
-                if (!item || (model_id && item->model_id != model_id)) {
-                    continue;
-                }
-            }
-            break;
-            case Npc: {
+                return agents.Is(i, AgentSnapshot::Item);
+            case Npc:
                 // Target npc by model id
-                const auto living_agent = agent->GetAsAgentLiving();
-                if (!living_agent || !living_agent->IsNPC() || !living_agent->GetIsAlive() || (model_id && living_agent->player_number != model_id)) {
-                    continue;
-                }
-            }
-            break;
-            case Player: {
+                return agents.Is(i, AgentSnapshot::Npc) && agents.Is(i, AgentSnapshot::Alive);
+            case Player:
                 // Target player by player number
-                const auto living_agent = agent->GetAsAgentLiving();
-                if (!living_agent || !living_agent->IsPlayer() || (model_id && living_agent->player_number != model_id)) {
-                    continue;
-                }
-            }
-            break;
-            case Ally: {
+                return agents.Is(i, AgentSnapshot::Player);
+            case Ally:
                 // Target any living ally
                 // NB: Not quite the same as the GW version;
                 // GW targets nearest player if they're less than half the distance as the nearest agent.
                 // Could be a little confusing if this is used instead of 'V' in-game.
-                const auto living_agent = agent->GetAsAgentLiving();
-                if (!living_agent
-                    || living_agent->allegiance == GW::Constants::Allegiance::Enemy
-                    || living_agent->allegiance == GW::Constants::Allegiance::Neutral
-                    || !living_agent->GetIsAlive() || (model_id && living_agent->player_number != model_id)) {
-                    continue;
-                }
-            }
-            break;
-            case Enemy: {
+                return agents.Is(i, AgentSnapshot::Living) && agents.Is(i, AgentSnapshot::Alive)
+                       && allegiance != GW::Constants::Allegiance::Enemy
+                       && allegiance != GW::Constants::Allegiance::Neutral;
+            case Enemy:
                 // Target any living enemy
-                const auto living_agent = agent->GetAsAgentLiving();
-                if (!living_agent || living_agent->allegiance != GW::Constants::Allegiance::Enemy || !living_agent->GetIsAlive() || (model_id && living_agent->player_number != model_id)) {
-                    continue;
-                }
-            }
-            break;
-            case Living: {
+                return agents.Is(i, AgentSnapshot::Living) && agents.Is(i, AgentSnapshot::Alive) && allegiance == GW::Constants::Allegiance::Enemy;
+            case Living:
                 // Target any living agent by model id
-                const auto living_agent = agent->GetAsAgentLiving();
-                if (!living_agent || !living_agent->GetIsAlive() || (model_id && living_agent->player_number != model_id)) {
-                    continue;
-                }
-            }
-            break;
+                return agents.Is(i, AgentSnapshot::Living) && agents.Is(i, AgentSnapshot::Alive);
             default:
-                continue;
-        }
-        if (index == 0) {
-            // target closest
-            const float newDistance = GetSquareDistance(me->pos, agent->pos);
-            if (newDistance < distance) {
-                closest = agent->agent_id;
-                distance = newDistance;
-            }
+                return false;
         }
-        else {
-            // target based on id
-            ++count;
-            if (count == index) {
-                closest = agent->agent_id;
+    };
+
+    size_t closest = AgentSnapshot::npos;
+    if (index == 0) {
+        // target closest
+        closest = agents.Nearest(agents.positions[me], GW::Constants::Range::Compass, is_match);
+    }
+    else {
+        // target based on id
+        size_t count = 0;
+        for (size_t i = 0; i < agents.size(); i++) {
+            if (is_match(i) && ++count == index) {
+                closest = i;
                 break;
             }
         }
     }
-    if (closest) {
-        GW::Agents::ChangeTarget(closest);
+    if (closest != AgentSnapshot::npos) {
+        GW::Agents::ChangeTarget(agents.agent_ids[closest]);
     }
 }
 
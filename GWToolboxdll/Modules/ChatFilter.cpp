@@ -19,6 +19,7 @@
 #include <GWCA/GameEntities/Friendslist.h>
 #include <Utils/ToolboxUtils.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/ContentFilter.h>
 
 #include "GWToolbox.h"
 #include "GWCA/Managers/PlayerMgr.h"
@@ -77,11 +78,11 @@ namespace {
     constexpr uint32_t NOISE_REDUCTION_DELAY_MS = 1000;
 
     // Chat filter
-    std::vector<std::wstring> bycontent_words;
+    // Compiled from bycontent_word_buf and bycontent_regex_buf
+    ContentFilter bycontent_filter;
     char bycontent_word_buf[FILTER_BUF_SIZE] = "";
     bool bycontent_filedirty = false;
 
-    std::vector<std::wregex> bycontent_regex;
     char bycontent_regex_buf[FILTER_BUF_SIZE] = "";
 
 #ifdef EXTENDED_IGNORE_LIST
@@ -160,10 +161,10 @@ namespace {
 
 
 
-    void ParseBuffer(const char* text, std::vector<std::wstring>& words)
+    void ParseWordBuffer(const char* text)
     {
         using namespace GuiUtils;
-        words.clear();
+        bycontent_filter.ClearWords();
         const auto text_ws = RemoveDiacritics(ToLower(StringToWString(text)));
         std::wstringstream stream(text_ws.c_str());
         std::wstring word;
@@ -171,14 +172,14 @@ namespace {
             if (word.empty()) {
                 continue;
             }
-            words.push_back(word);
+            bycontent_filter.AddWord(word);
         }
     }
 
-    void ParseBuffer(const char* text, std::vector<std::wregex>& regex)
+    void ParseRegexBuffer(const char* text)
     {
         using namespace GuiUtils;
-        regex.clear();
+        bycontent_filter.ClearRegexes();
         const auto text_ws = RemoveDiacritics(StringToWString(text));
         std::wstringstream stream(text_ws.c_str());
         std::wstring word;
@@ -225,10 +226,10 @@ namespace {
                                 break;
                         }
                     }
-                    regex.emplace_back(regex_str, regex_flags);
+                    bycontent_filter.AddRegex(regex_str, regex_flags);
                 }
                 else {
-                    regex.emplace_back(word, std::regex_constants::optimize);
+                    bycontent_filter.AddRegex(word, std::regex_constants::optimize);
                 }
             } catch (const std::regex_error&) {
                 Log::Warning("Cannot parse regular expression '%s'", word.c_str());
@@ -661,17 +662,7 @@ namespace {
         }
         const auto sanitized = RemoveDiacritics(str);
         const auto lowercase = ToLower(sanitized);
-        for (const auto& s : bycontent_words) {
-            if (lowercase.find(s) != std::wstring::npos) {
-                return true;
-            }
-        }
-        for (const auto& r : bycontent_regex) {
-            if (std::regex_search(sanitized, r)) {
-                return true;
-            }
-        }
-        return false;
+        return bycontent_filter.Match(sanitized, lowercase) != nullptr;
     }
 
     // Should this channel be checked for ignored messages?
@@ -875,14 +866,14 @@ void ChatFilter::LoadSettings(ToolboxIni* ini)
     if (file1.is_open()) {
         file1.get(bycontent_word_buf, FILTER_BUF_SIZE, '\0');
         file1.close();
-        ParseBuffer(bycontent_word_buf, bycontent_words);
+        ParseWordBuffer(bycontent_word_buf);
     }
     std::ifstream file2;
     file2.open(Resources::GetSettingFile(L"FilterByContent_regex.txt"));
     if (file2.is_open()) {
         file2.get(bycontent_regex_buf, FILTER_BUF_SIZE, '\0');
         file2.close();
-        ParseBuffer(bycontent_regex_buf, bycontent_regex);
+        ParseRegexBuffer(bycontent_regex_buf);
     }
 
 #ifdef EXTENDED_IGNORE_LIST
@@ -947,13 +938,13 @@ void ChatFilter::SaveSettings(ToolboxIni* ini)
 
     if (timer_parse_filters) {
         timer_parse_filters = 0;
-        ParseBuffer(bycontent_word_buf, bycontent_words);
+        ParseWordBuffer(bycontent_word_buf);
         bycontent_filedirty = true;
     }
 
     if (timer_parse_regexes) {
         timer_parse_regexes = 0;
-        ParseBuffer(bycontent_regex_buf, bycontent_regex);
+        ParseRegexBuffer(bycontent_regex_buf);
         bycontent_filedirty = true;
     }
 
@@ -1130,6 +1121,20 @@ void ChatFilter::DrawSettingsInternal()
                                   FILTER_BUF_SIZE, ImVec2(-1.0f, 0.0))) {
         timer_parse_regexes = GetTickCount() + NOISE_REDUCTION_DELAY_MS;
     }
+    if (!bycontent_filter.empty() && ImGui::TreeNodeEx("Filter hits", ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth)) {
+        ImGui::TextDisabled("Messages hidden by each line since the list was last changed");
+        for (const auto& rule : bycontent_filter.Rules()) {
+            ImGui::Text("%6u  %s", rule.hits, GuiUtils::WStringToString(rule.source).c_str());
+            if (rule.is_regex && rule.required_literal.empty()) {
+                ImGui::SameLine();
+                ImGui::TextDisabled("(checked against every message)");
+            }
+        }
+        if (ImGui::Button("Reset")) {
+            bycontent_filter.ResetHits();
+        }
+        ImGui::TreePop();
+    }
     ImGui::Unindent();
 
 #ifdef EXTENDED_IGNORE_LIST
@@ -1151,13 +1156,13 @@ void ChatFilter::Update(const float)
     const uint32_t timestamp = GetTickCount();
     if (timer_parse_filters && timer_parse_filters < timestamp) {
         timer_parse_filters = 0;
-        ParseBuffer(bycontent_word_buf, bycontent_words);
+        ParseWordBuffer(bycontent_word_buf);
         bycontent_filedirty = true;
     }
 
     if (timer_parse_regexes && timer_parse_regexes < timestamp) {
         timer_parse_regexes = 0;
-        ParseBuffer(bycontent_regex_buf, bycontent_regex);
+        ParseRegexBuffer(bycontent_regex_buf);
         bycontent_filedirty = true;
     }
 }
@@ -9,6 +9,7 @@
 #include <GWCA/Utilities/Scanner.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/SignatureCache.h>
 
 #include <Modules/Resources.h>
 #include <Modules/ChatLog.h>
@@ -23,6 +24,16 @@ namespace {
     ClearChatLog_pt ClearChatLog_Func = nullptr;
     using InitChatLog_pt = void(__cdecl*)();
     InitChatLog_pt InitChatLog_Func = nullptr;
+
+    uint64_t FileTimeToUInt64(const FILETIME& t)
+    {
+        return static_cast<uint64_t>(t.dwHighDateTime) << 32 | t.dwLowDateTime;
+    }
+
+    FILETIME UInt64ToFileTime(const uint64_t t)
+    {
+        return {static_cast<DWORD>(t), static_cast<DWORD>(t >> 32)};
+    }
 }
 
 namespace GW::Chat {
@@ -103,9 +114,15 @@ void ChatLog::Add(wchar_t* _message, const uint32_t _channel, const FILETIME _ti
     }
 trim_log:
     recv_count++;
+    bool kept = true;
     while (recv_count > GW::Chat::CHAT_LOG_LENGTH) {
+        kept = kept && recv_first != new_message;
         Remove(recv_first);
     }
+    // Anything older than the whole log has been journaled already
+    if (kept && !loading) {
+        journal.Append({ChatJournal::Kind::Received, _channel, FileTimeToUInt64(_timestamp), 0, _message});
+    }
 }
 
 void ChatLog::AddSent(wchar_t* _message, const uint32_t addr)
@@ -136,9 +153,15 @@ void ChatLog::AddSent(wchar_t* _message, const uint32_t addr)
     }
 trim_log:
     sent_count++;
+    const uint32_t address = new_message->gw_message_address;
     while (sent_count > GW::Chat::SENT_LOG_LENGTH) {
         RemoveSent(sent_first);
     }
+    if (!loading) {
+        FILETIME now;
+        GetSystemTimeAsFileTime(&now);
+        journal.Append({ChatJournal::Kind::Sent, 0, FileTimeToUInt64(now), address, _message});
+    }
 }
 
 void ChatLog::Remove(const TBChatMessage* message)
@@ -209,56 +232,10 @@ void ChatLog::Fetch()
     }
 }
 
-void ChatLog::Save() const
+void ChatLog::Save()
 {
-    if (!enabled || account.empty()) {
-        return;
-    }
-    // Received log FIFO
-    auto inifile = new ToolboxIni(false, false, false);
-    std::string msg_buf;
-    char addr_buf[8];
-    const TBChatMessage* recv = recv_first;
-    size_t i = 0;
-    std::string datetime_str;
-    while (recv) {
-        if (GuiUtils::TimeToString(recv->timestamp, datetime_str)) {
-            snprintf(addr_buf, 8, "%03x", i++);
-            ASSERT(GuiUtils::ArrayToIni(recv->msg.data(), &msg_buf));
-            inifile->SetValue(addr_buf, "message", msg_buf.c_str());
-            inifile->SetLongValue(addr_buf, "dwLowDateTime", recv->timestamp.dwLowDateTime);
-            inifile->SetLongValue(addr_buf, "dwHighDateTime", recv->timestamp.dwHighDateTime);
-            inifile->SetLongValue(addr_buf, "channel", recv->channel);
-            inifile->SetValue(addr_buf, "datetime", datetime_str.c_str());
-        }
-        else {
-            Log::Log("Failed to turn timestamp for message %d into string", i);
-        }
-
-        if (recv == recv_last) {
-            break;
-        }
-        recv = recv->next;
-    }
-    ASSERT(inifile->SaveFile(LogPath(L"recv").c_str()) == SI_OK);
-    delete inifile;
-
-    // Sent log FIFO
-    inifile = new ToolboxIni(false, false, false);
-    const TBSentMessage* sent = sent_first;
-    i = 0;
-    while (sent) {
-        snprintf(addr_buf, 8, "%03x", i++);
-        ASSERT(GuiUtils::ArrayToIni(sent->msg.c_str(), &msg_buf));
-        inifile->SetValue(addr_buf, "message", msg_buf.c_str());
-        inifile->SetLongValue(addr_buf, "addr", sent->gw_message_address);
-        if (sent == sent_last) {
-            break;
-        }
-        sent = sent->next;
-    }
-    ASSERT(inifile->SaveFile(LogPath(L"sent").c_str()) == SI_OK);
-    delete inifile;
+    // Messages are journaled as they arrive
+    journal.Flush();
 }
 
 void ChatLog::SaveSettings(ToolboxIni* ini)
@@ -276,6 +253,14 @@ void ChatLog::LoadSettings(ToolboxIni* ini)
     Init();
 }
 
+std::filesystem::path ChatLog::JournalPath() const
+{
+    wchar_t fn[128];
+    swprintf(fn, 128, L"chat_%s.dat", account.c_str());
+    Resources::EnsureFolderExists(Resources::GetPath(L"chat logs"));
+    return Resources::GetPath(L"chat logs", fn);
+}
+
 std::filesystem::path ChatLog::LogPath(const wchar_t* prefix) const
 {
     wchar_t fn[128];
@@ -287,11 +272,45 @@ std::filesystem::path ChatLog::LogPath(const wchar_t* prefix) const
 void ChatLog::Load(const std::wstring& _account)
 {
     Reset();
+    account = _account;
+    const auto path = JournalPath();
+    const bool existed = exists(path);
+    if (!journal.Open(path)) {
+        Log::LogW(L"Failed to open chat journal %s", path.wstring().c_str());
+        return;
+    }
+    if (!existed) {
+        if (!LoadLegacy()) {
+            // Leave the old logs to be imported next time, rather than keep a journal that's missing them
+            journal.Close();
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            std::filesystem::remove(path.wstring() + L".idx", ec);
+            Log::LogW(L"Failed to import chat logs for %s", account.c_str());
+        }
+        return;
+    }
 
+    loading = true;
+    std::vector<ChatJournal::Message> messages;
+    journal.Tail(ChatJournal::Kind::Received, GW::Chat::CHAT_LOG_LENGTH, messages);
+    for (auto& message : messages) {
+        Add(message.text.data(), message.channel, UInt64ToFileTime(message.timestamp));
+    }
+    journal.Tail(ChatJournal::Kind::Sent, GW::Chat::SENT_LOG_LENGTH, messages);
+    for (auto& message : messages) {
+        AddSent(message.text.data(), message.address);
+    }
+    loading = false;
+}
+
+bool ChatLog::LoadLegacy()
+{
     // Recv log FIFO
-    account = _account;
     ToolboxIni inifile;
-    ASSERT(inifile.LoadIfExists(LogPath(L"recv")) == SI_OK);
+    if (inifile.LoadIfExists(LogPath(L"recv")) != SI_OK) {
+        return false;
+    }
 
     ToolboxIni::TNamesDepend entries;
     inifile.GetAllSections(entries);
@@ -314,7 +333,9 @@ void ChatLog::Load(const std::wstring& _account)
 
     // sent log FIFO
     inifile.Reset();
-    ASSERT(inifile.LoadIfExists(LogPath(L"sent")) == SI_OK);
+    if (inifile.LoadIfExists(LogPath(L"sent")) != SI_OK) {
+        return false;
+    }
     entries.clear();
     inifile.GetAllSections(entries);
     for (const ToolboxIni::Entry& entry : entries) {
@@ -329,6 +350,15 @@ void ChatLog::Load(const std::wstring& _account)
         const uint32_t addr = inifile.GetLongValue(entry.pItem, "addr", 0);
         AddSent(buf.data(), addr);
     }
+
+    // Only once it's all in the journal
+    if (!journal.Flush()) {
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::remove(LogPath(L"recv"), ec);
+    std::filesystem::remove(LogPath(L"sent"), ec);
+    return true;
 }
 
 void ChatLog::Inject()
@@ -427,32 +457,37 @@ bool ChatLog::Init()
     return true;
 }
 
-void ChatLog::Initialize()
+void ChatLog::Preload()
 {
-    ToolboxModule::Initialize();
     {
         // Hook for logging outgoing (sent) messages
-        uintptr_t address = GW::Scanner::FindAssertion(R"(p:\code\gw\chat\ctchatedit.cpp)", "length", -0x5A);
+        const uintptr_t address = GW::Scanner::FindAssertion(R"(p:\code\gw\chat\ctchatedit.cpp)", "length", -0x5A);
         if (address) {
             AddToSentLog_Func = (AddToSentLog_pt)address;
-            GW::Hook::CreateHook(AddToSentLog_Func, OnAddToSentLog, (void**)&RetAddToSentLog);
-            GW::Hook::EnableHooks(AddToSentLog_Func);
-            address += 0x17;
-            gw_sent_log_ptr = *(uintptr_t*)address;
+            gw_sent_log_ptr = *(uintptr_t*)(address + 0x17);
         }
         printf("[SCAN] AddToSentLog_Func = %p\n", (void*)AddToSentLog_Func);
         printf("[SCAN] gw_sent_log_ptr = %p\n", (void*)gw_sent_log_ptr);
     }
     {
         // For properly clearing out the existing chat log (only need to call, not hook)
-        ClearChatLog_Func = (ClearChatLog_pt)GW::Scanner::Find("\x83\xc4\x08\x8d\x77\x0c\xbb\x00\x02\x00\x00", "xxxxxxxxxxx", -0x70);
+        ClearChatLog_Func = (ClearChatLog_pt)SignatureCache::Find("\x83\xc4\x08\x8d\x77\x0c\xbb\x00\x02\x00\x00", "xxxxxxxxxxx", -0x70);
         printf("[SCAN] ClearChatLog_Func = %p\n", (void*)ClearChatLog_Func);
     }
     {
         // For properly clearing out the existing chat log (only need to call, not hook)
-        InitChatLog_Func = (InitChatLog_pt)GW::Scanner::FunctionFromNearCall(GW::Scanner::Find("\x68\x7e\x00\x00\x10\x53", "xxxxxx", -0x5));
+        InitChatLog_Func = (InitChatLog_pt)GW::Scanner::FunctionFromNearCall(SignatureCache::Find("\x68\x7e\x00\x00\x10\x53", "xxxxxx", -0x5));
         printf("[SCAN] InitChatLog_Func = %p\n", (void*)InitChatLog_Func);
     }
+}
+
+void ChatLog::Initialize()
+{
+    ToolboxModule::Initialize();
+    if (AddToSentLog_Func) {
+        GW::Hook::CreateHook(AddToSentLog_Func, OnAddToSentLog, (void**)&RetAddToSentLog);
+        GW::Hook::EnableHooks(AddToSentLog_Func);
+    }
 
     RegisterChatLogCallback(&PreAddToChatLog_entry, OnPreAddToChatLog, -0x4000);
     RegisterChatLogCallback(&PostAddToChatLog_entry, OnPostAddToChatLog, 0x4000);
@@ -3,6 +3,7 @@
 #include <GWCA/Utilities/Hook.h>
 
 #include <ToolboxModule.h>
+#include <Utils/ChatJournal.h>
 #include <minwindef.h>
 
 namespace GW::Chat {
@@ -54,6 +55,9 @@ class ChatLog : public ToolboxModule {
     bool injecting = false;
     bool enabled = true;
     bool pending_inject = false;
+    // Messages being read back from the journal aren't written to it again
+    bool loading = false;
+    ChatJournal journal;
     void SetEnabled(bool _enabled);
     void Reset();
     // Collect current in-game logs and combine them with the tb logs
@@ -68,11 +72,16 @@ class ChatLog : public ToolboxModule {
     void RemoveSent(const TBSentMessage* message);
     // Add message to incoming log
     void Add(wchar_t* _message, uint32_t _channel, FILETIME _timestamp);
-    void Save() const;
-    // Path to chat log file on disk
+    // Write out anything the journal is holding on to
+    void Save();
+    // Path to the account's chat journal on disk
+    std::filesystem::path JournalPath() const;
+    // Path to chat log file on disk from before the journal, read once to fill it
     std::filesystem::path LogPath(const wchar_t* prefix) const;
     // Load chat log from file via account email address
     void Load(const std::wstring& _account);
+    // Imports the old .ini logs into a new journal; they're deleted only if that worked
+    bool LoadLegacy();
     // Clear current chat log and prefill from tb chat log; chat box will update on map change
     void Inject();
     void InjectSent();
@@ -137,6 +146,7 @@ public:
     [[nodiscard]] const char* Description() const override { return "Guild Wars doesn't save your chat history or sent messages if you log out of the game.\nTurn this feature on to let GWToolbox keep better track of your chat history between logins"; }
     [[nodiscard]] const char* SettingsName() const override { return "Chat Settings"; }
 
+    void Preload() override;
     void Initialize() override;
     void RegisterSettingsContent() override;
     void LoadSettings(ToolboxIni* ini) override;
@@ -5,6 +5,8 @@
 #include <GWCA/Utilities/Hooker.h>
 #include <GWCA/Utilities/Scanner.h>
 
+#include <Utils/SignatureCache.h>
+
 #include <Modules/CrashHandler.h>
 #include <Modules/Resources.h>
 #include <GWToolbox.h>
@@ -175,7 +177,7 @@ void CrashHandler::Initialize()
 {
     ToolboxModule::Initialize();
     GW::RegisterPanicHandler(GWCAPanicHandler, nullptr);
-    HandleCrash_Func = (HandleCrash_pt)GW::Scanner::Find("\x68\x00\x00\x08\x00\xff\x75\x1c", "xxxxxxxx", -0x4C);
+    HandleCrash_Func = (HandleCrash_pt)SignatureCache::Find("\x68\x00\x00\x08\x00\xff\x75\x1c", "xxxxxxxx", -0x4C);
     if (HandleCrash_Func) {
         GW::Hook::CreateHook(HandleCrash_Func, OnGWCrash, (void**)&RetHandleCrash);
         GW::Hook::EnableHooks(HandleCrash_Func);
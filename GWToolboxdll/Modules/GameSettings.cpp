@@ -45,6 +45,7 @@
 
 #include <Utils/GuiUtils.h>
 #include <Utils/ToolboxUtils.h>
+#include <Utils/SignatureCache.h>
 
 #include <Modules/PartyWindowModule.h>
 
@@ -1263,7 +1264,7 @@ void GameSettings::Initialize()
     ToolboxModule::Initialize();
 
     // Patch that allow storage page (and Anniversary page) to work.
-    uintptr_t address = GW::Scanner::Find("\xEB\x17\x33\xD2\x8D\x4A\x06\xEB", "xxxxxxxx", -4);
+    uintptr_t address = SignatureCache::Find("\xEB\x17\x33\xD2\x8D\x4A\x06\xEB", "xxxxxxxx", -4);
     printf("[SCAN] StoragePatch = %p\n", (void*)address);
 
     // Xunlai Chest has a behavior where if you
@@ -1277,31 +1278,31 @@ void GameSettings::Initialize()
     ctrl_click_patch.SetPatch(address, (const char*)&page_max, 1);
     ctrl_click_patch.TogglePatch(true);
 
-    address = GW::Scanner::Find("\x5F\x6A\x00\xFF\x75\xE4\x6A\x4C\xFF\x75\xF8", "xxxxxxxxxxx", -0x44);
+    address = SignatureCache::Find("\x5F\x6A\x00\xFF\x75\xE4\x6A\x4C\xFF\x75\xF8", "xxxxxxxxxxx", -0x44);
     printf("[SCAN] TomePatch = %p\n", (void*)address);
     if (address) {
         tome_patch.SetPatch(address, "\x75\x1E\x90\x90\x90\x90\x90", 7);
     }
 
-    address = GW::Scanner::Find("\x81\xff\x86\x02\x00\x00", "xxxxxx", 6);
+    address = SignatureCache::Find("\x81\xff\x86\x02\x00\x00", "xxxxxx", 6);
     printf("[SCAN] MapEntryMessagePatch = %p\n", (void*)address);
     if (address) {
         skip_map_entry_message_patch.SetPatch(address, "\x90\xe9", 2);
     }
 
-    address = GW::Scanner::Find("\xF7\x40\x0C\x10\x00\x02\x00\x75", "xxxxxx??", +7);
+    address = SignatureCache::Find("\xF7\x40\x0C\x10\x00\x02\x00\x75", "xxxxxx??", +7);
     printf("[SCAN] GoldConfirmationPatch = %p\n", (void*)address);
     if (address) {
         gold_confirm_patch.SetPatch(address, "\x90\x90", 2);
     }
 
-    address = GW::Scanner::Find("\xdf\xe0\xf6\xc4\x41\x7a\x78", "xxxxxxx", 0x5);
+    address = SignatureCache::Find("\xdf\xe0\xf6\xc4\x41\x7a\x78", "xxxxxxx", 0x5);
     if (address) {
         remove_skill_warmup_duration_patch.SetPatch(address, "\x90\x90", 2);
     }
 
     // This could be done with patches if we wanted to still show description for weapon sets and merchants etc, but its more signatures to log.
-    GetItemDescription_Func = (GetItemDescription_pt)GW::Scanner::Find("\x8b\xc3\x25\xfd\x00\x00\x00\x3c\xfd", "xxxxxxxxx", -0x5f);
+    GetItemDescription_Func = (GetItemDescription_pt)SignatureCache::Find("\x8b\xc3\x25\xfd\x00\x00\x00\x3c\xfd", "xxxxxxxxx", -0x5f);
     if (GetItemDescription_Func) {
         GW::HookBase::CreateHook(GetItemDescription_Func, OnGetItemDescription, (void**)&GetItemDescription_Ret);
         GW::HookBase::EnableHooks(GetItemDescription_Func);
@@ -1314,7 +1315,7 @@ void GameSettings::Initialize()
     skill_description_patch.TogglePatch(true);
 
     // See OnAgentAllegianceChanged
-    address = GW::Scanner::Find("\x75\x18\x81\xce\x00\x00\x00\x02\x56", "xxxxxxxxx", 0x9);
+    address = SignatureCache::Find("\x75\x18\x81\xce\x00\x00\x00\x02\x56", "xxxxxxxxx", 0x9);
     SetGlobalNameTagVisibility_Func = (SetGlobalNameTagVisibility_pt)GW::Scanner::FunctionFromNearCall(address);
     if (SetGlobalNameTagVisibility_Func) {
         GlobalNameTagVisibilityFlags = *(uint32_t**)((uintptr_t)SetGlobalNameTagVisibility_Func + 0xb);
@@ -1323,7 +1324,7 @@ void GameSettings::Initialize()
     printf("[SCAN] SetGlobalNameTagVisibility_Func = %p", (void*)SetGlobalNameTagVisibility_Func);
     printf("[SCAN] GlobalNameTagVisibilityFlags = %p", static_cast<void*>(GlobalNameTagVisibilityFlags));
 
-    address = GW::Scanner::Find("\x8b\x7d\x08\x8b\x70\x2c\x83\xff\x0f", "xxxxxxxxx");
+    address = SignatureCache::Find("\x8b\x7d\x08\x8b\x70\x2c\x83\xff\x0f", "xxxxxxxxx");
     ShowAgentFactionGain_Func = (ShowAgentFactionGain_pt)GW::Scanner::FunctionFromNearCall(address + 0x6c);
     ShowAgentExperienceGain_Func = (ShowAgentExperienceGain_pt)GW::Scanner::FunctionFromNearCall(address + 0x4f);
     printf("[SCAN] ShowAgentFactionGain_Func = %p\n", (void*)ShowAgentFactionGain_Func);
@@ -1335,7 +1336,7 @@ void GameSettings::Initialize()
     GW::HookBase::EnableHooks(ShowAgentExperienceGain_Func);
 
     // Stop GW from force closing the game when clicking on the exit button in window fullscreen; instead route it through the close signal.
-    OnMinOrRestoreOrExitBtnClicked_Func = (GW::UI::UIInteractionCallback)GW::Scanner::Find("\x83\xc4\x0c\xa9\x00\x00\x80\x00", "xxxxxxxx", -0x54);
+    OnMinOrRestoreOrExitBtnClicked_Func = (GW::UI::UIInteractionCallback)SignatureCache::Find("\x83\xc4\x0c\xa9\x00\x00\x80\x00", "xxxxxxxx", -0x54);
     if (OnMinOrRestoreOrExitBtnClicked_Func) {
         GW::HookBase::CreateHook(OnMinOrRestoreOrExitBtnClicked_Func, OnMinOrRestoreOrExitBtnClicked, reinterpret_cast<void**>(&OnMinOrRestoreOrExitBtnClicked_Ret));
         GW::HookBase::EnableHooks();
@@ -8,6 +8,7 @@
 #include <GWCA/Managers/ChatMgr.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/SignatureCache.h>
 
 #include <Modules/Resources.h>
 
@@ -532,7 +533,7 @@ void GuildWarsSettingsModule::Initialize()
         key_mappings_array = *(uint32_t**)address;
     }
 
-    address = GW::Scanner::Find("\x89\x77\x1c\x5f\x5e\x8b\xe5\x5d\xc2\x04\x00", "xxxxxxxxxxx", -0x155);
+    address = SignatureCache::Find("\x89\x77\x1c\x5f\x5e\x8b\xe5\x5d\xc2\x04\x00", "xxxxxxxxxxx", -0x155);
     if (address) {
         OnQuestEntryGroupInteract_Func = (OnQuestEntryGroupInteract_pt)address;
         GW::Hook::CreateHook(OnQuestEntryGroupInteract_Func, OnQuestEntryGroupInteract, (void**)&OnQuestEntryGroupInteract_Ret);
@@ -4,7 +4,11 @@
 #include <GWCA/Managers/UIMgr.h>
 #include <GWCA/Managers/ItemMgr.h>
 
+#include <File.h>
 #include <Logger.h>
+#include <Utils/AtexDecoder.h>
+#include <Utils/GwDatArchive.h>
+#include <Utils/SignatureCache.h>
 #include "GwDatTextureModule.h"
 
 #include "Resources.h"
@@ -97,76 +101,243 @@ namespace {
     }
 
 
-    // OpenImage converts any GW format to ARGB. It is possible to skip conversion if gw format is compatible with D3FMT.
-    uint32_t OpenImage(uint32_t file_id, gw_image_bits* dst_bits, Vec2i& dims, int& levels, GR_FORMAT& format)
+    // Image inside a dat record. Model files (ffna) carry their textures inline, so that's the first ATEX in them.
+    bool FindImage(uint8_t* bytes, const int size, uint8_t** image_bytes, int* image_size)
+    {
+        if (size < 4 || memcmp(bytes, "ffna", 4) != 0) {
+            *image_bytes = bytes;
+            *image_size = size;
+            return true;
+        }
+        const auto found = strnstr(reinterpret_cast<char*>(bytes), "ATEX", size);
+        if (!found || found - reinterpret_cast<char*>(bytes) < 4) {
+            return false;
+        }
+        const int offset = static_cast<int>(found - reinterpret_cast<char*>(bytes));
+        memcpy(image_size, found - 4, sizeof(*image_size));
+        *image_size = std::min(*image_size, size - offset);
+        *image_bytes = bytes + offset;
+        return *image_size > 0;
+    }
+
+    // The game's own decoder, for the formats AtexDecoder doesn't handle (raw, bmp, DXTA...)
+    bool DecodeWithGame(uint8_t* image_bytes, const int image_size, std::vector<uint32_t>& pixels, Vec2i& dims)
     {
-        int size = 0;
         uint8_t* pallete = nullptr;
         gw_image_bits bits = nullptr;
+        GR_FORMAT format = GR_FORMATS;
+        int levels = 0;
+        const uint32_t result = DecodeImage_func(image_size, image_bytes, &bits, pallete, &format, &dims, &levels);
+        if (!result || !bits || format >= GR_FORMATS || levels > 13 || dims.x <= 0 || dims.y <= 0) {
+            if (bits) {
+                FreeImage_func(bits);
+            }
+            return false;
+        }
+        levels = 1;
+        gw_image_bits argb = AllocateImage_func(GR_FORMAT_A8R8G8B8, &dims, levels, 0);
+        Depalletize_func((gw_image_bits)&argb, nullptr, GR_FORMAT_A8R8G8B8, nullptr, bits, pallete, format, nullptr, &dims, levels, 0, 0);
+        FreeImage_func(bits);
+        if (!argb) {
+            return false;
+        }
+        const auto argb_pixels = reinterpret_cast<const uint32_t*>(argb);
+        pixels.assign(argb_pixels, argb_pixels + static_cast<size_t>(dims.x) * dims.y);
+        FreeImage_func(argb);
+        return true;
+    }
 
+    // Decode the image in file_id to ARGB pixels. ATEX textures go through AtexDecoder; the game only decodes anything else.
+    bool OpenImage(const uint32_t file_id, std::vector<uint32_t>& pixels, Vec2i& dims)
+    {
         wchar_t fileHash[4] = { 0 };
         FileIdToFileHash(file_id, fileHash);
 
-        auto rec = FileHashToRecObj_func(fileHash, 1, 0);
-        if (!rec) return 0;
-
+        const auto rec = FileHashToRecObj_func(fileHash, 1, 0);
+        if (!rec) {
+            return false;
+        }
+        int size = 0;
         const auto bytes = GetRecObjectBytes_func(rec, &size);
         if (!bytes) {
             CloseRecObj_func(rec);
-            return 0;
+            return false;
         }
-        int image_size = size;
-        auto image_bytes = bytes;
-        if (memcmp((char*)bytes, "ffna", 4) == 0) {
-            // Model file format; try to find first instance of image from this.
-            const auto found = strnstr((char*)bytes, "ATEX",size);
-            if (!found) {
-                UnkRecObjBytes_func(rec, bytes);
-                CloseRecObj_func(rec);
-                return 0;
+
+        bool ok = false;
+        uint8_t* image_bytes = nullptr;
+        int image_size = 0;
+        if (FindImage(bytes, size, &image_bytes, &image_size)) {
+            AtexDecoder::ImageInfo info;
+            if (AtexDecoder::Decode(image_bytes, static_cast<size_t>(image_size), pixels, &info)) {
+                dims = {info.width, info.height};
+                ok = true;
+            }
+            else {
+                ok = DecodeWithGame(image_bytes, image_size, pixels, dims);
             }
-            image_bytes = (uint8_t*)found;
-            image_size = *(int*)(found - 4);
         }
+        UnkRecObjBytes_func(rec, bytes);
+        CloseRecObj_func(rec);
+        return ok && dims.x && dims.y;
+    }
 
-        uint32_t result = DecodeImage_func(image_size, image_bytes, &bits, pallete, &format, &dims, &levels);
-        if (rec) {
-            UnkRecObjBytes_func(rec, bytes);
-            if (levels > 13)                return 0;
+    // Gw.dat read directly, so that textures can be decompressed and decoded on worker threads instead of through the game on the
+    // render thread. Tasks hold their own reference, so Terminate doesn't have to wait for them.
+    std::shared_ptr<GwDatArchive> dat_archive;
+    std::mutex dat_archive_mutex;
 
-            CloseRecObj_func(rec);
+    std::shared_ptr<GwDatArchive> GetDatArchive()
+    {
+        std::lock_guard lock(dat_archive_mutex);
+        return dat_archive;
+    }
+
+    // Same as OpenImage, but through the archive; safe from any thread. Only ATEX images are handled, anything else needs the game.
+    bool ReadImage(const GwDatArchive& archive, const uint32_t file_id, std::vector<uint32_t>& pixels, Vec2i& dims)
+    {
+        const auto record = archive.Find(file_id);
+        if (!record) {
+            return false;
+        }
+        GwDatArchive::Arena arena;
+        if (!archive.Read(*record, arena) || arena.output.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            return false;
+        }
+        uint8_t* image_bytes = nullptr;
+        int image_size = 0;
+        if (!FindImage(arena.output.data(), static_cast<int>(arena.output.size()), &image_bytes, &image_size)) {
+            return false;
         }
+        AtexDecoder::ImageInfo info;
+        if (!AtexDecoder::Decode(image_bytes, static_cast<size_t>(image_size), pixels, &info)) {
+            return false;
+        }
+        dims = {info.width, info.height};
+        return dims.x && dims.y;
+    }
 
-        if (format >= GR_FORMATS || !result) return 0;
+    // Decoded ARGB images from previous sessions, so a warm start can upload textures without touching the dat decoder.
+    // Layout is a DecodedCacheHeader followed by DecodedCacheRecord + pixels for each image, appended as new file ids are decoded.
+    // The whole cache is thrown away when Gw.dat changes.
+    constexpr uint32_t DECODED_CACHE_MAGIC = 0x43545747; // "GWTC"
+    constexpr uint32_t DECODED_CACHE_VERSION = 1;
+    const wchar_t* DECODED_CACHE_FILENAME = L"gwdat_textures.bin";
+
+    struct DecodedCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t dat_fingerprint;
+    };
 
-        levels = 1;
-        
-        *dst_bits = AllocateImage_func(GR_FORMAT_A8R8G8B8, &dims, levels, 0);
-        Depalletize_func((gw_image_bits)dst_bits, nullptr, GR_FORMAT_A8R8G8B8, nullptr, bits, pallete, format, nullptr, &dims, levels, 0, 0);
+    struct DecodedCacheRecord {
+        uint32_t file_id;
+        uint32_t width;
+        uint32_t height;
+        uint32_t size; // bytes of pixel data following this record
+    };
 
-        FreeImage_func(bits);
+    MappedFile decoded_cache_view;
+    // file_id => record inside decoded_cache_view. Built once on Initialize, read-only afterwards.
+    std::unordered_map<uint32_t, const DecodedCacheRecord*> decoded_cache_index;
+    std::filesystem::path decoded_cache_path;
+    std::mutex decoded_cache_write_mutex;
 
-        // todo: free bytes;
-        return result;
+    // Gw.dat next to the running executable
+    std::filesystem::path GetDatPath()
+    {
+        wchar_t exe_path[MAX_PATH];
+        if (!GetModuleFileNameW(nullptr, exe_path, _countof(exe_path))) {
+            return {};
+        }
+        return std::filesystem::path(exe_path).parent_path() / L"Gw.dat";
     }
 
-    IDirect3DTexture9* CreateTexture(IDirect3DDevice9* device, uint32_t file_id, Vec2i &dims)
+    // Cheap stand-in for hashing a multi-gigabyte file: size and last write time of Gw.dat
+    uint64_t GetDatFingerprint()
     {
-        if (!device || !file_id) {
-            return nullptr;
+        const auto dat_path = GetDatPath();
+        if (dat_path.empty()) {
+            return 0;
         }
-        
-        gw_image_bits bits = nullptr;
-        int levels;
-        GR_FORMAT format;
-        auto ret = OpenImage(file_id, &bits, dims, levels, format);
-        if (!ret || !bits || !dims.x || !dims.y) {
-            if (bits) {
-                FreeImage_func(bits);
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(dat_path, ec);
+        if (ec) {
+            return 0;
+        }
+        const auto last_write = std::filesystem::last_write_time(dat_path, ec);
+        if (ec) {
+            return 0;
+        }
+        const auto ticks = static_cast<uint64_t>(last_write.time_since_epoch().count());
+        return (ticks * 0x9E3779B97F4A7C15ull) ^ size;
+    }
+
+    void OpenDecodedCache()
+    {
+        decoded_cache_view.Close();
+        decoded_cache_index.clear();
+        decoded_cache_path.clear();
+
+        const uint64_t fingerprint = GetDatFingerprint();
+        if (!fingerprint) {
+            return;
+        }
+        const auto cache_folder = Resources::GetPath(L"cache");
+        if (!Resources::EnsureFolderExists(cache_folder)) {
+            return;
+        }
+        const auto path = cache_folder / DECODED_CACHE_FILENAME;
+
+        if (decoded_cache_view.Open(path.c_str())) {
+            const auto data = decoded_cache_view.GetData();
+            const auto size = decoded_cache_view.GetSize();
+            const auto header = reinterpret_cast<const DecodedCacheHeader*>(data);
+            if (size >= sizeof(*header) && header->magic == DECODED_CACHE_MAGIC && header->version == DECODED_CACHE_VERSION && header->dat_fingerprint == fingerprint) {
+                size_t offset = sizeof(*header);
+                while (offset + sizeof(DecodedCacheRecord) <= size) {
+                    const auto record = reinterpret_cast<const DecodedCacheRecord*>(data + offset);
+                    const size_t record_size = sizeof(*record) + record->size;
+                    if (offset + record_size > size || record->size != record->width * record->height * 4) {
+                        break; // Truncated by a crash mid-write; anything after this point gets ignored
+                    }
+                    decoded_cache_index[record->file_id] = record;
+                    offset += record_size;
+                }
+                decoded_cache_path = path;
+                return;
             }
-            return nullptr;
+            decoded_cache_view.Close();
         }
 
+        // Missing, stale or unreadable; start again
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        const DecodedCacheHeader header = {DECODED_CACHE_MAGIC, DECODED_CACHE_VERSION, fingerprint};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (out) {
+            decoded_cache_path = path;
+        }
+    }
+
+    void AppendToDecodedCache(const uint32_t file_id, const Vec2i& dims, std::vector<uint8_t>&& pixels)
+    {
+        if (decoded_cache_path.empty()) {
+            return;
+        }
+        Resources::EnqueueWorkerTask([file_id, dims, pixels = std::move(pixels)] {
+            std::lock_guard lock(decoded_cache_write_mutex);
+            if (decoded_cache_path.empty()) {
+                return;
+            }
+            std::ofstream out(decoded_cache_path, std::ios::binary | std::ios::app);
+            const DecodedCacheRecord record = {file_id, static_cast<uint32_t>(dims.x), static_cast<uint32_t>(dims.y), static_cast<uint32_t>(pixels.size())};
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            out.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        }, TaskPool::Priority::Low);
+    }
+
+    IDirect3DTexture9* CreateTextureFromPixels(IDirect3DDevice9* device, const uint8_t* pixels, const Vec2i& dims, const int levels)
+    {
         // Create a texture: http://msdn.microsoft.com/en-us/library/windows/desktop/bb174363(v=vs.85).aspx
         IDirect3DTexture9* tex = nullptr;
         if (device->CreateTexture(dims.x, dims.y, levels, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &tex, 0) != D3D_OK) {
@@ -176,31 +347,55 @@ namespace {
         // Lock the texture for writing: http://msdn.microsoft.com/en-us/library/windows/desktop/bb205913(v=vs.85).aspx
         D3DLOCKED_RECT rect;
         if (tex->LockRect(0, &rect, 0, D3DLOCK_DISCARD) != D3D_OK) {
+            tex->Release();
             return nullptr;
         }
 
-        unsigned int* srcdata = (unsigned int*)bits;
-        for (int y = 0; y < dims.y; y++) {
-            uint8_t* destAddr = ((uint8_t*)rect.pBits + y * rect.Pitch);
-            memcpy(destAddr, srcdata, dims.x * 4);
-            srcdata += dims.x;
-            /* for (int x = 0; x < dims.x; ++x) {
-                uint8_t* destAddr = ((uint8_t*)rect.pBits + y * rect.Pitch + 4 * x);
-
-                // unsigned int data = 0xFF000000 | (*srcdata >> 24 & 0xFF) | (*srcdata >> 16 & 0xFF00) | (*srcdata >> 8 & 0xFF0000);
-                // memcpy(destAddr, &data, 4);
-                memcpy(destAddr, srcdata, 4);
-                srcdata++;
-            }*/
+        const size_t row_size = static_cast<size_t>(dims.x) * 4;
+        if (static_cast<size_t>(rect.Pitch) == row_size) {
+            memcpy(rect.pBits, pixels, row_size * dims.y);
+        }
+        else {
+            for (int y = 0; y < dims.y; y++) {
+                memcpy(static_cast<uint8_t*>(rect.pBits) + y * rect.Pitch, pixels + y * row_size, row_size);
+            }
         }
-        
-        FreeImage_func(bits);
 
         // Unlock the texture so it can be used.
         tex->UnlockRect(0);
         return tex;
     }
 
+    IDirect3DTexture9* CreateTextureFromImage(IDirect3DDevice9* device, const uint32_t file_id, const std::vector<uint32_t>& pixels, const Vec2i& dims)
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(pixels.data());
+        const auto tex = CreateTextureFromPixels(device, bytes, dims, 1);
+        if (tex) {
+            AppendToDecodedCache(file_id, dims, std::vector<uint8_t>(bytes, bytes + pixels.size() * sizeof(uint32_t)));
+        }
+        return tex;
+    }
+
+    IDirect3DTexture9* CreateTexture(IDirect3DDevice9* device, uint32_t file_id, Vec2i &dims)
+    {
+        if (!device || !file_id) {
+            return nullptr;
+        }
+
+        const auto cached = decoded_cache_index.find(file_id);
+        if (cached != decoded_cache_index.end()) {
+            const auto record = cached->second;
+            dims = {static_cast<int>(record->width), static_cast<int>(record->height)};
+            return CreateTextureFromPixels(device, reinterpret_cast<const uint8_t*>(record + 1), dims, 1);
+        }
+
+        std::vector<uint32_t> pixels;
+        if (!OpenImage(file_id, pixels, dims)) {
+            return nullptr;
+        }
+        return CreateTextureFromImage(device, file_id, pixels, dims);
+    }
+
     struct GwImg {
         uint32_t m_file_id = 0;
         Vec2i m_dims;
@@ -219,7 +414,7 @@ void GwDatTextureModule::Initialize()
     using namespace GW;
 
     // @Cleanup: Reduce size of signature and offset jumps
-    uintptr_t address = (uintptr_t)Scanner::Find("\x83\xc4\x0c\x33\xc0\x89\x45\xfc\x85\xf6\x74\x14\x8d\x45\xfc", "xxxxxxxxxxxxxxx", 0);
+    uintptr_t address = (uintptr_t)SignatureCache::Find("\x83\xc4\x0c\x33\xc0\x89\x45\xfc\x85\xf6\x74\x14\x8d\x45\xfc", "xxxxxxxxxxxxxxx", 0);
     if (address) {
         FileHashToRecObj_func = (FileIdToRecObj_pt)Scanner::FunctionFromNearCall(address - 7);
         GetRecObjectBytes_func = (GetRecObjectBytes_pt)Scanner::FunctionFromNearCall(address + 0x11);
@@ -228,8 +423,19 @@ void GwDatTextureModule::Initialize()
         CloseRecObj_func = (CloseRecObj_pt)Scanner::FunctionFromNearCall(address + 0x49);
         AllocateImage_func = (AllocateImage_pt)Scanner::FunctionFromNearCall((uintptr_t)DecodeImage_func + 0x1ef);
         FreeImage_func = (FreeImage_pt)Scanner::FunctionFromNearCall((uintptr_t)DecodeImage_func + 0x298);
-        Depalletize_func = (Depalletize_pt)Scanner::Find("\x83\xc4\x18\x39\xb5\x70\xff\xff\xff\x74\x21\x8b\x57\x04\x0f\xaf\x17\xc1\xe2\x02", "xxxxxxxxxxxxxxxxxxxx", -0x127);
+        Depalletize_func = (Depalletize_pt)SignatureCache::Find("\x83\xc4\x18\x39\xb5\x70\xff\xff\xff\x74\x21\x8b\x57\x04\x0f\xaf\x17\xc1\xe2\x02", "xxxxxxxxxxxxxxxxxxxx", -0x127);
     }
+    OpenDecodedCache();
+    Resources::EnqueueWorkerTask([] {
+        const auto dat_path = GetDatPath();
+        const auto archive = std::make_shared<GwDatArchive>();
+        if (dat_path.empty() || !archive->Open(dat_path.c_str())) {
+            Log::LogW(L"Failed to open %s; textures will be decoded by the game", dat_path.c_str());
+            return;
+        }
+        std::lock_guard lock(dat_archive_mutex);
+        dat_archive = archive;
+    });
 #ifdef _DEBUG
     ASSERT(FileHashToRecObj_func);
     ASSERT(GetRecObjectBytes_func);
@@ -249,9 +455,33 @@ IDirect3DTexture9** GwDatTextureModule::LoadTextureFromFileId(uint32_t file_id)
         return &found->second->m_tex;
     auto gwimg_ptr = new GwImg(file_id);
     textures_by_file_id[file_id] = gwimg_ptr;
-    Resources::Instance().EnqueueDxTask([gwimg_ptr](IDirect3DDevice9* device) {
-        gwimg_ptr->m_tex = CreateTexture(device, gwimg_ptr->m_file_id, gwimg_ptr->m_dims);
+    const auto archive = GetDatArchive();
+    if (!archive || decoded_cache_index.contains(file_id)) {
+        Resources::Instance().EnqueueDxTask([gwimg_ptr](IDirect3DDevice9* device) {
+            gwimg_ptr->m_tex = CreateTexture(device, gwimg_ptr->m_file_id, gwimg_ptr->m_dims);
+            });
+        return &gwimg_ptr->m_tex;
+    }
+    // Decompress and decode off the render thread; only the upload happens in the dx task
+    Resources::EnqueueWorkerTask([archive, file_id] {
+        std::vector<uint32_t> pixels;
+        Vec2i dims;
+        const bool decoded = ReadImage(*archive, file_id, pixels, dims);
+        Resources::EnqueueDxTask([file_id, decoded, pixels = std::move(pixels), dims](IDirect3DDevice9* device) {
+            const auto found = textures_by_file_id.find(file_id);
+            if (found == textures_by_file_id.end()) {
+                return; // Terminated in the meantime
+            }
+            const auto gwimg = found->second;
+            if (decoded) {
+                gwimg->m_dims = dims;
+                gwimg->m_tex = CreateTextureFromImage(device, file_id, pixels, dims);
+            }
+            else {
+                gwimg->m_tex = CreateTexture(device, file_id, gwimg->m_dims);
+            }
         });
+    });
     return &gwimg_ptr->m_tex;
 }
 void GwDatTextureModule::Terminate()
@@ -260,6 +490,14 @@ void GwDatTextureModule::Terminate()
         delete gwimg_ptr.second;
     }
     textures_by_file_id.clear();
+    {
+        std::lock_guard lock(dat_archive_mutex);
+        dat_archive.reset();
+    }
+    std::lock_guard lock(decoded_cache_write_mutex);
+    decoded_cache_index.clear();
+    decoded_cache_view.Close();
+    decoded_cache_path.clear();
 }
 uint32_t GwDatTextureModule::FileHashToFileId(const wchar_t* fileHash) {
     if (!fileHash)
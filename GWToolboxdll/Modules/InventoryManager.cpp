@@ -28,6 +28,7 @@
 #include <Timer.h>
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/SignatureCache.h>
 #include <Modules/InventoryManager.h>
 #include <Modules/GameSettings.h>
 #include <Windows/MaterialsWindow.h>
@@ -859,7 +860,7 @@ void InventoryManager::Initialize()
 
     inventory_bags_window_position = GetWindowPosition(GW::UI::WindowID::WindowID_InventoryBags);
 
-    AddItemRowToWindow_Func = reinterpret_cast<AddItemRowToWindow_pt>(GW::Scanner::Find(
+    AddItemRowToWindow_Func = reinterpret_cast<AddItemRowToWindow_pt>(SignatureCache::Find(
         "\x83\xc4\x04\x80\x78\x04\x06\x0f\x84\xd3\x00\x00\x00\x6a\x02\xff\x37", nullptr, -0x10));
     if (AddItemRowToWindow_Func) {
         GW::Hook::CreateHook(AddItemRowToWindow_Func, OnAddItemToWindow, reinterpret_cast<void**>(&RetAddItemRowToWindow));
@@ -2524,7 +2525,8 @@ void InventoryManager::PendingItem::PluralEncString::sanitise()
     }
     EncString::sanitise();
     if (sanitised) {
-        static const std::wregex plural(L"256 ");
-        decoded_ws = std::regex_replace(decoded_ws, plural, L"");
+        for (size_t pos = decoded_ws.find(L"256 "); pos != std::wstring::npos; pos = decoded_ws.find(L"256 ", pos)) {
+            decoded_ws.erase(pos, 4);
+        }
     }
 }
@@ -2,6 +2,8 @@
 
 #include <GWCA/Utilities/Scanner.h>
 
+#include <Utils/SignatureCache.h>
+
 #include "KeyboardLanguageFix.h"
 
 /*
@@ -15,7 +17,7 @@ void KeyboardLanguageFix::Initialize()
 
     const auto en_us_keyboard_name = "00000409";
 
-    HKL* address = *(HKL**)GW::Scanner::Find("\x81\xe6\xff\xff\xff\x7f\x85\xc0", "xxxxxxxx", -0x4);
+    HKL* address = *(HKL**)SignatureCache::Find("\x81\xe6\xff\xff\xff\x7f\x85\xc0", "xxxxxxxx", -0x4);
     if (!address) {
         Log::Error("Failed to find keyboard layout address");
         return;
@@ -9,6 +9,8 @@
 #include <GWCA/Managers/UIMgr.h>
 #include <GWCA/Managers/MemoryMgr.h>
 
+#include <Utils/SignatureCache.h>
+
 #include <Timer.h>
 
 #include "LoginModule.h"
@@ -102,7 +104,7 @@ void LoginModule::Initialize()
 
     state = LoginState::Idle;
 
-    PortalAccountLogin_Func = (PortalAccountLogin_pt)GW::Scanner::Find("\xc7\x45\xe8\x38\x00\x00\x00\x89\x4d\xf0", "xxxxxxxxxx", -0x2b);
+    PortalAccountLogin_Func = (PortalAccountLogin_pt)SignatureCache::Find("\xc7\x45\xe8\x38\x00\x00\x00\x89\x4d\xf0", "xxxxxxxxxx", -0x2b);
     if (!PortalAccountLogin_Func) {
         return InitialiationFailure("Failed to initialize PortalAccountLogin_Func");
     }
@@ -7,6 +7,8 @@
 #include <GWCA/Managers/GameThreadMgr.h>
 #include <GWCA/Managers/MemoryMgr.h>
 
+#include <Utils/SignatureCache.h>
+
 #include <Defines.h>
 #include <ImGuiAddons.h>
 #include "MouseFix.h"
@@ -385,7 +387,7 @@ void MouseFix::Initialize()
 {
     ToolboxModule::Initialize();
 
-    const uintptr_t address = GW::Scanner::Find("\x8b\x41\x08\x89\x82\x50\x0c\x00\x00", "xxxxxxxxx", 0x9);
+    const uintptr_t address = SignatureCache::Find("\x8b\x41\x08\x89\x82\x50\x0c\x00\x00", "xxxxxxxxx", 0x9);
     ChangeCursorIcon_Func = (ChangeCursorIcon_pt)GW::Scanner::FunctionFromNearCall(address);
     if (ChangeCursorIcon_Func) {
         GW::HookBase::CreateHook(ChangeCursorIcon_Func, OnChangeCursorIcon, (void**)&ChangeCursorIcon_Ret);
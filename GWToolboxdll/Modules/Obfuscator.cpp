@@ -22,6 +22,7 @@
 #include <Modules/ChatSettings.h>
 #include <Modules/Obfuscator.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/StringReplacer.h>
 #include <Windows/FriendListWindow.h>
 
 #include <Defines.h>
@@ -266,6 +267,9 @@ namespace {
     std::map<std::wstring, std::wstring> obfuscated_by_obfuscation;
     // List of obfuscated names, keyed by original
     std::map<std::wstring, std::wstring> obfuscated_by_original;
+    // Same names, compiled for rewriting whole messages in one pass
+    StringReplacer message_obfuscator;
+    StringReplacer message_unobfuscator;
     // Current position in the list of obfuscated names
     size_t pool_index = 0;
 
@@ -358,6 +362,8 @@ namespace {
         if (!obfuscated_by_original.contains(original_name)) {
             obfuscated_by_obfuscation.emplace(tmp_out, original_name);
             obfuscated_by_original.emplace(original_name, tmp_out);
+            message_obfuscator.Add(original_name, tmp_out);
+            message_unobfuscator.Add(tmp_out, original_name);
             out.assign(tmp_out);
             return true;
         }
@@ -382,22 +388,8 @@ namespace {
     {
         if (!wcschr(message.data(),0x107))
             return false; // Message contains no player names
-        std::wstring replacemsg{message};
-        const auto& to_search = obfuscate ? obfuscated_by_original : obfuscated_by_obfuscation;
-        bool was_changed = false;
-        for (const auto& [from, to] : to_search) {
-            if (from.empty()) {
-                break;
-            }
-            size_t start_pos = 0;
-            while ((start_pos = replacemsg.find(from, start_pos)) != std::string::npos) {
-                replacemsg.replace(start_pos, from.length(), to);
-                start_pos += to.length(); // In case 'to' contains 'from', like replacing 'x' with 'yx'
-                was_changed = true;
-            }
-        }
-        out.assign(replacemsg);
-        return !out.empty() && was_changed;
+        auto& replacer = obfuscate ? message_obfuscator : message_unobfuscator;
+        return replacer.Replace(message, out) && !out.empty();
     }
 
     bool UnobfuscateMessage(const wchar_t* message, std::wstring& out)
@@ -550,6 +542,8 @@ namespace {
         pool_index = 0;
         obfuscated_by_obfuscation.clear();
         obfuscated_by_original.clear();
+        message_obfuscator.Clear();
+        message_unobfuscator.Clear();
         // Don't use clear() on this; the game uses the pointer so we don't want to mess with it
         account_info_obfuscated_name[0] = '\0';
         // Don't use clear() on this; the game uses the pointer so we don't want to mess with it
@@ -93,6 +93,56 @@ struct JumboMessage : GW::Packet::StoC::Packet<JumboMessage> {
 const uint32_t GW::Packet::StoC::Packet<JumboMessage>::STATIC_HEADER = 0x18F; // 399
 
 
+namespace {
+    // What ObserverStats keeps of an agent when it's first seen
+    ObserverStats::AgentInfo AgentInfoOf(const GW::AgentLiving& agent_living)
+    {
+        ObserverStats::AgentInfo info;
+        info.agent_id = agent_living.agent_id;
+        info.login_number = agent_living.login_number;
+        info.guild_id = static_cast<uint32_t>(agent_living.tags->guild_id);
+        info.team_id = agent_living.team_id;
+        info.primary = agent_living.primary;
+        info.secondary = agent_living.secondary;
+        info.is_player = agent_living.IsPlayer();
+        info.is_npc = agent_living.IsNPC();
+        return info;
+    }
+
+    // What ObserverStats keeps of a guild
+    ObserverStats::Guild GuildOf(const GW::Guild& guild)
+    {
+        ObserverStats::Guild info;
+        info.guild_id = guild.index;
+        std::ranges::copy(guild.key.k, info.key.begin());
+        info.name = GuiUtils::WStringToString(guild.name);
+        info.tag = GuiUtils::WStringToString(guild.tag);
+        info.wrapped_tag = "[" + info.tag + "]";
+        info.rank = guild.rank;
+        info.rating = guild.rating;
+        info.faction = guild.faction;
+        info.faction_point = guild.faction_point;
+        info.qualifier_point = guild.qualifier_point;
+        info.cape_trim = guild.cape_trim;
+        return info;
+    }
+
+    // What ObserverStats keeps of a map
+    ObserverStats::MapInfo MapInfoOf(const GW::AreaInfo& area_info)
+    {
+        ObserverStats::MapInfo info;
+        info.campaign = static_cast<uint32_t>(area_info.campaign);
+        info.continent = static_cast<uint32_t>(area_info.continent);
+        info.region = static_cast<uint32_t>(area_info.region);
+        info.type = static_cast<uint32_t>(area_info.type);
+        info.flags = area_info.flags;
+        info.name_id = area_info.name_id;
+        info.description_id = area_info.description_id;
+        return info;
+    }
+}
+
+
 // Destructor
 ObserverModule::~ObserverModule()
 {
@@ -131,7 +181,10 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
-            HandleAgentState(packet->agent_id, packet->state);
+            // only deaths change the stats
+            if (packet->state == ObserverStats::agent_state_dead) {
+                ApplyEvent(ObserverStats::EventType::AgentState, packet->agent_id, NO_AGENT, packet->state);
+            }
         });
 
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentAdd>(
@@ -155,7 +208,8 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
-            HandleAgentProjectileLaunched(packet);
+            // can be used to determine when a ranged attack has finished
+            ApplyEvent(ObserverStats::EventType::ProjectileLaunched, packet->agent_id);
         });
 
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(
@@ -275,11 +329,11 @@ void ObserverModule::HandleJumboMessage(const uint8_t type, const uint32_t value
 {
     switch (type) {
         case JumboMessageType::MORALE_BOOST:
-            HandleMoraleBoost(GetObservablePartyById(JumboMessageValueToPartyId(value)));
+            ApplyEvent(ObserverStats::EventType::MoraleBoost, JumboMessageValueToPartyId(value));
             break;
         case JumboMessageType::VICTORY:
         case JumboMessageType::FLAWLESS_VICTORY:
-            HandleVictory(GetObservablePartyById(JumboMessageValueToPartyId(value)));
+            ApplyEvent(ObserverStats::EventType::Victory, JumboMessageValueToPartyId(value));
             break;
     }
 }
@@ -291,19 +345,19 @@ void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t
 {
     switch (value_id) {
         case GW::Packet::StoC::GenericValueID::damage:
-            HandleDamageDone(caster_id, target_id, value, false);
+            ApplyEvent(ObserverStats::EventType::DamageDone, caster_id, target_id, false, value);
             break;
 
         case GW::Packet::StoC::GenericValueID::critical:
-            HandleDamageDone(caster_id, target_id, value, true);
+            ApplyEvent(ObserverStats::EventType::DamageDone, caster_id, target_id, true, value);
             break;
 
         case GW::Packet::StoC::GenericValueID::armorignoring:
-            HandleDamageDone(caster_id, target_id, value, false);
+            ApplyEvent(ObserverStats::EventType::DamageDone, caster_id, target_id, false, value);
             break;
 
         case GW::Packet::StoC::GenericValueID::knocked_down:
-            HandleKnockedDown(caster_id, value);
+            ApplyEvent(ObserverStats::EventType::KnockedDown, caster_id, NO_AGENT, 0, value);
             break;
     }
 }
@@ -314,11 +368,11 @@ void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t
 {
     switch (value_id) {
         case GW::Packet::StoC::GenericValueID::melee_attack_finished:
-            HandleAttackFinished(caster_id);
+            ApplyEvent(ObserverStats::EventType::AttackFinished, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::attack_stopped:
-            HandleAttackStopped(caster_id);
+            ApplyEvent(ObserverStats::EventType::AttackStopped, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::attack_started: {
@@ -337,24 +391,24 @@ void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t
                 _target_id = caster_id;
             }
             // handle
-            HandleAttackStarted(_caster_id, _target_id);
+            ApplyEvent(ObserverStats::EventType::AttackStarted, _caster_id, _target_id);
             break;
         }
 
         case GW::Packet::StoC::GenericValueID::interrupted:
-            HandleInterrupted(caster_id);
+            ApplyEvent(ObserverStats::EventType::Interrupted, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::attack_skill_finished:
-            HandleAttackSkillFinished(caster_id);
+            ApplyEvent(ObserverStats::EventType::AttackSkillFinished, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::instant_skill_activated:
-            HandleInstantSkillActivated(caster_id, target_id, static_cast<GW::Constants::SkillID>(value));
+            ApplyEvent(ObserverStats::EventType::InstantSkillActivated, caster_id, target_id, value);
             break;
 
         case GW::Packet::StoC::GenericValueID::attack_skill_stopped:
-            HandleAttackSkillStopped(caster_id);
+            ApplyEvent(ObserverStats::EventType::AttackSkillStopped, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::attack_skill_activated: {
@@ -373,16 +427,16 @@ void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t
                 _target_id = caster_id;
             }
             // handle
-            HandleAttackSkillStarted(_caster_id, _target_id, static_cast<GW::Constants::SkillID>(value));
+            ApplyEvent(ObserverStats::EventType::AttackSkillStarted, _caster_id, _target_id, value);
             break;
         }
 
         case GW::Packet::StoC::GenericValueID::skill_finished:
-            HandleSkillFinished(caster_id);
+            ApplyEvent(ObserverStats::EventType::SkillFinished, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::skill_stopped:
-            HandleSkillStopped(caster_id);
+            ApplyEvent(ObserverStats::EventType::SkillStopped, caster_id);
             break;
 
         case GW::Packet::StoC::GenericValueID::skill_activated: {
@@ -407,116 +461,24 @@ void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t
                 _caster_id = target_id;
                 _target_id = caster_id;
             }
-            HandleSkillActivated(_caster_id, _target_id, static_cast<GW::Constants::SkillID>(value));
+            ApplyEvent(ObserverStats::EventType::SkillActivated, _caster_id, _target_id, value);
             break;
         }
     }
 }
 
 
-// Handle AgentState Packet
-// Fired when the server notifies us of an agent state change
-// Can tell us if the agent has just died
-void ObserverModule::HandleAgentState(const uint32_t agent_id, const uint32_t state)
-{
-    // 16 = dead
-    if (state != 16) {
-        return;
-    }
-
-    // don't credit kills/deaths on parties that are already defeated
-    // after a party is defeated all their players die, but we don't
-    // count those deaths / kills
-    if (match_finished) {
-        return;
-    }
-
-    ObservableAgent* observable_agent = GetObservableAgentById(agent_id);
-    if (!observable_agent) {
-        return;
-    }
-
-    ObservableParty* party = GetObservablePartyById(observable_agent->party_id);
-    if (party && party->is_defeated) {
-        return;
-    }
-
-    // notify the player
-    observable_agent->stats.HandleDeath();
-
-    // only grant a kill if the victim belonged to a party
-    // (don't count footmen/archer/bodyguard/lord/ghostly kills)
-    if (!party) {
-        return;
-    }
-    party->stats.HandleDeath();
-
-    // credit the kill to the last-hitter and their party,
-    ObservableAgent* killer = GetObservableAgentById(observable_agent->last_hit_by);
-    if (!killer) {
-        return;
-    }
-    killer->stats.HandleKill();
-    ObservableParty* killer_party = GetObservablePartyById(killer->party_id);
-    if (killer_party) {
-        killer_party->stats.HandleKill();
-    }
-}
-
-
-// Handle DamageDone (GenericModifier float Packet)
-void ObserverModule::HandleDamageDone(const uint32_t caster_id, const uint32_t target_id, const float amount_pc, const bool is_crit)
+// Reduce an event at the current instance time into the match
+void ObserverModule::ApplyEvent(const ObserverStats::EventType type, const uint32_t caster_id, const uint32_t target_id, const uint32_t value, const float amount)
 {
-    ObservableAgent* caster = GetObservableAgentById(caster_id);
-    ObservableAgent* target = GetObservableAgentById(target_id);
-
-    // get last hit to credit the kill
-    if (target && caster && caster->party_id != NO_PARTY && amount_pc < 0) {
-        target->last_hit_by = caster->agent_id;
-    }
-
-    if (is_crit) {
-        ObservableParty* caster_party = nullptr;
-        ObservableParty* target_party = nullptr;
-        if (caster) {
-            caster_party = GetObservablePartyById(caster->party_id);
-        }
-        if (target) {
-            target_party = GetObservablePartyById(target->party_id);
-        }
-
-        // notify the caster
-        if (caster) {
-            caster->stats.total_crits_dealt += 1;
-            if (target_party) {
-                caster->stats.total_party_crits_dealt += 1;
-            }
-        }
-
-        // notify the caster_party
-        if (caster_party) {
-            caster_party->stats.total_crits_dealt += 1;
-            if (target_party) {
-                caster_party->stats.total_party_crits_dealt += 1;
-            }
-        }
-
-        // notify the target
-        if (target) {
-            target->stats.total_crits_received += 1;
-            if (caster_party) {
-                target->stats.total_party_crits_received += 1;
-            }
-        }
-
-        // notify the target_party
-        if (target_party) {
-            target_party->stats.total_crits_received += 1;
-            if (caster_party) {
-                target_party->stats.total_party_crits_received += 1;
-            }
-        }
-    }
+    ObserverStats::Event event;
+    event.type = type;
+    event.time = GW::Map::GetInstanceTime();
+    event.caster_id = caster_id;
+    event.target_id = target_id;
+    event.value = value;
+    event.amount = amount;
+    Apply(event);
 }
 
 
@@ -529,131 +491,6 @@ void ObserverModule::HandleAgentAdd(const uint32_t)
 }
 
 
-// Handle AgentProjectileLaunched Packet
-// can be used to determine when a ranged attack has finished
-void ObserverModule::HandleAgentProjectileLaunched(const GW::Packet::StoC::AgentProjectileLaunched* packet)
-{
-    if (!packet) {
-        return;
-    }
-    ObservableAgent* agent = GetObservableAgentById(packet->agent_id);
-    // ensure the projectile was from an attack we're currently undertaking
-    if (!agent || !agent->current_target_action || !agent->current_target_action->is_attack) {
-        return;
-    }
-    ReduceAction(agent, ActionStage::Finished);
-}
-
-
-// Handle AttackFinished Packet
-void ObserverModule::HandleAttackFinished(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Finished);
-}
-
-// Handle AttackStopped Packet
-void ObserverModule::HandleAttackStopped(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Stopped);
-}
-
-
-// Handle AttackStarted Packet
-void ObserverModule::HandleAttackStarted(const uint32_t caster_id, const uint32_t target_id)
-{
-    const auto action = new TargetAction(caster_id, target_id, true, false, NO_SKILL);
-    if (!ReduceAction(GetObservableAgentById(caster_id), ActionStage::Started, action)) {
-        delete action;
-    }
-}
-
-
-// Handle Interrupted Packet
-void ObserverModule::HandleInterrupted(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Interrupted);
-}
-
-// Handle Attack SkillFinished Packet
-void ObserverModule::HandleAttackSkillFinished(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Finished);
-}
-
-
-// Handle Attack SkillStopped Packet
-void ObserverModule::HandleAttackSkillStopped(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Stopped);
-}
-
-
-// Handle InstantSkillActivated Packet
-void ObserverModule::HandleInstantSkillActivated(const uint32_t caster_id, const uint32_t target_id, const GW::Constants::SkillID skill_id)
-{
-    // assuming there are no instant attack skills...
-    const auto action = new TargetAction(caster_id, target_id, false, true, skill_id);
-    if (!ReduceAction(GetObservableAgentById(caster_id), ActionStage::Instant, action)) {
-        delete action;
-    }
-}
-
-
-// Handle AttackSkillActivated Packet
-void ObserverModule::HandleAttackSkillStarted(const uint32_t caster_id, const uint32_t target_id, const GW::Constants::SkillID skill_id)
-{
-    const auto action = new TargetAction(caster_id, target_id, true, true, skill_id);
-    if (!ReduceAction(GetObservableAgentById(caster_id), ActionStage::Started, action)) {
-        delete action;
-    }
-}
-
-
-// Handle AttackSkillFinished Packet
-void ObserverModule::HandleSkillFinished(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Finished);
-}
-
-
-// Handle SkillFinished Packet
-void ObserverModule::HandleSkillStopped(const uint32_t agent_id)
-{
-    ReduceAction(GetObservableAgentById(agent_id), ActionStage::Stopped);
-}
-
-
-// Handle SkillActivated Packet
-void ObserverModule::HandleSkillActivated(const uint32_t caster_id, const uint32_t target_id, const GW::Constants::SkillID skill_id)
-{
-    const auto action = new TargetAction(caster_id, target_id, false, true, skill_id);
-    if (!ReduceAction(GetObservableAgentById(caster_id), ActionStage::Started, action)) {
-        delete action;
-    }
-}
-
-
-// Handle KnockedDown Packet
-void ObserverModule::HandleKnockedDown(const uint32_t agent_id, const float duration)
-{
-    // notify the agent
-    ObservableAgent* agent = GetObservableAgentById(agent_id);
-    if (!agent) {
-        return;
-    }
-    agent->stats.knocked_down_count += 1;
-    agent->stats.knocked_down_duration += duration;
-
-    // notify the agents party
-    ObservableParty* party = GetObservablePartyById(agent->party_id);
-    if (!party) {
-        return;
-    }
-    party->stats.knocked_down_count += 1;
-    party->stats.knocked_down_duration += 1;
-}
-
-
 // Convert a JumboMessage value to a party_id
 uint32_t ObserverModule::JumboMessageValueToPartyId(const uint32_t value)
 {
@@ -669,472 +506,27 @@ uint32_t ObserverModule::JumboMessageValueToPartyId(const uint32_t value)
 }
 
 
-// Fired when a party receives a morale boost
-void ObserverModule::HandleMoraleBoost(ObservableParty* boosting_party)
-{
-    if (!boosting_party) {
-        return;
-    }
-    boosting_party->morale_boosts += 1;
-}
-
-
-// Fired when a party is victorious
-void ObserverModule::HandleVictory(ObservableParty* winning_party)
-{
-    if (!winning_party) {
-        return;
-    }
-
-    // TODO: handle draws
-    // There is no JumboMessage for a draw so we don't get notified of it...
-
-    // Draws mess up:
-    //  - the kills/deaths since everyone dies at the end and we don't know that
-    //    the match is over... so we have to count all those as kills/deaths
-    //  - we can't set match_finished = true
-    //  - we can't get the match duration
-
-    // match has concluded
-    // save winner and match duration
-    match_finished = true;
-
-    // notify the winning party
-    winning_party_id = winning_party->party_id;
-    winning_party->is_defeated = false;
-    winning_party->is_victorious = true;
-
-    // note the final game duration
-    // don't count the first minute before the gates open...
-    const uint32_t ms = GW::Map::GetInstanceTime() - 1000 * 60;
-    match_duration_ms_total = std::chrono::milliseconds(ms);
-    match_duration_ms = std::chrono::milliseconds(ms);
-    match_duration_secs = std::chrono::duration_cast<std::chrono::seconds>(match_duration_ms);
-    match_duration_ms -= std::chrono::duration_cast<std::chrono::milliseconds>(match_duration_secs);
-    match_duration_mins = std::chrono::duration_cast<std::chrono::minutes>(match_duration_secs);
-    match_duration_secs -= std::chrono::duration_cast<std::chrono::seconds>(match_duration_mins);
-
-    // notify other parties that they lost
-    for (auto& [_, losing_party] : observable_parties) {
-        if (losing_party && losing_party->party_id != winning_party->party_id) {
-            losing_party->is_defeated = true;
-            losing_party->is_victorious = false;
-        }
-    }
-}
-
-
-bool ObserverModule::ReduceAction(ObservableAgent* caster, const ActionStage stage, TargetAction* new_action)
-{
-    // if the action ends up owned by the caster, the observermodule is responsible for garbage collecting the action
-    // if the action ends up NOT owned by the caster, the caller is responsible for garbage collecting the action
-    bool action_ownership_transferred = false;
-
-    if (!caster) {
-        return action_ownership_transferred;
-    }
-
-    TargetAction* action;
-
-    // If starting a new action, delete the last stored action & store this new action
-    if (new_action) {
-        ASSERT(stage == ActionStage::Started || stage == ActionStage::Instant);
-        // starting a new action
-
-        // "instant" actions do not persist (don't received a "finished" packet) so we don't store them on the agent
-        // and they may be activateable while using other skills (e.g. shouts/stances) so we don't clear the current action
-        if (stage != ActionStage::Instant) {
-            // delete the previous blocking action
-
-            delete caster->current_target_action;
-
-            // store the new blocking action
-            caster->current_target_action = new_action;
-            action_ownership_transferred = true;
-        }
-        action = new_action;
-    }
-    else {
-        ASSERT(!(stage == ActionStage::Started || stage == ActionStage::Instant));
-        // we are finishing the previous action
-        // we have to keep the current_target_action on the caster in-case we receive an "interrupted" packet next
-        // after a "stopped" package
-        action = caster->current_target_action;
-    }
-
-    if (!action) {
-        return action_ownership_transferred;
-    }
-
-    // if the action was already "finished" in a previous ReduceAction call, there's nothing else to do
-    // this is important for skills like Dual Shot, Barrage, etc, where one skill leads to
-    // multiple "AttackFinished" packets (via the "AgentProjectileLaunched" packet)
-    if (action->was_finished) {
-        return action_ownership_transferred;
-    }
-
-    if (stage == ActionStage::Stopped) {
-        action->was_stopped = true;
-    }
-    if (stage == ActionStage::Finished) {
-        action->was_finished = true;
-    }
-
-    ObservableAgent* target = GetObservableAgentById(action->target_id);
-
-    ObservableParty* caster_party = GetObservablePartyById(caster->party_id);
-    ObservableParty* target_party = nullptr;
-    if (target) {
-        target_party = GetObservablePartyById(target->party_id);
-    }
-
-    // notify caster & caster_party of interrupt
-    //
-    // interrupt packet comes after cancelled packet most of the time.
-    //
-    // Can received a "cancelled" packet after a "finished" packet for attack skills where the target
-    // dies during the afterswing of a "finished" attack
-    // we don't count that as "stopped/cancelled"
-    if (stage == ActionStage::Interrupted) {
-        if (caster) {
-            if (action->was_stopped) {
-                caster->stats.cancelled_count -= 1;
-            }
-            caster->stats.interrupted_count += 1;
-        }
-        if (caster_party) {
-            if (action->was_stopped) {
-                caster_party->stats.cancelled_count -= 1;
-            }
-            caster_party->stats.interrupted_count += 1;
-        }
-        if (action->is_skill) {
-            if (caster) {
-                if (action->was_stopped) {
-                    caster->stats.cancelled_skills_count -= 1;
-                }
-                caster->stats.interrupted_skills_count += 1;
-            }
-            if (caster_party) {
-                if (action->was_stopped) {
-                    caster_party->stats.cancelled_skills_count -= 1;
-                }
-                caster_party->stats.interrupted_skills_count += 1;
-            }
-        }
-    }
-
-    // notify & caster_party caster of cancel
-    if (stage == ActionStage::Stopped) {
-        if (caster) {
-            caster->stats.cancelled_count += 1;
-        }
-        if (caster_party) {
-            caster_party->stats.cancelled_count += 1;
-        }
-        if (action->is_skill) {
-            if (caster) {
-                caster->stats.cancelled_skills_count += 1;
-            }
-            if (caster_party) {
-                caster_party->stats.cancelled_skills_count += 1;
-            }
-        }
-    }
-
-    // handle attack
-    if (action->is_attack) {
-        // update the caster
-        if (caster) {
-            caster->stats.total_attacks_dealt.Reduce(action, stage);
-            if (target) {
-                caster->stats.LazyGetAttacksDealedAgainst(target->agent_id).Reduce(action, stage);
-            }
-            // if the target belonged to a party, the caster just attacked that other party
-            if (target_party) {
-                caster->stats.total_attacks_dealt_to_other_parties.Reduce(action, stage);
-            }
-        }
-
-        // update the casters party
-        if (caster_party) {
-            caster_party->stats.total_attacks_dealt.Reduce(action, stage);
-            // if the target belonged to a party, the casters party just attacked that other party
-            if (target_party) {
-                caster_party->stats.total_attacks_dealt_to_other_parties.Reduce(action, stage);
-            }
-        }
-
-        // update the target
-        if (target) {
-            target->stats.total_attacks_received.Reduce(action, stage);
-            if (caster) {
-                target->stats.LazyGetAttacksReceivedFrom(caster->agent_id).Reduce(action, stage);
-            }
-            // if the caster belonged to a party, the target was just attacked by that other party
-            if (caster_party) {
-                target->stats.total_attacks_received_from_other_parties.Reduce(action, stage);
-            }
-        }
-
-        // update the targets party
-        if (target_party) {
-            target_party->stats.total_attacks_received.Reduce(action, stage);
-            // if the caster belonged to a party, the target_party was just attacked by that other party
-            if (caster_party) {
-                target_party->stats.total_attacks_received_from_other_parties.Reduce(action, stage);
-            }
-        }
-    }
-
-    // handle skill
-    if (action->is_skill) {
-        // update skill
-        ObservableSkill* skill = GetObservableSkillById(action->skill_id);
-        ASSERT(skill != nullptr);
-
-        // Modify the effective `target` and `target_party`, based on the
-        // targetting type of the skill to make stats more intuitive.
-
-        // For example if using Heal Burst on yourself, the packet only
-        // includes a caster and no target.
-        // here we effectively set the
-        // target to the caster.
-        const uint32_t target_type = skill->gw_skill.target;
-        switch (target_type) {
-            case static_cast<uint32_t>(TargetType::no_target): {
-                // don't provide a target
-                // e.g. flash enchantments, stances, whirlwind
-                break;
-            }
-            case static_cast<uint32_t>(TargetType::anyone): {
-                // Ensure we interpret the target correctly
-                // e.g. Mirror of Ice, Stone Sheath
-                if (action->target_id == NO_AGENT) {
-                    target = caster;
-                    target_party = caster_party;
-                }
-                break;
-            }
-            case static_cast<uint32_t>(TargetType::ally): {
-                // Ensure we interpret the target correctly
-                // e.g. Healing Burst
-                if (action->target_id == NO_AGENT) {
-                    target = caster;
-                    target_party = caster_party;
-                }
-                break;
-            }
-            case static_cast<uint32_t>(TargetType::other_ally): {
-                // should always have a target
-                break;
-            }
-            case static_cast<uint32_t>(TargetType::enemy): {
-                // should always have a target
-                break;
-            }
-        }
-        const bool same_team = caster && target && caster->team_id != NO_TEAM && caster->team_id == target->team_id;
-        const bool same_party = target_party && caster_party && target_party->party_id == caster_party->party_id;
-
-        // notify the skill
-        skill->stats.total_usages.Reduce(action, stage);
-        if (target) {
-            // target usages
-            if (caster == target) {
-                skill->stats.total_self_usages.Reduce(action, stage);
-            }
-            else {
-                skill->stats.total_other_usages.Reduce(action, stage);
-            }
-
-            // team usages
-            if (same_team) {
-                skill->stats.total_own_team_usages.Reduce(action, stage);
-            }
-            else {
-                skill->stats.total_other_team_usages.Reduce(action, stage);
-            }
-        }
-        if (target_party) {
-            // party usages
-            if (caster_party == target_party) {
-                skill->stats.total_own_party_usages.Reduce(action, stage);
-            }
-            else {
-                skill->stats.total_other_party_usages.Reduce(action, stage);
-            }
-        }
-
-        // notify the caster
-        if (caster) {
-            caster->stats.total_skills_used.Reduce(action, stage);
-            caster->stats.LazyGetSkillUsed(action->skill_id).Reduce(action, stage);
-
-            // used against a target?
-            if (target) {
-                // use against agent
-                caster->stats.LazyGetSkillUsedOn(target->agent_id, action->skill_id).Reduce(action, stage);
-
-                // team:
-                // same team
-                if (same_team) {
-                    caster->stats.total_skills_used_on_own_team.Reduce(action, stage);
-                }
-                // diff team
-                else {
-                    caster->stats.total_skills_used_on_other_teams.Reduce(action, stage);
-                }
-            }
-
-            // party:
-            if (target_party) {
-                // same party
-                if (same_party) {
-                    caster->stats.total_skills_used_on_own_party.Reduce(action, stage);
-                }
-                // diff party
-                else {
-                    caster->stats.total_skills_used_on_other_parties.Reduce(action, stage);
-                }
-            }
-        }
-
-        // notify the caster_party
-        if (caster_party) {
-            caster_party->stats.total_skills_used.Reduce(action, stage);
-
-            // team
-            // same team
-            if (same_team) {
-                caster_party->stats.total_skills_used_on_own_team.Reduce(action, stage);
-            }
-            // diff team
-            else {
-                caster_party->stats.total_skills_used_on_other_teams.Reduce(action, stage);
-            }
-
-            // party:
-            if (target_party) {
-                // same party
-                if (same_party) {
-                    caster_party->stats.total_skills_used_on_own_party.Reduce(action, stage);
-                }
-                // diff party
-                else {
-                    caster_party->stats.total_skills_used_on_other_parties.Reduce(action, stage);
-                }
-            }
-        }
-
-        // notify the target
-        if (target) {
-            target->stats.total_skills_received.Reduce(action, stage);
-            target->stats.LazyGetSkillReceived(action->skill_id).Reduce(action, stage);
-            // used from a living caster? (redundant)
-            if (caster) {
-                // use against agent
-                target->stats.LazyGetSkillReceivedFrom(caster->agent_id, action->skill_id).Reduce(action, stage);
-
-                // team
-                // same team
-                if (same_team) {
-                    target->stats.total_skills_received_from_own_team.Reduce(action, stage);
-                }
-                // diff team
-                else {
-                    target->stats.total_skills_received_from_other_teams.Reduce(action, stage);
-                }
-            }
-
-            // party:
-            if (caster_party) {
-                // same party
-                if (same_party) {
-                    target->stats.total_skills_received_from_own_party.Reduce(action, stage);
-                }
-                // diff party
-                else {
-                    target->stats.total_skills_received_from_other_parties.Reduce(action, stage);
-                }
-            }
-        }
-
-        // notify the target_party
-        if (target_party) {
-            target_party->stats.total_skills_received.Reduce(action, stage);
-
-            // team:
-            // same team
-            if (same_team) {
-                target_party->stats.total_skills_received_from_own_team.Reduce(action, stage);
-            }
-            // diff team
-            else {
-                target_party->stats.total_skills_received_from_other_teams.Reduce(action, stage);
-            }
-
-            // party:
-            if (caster_party) {
-                // same party
-                if (same_party) {
-                    target_party->stats.total_skills_received_from_own_party.Reduce(action, stage);
-                }
-                // diff party
-                else {
-                    target_party->stats.total_skills_received_from_other_parties.Reduce(action, stage);
-                }
-            }
-        }
-    }
-
-    return action_ownership_transferred;
-}
-
-
 // Module: Reset the Modules state
+// Observables are destroyed in place and the stat tables are emptied; their memory is kept for the next match
 void ObserverModule::Reset()
 {
+    // names are looked up asynchronously, so they go in last
+    JournalNames();
+    SetJournal(nullptr);
+    journal.Close();
+
     if (map) {
         delete map;
         map = nullptr;
     }
 
-    // clear guild info
-    observable_guild_ids.clear();
-    for (const auto& [_, guild] : observable_guilds) {
-        if (guild) {
-            delete guild;
-        }
-    }
-    observable_guilds.clear();
+    observable_guilds.Clear();
+    observable_skills.Clear();
+    observable_agents.Clear();
+    observable_parties.Clear();
 
-    // clear skill info
-    observable_skill_ids.clear();
-    for (const auto& [_, skill] : observable_skills) {
-        if (skill) {
-            delete skill;
-        }
-    }
-    observable_skills.clear();
-
-    // clear agent info
-    observable_agent_ids.clear();
-    for (const auto& [_, agent] : observable_agents) {
-        if (agent) {
-            delete agent;
-        }
-    }
-    observable_agents.clear();
-
-    // clear party info
-    observable_party_ids.clear();
-    for (const auto& [_, party] : observable_parties) {
-        if (party) {
-            delete party;
-        }
-    }
-    observable_parties.clear();
+    // clear ids and stats
+    Clear();
 }
 
 
@@ -1151,6 +543,21 @@ bool ObserverModule::InitializeObserverSession()
         return false;
     }
 
+    // start the journal before anything is loaded, so it has everything
+    if (journal_matches && !journal.IsOpen()) {
+        const std::filesystem::path folder = Resources::GetPath(L"observer\\journals");
+        if (Resources::EnsureFolderExists(folder)) {
+            SYSTEMTIME time;
+            GetLocalTime(&time);
+            wchar_t filename[64];
+            swprintf(filename, _countof(filename), L"%04d-%02d-%02dT%02d-%02d-%02d.gwobs",
+                     time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+            if (journal.Open(folder / filename)) {
+                SetJournal(&journal);
+            }
+        }
+    }
+
     // load parties
     if (!SynchroniseParties()) {
         return false;
@@ -1175,13 +582,7 @@ bool ObserverModule::InitializeObserverSession()
 
     delete map;
     map = new ObservableMap(*map_info);
-
-    match_finished = false;
-    winning_party_id = NO_PARTY;
-    match_duration_ms_total = std::chrono::milliseconds(0);
-    match_duration_ms = std::chrono::milliseconds(0);
-    match_duration_secs = std::chrono::seconds(0);
-    match_duration_mins = std::chrono::minutes(0);
+    BeginMatch(*map);
 
     observer_session_initialized = true;
     return true;
@@ -1227,6 +628,7 @@ void ObserverModule::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(is_enabled);
     LOAD_BOOL(trim_hench_names);
     LOAD_BOOL(enable_in_explorable_areas);
+    LOAD_BOOL(journal_matches);
 }
 
 
@@ -1237,6 +639,7 @@ void ObserverModule::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(is_enabled);
     SAVE_BOOL(trim_hench_names);
     SAVE_BOOL(enable_in_explorable_areas);
+    SAVE_BOOL(journal_matches);
 }
 
 
@@ -1248,11 +651,18 @@ void ObserverModule::DrawSettingsInternal()
     ImGui::Checkbox("Enabled", &is_enabled);
     ImGui::Checkbox("Trim henchman names", &trim_hench_names);
     ImGui::Checkbox("Enable in all Explorable Areas (experimental and unsupported)", &enable_in_explorable_areas);
+    ImGui::Checkbox("Journal matches", &journal_matches);
+    ImGui::ShowHelp("Write everything observed in each match to the observer\\journals folder,\nso the match can be replayed and exported again later on.");
 }
 
 
 void ObserverModule::Update(const float)
 {
+    // a crash loses at most a second of the match
+    if (journal.IsOpen() && TIMER_DIFF(journal_flush_timer) > 1000) {
+        journal.Flush();
+        journal_flush_timer = TIMER_INIT();
+    }
     if (party_sync_timer == 0) {
         return;
     }
@@ -1275,11 +685,11 @@ ObserverModule::ObservableGuild* ObserverModule::GetObservableGuildById(const ui
     }
 
     // lazy load
-    const auto it = observable_guilds.find(guild_id);
+    const ObserverStats::Index index = guild_indices.Find(guild_id);
 
     // found
-    if (it != observable_guilds.end()) {
-        return it->second;
+    if (index != ObserverStats::no_index) {
+        return &observable_guilds[index];
     }
 
     // create if active
@@ -1297,16 +707,15 @@ ObserverModule::ObservableGuild* ObserverModule::GetObservableGuildById(const ui
 
 
 // Create an ObservableGuild from a GW::Guild and cache it
-// Do NOT call this if the Agent already exists, it will cause a memory leak
+// Do NOT call this if the Guild already exists
 ObserverModule::ObservableGuild* ObserverModule::CreateObservableGuild(const GW::Guild& guild)
 {
+    const ObserverStats::Guild info = GuildOf(guild);
+    if (AddGuild(info) == ObserverStats::no_index) {
+        return nullptr;
+    }
     // create
-    auto observable_guild = new ObservableGuild(*this, guild);
-    // cache
-    observable_guilds.insert({observable_guild->guild_id, observable_guild});
-    observable_guild_ids.push_back(observable_guild->guild_id);
-    std::ranges::sort(observable_guild_ids);
-    return observable_guild;
+    return observable_guilds.Create(*this, info);
 }
 
 
@@ -1319,11 +728,11 @@ ObserverModule::ObservableAgent* ObserverModule::GetObservableAgentById(const ui
     }
 
     // lazy load
-    const auto it = observable_agents.find(agent_id);
+    const ObserverStats::Index index = agent_indices.Find(agent_id);
 
     // found
-    if (it != observable_agents.end()) {
-        return it->second;
+    if (index != ObserverStats::no_index) {
+        return &observable_agents[index];
     }
 
     // create if active
@@ -1346,18 +755,17 @@ ObserverModule::ObservableAgent* ObserverModule::GetObservableAgentById(const ui
 
 
 // Create an ObservableAgent from a GW::AgentLiving and cache it
-// Do NOT call this if the Agent already exists, it will cause a memory leak
+// Do NOT call this if the Agent already exists
 ObserverModule::ObservableAgent* ObserverModule::CreateObservableAgent(const GW::AgentLiving& agent_living)
 {
-    // create
     // ensure the guild is loaded...
     GetObservableGuildById(agent_living.tags->guild_id);
-    auto observable_agent = new ObservableAgent(*this, agent_living);
-    // cache
-    observable_agents.insert({observable_agent->agent_id, observable_agent});
-    observable_agent_ids.push_back(observable_agent->agent_id);
-    std::ranges::sort(observable_agent_ids);
-    return observable_agent;
+    const ObserverStats::Index index = AddAgent(AgentInfoOf(agent_living));
+    if (index == ObserverStats::no_index) {
+        return nullptr;
+    }
+    // create
+    return observable_agents.Create(*this, agent_living, index);
 }
 
 
@@ -1370,11 +778,11 @@ ObserverModule::ObservableSkill* ObserverModule::GetObservableSkillById(const GW
     }
 
     // find
-    const auto it_existing = observable_skills.find(skill_id);
+    const ObserverStats::Index index = skill_indices.Find(static_cast<uint32_t>(skill_id));
 
     // found
-    if (it_existing != observable_skills.end()) {
-        return it_existing->second;
+    if (index != ObserverStats::no_index) {
+        return &observable_skills[index];
     }
 
     // create if active
@@ -1391,16 +799,15 @@ ObserverModule::ObservableSkill* ObserverModule::GetObservableSkillById(const GW
 
 
 // Create an ObservableSkill from a GW::Skill and cache it
-// Do NOT call this is if the Skill already exists, It will cause a memory leak
+// Do NOT call this is if the Skill already exists
 ObserverModule::ObservableSkill* ObserverModule::CreateObservableSkill(const GW::Skill& gw_skill)
 {
+    const ObserverStats::Index index = AddSkill({static_cast<uint32_t>(gw_skill.skill_id), static_cast<uint32_t>(gw_skill.target)});
+    if (index == ObserverStats::no_index) {
+        return nullptr;
+    }
     // create
-    auto observable_skill = new ObservableSkill(*this, gw_skill);
-    // cache
-    observable_skills.insert({gw_skill.skill_id, observable_skill});
-    observable_skill_ids.push_back(observable_skill->skill_id);
-    std::ranges::sort(observable_skill_ids);
-    return observable_skill;
+    return observable_skills.Create(*this, gw_skill, index);
 }
 
 
@@ -1408,10 +815,10 @@ ObserverModule::ObservableSkill* ObserverModule::CreateObservableSkill(const GW:
 ObserverModule::ObservableParty* ObserverModule::GetObservablePartyByPartyInfo(const GW::PartyInfo& party_info)
 {
     // lazy load
-    const auto it_observable_party = observable_parties.find(party_info.party_id);
+    const ObserverStats::Index index = party_indices.Find(party_info.party_id);
     // found
-    if (it_observable_party != observable_parties.end()) {
-        return it_observable_party->second;
+    if (index != ObserverStats::no_index) {
+        return &observable_parties[index];
     }
 
     // create if active
@@ -1432,11 +839,11 @@ ObserverModule::ObservableParty* ObserverModule::GetObservablePartyById(const ui
     }
 
     // try to find
-    const auto it_party = observable_parties.find(party_id);
+    const ObserverStats::Index index = party_indices.Find(party_id);
 
     // found
-    if (it_party != observable_parties.end()) {
-        return it_party->second;
+    if (index != ObserverStats::no_index) {
+        return &observable_parties[index];
     }
 
     // create if active
@@ -1471,305 +878,20 @@ ObserverModule::ObservableParty* ObserverModule::GetObservablePartyById(const ui
 
 
 // Create an ObservableParty and cache it
-// Do NOT call this if the party already exists, will cause memory leak
+// Do NOT call this if the party already exists
 ObserverModule::ObservableParty* ObserverModule::CreateObservableParty(const GW::PartyInfo& party_info)
 {
-    // create
-    auto observable_party = new ObservableParty(*this, party_info);
-    // cache
-    observable_parties.insert({observable_party->party_id, observable_party});
-    observable_party_ids.push_back(observable_party->party_id);
-    std::ranges::sort(observable_party_ids);
-    return observable_party;
-}
-
-
-// change state based on an actions stage
-void ObserverModule::ObservedAction::Reduce(const TargetAction* action, const ActionStage stage)
-{
-    if (!action) {
-        return;
-    }
-
-    switch (stage) {
-        case ActionStage::Instant:
-            started += 1;
-            finished += 1;
-            break;
-        case ActionStage::Started:
-            started += 1;
-            break;
-        case ActionStage::Stopped:
-            // nothing to do if the action was already finished
-            // we can get "cancelled" packet after a "finished" packet if for example; we're using
-            // an attack skill, the attack skill completes, we begin the afterswing, and the target dies
-            // then the afterswing is cancelled, even though the action completed
-            if (!action->was_finished) {
-                stopped += 1;
-            }
-            break;
-        case ActionStage::Interrupted:
-            // nothing to do if the action was already finished
-            if (!action->was_finished) {
-                // were we prepended by a fake "cancelled" packet?
-                if (action->was_stopped) {
-                    stopped -= 1;
-                }
-                interrupted += 1;
-            }
-            break;
-        case ActionStage::Finished:
-            finished += 1;
-            break;
-    }
-
-    // re-calculate integrity
-    integrity = started - finished - stopped - interrupted;
-}
-
-
-// fired when the Agent dies
-void ObserverModule::SharedStats::HandleDeath()
-{
-    deaths += 1;
-    // recalculate kdr
-    kdr_pc = static_cast<float>(kills) / deaths;
-    // get kdr string
-    std::stringstream str;
-    str << std::fixed << std::setprecision(2) << kdr_pc;
-    kdr_str = str.str();
-}
-
-
-// fired when the agent scores a kill
-void ObserverModule::SharedStats::HandleKill()
-{
-    kills += 1;
-    // recalculate kdr
-    if (deaths < 1) {
-        kdr_pc = static_cast<float>(kills);
-    }
-    else {
-        kdr_pc = static_cast<float>(kills) / deaths;
-    }
-    // get kdr string
-    std::stringstream str;
-    str << std::fixed << std::setprecision(2) << kdr_pc;
-    kdr_str = str.str();
-}
-
-
-ObserverModule::ObservableAgentStats::~ObservableAgentStats()
-{
-    // attacks received (by agent)
-    for (const auto& [_, o_atk] : attacks_received_from_agents) {
-        if (o_atk) {
-            delete o_atk;
-        }
-    }
-    attacks_received_from_agents.clear();
-
-    // attacks dealed (by agent)
-    for (const auto& [_, o_atk] : attacks_dealt_to_agents) {
-        if (o_atk) {
-            delete o_atk;
-        }
-    }
-    attacks_dealt_to_agents.clear();
-
-    // skills used
-    skill_ids_used.clear();
-    for (const auto& [_, o_skill] : skills_used) {
-        if (o_skill) {
-            delete o_skill;
-        }
-    }
-    skills_used.clear();
-
-    // skills received
-    skill_ids_received.clear();
-    for (const auto& [_, o_skill] : skills_received) {
-        if (o_skill) {
-            delete o_skill;
-        }
-    }
-    skills_received.clear();
-
-    // skill received (by agent)
-    for (auto& [_, skill_ids] : skill_ids_received_from_agents) {
-        skill_ids.clear();
-    }
-    skill_ids_received_from_agents.clear();
-    for (auto& [_, agent_skills] : skills_received_from_agents) {
-        for (const auto [__, o_skill] : agent_skills) {
-            if (o_skill) {
-                delete o_skill;
-            }
-        }
-        agent_skills.clear();
-    }
-    skills_received_from_agents.clear();
-
-    // skill used (by agent)
-    for (auto& [_, skill_ids] : skill_ids_used_on_agents) {
-        skill_ids.clear();
-    }
-    skill_ids_used_on_agents.clear();
-    for (auto& [_, agent_skills] : skills_used_on_agents) {
-        for (const auto [__, o_skill] : agent_skills) {
-            if (o_skill) {
-                delete o_skill;
-            }
-        }
-        agent_skills.clear();
+    if (AddParty(party_info.party_id) == ObserverStats::no_index) {
+        return nullptr;
     }
-    skills_used_on_agents.clear();
-}
-
-
-// Get attacks dealed against this agent, by a caster_agent_id
-// Lazy initialises the caster_agent_id
-ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetAttacksDealedAgainst(const uint32_t target_agent_id)
-{
-    const auto it = attacks_dealt_to_agents.find(target_agent_id);
-    if (it == attacks_dealt_to_agents.end()) {
-        // receiver not registered
-        auto observed_action = new ObservedAction();
-        attacks_dealt_to_agents.insert({target_agent_id, observed_action});
-        return *observed_action;
-    }
-    // receiver is already reigstered
-    return *it->second;
-}
-
-
-// Get attacks dealed against this agent, by a caster_agent_id
-// Lazy initialises the caster_agent_id
-ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetAttacksReceivedFrom(const uint32_t caster_agent_id)
-{
-    const auto it = attacks_received_from_agents.find(caster_agent_id);
-    if (it == attacks_received_from_agents.end()) {
-        // attacker not registered
-        auto observed_action = new ObservedAction();
-        attacks_received_from_agents.insert({caster_agent_id, observed_action});
-        return *observed_action;
-    }
-    // attacker is already reigstered
-    return *it->second;
-}
-
-
-// Get skills used by this agent
-// Lazy initialises the skill_id
-ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetSkillUsed(const GW::Constants::SkillID skill_id)
-{
-    const auto it_skill = skills_used.find(skill_id);
-    if (it_skill == skills_used.end()) {
-        // skill not registered
-        skill_ids_used.push_back(skill_id);
-        // re-sort skills
-        std::ranges::sort(skill_ids_used);
-        auto observed_skill = new ObservedSkill(skill_id);
-        skills_used.insert({skill_id, observed_skill});
-        return *observed_skill;
-    }
-    // skill already registered
-    return *it_skill->second;
-}
-
-
-// Get skills used received by this agent
-// Lazy initialises the skill_id
-ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetSkillReceived(const GW::Constants::SkillID skill_id)
-{
-    const auto it_skill = skills_received.find(skill_id);
-    if (it_skill == skills_received.end()) {
-        // skill not registered
-        skill_ids_received.push_back(skill_id);
-        // re-sort skills
-        std::ranges::sort(skill_ids_received);
-        auto observed_skill = new ObservedSkill(skill_id);
-        skills_received.insert({skill_id, observed_skill});
-        return *observed_skill;
-    }
-    // skill already registered
-    return *it_skill->second;
-}
-
-
-// Get a skill received by this agent, from another agent
-// Lazy initialises the skill_id and caster_agent_id
-ObserverModule::ObservedSkill& ObserverModule::ObservableAgentStats::LazyGetSkillReceivedFrom(const uint32_t caster_agent_id, const GW::Constants::SkillID skill_id)
-{
-    const auto it_caster = skills_received_from_agents.find(caster_agent_id);
-    if (it_caster == skills_received_from_agents.end()) {
-        // receiver and his skills are not registered with this agent
-        std::vector received_skill_ids = {skill_id};
-        skill_ids_received_from_agents.insert({caster_agent_id, received_skill_ids});
-        auto observed_skill = new ObservedSkill(skill_id);
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> received_skills = {{skill_id, observed_skill}};
-        skills_received_from_agents.insert({caster_agent_id, received_skills});
-        return *observed_skill;
-    }
-    // receiver is registered with this agent
-    std::unordered_map<GW::Constants::SkillID, ObservedSkill*>& used_by_caster = it_caster->second;
-    const auto it_observed_skill = used_by_caster.find(skill_id);
-    // does receiver have the skill registered from/against us?
-    if (it_observed_skill == used_by_caster.end()) {
-        // caster hasn't registered this skill with this agent
-        // add & re-sort skill_ids by the caster
-        std::vector<GW::Constants::SkillID>& skills_ids_received_by_agent_vec = skill_ids_received_from_agents.find(caster_agent_id)->second;
-        skills_ids_received_by_agent_vec.push_back(skill_id);
-        // re-sort
-        std::ranges::sort(skills_ids_received_by_agent_vec);
-        // add the observed skill for the caster
-        auto observed_skill = new ObservedSkill(skill_id);
-        used_by_caster.insert({skill_id, observed_skill});
-        return *observed_skill;
-    }
-    // receivers already registered this skill
-    return *it_observed_skill->second;
-}
-
-
-// Get a skill received by this agent, from another agent
-// Lazy initialises the skill_id and caster_agent_id
-ObserverModule::ObservedSkill& ObserverModule::ObservableAgentStats::LazyGetSkillUsedOn(const uint32_t target_agent_id, const GW::Constants::SkillID skill_id)
-{
-    const auto it_target = skills_used_on_agents.find(target_agent_id);
-    if (it_target == skills_used_on_agents.end()) {
-        // receiver and his skills are not registered with this agent
-        std::vector used_skill_ids = {skill_id};
-        skill_ids_used_on_agents.insert({target_agent_id, used_skill_ids});
-        auto observed_skill = new ObservedSkill(skill_id);
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> used_skills = {{skill_id, observed_skill}};
-        skills_used_on_agents.insert({target_agent_id, used_skills});
-        return *observed_skill;
-    }
-    std::unordered_map<GW::Constants::SkillID, ObservedSkill*>& used_on_target = it_target->second;
-    // receiver is registered with this agent
-    const auto it_observed_skill = used_on_target.find(skill_id);
-    // does receiver have the skill registered from/against us?
-    if (it_observed_skill == used_on_target.end()) {
-        // target hasn't registered this skill with this agent
-        // add & re-sort skill_ids by the caster
-        std::vector<GW::Constants::SkillID>& skills_ids_used_on_agent_vec = skill_ids_used_on_agents.find(target_agent_id)->second;
-        skills_ids_used_on_agent_vec.push_back(skill_id);
-        // re-sort
-        std::ranges::sort(skills_ids_used_on_agent_vec);
-        // add the observed skill for the caster
-        auto observed_skill = new ObservedSkill(skill_id);
-        used_on_target.insert({skill_id, observed_skill});
-        return *observed_skill;
-    }
-    // receivers already registered this skill
-    return *it_observed_skill->second;
+    // create
+    return observable_parties.Create(*this, party_info);
 }
 
 
 // Constructor
 ObserverModule::ObservableParty::ObservableParty(ObserverModule& parent, const GW::PartyInfo& info)
-    : party_id(info.party_id)
+    : Party(info.party_id)
     , parent(parent) {}
 
 
@@ -1803,6 +925,12 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
         return false;
     }
 
+    // to tell whether the journal needs to hear about it
+    const std::vector<uint32_t> prev_agent_ids = agent_ids;
+    const uint32_t prev_guild_id = guild_id;
+    const uint32_t prev_rank = rank;
+    const uint32_t prev_rating = rating;
+
     // load party members:
     // 1. players
     //  1.1 player heroes
@@ -1824,8 +952,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
             // clear old party member
             ObservableAgent* observable_agent_prev = parent.GetObservableAgentById(agent_ids[i]);
             if (observable_agent_prev) {
-                observable_agent_prev->party_id = NO_PARTY;
-                observable_agent_prev->party_index = 0;
+                parent.SetAgentParty(*observable_agent_prev, NO_PARTY, 0);
             }
         }
         agent_ids.resize(party_size, NO_AGENT);
@@ -1843,8 +970,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
                 // clear old party member
                 ObservableAgent* observable_player_prev = parent.GetObservableAgentById(agent_ids[party_index]);
                 if (observable_player_prev) {
-                    observable_player_prev->party_id = NO_PARTY;
-                    observable_player_prev->party_index = 0;
+                    parent.SetAgentParty(*observable_player_prev, NO_PARTY, 0);
                 }
             }
             // add new party member
@@ -1852,8 +978,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
             ObservableAgent* observable_player = parent.GetObservableAgentById(player.agent_id);
             if (observable_player) {
                 // notify the player of their party & position
-                observable_player->party_id = party_id;
-                observable_player->party_index = party_index;
+                parent.SetAgentParty(*observable_player, party_id, static_cast<uint32_t>(party_index));
             }
         }
         party_index += 1;
@@ -1868,8 +993,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
                         // clear old party member
                         ObservableAgent* observable_hero_prev = parent.GetObservableAgentById(agent_ids[party_index]);
                         if (observable_hero_prev) {
-                            observable_hero_prev->party_id = NO_PARTY;
-                            observable_hero_prev->party_index = 0;
+                            parent.SetAgentParty(*observable_hero_prev, NO_PARTY, 0);
                         }
                     }
                     // add new party member
@@ -1877,8 +1001,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
                     ObservableAgent* observable_hero = parent.GetObservableAgentById(hero.agent_id);
                     if (observable_hero) {
                         // notify the hero of their party & position
-                        observable_hero->party_id = party_id;
-                        observable_hero->party_index = party_index;
+                        parent.SetAgentParty(*observable_hero, party_id, static_cast<uint32_t>(party_index));
                     }
                 }
             }
@@ -1894,8 +1017,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
                 // clear old party member
                 ObservableAgent* observable_hench_prev = parent.GetObservableAgentById(agent_ids[party_index]);
                 if (observable_hench_prev) {
-                    observable_hench_prev->party_id = NO_PARTY;
-                    observable_hench_prev->party_index = 0;
+                    parent.SetAgentParty(*observable_hench_prev, NO_PARTY, 0);
                 }
             }
             // add new party member
@@ -1903,8 +1025,7 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
             ObservableAgent* observable_hench = parent.GetObservableAgentById(hench.agent_id);
             if (observable_hench) {
                 // notify the henchman of their party & position
-                observable_hench->party_id = party_id;
-                observable_hench->party_index = party_index;
+                parent.SetAgentParty(*observable_hench, party_id, static_cast<uint32_t>(party_index));
             }
         }
         party_index += 1;
@@ -1939,17 +1060,21 @@ bool ObserverModule::ObservableParty::SynchroniseParty()
         }
     }
 
+    if (agent_ids != prev_agent_ids || guild_id != prev_guild_id || rank != prev_rank || rating != prev_rating) {
+        parent.SetPartyRoster(*this);
+    }
+
     // success
     return true;
 }
 
 
 // Constructor
-ObserverModule::ObservableSkill::ObservableSkill(ObserverModule& parent, const GW::Skill& _gw_skill)
-    : parent(parent)
+ObserverModule::ObservableSkill::ObservableSkill(ObserverModule& parent, const GW::Skill& _gw_skill, const ObserverStats::Index index)
+    : Skill(index, {static_cast<uint32_t>(_gw_skill.skill_id), static_cast<uint32_t>(_gw_skill.target)})
+    , parent(parent)
     , gw_skill(_gw_skill)
 {
-    skill_id = _gw_skill.skill_id;
     // initialize the name asynchronously here
     if (!name_enc[0] && GW::UI::UInt32ToEncStr(gw_skill.name, name_enc, 16)) {
         GW::UI::AsyncDecodeStr(name_enc, name_dec, 256);
@@ -1958,7 +1083,7 @@ ObserverModule::ObservableSkill::ObservableSkill(ObserverModule& parent, const G
 
 
 // Name of the skill
-const std::string ObserverModule::ObservableSkill::Name()
+std::string ObserverModule::ObservableSkill::Name()
 {
     // cached?
     if (_name.length() > 0) {
@@ -1984,44 +1109,27 @@ std::string ObserverModule::ObservableSkill::DebugName()
 
 
 // Constructor
-ObserverModule::ObservableGuild::ObservableGuild(ObserverModule& parent, const GW::Guild& guild)
-    : parent(parent)
-    , guild_id(guild.index)
-    , key(guild.key)
-    , name(GuiUtils::WStringToString(guild.name))
-    , tag(GuiUtils::WStringToString(guild.tag))
-    , wrapped_tag("[" + tag + "]")
-    , rank(guild.rank)
-    , rating(guild.rating)
-    , faction(guild.faction)
-    , faction_point(guild.faction_point)
-    , qualifier_point(guild.qualifier_point)
-    , cape_trim(guild.cape_trim)
+ObserverModule::ObservableGuild::ObservableGuild(ObserverModule& parent, const ObserverStats::Guild& guild)
+    : Guild(guild)
+    , parent(parent)
 {
     //
 }
 
 
 // Constructor
-ObserverModule::ObservableAgent::ObservableAgent(ObserverModule& parent, const GW::AgentLiving& agent_living)
-    : parent(parent)
-    , agent_id(agent_living.agent_id)
-    , login_number(agent_living.login_number)
+ObserverModule::ObservableAgent::ObservableAgent(ObserverModule& parent, const GW::AgentLiving& agent_living, const ObserverStats::Index index)
+    : Agent(parent, index, AgentInfoOf(agent_living))
+    , parent(parent)
     , state(agent_living.model_state)
-    , guild_id(static_cast<uint32_t>(agent_living.tags->guild_id))
-    , team_id(agent_living.team_id)
-    , primary(static_cast<GW::Constants::Profession>(agent_living.primary))
-    , secondary(static_cast<GW::Constants::Profession>(agent_living.secondary))
-    , is_player(agent_living.IsPlayer())
-    , is_npc(agent_living.IsNPC())
 {
     // async initialise the agents name now because we probably want it later
     GW::Agents::AsyncGetAgentName(&agent_living, _raw_name_w);
 
-    if (primary != GW::Constants::Profession::None) {
-        std::string prof = GetProfessionAcronym(primary);
-        if (secondary != GW::Constants::Profession::None) {
-            const std::string s_prof = GetProfessionAcronym(secondary);
+    if (static_cast<GW::Constants::Profession>(primary) != GW::Constants::Profession::None) {
+        std::string prof = GetProfessionAcronym(static_cast<GW::Constants::Profession>(primary));
+        if (static_cast<GW::Constants::Profession>(secondary) != GW::Constants::Profession::None) {
+            const std::string s_prof = GetProfessionAcronym(static_cast<GW::Constants::Profession>(secondary));
             prof = prof + "/" + s_prof;
         }
         profession = prof;
@@ -2029,13 +1137,6 @@ ObserverModule::ObservableAgent::ObservableAgent(ObserverModule& parent, const G
 };
 
 
-// Destructor
-ObserverModule::ObservableAgent::~ObservableAgent()
-{
-    delete current_target_action;
-}
-
-
 // Name of the Agent to display on HUD
 std::string ObserverModule::ObservableAgent::DisplayName()
 {
@@ -2143,13 +1244,7 @@ std::string ObserverModule::ObservableAgent::DebugName()
 
 // Constructor
 ObserverModule::ObservableMap::ObservableMap(const GW::AreaInfo& area_info)
-    : campaign(area_info.campaign)
-    , continent(area_info.continent)
-    , region(area_info.region)
-    , type(area_info.type)
-    , flags(area_info.flags)
-    , name_id(area_info.name_id)
-    , description_id(area_info.description_id)
+    : Map(MapInfoOf(area_info))
 {
     // async initialise the name
     if (GW::UI::UInt32ToEncStr(area_info.name_id, name_enc, 8)) {
@@ -13,6 +13,8 @@
 #include <GWCA/Utilities/Hook.h>
 
 #include <ToolboxModule.h>
+#include <Utils/ObserverJournal.h>
+#include <Utils/ObserverMatch.h>
 
 constexpr auto NO_SKILL = static_cast<GW::Constants::SkillID>(0);
 constexpr auto NO_AGENT = 0;
@@ -47,253 +49,34 @@ namespace ObserverLabel {
 }; // namespace ObserverLabels
 
 
-class ObserverModule : public ToolboxModule {
+class ObserverModule : public ToolboxModule, public ObserverStats::Match {
 public:
-    enum class ActionStage {
-        // start
-        Started,
-
-        // both
-        Instant,
-
-        // finish
-        Stopped,
-        Finished,
-        Interrupted // "Interrupted" is received after "Stopped"
-    };
-
-    // An action between a caster and target
-    // Where an action can be a skill and/or attack
-    struct TargetAction {
-        TargetAction(const uint32_t caster_id,
-                     const uint32_t target_id,
-                     const bool is_attack,
-                     const bool is_skill,
-                     const GW::Constants::SkillID skill_id
-        )
-            : caster_id(caster_id)
-            , target_id(target_id)
-            , is_attack(is_attack)
-            , is_skill(is_skill)
-            , skill_id(skill_id) { }
-
-        const uint32_t caster_id;
-        const uint32_t target_id;
-        const bool is_attack;
-        const bool is_skill;
-        const GW::Constants::SkillID skill_id;
-
-        // if the action was interrupted after it was finished (e.g. an attack skill that gets interrupted
-        // in the aftersting [once the skill has completed activation]) then we don't count as "interrupted"
-        // even if receiving an "interrupted" signal
-        bool was_stopped = false;
-        bool was_finished = false;
-    };
-
-    // an agents statistics for an action (attack)
-    class ObservedAction {
-    public:
-        size_t started = 0;
-        size_t stopped = 0;
-        size_t finished = 0;
-        size_t interrupted = 0;
-
-        // should be zero at all times except when an action is not yet concluded
-        // used to indicate there may be inaccuracies in the stats due to due to
-        // inaccuracies in our modelling of the game engine
-        int integrity = 0;
-
-        void Reduce(const TargetAction* action, ActionStage stage);
-    };
-
-    // an agents statistics for an action (skill)
-    struct ObservedSkill : ObservedAction {
-        ObservedSkill(const GW::Constants::SkillID skill_id)
-            : skill_id(skill_id) { }
-
-        const GW::Constants::SkillID skill_id;
-    };
-
-
-    // Shared stats for an Agent or Team
-    class SharedStats {
-    public:
-        // ****
-        // misc
-        // ****
-
-        size_t total_crits_received = 0;
-        size_t total_crits_dealt = 0;
-
-        size_t total_party_crits_received = 0;
-        size_t total_party_crits_dealt = 0;
-
-        size_t knocked_down_count = 0;
-        size_t interrupted_count = 0;
-        size_t interrupted_skills_count = 0;
-        size_t cancelled_count = 0;
-        size_t cancelled_skills_count = 0;
-        float knocked_down_duration = 0;
-
-        // deaths: from AgentState packets
-        size_t deaths = 0;
-        // kills: player kills only, not npc kills
-        //        guessed from damage packets
-        size_t kills = 0;
-        float kdr_pc = 0;
-        std::string kdr_str = "0.00";
-
-        // attacks
-
-        ObservedAction total_attacks_dealt;
-        ObservedAction total_attacks_received;
-
-        // attacks done on other parties (not inc. npcs)
-        ObservedAction total_attacks_dealt_to_other_parties;
-        // attacks received from other parties (not inc. npcs)
-        ObservedAction total_attacks_received_from_other_parties;
-
-        // skills
-
-        // skills used on anyone
-        ObservedAction total_skills_used;
-        // skills received from anyone
-        ObservedAction total_skills_received;
-
-        // skills used on your own party (not inc. npcs)
-        ObservedAction total_skills_used_on_own_party;
-        // skills used on other parties (not inc. npcs)
-        ObservedAction total_skills_used_on_other_parties;
-
-        // skills received from your own party (not inc. npcs)
-        ObservedAction total_skills_received_from_own_party;
-        // skills received from other parties (not inc. npcs)
-        ObservedAction total_skills_received_from_other_parties;
-
-        // skills used on your own team (inc. npcs)
-        ObservedAction total_skills_used_on_own_team;
-        // skills used on other team (inc. npcs)
-        ObservedAction total_skills_used_on_other_teams;
-
-        // skills received from your own team (inc. npcs)
-        ObservedAction total_skills_received_from_own_team;
-        // skills received from other team (inc. npcs)
-        ObservedAction total_skills_received_from_other_teams;
-
-        // fired when the agent dies
-        void HandleDeath();
-
-        // fired when the agent scores a kill
-        void HandleKill();
-    };
-
-    // Stats for Agents
-    class ObservableAgentStats : public SharedStats {
-    public:
-        ~ObservableAgentStats();
-
-        // map of agent_id -> ObservedAction
-        std::unordered_map<uint32_t, ObservedAction*> attacks_dealt_to_agents = {};
-        ObservedAction& LazyGetAttacksDealedAgainst(uint32_t target_agent_id);
-
-        // map of agent_id -> ObservedAction
-        std::unordered_map<uint32_t, ObservedAction*> attacks_received_from_agents = {};
-        ObservedAction& LazyGetAttacksReceivedFrom(uint32_t attacker_agent_id);
-
-        // skills
-
-        // map of skill_id -> count of times received
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> skills_used = {};
-        std::vector<GW::Constants::SkillID> skill_ids_used = {};
-        ObservedAction& LazyGetSkillUsed(GW::Constants::SkillID skill_id);
-
-        // map of skill_id -> count of times used
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> skills_received = {};
-        std::vector<GW::Constants::SkillID> skill_ids_received = {};
-        ObservedAction& LazyGetSkillReceived(GW::Constants::SkillID skill_id);
-
-        // skills by agent
-
-        // map of agent_id -> skill_id -> count of times received
-        std::unordered_map<uint32_t, std::unordered_map<GW::Constants::SkillID, ObservedSkill*>> skills_received_from_agents = {};
-        std::unordered_map<uint32_t, std::vector<GW::Constants::SkillID>> skill_ids_received_from_agents = {};
-        ObservedSkill& LazyGetSkillReceivedFrom(uint32_t caster_agent_id, GW::Constants::SkillID skill_id);
-
-        // map of agent_id -> skill_id -> count of times used
-        std::unordered_map<uint32_t, std::unordered_map<GW::Constants::SkillID, ObservedSkill*>> skills_used_on_agents = {};
-        std::unordered_map<uint32_t, std::vector<GW::Constants::SkillID>> skill_ids_used_on_agents = {};
-        ObservedSkill& LazyGetSkillUsedOn(uint32_t target_agent_id, GW::Constants::SkillID skill_id);
-    };
-
-    // Stats for Parties
-    class ObservablePartyStats : public SharedStats {
-    public:
-        //
-    };
-
-    class ObservableSkillStats {
-    public:
-        ObservedAction total_usages;
-
-        ObservedAction total_self_usages;
-        ObservedAction total_other_usages;
-
-        ObservedAction total_own_party_usages;
-        ObservedAction total_own_team_usages;
-
-        ObservedAction total_other_party_usages;
-        ObservedAction total_other_team_usages;
-    };
+    using ActionStage = ObserverStats::ActionStage;
+    using TargetAction = ObserverStats::TargetAction;
+    using ObservedAction = ObserverStats::ObservedAction;
+    using ObservedSkill = ObserverStats::ObservedSkill;
+    using SharedStats = ObserverStats::SharedStats;
+    using ObservableAgentStats = ObserverStats::AgentStats;
+    using ObservablePartyStats = ObserverStats::PartyStats;
+    using ObservableSkillStats = ObserverStats::SkillStats;
+    using TargetType = ObserverStats::TargetType;
 
 
     // Represents an agent whose stats are tracked
     // Includes players AND npc's
-    class ObservableAgent {
+    class ObservableAgent : public ObserverStats::Agent {
     public:
-        ObservableAgent(ObserverModule& parent, const GW::AgentLiving& agent_living);
-        ~ObservableAgent();
-
-        std::string profession = "";
+        ObservableAgent(ObserverModule& parent, const GW::AgentLiving& agent_living, ObserverStats::Index index);
 
         ObserverModule& parent;
-        uint32_t agent_id;
-        uint32_t login_number;
-        uint32_t state = state;
-
-        uint32_t guild_id;
-        uint32_t team_id;
-        // initialise to no party id
-        // let the party set the party_id
-        uint32_t party_id = NO_PARTY;
-        uint32_t party_index = 0;
-
-        GW::Constants::Profession primary;
-        GW::Constants::Profession secondary;
-
-        // latest action (attack/skill) the agent was undertaking
-        TargetAction* current_target_action = nullptr;
-
-        // last_hit_by tells us who killed the player if they die
-        // MUST be a party_member (e.g. not a footman)
-        // Not literally who is responsible for the kill, but may help
-        // account for degen / npc steals / such.
-        // It's a for fun stat so don't take it too serious
-        uint32_t last_hit_by = NO_AGENT;
-
-        // TODO: last_hit_at to limit the kill window
-
-        bool is_player;
-        bool is_npc;
-
-        // stats:
-        ObservableAgentStats stats;;
+        uint32_t state;
 
         // name fns with excessive caching & lazy loading
-        std::string DisplayName();
-        std::string RawName();
+        std::string DisplayName() override;
+        std::string RawName() override;
         std::wstring RawNameW();
-        std::string DebugName();
-        std::string SanitizedName();
+        std::string DebugName() override;
+        std::string SanitizedName() override;
         std::wstring SanitizedNameW();
 
     private:
@@ -310,31 +93,19 @@ public:
         std::string _sanitized_name = "";
     };
 
-    class ObservableGuild {
+    class ObservableGuild : public ObserverStats::Guild {
     public:
-        ObservableGuild(ObserverModule& parent, const GW::Guild& guild);
+        ObservableGuild(ObserverModule& parent, const ObserverStats::Guild& guild);
 
         ObserverModule& parent;
-        uint32_t guild_id;
-        GW::GHKey key;
-        std::string name;
-        std::string tag;
-        std::string wrapped_tag;
-        uint32_t rank;
-        uint32_t rating;
-        uint32_t faction; // 0 - kurz, 1 - lux
-        uint32_t faction_point;
-        uint32_t qualifier_point;
-        uint32_t cape_trim; // TODO: which is gold (1)?
     };
 
     // Represents a skill in an ObserverMode
     // Usage is tracked
-    class ObservableSkill {
+    class ObservableSkill : public ObserverStats::Skill {
     public:
-        ObservableSkill(ObserverModule& parent, const GW::Skill& _gw_skill);
+        ObservableSkill(ObserverModule& parent, const GW::Skill& _gw_skill, ObserverStats::Index index);
 
-        GW::Constants::SkillID skill_id;
         ObserverModule& parent;
         const GW::Skill& gw_skill;
 
@@ -343,9 +114,8 @@ public:
         const bool IsMaintained() const { return gw_skill.duration0 == 0x20000; }
         const bool IsPvE() const { return (gw_skill.special & 0x80000) != 0; }
         const bool IsElite() const { return (gw_skill.special & 0x4) != 0; }
-        ObservableSkillStats stats = ObservableSkillStats();
 
-        const std::string Name();
+        std::string Name() override;
         std::string DebugName();
 
     private:
@@ -356,36 +126,15 @@ public:
     };
 
 
-    class ObservableParty {
+    class ObservableParty : public ObserverStats::Party {
     public:
         ObservableParty(ObserverModule& parent, const GW::PartyInfo& info);
         ~ObservableParty();
 
-        uint32_t party_id;
-
-        // guild_id and name are inferred from the guilds members
-        // TODO: get the actual teams guild/name from memory,
-        // instead of guessing
-        uint32_t guild_id = NO_GUILD;
-        uint32_t rating = NO_RATING;
-        uint32_t rank = NO_RANK;
-        std::string rank_str; // 0 -> "N/A"
-        std::string name = "";
-        std::string display_name = "";
-
-        uint32_t morale_boosts = 0;
-        bool is_victorious = false;
-        bool is_defeated = false;
-
         ObserverModule& parent;
 
-        ObservablePartyStats stats = ObservablePartyStats();
-
         bool SynchroniseParty();
 
-        // agent_ids representing the players
-        std::vector<uint32_t> agent_ids = {};
-
         std::string DebugName() const
         {
             std::string _debug_name = "(" + std::to_string(party_id) + ") " + display_name;
@@ -394,22 +143,12 @@ public:
     };
 
     // closely rlated to GW::AreaInfo
-    class ObservableMap {
+    class ObservableMap : public ObserverStats::Map {
     public:
         ObservableMap(const GW::AreaInfo& area_info);
 
-        GW::Constants::Campaign campaign;
-        GW::Continent continent;
-        GW::Region region;
-        GW::RegionType type;
-        uint32_t flags;
-        uint32_t name_id;
-        uint32_t description_id;
-
-        std::string Name();
-        std::string Description();
-        [[nodiscard]] bool GetIsPvP() const { return (flags & 0x1) != 0; }
-        [[nodiscard]] bool GetIsGuildHall() const { return (flags & 0x800000) != 0; }
+        std::string Name() override;
+        std::string Description() override;
 
     private:
         std::string name = "";
@@ -420,17 +159,6 @@ public:
         wchar_t description_enc[8]{};
     };
 
-    // TODO: push this to GWCA
-    // applies to skill.target
-    enum class TargetType {
-        no_target = 0,
-        anyone    = 1,
-        // 2?
-        ally       = 3,
-        other_ally = 4,
-        enemy      = 5,
-    };
-
     ~ObserverModule() override;
 
     static ObserverModule& Instance()
@@ -460,22 +188,13 @@ public:
     ObservableSkill* GetObservableSkillById(GW::Constants::SkillID skill_id);
     ObservableParty* GetObservablePartyById(uint32_t party_id);
 
-    ObservableMap* GetMap() const { return map; }
-    const std::vector<uint32_t>& GetObservableGuildIds() { return observable_guild_ids; }
-    const std::vector<uint32_t>& GetObservableAgentIds() { return observable_agent_ids; }
-    const std::vector<uint32_t>& GetObservablePartyIds() { return observable_party_ids; }
-    const std::vector<GW::Constants::SkillID>& GetObservableSkillIds() { return observable_skill_ids; }
-    const std::unordered_map<uint32_t, ObservableGuild*>& GetObservableGuilds() { return observable_guilds; }
-    const std::unordered_map<uint32_t, ObservableAgent*>& GetObservableAgents() { return observable_agents; }
-    const std::unordered_map<uint32_t, ObservableParty*>& GetObservableParties() { return observable_parties; }
-    const std::unordered_map<GW::Constants::SkillID, ObservableSkill*>& GetObservableSkills() { return observable_skills; }
-
-    bool match_finished = false;
-    uint32_t winning_party_id = NO_PARTY;
-    std::chrono::milliseconds match_duration_ms_total{};
-    std::chrono::milliseconds match_duration_ms{};
-    std::chrono::seconds match_duration_secs{};
-    std::chrono::minutes match_duration_mins{};
+    ObservableMap* GetMap() const override { return map; }
+
+    // ObserverStats::Match lookups; lazy load from the game like the above
+    ObserverStats::Agent* GetAgent(const uint32_t agent_id) override { return GetObservableAgentById(agent_id); }
+    ObserverStats::Party* GetParty(const uint32_t party_id) override { return GetObservablePartyById(party_id); }
+    ObserverStats::Skill* GetSkill(const uint32_t skill_id) override { return GetObservableSkillById(static_cast<GW::Constants::SkillID>(skill_id)); }
+    ObserverStats::Guild* GetGuild(const uint32_t guild_id) override { return GetObservableGuildById(guild_id); }
 
 private:
     ObservableGuild* CreateObservableGuild(const GW::Guild& guild);
@@ -485,11 +204,14 @@ private:
     ObservableParty* GetObservablePartyByPartyInfo(const GW::PartyInfo& party_info);
 
     clock_t party_sync_timer = 0;
+    clock_t journal_flush_timer = 0;
 
     // agent name settings
     bool trim_hench_names = false;
     bool trim_player_indexes = false;
     bool enable_in_explorable_areas = false;
+    // journal each match to observer\journals, to be replayed and exported later on
+    bool journal_matches = false;
 
     // can be force enabled in non-explorable explorable areas
 
@@ -501,61 +223,38 @@ private:
 
     void HandleInstanceLoadInfo(const GW::HookStatus* status, const GW::Packet::StoC::InstanceLoadInfo* packet);
     void HandleJumboMessage(uint8_t type, uint32_t value);
-    void HandleAgentProjectileLaunched(const GW::Packet::StoC::AgentProjectileLaunched* packet);
-
-    // generic handlers
-
-    void HandleInterrupted(uint32_t agent_id);
-    void HandleKnockedDown(uint32_t agent_id, float duration);
-    void HandleAgentState(uint32_t agent_id, uint32_t state);
-    void HandleDamageDone(uint32_t caster_id, uint32_t target_id, float amount_pc, bool is_crit);
     void HandleAgentAdd(uint32_t agent_id);
 
-    void HandleAttackFinished(uint32_t agent_id);
-    void HandleAttackStopped(uint32_t agent_id);
-    void HandleAttackStarted(uint32_t caster_id, uint32_t target_id);
-
-    void HandleInstantSkillActivated(uint32_t caster_id, uint32_t target_id, GW::Constants::SkillID skill_id);
-
-    void HandleAttackSkillFinished(uint32_t agent_id);
-    void HandleAttackSkillStopped(uint32_t agent_id);
-    void HandleAttackSkillStarted(uint32_t caster_id, uint32_t target_id, GW::Constants::SkillID skill_id);
-
-    void HandleSkillFinished(uint32_t agent_id);
-    void HandleSkillStopped(uint32_t agent_id);
-    void HandleSkillActivated(uint32_t caster_id, uint32_t target_id, GW::Constants::SkillID skill_id);
-
     void HandleGenericPacket(uint32_t value_id, uint32_t caster_id,
                              uint32_t target_id, float value, bool no_target);
 
     void HandleGenericPacket(uint32_t value_id, uint32_t caster_id,
                              uint32_t target_id, uint32_t value, bool no_target);
 
-    // Update the state of the module based on an Action & Stage
-    // return false means action was not assigned and may need freeing by the caller
-    bool ReduceAction(ObservableAgent* caster, ActionStage stage, TargetAction* new_action = nullptr);
+    // Reduce an event at the current instance time into the match
+    void ApplyEvent(ObserverStats::EventType type, uint32_t caster_id, uint32_t target_id = NO_AGENT, uint32_t value = 0, float amount = 0);
 
     static uint32_t JumboMessageValueToPartyId(uint32_t value);
-    static void HandleMoraleBoost(ObservableParty* boosting_party);
-    void HandleVictory(ObservableParty* winning_party);
 
     ObservableMap* map{};
 
+    // Everything below lives until Reset(), and keeps its memory for the next match.
+    // Observables are kept in their arena at the index ObserverStats::Match gave them.
+
     // lazy loaded observed guilds
-    std::unordered_map<uint32_t, ObservableGuild*> observable_guilds = {};
-    std::vector<uint32_t> observable_guild_ids = {};
+    ObserverStats::ObjectArena<ObservableGuild> observable_guilds;
 
     // lazy loaded observed agents
-    std::unordered_map<uint32_t, ObservableAgent*> observable_agents = {};
-    std::vector<uint32_t> observable_agent_ids = {};
+    ObserverStats::ObjectArena<ObservableAgent> observable_agents;
 
     // lazy loaded observed skills
-    std::unordered_map<GW::Constants::SkillID, ObservableSkill*> observable_skills = {};
-    std::vector<GW::Constants::SkillID> observable_skill_ids = {};
+    ObserverStats::ObjectArena<ObservableSkill> observable_skills;
 
     // lazy loaded observed parties
-    std::unordered_map<uint32_t, ObservableParty*> observable_parties = {};
-    std::vector<uint32_t> observable_party_ids = {};
+    ObserverStats::ObjectArena<ObservableParty> observable_parties;
+
+    // the current match, as it happens
+    ObserverJournal journal;
 
     bool SynchroniseParties();
 
@@ -0,0 +1,299 @@
+#include "stdafx.h"
+
+#include <GWCA/Packets/StoC.h>
+#include <GWCA/Managers/ChatMgr.h>
+#include <GWCA/Managers/StoCMgr.h>
+
+#include <GWToolbox.h>
+#include <Utils/FrameProfiler.h>
+#include <Modules/Resources.h>
+#include <Defines.h>
+#include <Logger.h>
+#include <ImGuiAddons.h>
+#include "ProfilerModule.h"
+
+namespace {
+    using FrameProfiler::Phase;
+
+    bool enabled = false;
+
+    // Each header gets its own zone for the toolbox callbacks that run before the game handles the packet, and one
+    // for those after. The game handler itself runs between the two and isn't counted.
+    constexpr size_t stoc_header_max = 512;
+    constexpr uintptr_t stoc_post_key = 0x10000;
+    GW::HookEntry stoc_pre_begin_entry;
+    GW::HookEntry stoc_pre_end_entry;
+    GW::HookEntry stoc_post_begin_entry;
+    GW::HookEntry stoc_post_end_entry;
+    size_t stoc_headers_hooked = 0;
+    // Packets are only handled on the game thread
+    std::array<int64_t, stoc_header_max> stoc_pre_start{};
+    std::array<int64_t, stoc_header_max> stoc_post_start{};
+    std::array<std::string, stoc_header_max * 2> stoc_zone_names;
+
+    void OnStoCBegin(std::array<int64_t, stoc_header_max>& starts, const GW::Packet::StoC::PacketBase* packet)
+    {
+        if (packet->header < stoc_header_max) {
+            starts[packet->header] = FrameProfiler::Now();
+        }
+    }
+
+    void OnStoCEnd(std::array<int64_t, stoc_header_max>& starts, const GW::Packet::StoC::PacketBase* packet, const bool post)
+    {
+        if (packet->header >= stoc_header_max || !starts[packet->header]) {
+            return;
+        }
+        const size_t name_index = packet->header + (post ? stoc_header_max : 0);
+        FrameProfiler::Record(Phase::StoC, packet->header | (post ? stoc_post_key : 0), stoc_zone_names[name_index].c_str(), starts[packet->header]);
+        starts[packet->header] = 0;
+    }
+
+    void HookStoC()
+    {
+        if (stoc_headers_hooked) {
+            return;
+        }
+        // There's no telling how many headers the game has from here; GWCA refuses the first one past the end
+        for (uint32_t header = 0; header < stoc_header_max; header++) {
+            const bool hooked = GW::StoC::RegisterPacketCallback(&stoc_pre_begin_entry, header, [](GW::HookStatus*, const GW::Packet::StoC::PacketBase* packet) {
+                OnStoCBegin(stoc_pre_start, packet);
+            }, -0x10000);
+            if (!hooked) {
+                break;
+            }
+            GW::StoC::RegisterPacketCallback(&stoc_pre_end_entry, header, [](GW::HookStatus*, const GW::Packet::StoC::PacketBase* packet) {
+                OnStoCEnd(stoc_pre_start, packet, false);
+            }, 0);
+            GW::StoC::RegisterPacketCallback(&stoc_post_begin_entry, header, [](GW::HookStatus*, const GW::Packet::StoC::PacketBase* packet) {
+                OnStoCBegin(stoc_post_start, packet);
+            }, 1);
+            GW::StoC::RegisterPacketCallback(&stoc_post_end_entry, header, [](GW::HookStatus*, const GW::Packet::StoC::PacketBase* packet) {
+                OnStoCEnd(stoc_post_start, packet, true);
+            }, 0x10000);
+            stoc_zone_names[header] = std::format("StoC {}", header);
+            stoc_zone_names[header + stoc_header_max] = std::format("StoC {} (after game)", header);
+            stoc_headers_hooked = header + 1;
+        }
+    }
+
+    void UnhookStoC()
+    {
+        for (uint32_t header = 0; header < stoc_headers_hooked; header++) {
+            GW::StoC::RemoveCallback(header, &stoc_pre_begin_entry);
+            GW::StoC::RemoveCallback(header, &stoc_pre_end_entry);
+            GW::StoC::RemoveCallback(header, &stoc_post_begin_entry);
+            GW::StoC::RemoveCallback(header, &stoc_post_end_entry);
+        }
+        stoc_headers_hooked = 0;
+        stoc_pre_start.fill(0);
+        stoc_post_start.fill(0);
+    }
+
+    void GetStatsByP99(std::vector<FrameProfiler::ZoneStats>& stats)
+    {
+        FrameProfiler::GetStats(stats);
+        std::ranges::sort(stats, [](const FrameProfiler::ZoneStats& a, const FrameProfiler::ZoneStats& b) {
+            return a.p99 > b.p99;
+        });
+    }
+
+    // Slowest first
+    std::vector<GWToolbox::ModuleInitTiming> GetInitTimings()
+    {
+        auto timings = GWToolbox::GetInitTimings();
+        std::ranges::sort(timings, [](const GWToolbox::ModuleInitTiming& a, const GWToolbox::ModuleInitTiming& b) {
+            return a.preload_ms + a.initialize_ms > b.preload_ms + b.initialize_ms;
+        });
+        return timings;
+    }
+
+    void DrawInitTimings()
+    {
+        const auto timings = GetInitTimings();
+        if (timings.empty()) {
+            return;
+        }
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY;
+        if (!ImGui::BeginTable("profiler_init_timings", 3, flags, {0, 200.f * ImGui::GetIO().FontGlobalScale})) {
+            return;
+        }
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Module", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Preload ms", ImGuiTableColumnFlags_WidthFixed, 80);
+        ImGui::TableSetupColumn("Initialize ms", ImGuiTableColumnFlags_WidthFixed, 80);
+        ImGui::TableHeadersRow();
+        for (const auto& timing : timings) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(timing.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", timing.preload_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", timing.initialize_ms);
+        }
+        ImGui::EndTable();
+    }
+
+    void CmdProfiler(const wchar_t*, const int argc, const LPWSTR* argv)
+    {
+        const std::wstring arg = argc > 1 ? argv[1] : L"";
+        if (arg.empty()) {
+            ProfilerModule::SetEnabled(!enabled);
+        }
+        else if (arg == L"on" || arg == L"off") {
+            ProfilerModule::SetEnabled(arg == L"on");
+        }
+        else if (arg == L"reset") {
+            FrameProfiler::Reset();
+            Log::Info("Profiler reset");
+        }
+        else if (arg == L"export") {
+            const auto path = ProfilerModule::ExportTrace();
+            if (path.empty()) {
+                Log::Error("Failed to export profiler trace");
+            }
+            else {
+                Log::Info("Profiler trace written to %s", path.string().c_str());
+            }
+        }
+        else if (arg == L"top") {
+            int count = 5;
+            if (argc > 2) {
+                count = std::clamp(_wtoi(argv[2]), 1, 20);
+            }
+            std::vector<FrameProfiler::ZoneStats> stats;
+            GetStatsByP99(stats);
+            if (stats.empty()) {
+                Log::Info("Nothing profiled yet%s", enabled ? "" : "; use /profiler on");
+                return;
+            }
+            for (size_t i = 0; i < stats.size() && i < static_cast<size_t>(count); i++) {
+                const auto& zone = stats[i];
+                Log::Info("%s %s: p50 %.3fms, p99 %.3fms, max %.3fms", FrameProfiler::PhaseName(zone.phase), zone.name.c_str(), zone.p50, zone.p99, zone.max);
+            }
+        }
+        else if (arg == L"startup") {
+            const auto timings = GetInitTimings();
+            for (size_t i = 0; i < timings.size() && i < 10; i++) {
+                Log::Info("%s: preload %.1fms, initialize %.1fms", timings[i].name, timings[i].preload_ms, timings[i].initialize_ms);
+            }
+        }
+        else {
+            Log::Error("Syntax: /profiler [on|off|reset|export|top [count]|startup]");
+        }
+    }
+}
+
+void ProfilerModule::Initialize()
+{
+    ToolboxModule::Initialize();
+    GW::Chat::CreateCommand(L"profiler", CmdProfiler);
+}
+
+void ProfilerModule::Terminate()
+{
+    ToolboxModule::Terminate();
+    GW::Chat::DeleteCommand(L"profiler");
+    UnhookStoC();
+    FrameProfiler::SetEnabled(false);
+}
+
+void ProfilerModule::LoadSettings(ToolboxIni* ini)
+{
+    ToolboxModule::LoadSettings(ini);
+    SetEnabled(ini->GetBoolValue(Name(), VAR_NAME(enabled), enabled));
+}
+
+void ProfilerModule::SaveSettings(ToolboxIni* ini)
+{
+    ToolboxModule::SaveSettings(ini);
+    SAVE_BOOL(enabled);
+}
+
+void ProfilerModule::SetEnabled(const bool enable)
+{
+    if (enabled == enable) {
+        return;
+    }
+    enabled = enable;
+    FrameProfiler::SetEnabled(enable);
+    if (enable) {
+        HookStoC();
+        Log::Info("Profiler enabled. Use '/profiler top' to see the slowest zones");
+    }
+    else {
+        UnhookStoC();
+        Log::Info("Profiler disabled");
+    }
+}
+
+std::filesystem::path ProfilerModule::ExportTrace()
+{
+    const auto path = Resources::GetPath(std::format(L"profiler_trace_{}.json", time(nullptr)));
+    return FrameProfiler::ExportTrace(path) ? path : std::filesystem::path{};
+}
+
+void ProfilerModule::DrawSettingsInternal()
+{
+    bool enable = enabled;
+    if (ImGui::Checkbox("Profile toolbox frame time", &enable)) {
+        SetEnabled(enable);
+    }
+    ImGui::ShowHelp("Times each module's Update, Draw and WndProc, and toolbox callbacks for each StoC packet.\nAlso available with /profiler [on|off|reset|export|top|startup]");
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        FrameProfiler::Reset();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace")) {
+        const auto path = ExportTrace();
+        if (path.empty()) {
+            Log::Error("Failed to export profiler trace");
+        }
+        else {
+            Log::Info("Profiler trace written to %s", path.string().c_str());
+        }
+    }
+    ImGui::TextDisabled("%zu spans in the trace; open an exported trace in chrome://tracing or ui.perfetto.dev", FrameProfiler::TraceSize());
+
+    if (ImGui::TreeNodeEx("Module startup", ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth)) {
+        ImGui::TextDisabled("Time taken the last time each module was enabled; preloads run in parallel on worker threads");
+        DrawInitTimings();
+        ImGui::TreePop();
+    }
+
+    std::vector<FrameProfiler::ZoneStats> stats;
+    GetStatsByP99(stats);
+    if (stats.empty()) {
+        return;
+    }
+    ImGui::TextDisabled("Over the last %zu calls of each, slowest first:", FrameProfiler::sample_count);
+    constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY;
+    if (!ImGui::BeginTable("profiler_zones", 6, flags, {0, 300.f * ImGui::GetIO().FontGlobalScale})) {
+        return;
+    }
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Phase", ImGuiTableColumnFlags_WidthFixed, 60);
+    ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 70);
+    ImGui::TableSetupColumn("p50 ms", ImGuiTableColumnFlags_WidthFixed, 60);
+    ImGui::TableSetupColumn("p99 ms", ImGuiTableColumnFlags_WidthFixed, 60);
+    ImGui::TableSetupColumn("max ms", ImGuiTableColumnFlags_WidthFixed, 60);
+    ImGui::TableHeadersRow();
+    for (const auto& zone : stats) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(FrameProfiler::PhaseName(zone.phase));
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(zone.name.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", zone.calls);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", zone.p50);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", zone.p99);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", zone.max);
+    }
+    ImGui::EndTable();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <ToolboxModule.h>
+
+// Shows where toolbox spends its frame time, per module; see Utils/FrameProfiler.h
+class ProfilerModule : public ToolboxModule {
+    ProfilerModule() = default;
+    ~ProfilerModule() override = default;
+
+public:
+    static ProfilerModule& Instance()
+    {
+        static ProfilerModule instance;
+        return instance;
+    }
+
+    [[nodiscard]] const char* Name() const override { return "Profiler"; }
+    [[nodiscard]] const char* Description() const override { return " - Frame time spent in each module, and a trace of it that can be opened in chrome://tracing\n - How long each module took to start"; }
+    [[nodiscard]] const char* Icon() const override { return ICON_FA_STOPWATCH; }
+
+    void Initialize() override;
+    void Terminate() override;
+    void LoadSettings(ToolboxIni*) override;
+    void SaveSettings(ToolboxIni*) override;
+    void DrawSettingsInternal() override;
+
+    static void SetEnabled(bool enable);
+    // Writes the trace to the toolbox folder; empty if it couldn't
+    static std::filesystem::path ExportTrace();
+};
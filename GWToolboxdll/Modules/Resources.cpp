@@ -11,16 +11,23 @@
 #include <GWCA/Managers/ItemMgr.h>
 
 
+#include <Defines.h>
 #include <EmbeddedResource.h>
+#include <FileDownloader.h>
 #include <GWToolbox.h>
+#include <ImGuiAddons.h>
 #include <Logger.h>
 #include <Path.h>
 #include <RestClient.h>
+#include <sha1.hpp>
 #include <Str.h>
 
 #include <GWCA/Constants/Constants.h>
 #include <Modules/Resources.h>
+#include <Utils/EncStringCache.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/NetReactor.h>
+#include <Utils/TaskPool.h>
 
 #include <include/nfd.h>
 #include <nfd_common.c>
@@ -69,20 +76,59 @@ namespace {
     const wchar_t* ITEM_IMAGES_PATH = L"img\\items";
     const wchar_t* PROF_ICONS_PATH = L"img\\professions";
 
-    std::recursive_mutex worker_mutex;
-    std::recursive_mutex main_mutex;
-    std::recursive_mutex dx_mutex;
+    std::mutex main_mutex;
+    std::mutex dx_mutex;
 
-    // tasks to be done async by the worker thread
-    std::queue<std::function<void()>> thread_jobs;
+    // tasks to be done async by the worker threads
+    TaskPool worker_pool;
+    // websockets and raw sockets, read on one thread
+    NetReactor net_reactor;
     // tasks to be done in the render thread
-    std::queue<std::function<void(IDirect3DDevice9*)>> dx_jobs;
+    std::deque<std::function<void(IDirect3DDevice9*)>> dx_jobs;
     // tasks to be done in main thread
-    std::queue<std::function<void()>> main_jobs;
+    std::deque<std::function<void()>> main_jobs;
 
-    bool should_stop = false;
+    // Jobs swapped out of the queues above, waiting for time in a later frame. Only touched by the thread that drains them.
+    std::deque<std::function<void(IDirect3DDevice9*)>> dx_jobs_batch;
+    std::deque<std::function<void()>> main_jobs_batch;
 
-    std::vector<std::thread*> workers;
+    // Max time per frame spent running queued jobs; at least one job is always run per frame
+    int main_jobs_budget_us = 2000;
+    int dx_jobs_budget_us = 4000;
+
+    Resources::TaskQueueStats main_jobs_stats;
+    Resources::TaskQueueStats dx_jobs_stats;
+
+    // Move anything newly queued onto the back of the batch under a single lock, then run jobs until the budget is spent
+    template <typename Func, typename... Args>
+    void DrainJobs(std::mutex& mutex, std::deque<Func>& queue, std::deque<Func>& batch, const int budget_us, Resources::TaskQueueStats& stats, Args... args)
+    {
+        {
+            const std::lock_guard lock(mutex);
+            if (batch.empty()) {
+                batch.swap(queue);
+            }
+            else {
+                std::ranges::move(queue, std::back_inserter(batch));
+                queue.clear();
+            }
+        }
+        stats.jobs_run = 0;
+        stats.time_spent_us = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto budget = std::chrono::microseconds(std::max(budget_us, 0));
+        while (!batch.empty()) {
+            const auto func = std::move(batch.front());
+            batch.pop_front();
+            func(args...);
+            stats.jobs_run++;
+            if (std::chrono::steady_clock::now() - start >= budget) {
+                break;
+            }
+        }
+        stats.time_spent_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        stats.backlog = batch.size();
+    }
 
     // snprintf error message, pass to callback as a failure. Used internally.
     void trigger_failure_callback(const std::function<void(bool, const std::wstring&)>& callback, const wchar_t* format, ...)
@@ -111,25 +157,136 @@ namespace {
         }
     }
 
-    void WorkerUpdate()
+    // Async downloads, shared by the public Download overloads and the texture fetchers which need to jump the queue
+    void DownloadAsync(const std::filesystem::path& path_to_file, const std::string& url, Resources::AsyncLoadCallback callback, const TaskPool::Priority priority)
     {
-        while (!should_stop) {
-            worker_mutex.lock();
-            if (thread_jobs.empty()) {
-                worker_mutex.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Resources::EnqueueWorkerTask([path_to_file, url, callback] {
+            std::wstring error_message;
+            bool success = Resources::Download(path_to_file, url, error_message);
+            // and call the callback in the main thread
+            if (callback) {
+                Resources::EnqueueMainTask([callback, success, error_message] {
+                    callback(success, error_message);
+                });
             }
-            else {
-                std::function<void()> func = thread_jobs.front();
-                thread_jobs.pop();
-                worker_mutex.unlock();
-                func();
+            else if (!success) {
+                Log::LogW(L"Failed to download %s from %S\n%S", path_to_file.wstring().c_str(), url.c_str(), error_message.c_str());
+            }
+        }, priority);
+    }
+
+    void DownloadAsync(const std::string& url, Resources::AsyncLoadMbCallback callback, const TaskPool::Priority priority)
+    {
+        Resources::EnqueueWorkerTask([url, callback] {
+            std::string response;
+            bool ok = Resources::Download(url, response);
+            Resources::EnqueueMainTask([callback, ok, response] {
+                callback(ok, response);
+            });
+        }, priority);
+    }
+
+    // DNS lookups and TLS sessions are shared between every blocking request made through Resources
+    std::unique_ptr<CurlShare> curl_share;
+
+    // On-disk cache for GET requests, revalidated with If-None-Match/If-Modified-Since on every download
+    const wchar_t* HTTP_CACHE_PATH = L"cache\\http";
+    // Anything bigger (e.g. dll updates) isn't worth keeping a second copy of
+    constexpr size_t HTTP_CACHE_MAX_ENTRY_SIZE = 2 * 1024 * 1024;
+
+    // Decoded map/skill/npc names etc from last session, so they don't have to be decoded again
+    const wchar_t* DECODED_STRINGS_PATH = L"cache\\decoded_strings.dat";
+
+    struct HttpCacheStats {
+        std::atomic<size_t> hits = 0;
+        std::atomic<size_t> misses = 0;
+        std::atomic<size_t> bytes_downloaded = 0;
+        std::atomic<size_t> connections_opened = 0;
+    } http_cache_stats;
+
+    struct HttpCacheEntry {
+        std::string etag;
+        std::string last_modified;
+        std::string body;
+    };
+
+    // One file per url: a line of json with the url and validators, then the body. Validators and body are swapped in
+    // together, so a request can never revalidate one body against another's ETag.
+    std::filesystem::path HttpCachePath(const std::string& url)
+    {
+        SHA1 checksum;
+        checksum.update(url);
+        auto path = Resources::GetPath(HTTP_CACHE_PATH) / checksum.final();
+        path += ".entry";
+        return path;
+    }
+
+    bool LoadHttpCacheEntry(const std::string& url, HttpCacheEntry& entry)
+    {
+        std::ifstream file(HttpCachePath(url), std::ios::binary);
+        std::string meta_line;
+        if (!(file && std::getline(file, meta_line))) {
+            return false;
+        }
+        const auto meta = nlohmann::json::parse(meta_line, nullptr, false);
+        if (meta.is_discarded() || !meta.is_object() || meta.value("url", "") != url) {
+            return false;
+        }
+        entry.etag = meta.value("etag", "");
+        entry.last_modified = meta.value("last_modified", "");
+        if (entry.etag.empty() && entry.last_modified.empty()) {
+            return false;
+        }
+        entry.body.assign(std::istreambuf_iterator(file), std::istreambuf_iterator<char>());
+        return entry.body.size() == meta.value("size", std::string::npos);
+    }
+
+    void SaveHttpCacheEntry(const std::string& url, const RestClient& r, const std::string& body)
+    {
+        if (body.size() > HTTP_CACHE_MAX_ENTRY_SIZE) {
+            return;
+        }
+        std::string etag, last_modified;
+        r.GetResponseHeader("ETag", etag);
+        r.GetResponseHeader("Last-Modified", last_modified);
+        if (etag.empty() && last_modified.empty()) {
+            return; // Nothing to revalidate against
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(Resources::GetPath(HTTP_CACHE_PATH), ec);
+        if (ec) {
+            return;
+        }
+        const auto path = HttpCachePath(url);
+        // Several workers can fetch the same url at once; write to a temp file then swap it in so readers never see a partial entry
+        auto tmp_path = path;
+        tmp_path += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            nlohmann::json meta;
+            meta["url"] = url;
+            meta["etag"] = etag;
+            meta["last_modified"] = last_modified;
+            meta["size"] = body.size();
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            file << meta.dump() << '\n';
+            file.write(body.data(), static_cast<std::streamsize>(body.size()));
+            if (!file) {
+                file.close();
+                std::filesystem::remove(tmp_path, ec);
+                return;
             }
         }
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp_path, ec);
+        }
     }
 
     void InitRestClient(RestClient* r)
     {
+        if (curl_share) {
+            r->SetShare(curl_share.get());
+        }
         char user_agent_str[32];
         ASSERT(snprintf(user_agent_str, sizeof(user_agent_str), "GWToolboxpp/%s", GWTOOLBOXDLL_VERSION) != -1);
         r->SetUserAgent(user_agent_str);
@@ -143,11 +300,13 @@ namespace {
 Resources::Resources()
 {
     InitCurl();
+    curl_share = std::make_unique<CurlShare>();
 }
 
 Resources::~Resources()
 {
     Cleanup();
+    curl_share.reset();
     ShutdownCurl();
     for (const auto& tex : skill_images | std::views::values) {
         delete tex;
@@ -163,25 +322,36 @@ Resources::~Resources()
     map_names.clear();
 };
 
-void Resources::EnqueueWorkerTask(const std::function<void()>& f)
+void Resources::EnqueueWorkerTask(const std::function<void()>& f, const TaskPool::Priority priority, TaskPool::CancellationToken token)
 {
-    worker_mutex.lock();
-    thread_jobs.push(f);
-    worker_mutex.unlock();
+    worker_pool.Enqueue(f, priority, std::move(token));
+}
+
+NetReactor& Resources::GetNetReactor()
+{
+    return net_reactor;
 }
 
 void Resources::EnqueueMainTask(const std::function<void()>& f)
 {
-    main_mutex.lock();
-    main_jobs.push(f);
-    main_mutex.unlock();
+    const std::lock_guard lock(main_mutex);
+    main_jobs.push_back(f);
 }
 
 void Resources::EnqueueDxTask(const std::function<void(IDirect3DDevice9*)>& f)
 {
-    dx_mutex.lock();
-    dx_jobs.push(f);
-    dx_mutex.unlock();
+    const std::lock_guard lock(dx_mutex);
+    dx_jobs.push_back(f);
+}
+
+const Resources::TaskQueueStats& Resources::GetMainTaskStats()
+{
+    return main_jobs_stats;
+}
+
+const Resources::TaskQueueStats& Resources::GetDxTaskStats()
+{
+    return dx_jobs_stats;
 }
 
 void Resources::OpenFileDialog(std::function<void(const char*)> callback, const char* filterList, const char* defaultPath)
@@ -327,26 +497,21 @@ HRESULT Resources::ResolveShortcut(const std::filesystem::path& in_shortcut_path
 void Resources::Initialize()
 {
     ToolboxModule::Initialize();
-    for (size_t i = 0; i < MAX_WORKERS; i++) {
-        workers.push_back(new std::thread([this] {
-            WorkerUpdate();
-        }));
-    }
+    worker_pool.Start(MAX_WORKERS);
+    net_reactor.Start([](std::function<void()> task) {
+        EnqueueWorkerTask(task);
+    });
     RegisterUIMessageCallback(&OnUIMessage_Hook, GW::UI::UIMessage::kEnumPreference, OnUIMessage, 0x8000);
+    EnqueueWorkerTask([] {
+        EncStringCache::Load(GetPath(DECODED_STRINGS_PATH));
+    }, TaskPool::Priority::High);
 }
 
 void Resources::Cleanup()
 {
-    should_stop = true;
-    for (std::thread* worker : workers) {
-        if (!worker) {
-            continue;
-        }
-        ASSERT(worker->joinable());
-        worker->join();
-        delete worker;
-    }
-    workers.clear();
+    // Before the workers, which may still be connecting a websocket for it
+    net_reactor.Stop();
+    worker_pool.Stop();
     for (const auto& tex : skill_images | std::views::values) {
         delete tex;
     }
@@ -372,14 +537,52 @@ void Resources::Terminate()
 
     GW::UI::RemoveUIMessageCallback(&OnUIMessage_Hook);
 
+    std::error_code ec;
+    std::filesystem::create_directories(GetPath(DECODED_STRINGS_PATH).parent_path(), ec);
+    EncStringCache::Save(GetPath(DECODED_STRINGS_PATH));
+
     Cleanup();
 }
 
+void Resources::LoadSettings(ToolboxIni* ini)
+{
+    ToolboxModule::LoadSettings(ini);
+    main_jobs_budget_us = ini->GetLongValue(Name(), VAR_NAME(main_jobs_budget_us), main_jobs_budget_us);
+    dx_jobs_budget_us = ini->GetLongValue(Name(), VAR_NAME(dx_jobs_budget_us), dx_jobs_budget_us);
+}
+
+void Resources::SaveSettings(ToolboxIni* ini)
+{
+    ToolboxModule::SaveSettings(ini);
+    ini->SetLongValue(Name(), VAR_NAME(main_jobs_budget_us), main_jobs_budget_us);
+    ini->SetLongValue(Name(), VAR_NAME(dx_jobs_budget_us), dx_jobs_budget_us);
+}
+
+void Resources::DrawSettingsInternal()
+{
+    ImGui::SliderInt("Main thread task budget (microseconds per frame)", &main_jobs_budget_us, 0, 16000);
+    ImGui::ShowHelp("Time per frame spent running callbacks from background tasks e.g. downloads.\nAt least one task is always run each frame.");
+    ImGui::SliderInt("Render thread task budget (microseconds per frame)", &dx_jobs_budget_us, 0, 16000);
+    ImGui::ShowHelp("Time per frame spent creating textures.\nAt least one task is always run each frame.");
+    ImGui::Text("Last frame: %zu main tasks in %llu us, %zu queued; %zu render tasks in %llu us, %zu queued",
+                main_jobs_stats.jobs_run, main_jobs_stats.time_spent_us, main_jobs_stats.backlog,
+                dx_jobs_stats.jobs_run, dx_jobs_stats.time_spent_us, dx_jobs_stats.backlog);
+    ImGui::Text("Background tasks pending: %zu", worker_pool.Pending());
+    const auto net_stats = net_reactor.GetStats();
+    ImGui::Text("Network: %zu websockets, %zu other sockets; %llu messages received, %llu wakeups",
+                net_stats.websockets, net_stats.watched, net_stats.messages, net_stats.wakeups);
+    ImGui::Text("HTTP cache: %zu hits, %zu misses, %zu bytes downloaded, %zu connections opened",
+                http_cache_stats.hits.load(), http_cache_stats.misses.load(), http_cache_stats.bytes_downloaded.load(), http_cache_stats.connections_opened.load());
+    const auto decode_stats = EncStringCache::GetStats();
+    const auto decode_requests = decode_stats.hits + decode_stats.misses + decode_stats.coalesced;
+    ImGui::Text("Decoded strings: %zu cached (%zu from last session), %.1f%% hit rate; %llu hits, %llu decoded, %llu waited on another decode",
+                decode_stats.entries, decode_stats.loaded, decode_requests ? 100.0 * static_cast<double>(decode_stats.hits) / static_cast<double>(decode_requests) : 0.0,
+                decode_stats.hits, decode_stats.misses, decode_stats.coalesced);
+}
+
 void Resources::EndLoading() const
 {
-    EnqueueWorkerTask([this] {
-        should_stop = true;
-    });
+    worker_pool.RequestStop();
 }
 
 std::filesystem::path Resources::GetComputerFolderPath()
@@ -439,51 +642,33 @@ utf8::string Resources::GetPathUtf8(const std::wstring& file)
     return Unicode16ToUtf8(path.c_str());
 }
 
-bool Resources::Download(const std::filesystem::path& path_to_file, const std::string& url, std::wstring& response)
+bool Resources::Download(const std::filesystem::path& path_to_file, const std::string& url, std::wstring& response, const uint64_t size, const std::string& sha256)
 {
-    if (exists(path_to_file)) {
-        if (!std::filesystem::remove(path_to_file)) {
-            return StrSwprintf(response, L"Failed to delete existing file %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
-        }
-    }
-    if (exists(path_to_file)) {
-        return StrSwprintf(response, L"File already exists @ %s", path_to_file.wstring().c_str()), false;
-    }
-
-    std::string content;
-    if (!Download(url, content)) {
-        return StrSwprintf(response, L"%S", content.c_str()), false;
-    }
-    if (!content.length()) {
+    // Streamed to "<file>.part" and moved into place once it's all there, so a failed download leaves the old file
+    // alone. Dropped connections are resumed; so are leftovers from another run, but only if they can be checked.
+    FileDownloader downloader;
+    InitRestClient(&downloader);
+    downloader.SetUrl(url.c_str());
+    downloader.SetDestination(path_to_file, size);
+    if (sha256.empty()) {
+        downloader.Discard();
+    }
+    if (!downloader.Run()) {
+        return StrSwprintf(response, L"Failed to download %S: %S", url.c_str(), downloader.GetError().c_str()), false;
+    }
+    if (!downloader.GetReceived()) {
+        downloader.Discard();
         return StrSwprintf(response, L"Failed to download %S, no content length", url.c_str()), false;
     }
-    FILE* fp = fopen(path_to_file.string().c_str(), "wb");
-    if (!fp) {
-        return StrSwprintf(response, L"Failed to call fopen for %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
-    }
-    const auto written = fwrite(content.data(), content.size() + 1, 1, fp);
-    fclose(fp);
-    if (written != 1) {
-        return StrSwprintf(response, L"Failed to call fwrite for %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
+    if (!downloader.Verify(sha256) || !downloader.Commit()) {
+        return StrSwprintf(response, L"Failed to download %S: %S", url.c_str(), downloader.GetError().c_str()), false;
     }
     return true;
 }
 
 void Resources::Download(const std::filesystem::path& path_to_file, const std::string& url, AsyncLoadCallback callback) const
 {
-    EnqueueWorkerTask([this, path_to_file, url, callback] {
-        std::wstring error_message;
-        bool success = Download(path_to_file, url, error_message);
-        // and call the callback in the main thread
-        if (callback) {
-            EnqueueMainTask([callback, success, error_message] {
-                callback(success, error_message);
-            });
-        }
-        else if (!success) {
-            Log::LogW(L"Failed to download %s from %S\n%S", path_to_file.wstring().c_str(), url.c_str(), error_message.c_str());
-        }
-    });
+    DownloadAsync(path_to_file, url, std::move(callback), TaskPool::Priority::Normal);
 }
 
 bool Resources::Download(const std::string& url, std::string& response)
@@ -491,24 +676,37 @@ bool Resources::Download(const std::string& url, std::string& response)
     RestClient r;
     InitRestClient(&r);
     r.SetUrl(url.c_str());
+    HttpCacheEntry cached;
+    const bool has_cached = LoadHttpCacheEntry(url, cached);
+    if (has_cached) {
+        if (!cached.etag.empty()) {
+            r.SetHeader("If-None-Match", cached.etag.c_str());
+        }
+        if (!cached.last_modified.empty()) {
+            r.SetHeader("If-Modified-Since", cached.last_modified.c_str());
+        }
+    }
     r.Execute();
+    http_cache_stats.bytes_downloaded += static_cast<size_t>(r.GetDownloadSize());
+    http_cache_stats.connections_opened += static_cast<size_t>(r.GetNewConnectionCount());
+    if (has_cached && r.GetStatus() == ResponseStatus::Completed && r.GetStatusCode() == 304) {
+        http_cache_stats.hits++;
+        response = std::move(cached.body);
+        return true;
+    }
     if (!r.IsSuccessful()) {
         StrSprintf(response, "Failed to download %s, curl status %d %s", url.c_str(), r.GetStatusCode(), r.GetStatusStr());
         return false;
     }
+    http_cache_stats.misses++;
+    SaveHttpCacheEntry(url, r, r.GetContent());
     response = std::move(r.GetContent());
     return true;
 }
 
 void Resources::Download(const std::string& url, AsyncLoadMbCallback callback) const
 {
-    EnqueueWorkerTask([this, url, callback] {
-        std::string response;
-        bool ok = Download(url, response);
-        EnqueueMainTask([callback, ok, response] {
-            callback(ok, response);
-        });
-    });
+    DownloadAsync(url, std::move(callback), TaskPool::Priority::Normal);
 }
 
 bool Resources::Post(const std::string& url, const std::string& payload, std::string& response)
@@ -543,7 +741,7 @@ void Resources::Post(const std::string& url, const std::string& payload, AsyncLo
     });
 }
 
-void Resources::EnsureFileExists(const std::filesystem::path& path_to_file, const std::string& url, const AsyncLoadCallback& callback)
+void Resources::EnsureFileExists(const std::filesystem::path& path_to_file, const std::string& url, const AsyncLoadCallback& callback, const TaskPool::Priority priority)
 {
     if (exists(path_to_file)) {
         // if file exists, run the callback immediately in the same thread
@@ -551,7 +749,7 @@ void Resources::EnsureFileExists(const std::filesystem::path& path_to_file, cons
     }
     else {
         // otherwise try to download it in the worker
-        Instance().Download(path_to_file, url, callback);
+        DownloadAsync(path_to_file, url, callback, priority);
     }
 }
 
@@ -649,7 +847,7 @@ void Resources::LoadTexture(IDirect3DTexture9** texture, const std::filesystem::
                 Log::LogW(L"Failed to EnsureFileExists %s\n%S", path_to_file.wstring().c_str(), error.c_str());
             }
         }
-    });
+    }, TaskPool::Priority::High);
 }
 
 void Resources::LoadTexture(IDirect3DTexture9** texture, const std::filesystem::path& path_to_file, WORD id, AsyncLoadCallback callback)
@@ -726,30 +924,12 @@ int Resources::SaveIniToFile(const std::filesystem::path& absolute_path, const T
 
 void Resources::DxUpdate(IDirect3DDevice9* device)
 {
-    while (true) {
-        dx_mutex.lock();
-        if (dx_jobs.empty()) {
-            dx_mutex.unlock();
-            return;
-        }
-        const std::function<void(IDirect3DDevice9*)> func = std::move(dx_jobs.front());
-        dx_jobs.pop();
-        dx_mutex.unlock();
-        func(device);
-    }
+    DrainJobs(dx_mutex, dx_jobs, dx_jobs_batch, dx_jobs_budget_us, dx_jobs_stats, device);
 }
 
 void Resources::Update(float)
 {
-    main_mutex.lock();
-    if (main_jobs.empty()) {
-        main_mutex.unlock();
-        return;
-    }
-    const std::function<void()> func = std::move(main_jobs.front());
-    main_jobs.pop();
-    main_mutex.unlock();
-    func();
+    DrainJobs(main_mutex, main_jobs, main_jobs_batch, main_jobs_budget_us, main_jobs_stats);
 }
 
 IDirect3DTexture9** Resources::GetProfessionIcon(GW::Constants::Profession p)
@@ -817,7 +997,7 @@ IDirect3DTexture9** Resources::GetGuildWarsWikiImage(const char* filename, size_
     // No local file found; download from wiki via skill link URL
     std::string wiki_url = "https://wiki.guildwars.com/wiki/File:";
     wiki_url.append(GuiUtils::UrlEncode(filename, '_'));
-    Instance().Download(wiki_url.c_str(), [texture, filename_sanitised, callback, width](const bool ok, const std::string& response) {
+    DownloadAsync(wiki_url.c_str(), [texture, filename_sanitised, callback, width](const bool ok, const std::string& response) {
         if (!ok) {
             callback(ok, GuiUtils::StringToWString(response));
             return; // Already logged whatever errors
@@ -853,7 +1033,7 @@ IDirect3DTexture9** Resources::GetGuildWarsWikiImage(const char* filename, size_
             image_url = tmp_str;
         }
         LoadTexture(texture, path_to_file2, image_url, callback);
-    });
+    }, TaskPool::Priority::High);
     return texture;
 }
 
@@ -904,7 +1084,7 @@ IDirect3DTexture9** Resources::GetSkillImageFromGWW(GW::Constants::SkillID skill
     // No local file found; download from wiki via skill link URL
     char url[128];
     snprintf(url, _countof(url), "https://wiki.guildwars.com/wiki/Game_link:Skill_%d", skill_id);
-    Instance().Download(url, [texture, skill_id, callback](const bool ok, const std::string& response) {
+    DownloadAsync(url, [texture, skill_id, callback](const bool ok, const std::string& response) {
         if (!ok) {
             callback(ok, GuiUtils::StringToWString(response));
             return; // Already logged whatever errors
@@ -953,7 +1133,7 @@ IDirect3DTexture9** Resources::GetSkillImageFromGWW(GW::Constants::SkillID skill
             snprintf(url, _countof(url), "https://wiki.guildwars.com%s%s", image_path.c_str(), image_extension.c_str());
         }
         LoadTexture(texture, path_to_file, url, callback);
-    });
+    }, TaskPool::Priority::High);
     return texture;
 }
 
@@ -1035,7 +1215,7 @@ IDirect3DTexture9** Resources::GetItemImage(const std::wstring& item_name)
 
     // No local file found; download from wiki via searching by the item name; the wiki will usually return a 302 redirect if its an exact item match
     const std::string search_str = GuiUtils::WikiUrl(item_name);
-    Instance().Download(search_str, [texture, item_name, callback](const bool ok, const std::string& response) {
+    DownloadAsync(search_str, [texture, item_name, callback](const bool ok, const std::string& response) {
         if (!ok) {
             callback(ok, GuiUtils::StringToWString(response));
             return;
@@ -1076,6 +1256,6 @@ IDirect3DTexture9** Resources::GetItemImage(const std::wstring& item_name)
             snprintf(url, _countof(url), "https://wiki.guildwars.com%s%s", image_path.c_str(), image_extension.c_str());
         }
         LoadTexture(texture, path_to_file, url, callback);
-    });
+    }, TaskPool::Priority::High);
     return texture;
 }
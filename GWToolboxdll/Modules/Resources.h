@@ -2,6 +2,8 @@
 
 #include <ToolboxModule.h>
 #include <Utf8.h>
+#include <Utils/NetReactor.h>
+#include <Utils/TaskPool.h>
 
 namespace GuiUtils {
     class EncString;
@@ -31,21 +33,35 @@ public:
     }
 
     [[nodiscard]] const char* Name() const override { return "Resources"; }
-    bool HasSettings() override { return false; }
 
     void Initialize() override;
     void Terminate() override;
+    void LoadSettings(ToolboxIni* ini) override;
+    void SaveSettings(ToolboxIni* ini) override;
+    void DrawSettingsInternal() override;
 
     void Update(float delta) override;
     static void DxUpdate(IDirect3DDevice9* device);
 
     // Enqueue instruction to be called on worker thread, away from the render loop e.g. curl requests
-    static void EnqueueWorkerTask(const std::function<void()>& f);
+    // Use TaskPool::Priority::High for anything the user is waiting to see. Task is skipped if token is set before it starts.
+    static void EnqueueWorkerTask(const std::function<void()>& f, TaskPool::Priority priority = TaskPool::Priority::Normal, TaskPool::CancellationToken token = nullptr);
+    // Thread that services every websocket and watched raw socket; connections are made on the worker threads
+    static NetReactor& GetNetReactor();
     // Enqueue instruction to be called on the main update loop of GW
     static void EnqueueMainTask(const std::function<void()>& f);
     // Enqueue instruction to be called on the draw loop of GW e.g. messing with DirectX9 device
     static void EnqueueDxTask(const std::function<void(IDirect3DDevice9*)>& f);
 
+    // Stats for the last frame's drain of the main or dx task queue
+    struct TaskQueueStats {
+        size_t jobs_run = 0;
+        uint64_t time_spent_us = 0;
+        size_t backlog = 0;
+    };
+    static const TaskQueueStats& GetMainTaskStats();
+    static const TaskQueueStats& GetDxTaskStats();
+
     static void OpenFileDialog(std::function<void(const char*)> callback, const char* filterList = nullptr, const char* defaultPath = nullptr);
     static void SaveFileDialog(std::function<void(const char*)> callback, const char* filterList = nullptr, const char* defaultPath = nullptr);
 
@@ -109,10 +125,11 @@ public:
     static GuiUtils::EncString* DecodeStringId(uint32_t enc_str_id);
 
     // Ensure file exists on disk, download from remote location if not found. If an error occurs, details are held in error string
-    static void EnsureFileExists(const std::filesystem::path& path_to_file, const std::string& url, const AsyncLoadCallback& callback);
+    static void EnsureFileExists(const std::filesystem::path& path_to_file, const std::string& url, const AsyncLoadCallback& callback, TaskPool::Priority priority = TaskPool::Priority::Normal);
 
     // download to file, blocking. If an error occurs, details are held in response string
-    static bool Download(const std::filesystem::path& path_to_file, const std::string& url, std::wstring& response);
+    // If sha256 (hex) is given, the file has to match it (and size, if given) and an interrupted earlier download of it is resumed
+    static bool Download(const std::filesystem::path& path_to_file, const std::string& url, std::wstring& response, uint64_t size = 0, const std::string& sha256 = {});
     // download to file, async, calls callback on completion. If an error occurs, details are held in response string
     void Download(const std::filesystem::path& path_to_file, const std::string& url, AsyncLoadCallback callback) const;
     // download to memory, blocking. If an error occurs, details are held in response string
@@ -25,7 +25,6 @@
 #include <Modules/Resources.h>
 #include <Modules/Teamspeak5Module.h>
 
-using easywsclient::WebSocket;
 using nlohmann::json;
 using json_vec = std::vector<json>;
 
@@ -48,11 +47,11 @@ namespace {
     ConnectionStep step = Idle;
 
     bool enabled = true;
-    bool disconnecting = false;
     bool pending_connect = false;
     bool pending_disconnect = false;
-    WSAData wsaData = {0};
-    WebSocket* websocket = nullptr;
+    // Whether the user asked for the connection in progress, so should be told how it went
+    bool connect_user_invoked = false;
+    NetReactor::WebsocketPtr websocket;
 
     struct TS3Server {
         uint32_t my_client_id = 0;
@@ -125,15 +124,9 @@ namespace {
         if (!websocket) {
             return;
         }
-        if (websocket->getReadyState() == WebSocket::OPEN) {
-            websocket->close();
-        }
-        disconnecting = true;
-        while (websocket->getReadyState() != WebSocket::CLOSED) {
-            websocket->poll();
-        }
-        delete websocket;
+        websocket->Close();
         websocket = nullptr;
+        step = Idle;
     }
 
     TS3Server* GetServer(const uint32_t connection_id)
@@ -157,7 +150,7 @@ namespace {
 
     const bool IsConnected()
     {
-        return websocket && websocket->getReadyState() == WebSocket::OPEN;
+        return websocket && websocket->IsOpen();
     }
 
     void GetServerInviteLink(TS3Server* server, std::string channel_id, std::function<void(const std::string&)> callback)
@@ -234,7 +227,7 @@ namespace {
         payload["content"] = content;
         packet["payload"] = payload;
 
-        websocket->send(packet.dump());
+        websocket->Send(packet.dump());
     }
 
     bool Connect(bool user_invoked = false)
@@ -251,36 +244,33 @@ namespace {
             step = Idle;
             return false;
         }
-        int res;
-        if (!wsaData.wVersion && (res = WSAStartup(MAKEWORD(2, 2), &wsaData)) != 0) {
-            if (user_invoked) {
-                Log::Error("Failed to call WSAStartup: %d\n", res);
-            }
-            step = Idle;
-            return false;
-        }
-        step = Connecting;
-        Resources::EnqueueWorkerTask([user_invoked] {
-            websocket = WebSocket::from_url(GetWebsocketHost());
-            if (websocket == nullptr) {
-                if (user_invoked) {
-                    Log::Error("Couldn't connect to the teamspeak 5 websocket; ensure Teamspeak 5 is running and that the 'Remote Apps' feature is enabled");
-                }
-            }
-            else {
-                if (user_invoked) {
-                    Log::Info("Teamspeak 5 connected");
-                }
-                SendTeamspeakHandshake();
-                GW::Chat::CreateCommand(L"ts", OnTeamspeakCommand);
-                GW::Chat::CreateCommand(L"ts5", OnTeamspeakCommand);
-            }
-            step = Idle;
-            pending_connect = false;
-        });
+        connect_user_invoked = user_invoked;
+        websocket = Resources::GetNetReactor().Connect(GetWebsocketHost());
+        // Goes out as soon as it's open; see Teamspeak5Module::Update for the rest
+        SendTeamspeakHandshake();
         return true;
     }
 
+    void OnConnected()
+    {
+        if (connect_user_invoked) {
+            Log::Info("Teamspeak 5 connected");
+        }
+        GW::Chat::CreateCommand(L"ts", OnTeamspeakCommand);
+        GW::Chat::CreateCommand(L"ts5", OnTeamspeakCommand);
+        step = Idle;
+    }
+
+    void OnDisconnected()
+    {
+        if (step == Connecting && connect_user_invoked) {
+            Log::Error("Couldn't connect to the teamspeak 5 websocket; ensure Teamspeak 5 is running and that the 'Remote Apps' feature is enabled");
+        }
+        websocket = nullptr;
+        step = Idle;
+        pending_connect = pending_disconnect = false;
+    }
+
 
     TS3Server* UpsertServer(const json& props_json, const uint32_t connection_id)
     {
@@ -431,12 +421,10 @@ namespace {
         return GetValue(payload, "newChannelId", &server->my_channel_id);
     }
 
-    bool OnWebsocketMessage(const std::string& data)
+    bool OnWebsocketMessage(const json& res)
     {
-        //Log::Log("%s\n", data.c_str());
-        const json& res = json::parse(data.c_str(), nullptr, false);
         if (res == json::value_t::discarded) {
-            Log::Log("ERROR: Failed to parse res JSON from response in websocket->dispatch\n");
+            Log::Log("ERROR: Failed to parse res JSON from teamspeak 5 websocket message\n");
             return false;
         }
         json payload;
@@ -489,10 +477,6 @@ void Teamspeak5Module::Initialize()
 void Teamspeak5Module::Terminate()
 {
     DeleteWebSocket();
-    if (wsaData.wVersion) {
-        WSACleanup();
-        wsaData = {0};
-    }
     GW::Chat::DeleteCommand(L"ts");
 }
 
@@ -525,29 +509,25 @@ void Teamspeak5Module::Update(float)
     }
     if (pending_disconnect) {
         if (websocket) {
-            websocket->close();
+            websocket->Close();
         }
         pending_disconnect = false;
         return;
     }
-    if (websocket) {
-        switch (websocket->getReadyState()) {
-            case WebSocket::OPEN:
-                if (pending_connect) {
-                    pending_connect = pending_disconnect = false;
-                    return;
-                }
-            case WebSocket::CLOSING:
-            case WebSocket::CONNECTING:
-                websocket->poll();
+    // Messages arrive already parsed, from the network thread
+    NetReactor::Websocket::Event event;
+    while (websocket && websocket->Poll(event)) {
+        switch (event.type) {
+            case NetReactor::Websocket::Event::Type::Opened:
+                OnConnected();
+                break;
+            case NetReactor::Websocket::Event::Type::Message:
+                OnWebsocketMessage(event.json);
+                break;
+            case NetReactor::Websocket::Event::Type::Closed:
+                OnDisconnected();
                 break;
-            case WebSocket::CLOSED:
-                delete websocket;
-                websocket = nullptr;
-                pending_connect = pending_disconnect = false;
-                return;
         }
-        websocket->dispatch(OnWebsocketMessage);
     }
 }
 
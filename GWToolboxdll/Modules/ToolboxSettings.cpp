@@ -199,26 +199,42 @@ void ToolboxSettings::LoadModules(ToolboxIni* ini)
 
     inifile = ini;
 
+    std::vector<ToolboxModule*> to_enable;
 #ifdef _DEBUG
 #if 0
-    GWToolbox::ToggleModule(PartySearchWindow::Instance());
-    GWToolbox::ToggleModule(GWFileRequester::Instance());
+    to_enable.push_back(&PartySearchWindow::Instance());
+    to_enable.push_back(&GWFileRequester::Instance());
 #endif
-    GWToolbox::ToggleModule(PacketLoggerWindow::Instance());
-    GWToolbox::ToggleModule(StringDecoderWindow::Instance());
-    GWToolbox::ToggleModule(DoorMonitorWindow::Instance());
-    GWToolbox::ToggleModule(SkillListingWindow::Instance());
+    to_enable.push_back(&PacketLoggerWindow::Instance());
+    to_enable.push_back(&StringDecoderWindow::Instance());
+    to_enable.push_back(&DoorMonitorWindow::Instance());
+    to_enable.push_back(&SkillListingWindow::Instance());
 #endif
     for (const auto& m : optional_modules) {
-        GWToolbox::ToggleModule(*m.toolbox_module, m.enabled);
+        if (m.enabled) {
+            to_enable.push_back(m.toolbox_module);
+        }
+        else {
+            GWToolbox::ToggleModule(*m.toolbox_module, false);
+        }
     }
-
     for (const auto& m : optional_windows) {
-        GWToolbox::ToggleModule(*m.toolbox_module, m.enabled);
+        if (m.enabled) {
+            to_enable.push_back(m.toolbox_module);
+        }
+        else {
+            GWToolbox::ToggleModule(*m.toolbox_module, false);
+        }
     }
     for (const auto& m : optional_widgets) {
-        GWToolbox::ToggleModule(*m.toolbox_module, m.enabled);
+        if (m.enabled) {
+            to_enable.push_back(m.toolbox_module);
+        }
+        else {
+            GWToolbox::ToggleModule(*m.toolbox_module, false);
+        }
     }
+    GWToolbox::EnableModules(to_enable);
 }
 
 void ToolboxSettings::DrawSettingsInternal()
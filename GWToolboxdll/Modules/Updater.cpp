@@ -1,8 +1,10 @@
 #include "stdafx.h"
 
 #include <Utils/GuiUtils.h>
+#include <Delta.h>
 #include <GWToolbox.h>
 #include <Logger.h>
+#include <Sha256.h>
 
 #include <Modules/Resources.h>
 #include <Modules/Updater.h>
@@ -40,6 +42,11 @@ namespace {
         std::string version;
         std::string download_url;
         uintmax_t size = 0;
+        std::string asset_name;
+        // Hex, if the release lists it
+        std::string sha256;
+        // Deltas from earlier builds to this one, by asset name
+        std::unordered_map<std::string, std::string> delta_urls;
     };
 
     GWToolboxRelease latest_release;
@@ -80,6 +87,8 @@ namespace {
             if (!(js.contains("body") && js["body"].is_string())) {
                 continue;
             }
+            bool found = false;
+            release->delta_urls.clear();
             for (unsigned int j = 0; j < js["assets"].size(); j++) {
                 const Json& asset = js["assets"][j];
                 if (!(asset.contains("name") && asset["name"].is_string())
@@ -87,13 +96,29 @@ namespace {
                     continue;
                 }
                 auto asset_name = asset["name"].get<std::string>();
-                if (asset_name != "GWToolbox.dll" && asset_name != "GWToolboxdll.dll") {
-                    continue; // This release doesn't have a dll download.
+                if (asset_name.ends_with(".delta")) {
+                    release->delta_urls[asset_name] = asset["browser_download_url"].get<std::string>();
+                    continue;
+                }
+                if (found || (asset_name != "GWToolbox.dll" && asset_name != "GWToolboxdll.dll")) {
+                    continue;
                 }
+                found = true;
                 release->download_url = asset["browser_download_url"].get<std::string>();
                 release->version = tag_name.substr(0, version_number_len);
                 release->body = js["body"].get<std::string>();
                 release->size = asset["size"].get<uintmax_t>();
+                release->asset_name = asset_name;
+                release->sha256.clear();
+                // "sha256:<hex>"
+                if (asset.contains("digest") && asset["digest"].is_string()) {
+                    const auto digest = asset["digest"].get<std::string>();
+                    if (digest.starts_with("sha256:")) {
+                        release->sha256 = digest.substr(7);
+                    }
+                }
+            }
+            if (found) {
                 return release;
             }
         }
@@ -132,6 +157,33 @@ namespace {
         return update_available_text;
     }
 
+    // Only the changes since the dll we're running, if the release published a delta from it
+    bool UpdateFromDelta(const std::wstring& installed_path, const std::wstring& dll_path, const GWToolboxRelease& release)
+    {
+        if (release.delta_urls.empty()) {
+            return false;
+        }
+        std::string installed_sha256;
+        if (!Sha256File(installed_path.c_str(), installed_sha256)) {
+            return false;
+        }
+        const auto found = release.delta_urls.find(DeltaFileName(release.asset_name.c_str(), installed_sha256));
+        if (found == release.delta_urls.end()) {
+            return false;
+        }
+        std::string delta;
+        if (!Resources::Download(found->second, delta)) {
+            Log::Log("Failed to download %s\n%s", found->first.c_str(), delta.c_str());
+            return false;
+        }
+        if (!DeltaApplyFile(installed_path.c_str(), reinterpret_cast<const uint8_t*>(delta.data()), delta.size(), dll_path.c_str(), release.sha256)) {
+            Log::Log("Failed to apply %s\n", found->first.c_str());
+            return false;
+        }
+        Log::Log("Updated with %s (%zu bytes instead of %ju)\n", found->first.c_str(), delta.size(), release.size);
+        return true;
+    }
+
     void DoUpdate()
     {
         Log::Warning("Downloading update...");
@@ -173,10 +225,14 @@ namespace {
         DeleteFileW(dllold.c_str());
         MoveFileW(dllfile, dllold.c_str());
 
-        // 2. download new dll
-        Resources::Instance().Download(
-            dllfile, latest_release.download_url,
-            [wdll = std::wstring(dllfile), dllold](const bool success, const std::wstring& error) -> void {
+        // 2. download new dll: a delta from the one we're running if there is one, otherwise the whole thing
+        Resources::EnqueueWorkerTask([wdll = std::wstring(dllfile), dllold, release = latest_release] {
+            std::wstring error;
+            bool success = UpdateFromDelta(dllold, wdll, release);
+            if (!success) {
+                success = Resources::Download(wdll, release.download_url, error, release.size, release.sha256);
+            }
+            Resources::EnqueueMainTask([wdll, dllold, success, error] {
                 if (success) {
                     step = Success;
                     Log::WarningW(L"Update successful, please restart toolbox.");
@@ -187,6 +243,7 @@ namespace {
                     step = Done;
                 }
             });
+        });
     }
 }
 
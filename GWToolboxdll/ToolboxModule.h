@@ -46,6 +46,13 @@ public:
     // Readable array of modules currently loaded
     static const std::unordered_map<std::string, ToolboxModule*>& GetModulesLoaded();
 
+    // Modules that have to be initialized before this one when they're enabled together
+    [[nodiscard]] virtual std::vector<ToolboxModule*> GetDependencies() { return {}; }
+
+    // Slow setup that doesn't touch game state, ImGui or other modules, e.g. signature scans, reading and parsing files.
+    // Runs on a worker thread, alongside other modules' Preload, before Initialize.
+    virtual void Preload() { }
+
     // Initialize module
     virtual void Initialize();
 
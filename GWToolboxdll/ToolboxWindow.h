@@ -15,6 +15,18 @@ public:
     {
         ToolboxUIElement::Initialize();
         has_closebutton = true;
+        content_initialized = false;
+    }
+
+    // Setup that's only needed to draw the window, e.g. its textures. Deferred until the window is first shown.
+    virtual void InitializeContent() { }
+
+    void EnsureContentInitialized()
+    {
+        if (!content_initialized) {
+            content_initialized = true;
+            InitializeContent();
+        }
     }
 
     void LoadSettings(ToolboxIni* ini) override
@@ -34,4 +46,7 @@ public:
     }
 
     [[nodiscard]] virtual ImGuiWindowFlags GetWinFlags(ImGuiWindowFlags flags = 0) const;
+
+private:
+    bool content_initialized = false;
 };
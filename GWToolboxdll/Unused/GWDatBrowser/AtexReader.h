@@ -1,7 +1,6 @@
 #pragma once
 
 #include <gdiplus.h>
-#include "AtexReader.h"
 
 union RGBA
 {
@@ -9,7 +8,7 @@ union RGBA
 	struct { unsigned char r, g, b, a; };
 	unsigned int dw;
 };
-bool ProcessImageFile(unsigned char* img, int size, Gdiplus::Bitmap* image);
+bool ProcessImageFile(unsigned char* img, int size, Gdiplus::Bitmap** image);
 
 
 
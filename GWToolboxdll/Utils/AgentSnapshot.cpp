@@ -0,0 +1,185 @@
+#include <stdafx.h>
+
+#include <GWCA/GameContainers/Array.h>
+#include <GWCA/GameEntities/Agent.h>
+#include <GWCA/GameEntities/Item.h>
+#include <GWCA/Managers/AgentMgr.h>
+#include <GWCA/Managers/ItemMgr.h>
+
+#include "AgentSnapshot.h"
+
+namespace {
+    // Keeps the grid small even when agents are spread over the whole map; cells grow instead
+    constexpr int max_grid_size = 128;
+    constexpr float min_cell_size = 1000.f;
+
+    AgentSnapshot snapshot;
+    uint32_t frame = 1;
+    uint32_t snapshot_frame = 0;
+}
+
+const AgentSnapshot& AgentSnapshot::Get()
+{
+    if (snapshot_frame != frame) {
+        snapshot.Take();
+        snapshot_frame = frame;
+    }
+    return snapshot;
+}
+
+void AgentSnapshot::NextFrame()
+{
+    frame++;
+}
+
+size_t AgentSnapshot::IndexOf(const uint32_t agent_id) const
+{
+    if (agent_id >= index_by_id.size() || !index_by_id[agent_id]) {
+        return npos;
+    }
+    return index_by_id[agent_id] - 1;
+}
+
+void AgentSnapshot::Clear()
+{
+    agent_ids.clear();
+    flags.clear();
+    model_ids.clear();
+    allegiances.clear();
+    hp.clear();
+    positions.clear();
+    index_by_id.clear();
+    me = npos;
+    columns = rows = 0;
+    cell_start.clear();
+    cell_agents.clear();
+}
+
+void AgentSnapshot::Add(const uint32_t agent_id, const uint16_t agent_flags, const uint32_t model_id, const uint8_t allegiance, const float agent_hp, const GW::Vec2f pos)
+{
+    if (agent_flags & Me) {
+        me = agent_ids.size();
+    }
+    agent_ids.push_back(agent_id);
+    flags.push_back(agent_flags);
+    model_ids.push_back(model_id);
+    allegiances.push_back(allegiance);
+    hp.push_back(agent_hp);
+    positions.push_back(pos);
+}
+
+void AgentSnapshot::Take()
+{
+    Clear();
+    const GW::AgentArray* agents = GW::Agents::GetAgentArray();
+    if (!agents) {
+        Index();
+        return;
+    }
+    const GW::Agent* player = GW::Agents::GetPlayer();
+    for (const GW::Agent* agent : *agents) {
+        if (!agent) {
+            continue;
+        }
+        uint16_t agent_flags = 0;
+        uint32_t model_id = 0;
+        uint8_t allegiance = 0;
+        float agent_hp = 0.f;
+        if (GW::Agents::GetIsAgentTargettable(agent)) {
+            agent_flags |= Targettable;
+        }
+        if (agent == player) {
+            agent_flags |= Me;
+        }
+        if (const auto living = agent->GetAsAgentLiving()) {
+            agent_flags |= Living;
+            agent_flags |= living->GetIsDead() ? Dead : 0;
+            agent_flags |= living->GetIsAlive() ? Alive : 0;
+            agent_flags |= living->IsPlayer() ? Player : 0;
+            agent_flags |= living->IsNPC() ? Npc : 0;
+            model_id = living->player_number;
+            allegiance = static_cast<uint8_t>(living->allegiance);
+            agent_hp = living->hp;
+        }
+        else if (const auto gadget = agent->GetAsAgentGadget()) {
+            agent_flags |= Gadget;
+            model_id = gadget->gadget_id;
+        }
+        else if (const auto item_agent = agent->GetAsAgentItem()) {
+            agent_flags |= Item;
+            const auto item = GW::Items::GetItemById(item_agent->item_id);
+            model_id = item ? item->model_id : 0;
+        }
+        Add(agent->agent_id, agent_flags, model_id, allegiance, agent_hp, {agent->pos.x, agent->pos.y});
+    }
+    Index();
+}
+
+void AgentSnapshot::Index()
+{
+    index_by_id.clear();
+    cell_start.clear();
+    cell_agents.clear();
+    columns = rows = 0;
+    if (agent_ids.empty()) {
+        return;
+    }
+    index_by_id.resize(*std::ranges::max_element(agent_ids) + 1, 0);
+    for (size_t i = 0; i < agent_ids.size(); i++) {
+        index_by_id[agent_ids[i]] = static_cast<uint32_t>(i + 1);
+    }
+
+    float min_x = positions[0].x, min_y = positions[0].y;
+    float max_x = min_x, max_y = min_y;
+    for (const auto& pos : positions) {
+        min_x = std::min(min_x, pos.x);
+        min_y = std::min(min_y, pos.y);
+        max_x = std::max(max_x, pos.x);
+        max_y = std::max(max_y, pos.y);
+    }
+    origin_x = min_x;
+    origin_y = min_y;
+    cell_size = std::max({min_cell_size, (max_x - min_x) / max_grid_size, (max_y - min_y) / max_grid_size});
+    columns = std::min(static_cast<int>((max_x - min_x) / cell_size) + 1, max_grid_size);
+    rows = std::min(static_cast<int>((max_y - min_y) / cell_size) + 1, max_grid_size);
+
+    // Counting sort of agents by cell
+    cell_start.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    static std::vector<uint32_t> agent_cells;
+    agent_cells.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        const int x = std::clamp(CellX(positions[i].x), 0, columns - 1);
+        const int y = std::clamp(CellY(positions[i].y), 0, rows - 1);
+        agent_cells[i] = static_cast<uint32_t>(y * columns + x);
+        cell_start[agent_cells[i] + 1]++;
+    }
+    for (size_t c = 1; c < cell_start.size(); c++) {
+        cell_start[c] += cell_start[c - 1];
+    }
+    cell_agents.resize(positions.size());
+    static std::vector<uint32_t> next_slot;
+    next_slot.assign(cell_start.begin(), cell_start.end() - 1);
+    for (size_t i = 0; i < positions.size(); i++) {
+        cell_agents[next_slot[agent_cells[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+int AgentSnapshot::CellX(const float x) const
+{
+    return static_cast<int>(std::floor(std::clamp((x - origin_x) / cell_size, -1e6f, 1e6f)));
+}
+
+int AgentSnapshot::CellY(const float y) const
+{
+    return static_cast<int>(std::floor(std::clamp((y - origin_y) / cell_size, -1e6f, 1e6f)));
+}
+
+AgentSnapshot::CellRange AgentSnapshot::CellsAround(const GW::Vec2f pos, const float radius) const
+{
+    return {
+        std::max(CellX(pos.x - radius), 0),
+        std::max(CellY(pos.y - radius), 0),
+        std::min(CellX(pos.x + radius), columns - 1),
+        std::min(CellY(pos.y + radius), rows - 1)
+    };
+}
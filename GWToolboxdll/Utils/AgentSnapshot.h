@@ -0,0 +1,235 @@
+#pragma once
+
+#include <GWCA/GameContainers/GamePos.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Compact copy of the agent array, taken at most once per frame, with a uniform grid over agent positions.
+// Targeting and rendering code queries this instead of walking GW::AgentArray and re-checking agent types themselves.
+// Agents are stored in agent array order (i.e. by agent id) as parallel arrays; queries return indices into them.
+// Only use from the game thread.
+class AgentSnapshot {
+public:
+    enum Flags : uint16_t {
+        Living = 1 << 0,
+        Item = 1 << 1,
+        Gadget = 1 << 2,
+        Dead = 1 << 3,
+        Targettable = 1 << 4,
+        Player = 1 << 5,
+        Npc = 1 << 6,
+        Me = 1 << 7,
+        // Not the same as !Dead; see GW::AgentLiving::GetIsAlive
+        Alive = 1 << 8
+    };
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    // Snapshot for the current frame, taken on first use
+    static const AgentSnapshot& Get();
+    // Called once per frame from the game thread so that the next Get() takes a fresh snapshot
+    static void NextFrame();
+
+    [[nodiscard]] size_t size() const { return agent_ids.size(); }
+    [[nodiscard]] bool empty() const { return agent_ids.empty(); }
+    // Index of the agent with this id, or npos if it wasn't in the snapshot
+    [[nodiscard]] size_t IndexOf(uint32_t agent_id) const;
+    // Index of the player's own agent, or npos
+    [[nodiscard]] size_t MyIndex() const { return me; }
+
+    // True if agent i has any of the given flags
+    [[nodiscard]] bool Is(const size_t i, const uint16_t flag) const { return (flags[i] & flag) != 0; }
+
+    std::vector<uint32_t> agent_ids;
+    std::vector<uint16_t> flags;
+    // Living: player number (model id); gadget: gadget id; item: item model id
+    std::vector<uint32_t> model_ids;
+    std::vector<uint8_t> allegiances;
+    std::vector<float> hp;
+    std::vector<GW::Vec2f> positions;
+
+    // Closest agent within range of pos for which filter(index) is true, or npos
+    template <typename Filter>
+    [[nodiscard]] size_t Nearest(GW::Vec2f pos, float range, Filter&& filter) const;
+    // Up to k closest agents within range of pos, closest first
+    template <typename Filter>
+    size_t KNearest(GW::Vec2f pos, size_t k, float range, Filter&& filter, std::vector<size_t>& out) const;
+    // Every agent within radius of pos, in agent array order
+    template <typename Filter>
+    size_t WithinRadius(GW::Vec2f pos, float radius, Filter&& filter, std::vector<size_t>& out) const;
+    // Every agent inside the polygon (any winding, not self intersecting), in agent array order
+    template <typename Filter>
+    size_t InPolygon(const std::vector<GW::Vec2f>& polygon, Filter&& filter, std::vector<size_t>& out) const;
+
+    // Building blocks for Get(); also lets a snapshot be filled from something other than the live agent array.
+    void Clear();
+    void Add(uint32_t agent_id, uint16_t agent_flags, uint32_t model_id, uint8_t allegiance, float agent_hp, GW::Vec2f pos);
+    // Build the grid; call after the last Add()
+    void Index();
+
+private:
+    struct CellRange {
+        int min_x, min_y, max_x, max_y;
+    };
+
+    void Take();
+    [[nodiscard]] CellRange CellsAround(GW::Vec2f pos, float radius) const;
+    [[nodiscard]] int CellX(float x) const;
+    [[nodiscard]] int CellY(float y) const;
+    template <typename Visit>
+    void ForEachInCells(const CellRange& range, Visit&& visit) const;
+
+    size_t me = npos;
+    // agent id => index + 1, 0 if absent
+    std::vector<uint32_t> index_by_id;
+
+    // Grid over the bounding box of all agents; cell_start[c]..cell_start[c + 1] indexes cell_agents for cell c
+    float cell_size = 1000.f;
+    float origin_x = 0.f;
+    float origin_y = 0.f;
+    int columns = 0;
+    int rows = 0;
+    std::vector<uint32_t> cell_start;
+    std::vector<uint32_t> cell_agents;
+
+    // Scratch for KNearest
+    mutable std::vector<std::pair<float, size_t>> candidates;
+};
+
+template <typename Visit>
+void AgentSnapshot::ForEachInCells(const CellRange& range, Visit&& visit) const
+{
+    for (int y = range.min_y; y <= range.max_y; y++) {
+        for (int x = range.min_x; x <= range.max_x; x++) {
+            const size_t cell = static_cast<size_t>(y) * columns + x;
+            for (uint32_t j = cell_start[cell]; j < cell_start[cell + 1]; j++) {
+                visit(static_cast<size_t>(cell_agents[j]));
+            }
+        }
+    }
+}
+
+template <typename Filter>
+size_t AgentSnapshot::Nearest(const GW::Vec2f pos, const float range, Filter&& filter) const
+{
+    const CellRange limit = CellsAround(pos, range);
+    if (!columns || limit.min_x > limit.max_x || limit.min_y > limit.max_y) {
+        return npos;
+    }
+    // Search rings of cells outwards from pos until nothing closer than the best so far can be in the next ring
+    const int cx = CellX(pos.x);
+    const int cy = CellY(pos.y);
+    float best_distance = range * range;
+    size_t best = npos;
+    for (int ring = 0;; ring++) {
+        const CellRange cells = {cx - ring, cy - ring, cx + ring, cy + ring};
+        if (cells.min_x < limit.min_x && cells.min_y < limit.min_y && cells.max_x > limit.max_x && cells.max_y > limit.max_y) {
+            break;
+        }
+        for (int y = std::max(cells.min_y, limit.min_y); y <= std::min(cells.max_y, limit.max_y); y++) {
+            // Only the edge of the ring; the inside was searched already
+            const bool edge_row = y == cells.min_y || y == cells.max_y;
+            const int step = edge_row ? 1 : cells.max_x - cells.min_x;
+            for (int x = cells.min_x; x <= cells.max_x; x += std::max(step, 1)) {
+                if (x < limit.min_x || x > limit.max_x) {
+                    continue;
+                }
+                const size_t cell = static_cast<size_t>(y) * columns + x;
+                for (uint32_t j = cell_start[cell]; j < cell_start[cell + 1]; j++) {
+                    const size_t i = cell_agents[j];
+                    const float distance = GetSquareDistance(pos, positions[i]);
+                    if (distance < best_distance && filter(i)) {
+                        best_distance = distance;
+                        best = i;
+                    }
+                }
+            }
+        }
+        // Anything in the next ring is at least ring * cell_size away
+        const float ring_distance = static_cast<float>(ring) * cell_size;
+        if (best != npos && ring_distance * ring_distance > best_distance) {
+            break;
+        }
+    }
+    return best;
+}
+
+template <typename Filter>
+size_t AgentSnapshot::KNearest(const GW::Vec2f pos, const size_t k, const float range, Filter&& filter, std::vector<size_t>& out) const
+{
+    out.clear();
+    if (!columns || !k) {
+        return 0;
+    }
+    candidates.clear();
+    const float max_distance = range * range;
+    ForEachInCells(CellsAround(pos, range), [&](const size_t i) {
+        const float distance = GetSquareDistance(pos, positions[i]);
+        if (distance <= max_distance && filter(i)) {
+            candidates.emplace_back(distance, i);
+        }
+    });
+    const size_t count = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    for (size_t j = 0; j < count; j++) {
+        out.push_back(candidates[j].second);
+    }
+    return out.size();
+}
+
+template <typename Filter>
+size_t AgentSnapshot::WithinRadius(const GW::Vec2f pos, const float radius, Filter&& filter, std::vector<size_t>& out) const
+{
+    out.clear();
+    if (!columns) {
+        return 0;
+    }
+    const float max_distance = radius * radius;
+    ForEachInCells(CellsAround(pos, radius), [&](const size_t i) {
+        if (GetSquareDistance(pos, positions[i]) <= max_distance && filter(i)) {
+            out.push_back(i);
+        }
+    });
+    std::ranges::sort(out);
+    return out.size();
+}
+
+template <typename Filter>
+size_t AgentSnapshot::InPolygon(const std::vector<GW::Vec2f>& polygon, Filter&& filter, std::vector<size_t>& out) const
+{
+    out.clear();
+    if (!columns || polygon.size() < 3) {
+        return 0;
+    }
+    GW::Vec2f min = polygon[0];
+    GW::Vec2f max = polygon[0];
+    for (const auto& p : polygon) {
+        min.x = std::min(min.x, p.x);
+        min.y = std::min(min.y, p.y);
+        max.x = std::max(max.x, p.x);
+        max.y = std::max(max.y, p.y);
+    }
+    const CellRange cells = {std::max(CellX(min.x), 0), std::max(CellY(min.y), 0), std::min(CellX(max.x), columns - 1), std::min(CellY(max.y), rows - 1)};
+    ForEachInCells(cells, [&](const size_t i) {
+        const GW::Vec2f& p = positions[i];
+        if (p.x < min.x || p.x > max.x || p.y < min.y || p.y > max.y) {
+            return;
+        }
+        // Even-odd rule
+        bool inside = false;
+        for (size_t a = 0, b = polygon.size() - 1; a < polygon.size(); b = a++) {
+            const GW::Vec2f& pa = polygon[a];
+            const GW::Vec2f& pb = polygon[b];
+            if ((pa.y > p.y) != (pb.y > p.y) && p.x < (pb.x - pa.x) * (p.y - pa.y) / (pb.y - pa.y) + pa.x) {
+                inside = !inside;
+            }
+        }
+        if (inside && filter(i)) {
+            out.push_back(i);
+        }
+    });
+    std::ranges::sort(out);
+    return out.size();
+}
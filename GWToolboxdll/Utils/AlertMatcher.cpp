@@ -0,0 +1,108 @@
+#include <stdafx.h>
+
+#include "AlertMatcher.h"
+
+namespace {
+    constexpr auto regex_flags = std::regex::ECMAScript | std::regex::icase;
+
+    wchar_t FoldByte(const char c)
+    {
+        return static_cast<wchar_t>(tolower(static_cast<unsigned char>(c)));
+    }
+
+    bool HasBackReference(const std::string& pattern)
+    {
+        for (size_t i = 0; i + 1 < pattern.size(); i++) {
+            if (pattern[i] != '\\') {
+                continue;
+            }
+            if (pattern[i + 1] >= '1' && pattern[i + 1] <= '9') {
+                return true;
+            }
+            i++;
+        }
+        return false;
+    }
+}
+
+void AlertMatcher::Clear()
+{
+    keywords.Clear();
+    combined_regex = {};
+    has_combined_regex = false;
+    separate_regexes.clear();
+}
+
+void AlertMatcher::Compile(const char* text)
+{
+    Clear();
+    static const auto regex_check = std::regex("^/(.*)/[a-z]?$", regex_flags);
+
+    std::vector<std::string> patterns;
+    std::istringstream stream(text);
+    std::string line;
+    std::smatch m;
+    while (std::getline(stream, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::ranges::transform(line, line.begin(), [](const char c) {
+            return static_cast<char>(FoldByte(c));
+        });
+        if (!std::regex_search(line, m, regex_check)) {
+            std::wstring folded;
+            std::ranges::transform(line, std::back_inserter(folded), FoldByte);
+            keywords.Add(folded);
+            continue;
+        }
+        const auto pattern = m[1].str();
+        try {
+            // Compile on its own first, so that one bad line doesn't break the combined program
+            std::regex regex(pattern, regex_flags);
+            if (HasBackReference(pattern)) {
+                separate_regexes.push_back(std::move(regex));
+                continue;
+            }
+        } catch (const std::regex_error&) {
+            // Silent fail; invalid regex
+            continue;
+        }
+        patterns.push_back(pattern);
+    }
+    if (patterns.empty()) {
+        return;
+    }
+    std::string combined;
+    for (const auto& pattern : patterns) {
+        if (!combined.empty()) {
+            combined += '|';
+        }
+        combined += "(?:" + pattern + ")";
+    }
+    try {
+        combined_regex = std::regex(combined, regex_flags | std::regex::optimize);
+        has_combined_regex = true;
+    } catch (const std::regex_error&) {
+        // Each part compiled on its own, so fall back to running them one at a time
+        for (const auto& pattern : patterns) {
+            separate_regexes.emplace_back(pattern, regex_flags);
+        }
+    }
+}
+
+bool AlertMatcher::Matches(const std::string_view message)
+{
+    if (!keywords.empty()) {
+        folded_message.clear();
+        std::ranges::transform(message, std::back_inserter(folded_message), FoldByte);
+        if (keywords.FindAll(folded_message, found)) {
+            return true;
+        }
+    }
+    if (has_combined_regex && std::regex_search(message.begin(), message.end(), combined_regex)) {
+        return true;
+    }
+    return std::ranges::any_of(separate_regexes, [message](const std::regex& regex) {
+        return std::regex_search(message.begin(), message.end(), regex);
+    });
+}
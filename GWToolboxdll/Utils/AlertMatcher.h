@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Utils/StringReplacer.h>
+
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Alert keyword list shared by the trade and party search windows, compiled once whenever the list changes.
+// One alert per line: /pattern/ lines are case insensitive ECMAScript regexes, anything else matches case insensitively anywhere
+// in the message. Plain keywords are searched for together in one pass; the regexes are joined into a single alternation
+// (except any using back references, which can't be renumbered) so a message is matched by one regex program.
+class AlertMatcher {
+public:
+    // Replace the alert list with the lines in text. Invalid regexes are skipped.
+    void Compile(const char* text);
+    void Clear();
+    [[nodiscard]] bool empty() const { return keywords.empty() && !has_combined_regex && separate_regexes.empty(); }
+
+    // Does message (UTF-8) match any alert?
+    bool Matches(std::string_view message);
+
+private:
+    // Keywords lowercased, one wchar_t per byte of UTF-8
+    StringReplacer keywords;
+    std::regex combined_regex;
+    bool has_combined_regex = false;
+    std::vector<std::regex> separate_regexes;
+
+    std::wstring folded_message;
+    std::vector<bool> found;
+};
@@ -0,0 +1,709 @@
+#include <stdafx.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
+
+#include "AtexDecoder.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ATEX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr size_t header_size = 12;
+
+    // Image format codes the game's decoder uses internally; the ATEX passes below are keyed on them
+    constexpr uint32_t FORMAT_DXT1 = 0xF;
+    constexpr uint32_t FORMAT_DXT3 = 0x11;
+    constexpr uint32_t FORMAT_DXTL = 0x12;
+    constexpr uint32_t FORMAT_DXT5 = 0x13;
+
+    uint32_t FormatCode(const AtexDecoder::Format format)
+    {
+        switch (format) {
+            case AtexDecoder::Format::DXT1:
+                return FORMAT_DXT1;
+            case AtexDecoder::Format::DXT3:
+                return FORMAT_DXT3;
+            case AtexDecoder::Format::DXT5:
+                return FORMAT_DXT5;
+            case AtexDecoder::Format::DXTL:
+                return FORMAT_DXTL;
+            default:
+                return 0;
+        }
+    }
+
+    uint32_t LoadWord(const uint8_t* p)
+    {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        return word;
+    }
+
+    // Run length codes, indexed by the top 6 bits of the stream: '1' = 1 block, '01' = 18 blocks, '00xxxx' = 17 - xxxx blocks
+    struct RunLengthCode {
+        uint8_t bits;
+        uint8_t run;
+    };
+
+    constexpr auto run_length_codes = [] {
+        std::array<RunLengthCode, 64> codes{};
+        for (uint8_t i = 0; i < 64; i++) {
+            if (i < 16) {
+                codes[i] = {6, static_cast<uint8_t>(17 - i)};
+            }
+            else if (i < 32) {
+                codes[i] = {2, 18};
+            }
+            else {
+                codes[i] = {1, 1};
+            }
+        }
+        return codes;
+    }();
+
+    // MSB-first reader over the compressed stream. Keeps a 64 bit window in cur:next, refilled a word at a time,
+    // exactly as the game's reader does - including reading zeros once the stream runs out.
+    struct BitReader {
+        const uint8_t* pos = nullptr;
+        const uint8_t* end = nullptr;
+        uint32_t avail = 0;
+        uint32_t cur = 0;
+        uint32_t next = 0;
+
+        void Skip(const uint32_t n)
+        {
+            if (n) {
+                cur = (cur << n) | (next >> (32 - n));
+            }
+            if (n <= avail) {
+                next <<= n;
+                avail -= n;
+            }
+            else if (pos != end) {
+                const uint32_t word = LoadWord(pos);
+                pos += 4;
+                const uint32_t k = n - avail;
+                cur |= word >> (32 - k);
+                next = word << k;
+                avail = 32 - k;
+            }
+            else {
+                next = 0;
+                avail = 0;
+            }
+        }
+
+        uint32_t Read(const uint32_t n)
+        {
+            const uint32_t value = cur >> (32 - n);
+            Skip(n);
+            return value;
+        }
+
+        uint32_t ReadRunLength()
+        {
+            const auto& code = run_length_codes[cur >> 26];
+            Skip(code.bits);
+            return code.run;
+        }
+    };
+
+    bool TestBit(const uint32_t* bits, const uint32_t i)
+    {
+        return (bits[i >> 5] & (1u << (i & 31))) != 0;
+    }
+
+    void SetBit(uint32_t* bits, const uint32_t i)
+    {
+        bits[i >> 5] |= 1u << (i & 31);
+    }
+
+    // Shared shape of the run-length passes: each run reads a mode, then covers the next `run` blocks that weren't already
+    // filled by an earlier pass (their bit is set in `filled`). Blocks already filled are skipped without consuming the run.
+    template <typename ReadMode, typename Apply>
+    void RunLengthPass(BitReader& reader, const uint32_t* filled, const uint32_t block_count, ReadMode read_mode, Apply apply)
+    {
+        uint32_t i = 0;
+        while (i < block_count) {
+            uint32_t run = reader.ReadRunLength();
+            const uint32_t mode = read_mode();
+            for (; run; i++) {
+                if (i == block_count) {
+                    return;
+                }
+                if (!TestBit(filled, i)) {
+                    apply(i, mode);
+                    run--;
+                }
+            }
+            while (i < block_count && TestBit(filled, i)) {
+                i++;
+            }
+        }
+    }
+
+    // The outer 2 block rows/columns of a 256x256 DXT3 texture can be stored as a mirror of the blocks next to them
+    bool IsMirroredEdge(const uint32_t i)
+    {
+        return ((1u << (i & 31)) & 0xC0000003) != 0;
+    }
+
+    void MarkMirroredBlocks(uint32_t* alpha_filled, uint32_t* colour_filled, const uint32_t block_count)
+    {
+        for (uint32_t i = 0; i < block_count; i++) {
+            if (IsMirroredEdge(i) || IsMirroredEdge(i >> 6)) {
+                SetBit(alpha_filled, i);
+                SetBit(colour_filled, i);
+            }
+        }
+    }
+
+    void CopyMirroredBlocks(uint32_t* out, const uint32_t block_count)
+    {
+        for (uint32_t i = 0; i < block_count; i++) {
+            uint32_t x = i & 63;
+            uint32_t y = i >> 6;
+            const bool flip_x = IsMirroredEdge(x);
+            const bool flip_y = IsMirroredEdge(y);
+            if (!flip_x && !flip_y) {
+                continue;
+            }
+            if (flip_x) {
+                x ^= 3;
+            }
+            if (flip_y) {
+                y ^= 3;
+            }
+            const uint32_t* src = out + (y * 64 + x) * 4;
+            uint32_t alpha0 = src[0];
+            uint32_t alpha1 = src[1];
+            const uint32_t colour = src[2];
+            uint32_t indices = src[3];
+            if (flip_x) {
+                // Reverse the 4 nibbles of each alpha row. The game derives the second alpha word from the first here; kept as-is.
+                const auto reverse_nibbles = [](const uint32_t v) {
+                    const uint32_t lo = ((v >> 8) & 0x00F000F0) | (v & 0x0F000F00);
+                    const uint32_t hi = ((v & 0xFFFF000F) << 8) | (v & 0x00F000F0);
+                    return (lo >> 4) | (hi << 4);
+                };
+                alpha0 = reverse_nibbles(alpha0);
+                alpha1 = reverse_nibbles(alpha0);
+                // Reverse the 4 2-bit colour indices of each row
+                const uint32_t lo = (((indices & 0xFF030303) << 4) | (indices & 0x0C0C0C0C)) << 2;
+                const uint32_t hi = (((indices >> 4) & 0x0C0C0C0C) | (indices & 0x30303030)) >> 2;
+                indices = lo | hi;
+            }
+            if (flip_y) {
+                const uint32_t swapped = alpha0;
+                alpha0 = (alpha1 >> 16) | (alpha1 << 16);
+                alpha1 = (swapped >> 16) | (swapped << 16);
+                const uint32_t lo = ((indices & 0x00FF0000) | (indices >> 16)) >> 8;
+                const uint32_t hi = ((indices << 16) | (indices & 0x0000FF00)) << 8;
+                indices = lo | hi;
+            }
+            uint32_t* dst = out + i * 4;
+            dst[0] = alpha0;
+            dst[1] = alpha1;
+            dst[2] = colour;
+            dst[3] = indices;
+        }
+    }
+
+    // Pick a DXT colour block (endpoints + index word) that reproduces a solid 24 bit colour as closely as 565 allows
+    void EncodeSolidColour(const uint32_t colour, const bool dxt1, uint32_t out[2])
+    {
+        constexpr uint32_t channel_bits[3] = {5, 6, 5};
+        uint32_t lo_endpoint[3];
+        uint32_t hi_endpoint[3];
+        uint32_t quantized[3];
+        uint32_t fraction[3];
+        for (size_t c = 0; c < 3; c++) {
+            const uint32_t bits = channel_bits[c];
+            const uint32_t value = (colour >> (c * 8)) & 0xFF;
+            const uint32_t q = (value - (value >> bits)) >> (8 - bits);
+            const auto expand = [bits](const uint32_t v) {
+                return (v >> (2 * bits - 8)) + (v << (8 - bits));
+            };
+            const uint32_t lo = expand(q);
+            const uint32_t hi = expand(q + 1);
+            quantized[c] = q;
+            // How far between the two nearest 565 values the channel sits, in twelfths
+            fraction[c] = (value * 12 - lo * 12) / (hi - lo);
+            if (fraction[c] < 2) {
+                lo_endpoint[c] = hi_endpoint[c] = q;
+            }
+            else if (fraction[c] < 6) {
+                lo_endpoint[c] = q;
+                hi_endpoint[c] = q + 1;
+            }
+            else if (fraction[c] < 10) {
+                lo_endpoint[c] = q + 1;
+                hi_endpoint[c] = q;
+            }
+            else {
+                lo_endpoint[c] = hi_endpoint[c] = q + 1;
+            }
+        }
+        uint32_t c0 = (((lo_endpoint[2] << 6) | lo_endpoint[1]) << 5) | lo_endpoint[0];
+        uint32_t c1 = (((hi_endpoint[2] << 6) | hi_endpoint[1]) << 5) | hi_endpoint[0];
+
+        uint32_t weight = 0;
+        uint32_t weighted_channels = 0;
+        for (size_t c = 0; c < 3; c++) {
+            if (lo_endpoint[c] == hi_endpoint[c]) {
+                continue;
+            }
+            weight += lo_endpoint[c] == quantized[c] ? fraction[c] : 12 - fraction[c];
+            weighted_channels++;
+        }
+        if (weighted_channels) {
+            weight = (weight + weighted_channels / 2) / weighted_channels;
+        }
+
+        // DXT1 blocks can use the 3 colour mode to hit the midpoint exactly
+        const bool three_colour = dxt1 && (weight == 5 || weight == 6 || !weighted_channels);
+        if (!weighted_channels && !three_colour) {
+            if (c1 == 0xFFFF) {
+                weight = 12;
+                c0--;
+            }
+            else {
+                weight = 0;
+                c1++;
+            }
+        }
+        if (three_colour != (c1 >= c0)) {
+            std::swap(c0, c1);
+            weight = 12 - weight;
+        }
+
+        uint32_t index;
+        if (three_colour) {
+            index = 2;
+        }
+        else if (weight < 2) {
+            index = 0;
+        }
+        else if (weight < 6) {
+            index = 2;
+        }
+        else if (weight < 10) {
+            index = 3;
+        }
+        else {
+            index = 1;
+        }
+        out[0] = (c1 << 16) | c0;
+        out[1] = index * 0x55555555;
+    }
+
+    // DXT helpers
+
+    uint32_t Expand565(const uint32_t c, const uint32_t alpha)
+    {
+        return (alpha << 24) | ((c >> 11) << 19) | (((c >> 5) & 0x3F) << 10) | ((c & 0x1F) << 3);
+    }
+
+    uint32_t Lerp(const uint32_t a, const uint32_t b, const uint32_t wa, const uint32_t wb, const uint32_t div)
+    {
+        uint32_t out = 0;
+        for (uint32_t shift = 0; shift < 24; shift += 8) {
+            out |= (((a >> shift & 0xFF) * wa + (b >> shift & 0xFF) * wb) / div) << shift;
+        }
+        return out;
+    }
+
+    void ColourPalette(const uint32_t endpoints, const bool dxt1, uint32_t palette[4])
+    {
+        const uint32_t c0 = endpoints & 0xFFFF;
+        const uint32_t c1 = endpoints >> 16;
+        palette[0] = Expand565(c0, 0xFF);
+        palette[1] = Expand565(c1, 0xFF);
+        if (!dxt1 || c0 > c1) {
+            palette[2] = Lerp(palette[0], palette[1], 2, 1, 3) | 0xFF000000;
+            palette[3] = Lerp(palette[0], palette[1], 1, 2, 3) | 0xFF000000;
+        }
+        else {
+            palette[2] = Lerp(palette[0], palette[1], 1, 1, 2) | 0xFF000000;
+            palette[3] = 0;
+        }
+    }
+
+    void AlphaPaletteDXT5(const uint32_t a0, const uint32_t a1, uint8_t palette[8])
+    {
+        palette[0] = static_cast<uint8_t>(a0);
+        palette[1] = static_cast<uint8_t>(a1);
+        if (a0 > a1) {
+            for (uint32_t z = 0; z < 6; z++) {
+                palette[z + 2] = static_cast<uint8_t>(((6 - z) * a0 + (z + 1) * a1) / 7);
+            }
+        }
+        else {
+            for (uint32_t z = 0; z < 4; z++) {
+                palette[z + 2] = static_cast<uint8_t>(((4 - z) * a0 + (z + 1) * a1) / 5);
+            }
+            palette[6] = 0;
+            palette[7] = 0xFF;
+        }
+    }
+
+    // 16 alpha values, in pixel order
+    void BlockAlpha(const AtexDecoder::Format format, const uint32_t* block, uint8_t alpha[16])
+    {
+        const uint64_t bits = block[0] | static_cast<uint64_t>(block[1]) << 32;
+        if (format == AtexDecoder::Format::DXT3) {
+            for (uint32_t p = 0; p < 16; p++) {
+                alpha[p] = static_cast<uint8_t>((bits >> (p * 4) & 0xF) << 4);
+            }
+            return;
+        }
+        uint8_t palette[8];
+        AlphaPaletteDXT5(bits & 0xFF, bits >> 8 & 0xFF, palette);
+        const uint64_t indices = bits >> 16;
+        for (uint32_t p = 0; p < 16; p++) {
+            alpha[p] = palette[indices >> (p * 3) & 7];
+        }
+    }
+
+    uint32_t Premultiply(const uint32_t argb)
+    {
+        const uint32_t a = argb >> 24;
+        uint32_t out = argb & 0xFF000000;
+        for (uint32_t shift = 0; shift < 24; shift += 8) {
+            out |= ((argb >> shift & 0xFF) * a / 255) << shift;
+        }
+        return out;
+    }
+
+    void DecodeBlockScalar(const AtexDecoder::Format format, const uint32_t* block, uint32_t* dst, const uint32_t stride)
+    {
+        const bool dxt1 = format == AtexDecoder::Format::DXT1;
+        const uint32_t* colour = dxt1 ? block : block + 2;
+        uint32_t palette[4];
+        ColourPalette(colour[0], dxt1, palette);
+        uint32_t indices = colour[1];
+        if (dxt1) {
+            for (uint32_t y = 0; y < 4; y++, dst += stride) {
+                for (uint32_t x = 0; x < 4; x++, indices >>= 2) {
+                    dst[x] = palette[indices & 3];
+                }
+            }
+            return;
+        }
+        uint8_t alpha[16];
+        BlockAlpha(format, block, alpha);
+        for (uint32_t y = 0; y < 4; y++, dst += stride) {
+            for (uint32_t x = 0; x < 4; x++, indices >>= 2) {
+                const uint32_t argb = (palette[indices & 3] & 0xFFFFFF) | static_cast<uint32_t>(alpha[y * 4 + x]) << 24;
+                dst[x] = format == AtexDecoder::Format::DXTL ? Premultiply(argb) : argb;
+            }
+        }
+    }
+
+#ifdef ATEX_SSE2
+    // Same output as DecodeBlockScalar. Palette interpolation runs on 16 bit lanes and each row of 4 pixels is picked from
+    // the palette with compare masks rather than indexed loads. DXTL falls back to the scalar kernel.
+    void DecodeBlockSSE2(const AtexDecoder::Format format, const uint32_t* block, uint32_t* dst, const uint32_t stride)
+    {
+        const bool dxt1 = format == AtexDecoder::Format::DXT1;
+        const uint32_t* colour = dxt1 ? block : block + 2;
+        const uint32_t c0 = colour[0] & 0xFFFF;
+        const uint32_t c1 = colour[0] >> 16;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i p0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(Expand565(c0, 0xFF))), zero);
+        const __m128i p1 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(Expand565(c1, 0xFF))), zero);
+        __m128i p2;
+        __m128i p3;
+        if (!dxt1 || c0 > c1) {
+            // x / 3 == (x * 0xAAAB) >> 17 for every value we can see here
+            const __m128i third = _mm_set1_epi16(static_cast<short>(0xAAAB));
+            p2 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(p0, p0), p1), third), 1);
+            p3 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(p1, p1), p0), third), 1);
+        }
+        else {
+            p2 = _mm_srli_epi16(_mm_add_epi16(p0, p1), 1);
+            p3 = zero;
+        }
+        // Alpha lanes are interpolated along with the colour, so they stay 0xFF (or 0 for the dxt1 3 colour mode's transparent entry)
+        const __m128i pal0 = _mm_shuffle_epi32(_mm_packus_epi16(p0, zero), 0);
+        const __m128i pal1 = _mm_shuffle_epi32(_mm_packus_epi16(p1, zero), 0);
+        const __m128i pal2 = _mm_shuffle_epi32(_mm_packus_epi16(p2, zero), 0);
+        const __m128i pal3 = _mm_shuffle_epi32(_mm_packus_epi16(p3, zero), 0);
+
+        __m128i alpha_rows[4];
+        const __m128i colour_mask = dxt1 ? _mm_set1_epi32(-1) : _mm_set1_epi32(0x00FFFFFF);
+        if (!dxt1) {
+            __m128i alpha;
+            if (format == AtexDecoder::Format::DXT3) {
+                // Nibbles to bytes in pixel order, then scale by 16
+                const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block));
+                const __m128i low_nibbles = _mm_and_si128(packed, _mm_set1_epi8(0x0F));
+                const __m128i high_nibbles = _mm_and_si128(_mm_srli_epi16(packed, 4), _mm_set1_epi8(0x0F));
+                alpha = _mm_slli_epi16(_mm_unpacklo_epi8(low_nibbles, high_nibbles), 4);
+            }
+            else {
+                alignas(16) uint8_t values[16];
+                BlockAlpha(format, block, values);
+                alpha = _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+            }
+            const __m128i alpha_lo = _mm_unpacklo_epi8(zero, alpha);
+            const __m128i alpha_hi = _mm_unpackhi_epi8(zero, alpha);
+            alpha_rows[0] = _mm_unpacklo_epi16(zero, alpha_lo);
+            alpha_rows[1] = _mm_unpackhi_epi16(zero, alpha_lo);
+            alpha_rows[2] = _mm_unpacklo_epi16(zero, alpha_hi);
+            alpha_rows[3] = _mm_unpackhi_epi16(zero, alpha_hi);
+        }
+
+        const __m128i indices = _mm_set1_epi32(static_cast<int>(colour[1]));
+        __m128i low_bit = _mm_setr_epi32(1 << 0, 1 << 2, 1 << 4, 1 << 6);
+        __m128i high_bit = _mm_setr_epi32(1 << 1, 1 << 3, 1 << 5, 1 << 7);
+        for (uint32_t y = 0; y < 4; y++, dst += stride) {
+            const __m128i lo = _mm_cmpeq_epi32(_mm_and_si128(indices, low_bit), low_bit);
+            const __m128i hi = _mm_cmpeq_epi32(_mm_and_si128(indices, high_bit), high_bit);
+            const __m128i first_pair = _mm_or_si128(_mm_and_si128(lo, pal1), _mm_andnot_si128(lo, pal0));
+            const __m128i second_pair = _mm_or_si128(_mm_and_si128(lo, pal3), _mm_andnot_si128(lo, pal2));
+            __m128i row = _mm_or_si128(_mm_and_si128(hi, second_pair), _mm_andnot_si128(hi, first_pair));
+            if (!dxt1) {
+                row = _mm_or_si128(_mm_and_si128(row, colour_mask), alpha_rows[y]);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), row);
+            low_bit = _mm_slli_epi32(low_bit, 8);
+            high_bit = _mm_slli_epi32(high_bit, 8);
+        }
+    }
+#endif
+
+    using BlockKernel = void (*)(AtexDecoder::Format, const uint32_t*, uint32_t*, uint32_t);
+
+    void DecodeBlockRows(const BlockKernel kernel, const AtexDecoder::Format format, const uint32_t* blocks, const uint32_t width, const uint32_t height, const uint32_t first_row, const uint32_t num_rows,
+                         uint32_t* pixels)
+    {
+        const uint32_t blocks_x = width / 4;
+        const uint32_t last_row = std::min(first_row + num_rows, height / 4);
+        const uint32_t block_words = AtexDecoder::BlockWords(format);
+        for (uint32_t by = first_row; by < last_row; by++) {
+            const uint32_t* block = blocks + static_cast<size_t>(by) * blocks_x * block_words;
+            uint32_t* dst = pixels + static_cast<size_t>(by) * 4 * width;
+            for (uint32_t bx = 0; bx < blocks_x; bx++, block += block_words, dst += 4) {
+                kernel(format, block, dst, width);
+            }
+        }
+    }
+}
+
+bool AtexDecoder::ReadHeader(const uint8_t* data, const size_t size, ImageInfo* info)
+{
+    if (!data || size < header_size) {
+        return false;
+    }
+    if (memcmp(data, "ATEX", 4) != 0 && memcmp(data, "ATTX", 4) != 0) {
+        return false;
+    }
+    if (memcmp(data + 4, "DXT", 3) != 0) {
+        return false;
+    }
+    Format format;
+    switch (data[7]) {
+        case '1':
+            format = Format::DXT1;
+            break;
+        case '2':
+        case '3':
+        case 'N':
+            format = Format::DXT3;
+            break;
+        case '4':
+        case '5':
+            format = Format::DXT5;
+            break;
+        case 'L':
+            format = Format::DXTL;
+            break;
+        default:
+            return false;
+    }
+    if (info) {
+        info->format = format;
+        memcpy(&info->width, data + 8, sizeof(info->width));
+        memcpy(&info->height, data + 10, sizeof(info->height));
+    }
+    return true;
+}
+
+uint32_t AtexDecoder::BlockWords(const Format format)
+{
+    return format == Format::DXT1 ? 2 : 4;
+}
+
+bool AtexDecoder::Decompress(const uint8_t* data, const size_t size, const ImageInfo& info, std::vector<uint32_t>& out_blocks)
+{
+    const uint32_t format_code = FormatCode(info.format);
+    const uint32_t block_count = static_cast<uint32_t>(info.width) * info.height / 16;
+    if (!format_code || !block_count || header_size + 8 >= size) {
+        return false;
+    }
+    const uint32_t data_size = LoadWord(data + header_size);
+    const uint32_t compression = LoadWord(data + header_size + 4);
+    if (data_size <= 8 || data_size > size - header_size) {
+        return false;
+    }
+
+    const bool dxt1 = format_code == FORMAT_DXT1;
+    const uint32_t alpha_words = dxt1 ? 0 : 2;
+    const uint32_t block_words = BlockWords(info.format);
+    out_blocks.assign(static_cast<size_t>(block_count) * block_words, 0);
+    uint32_t* out = out_blocks.data();
+
+    // Blocks already filled in by a run-length pass, so the raw copy at the end skips them. The colour bitmap starts half way
+    // into the alpha one, same as the game; they only ever overlap for single block images.
+    std::vector<uint32_t> filled(std::max<uint32_t>(block_count, 2), 0);
+    uint32_t* alpha_filled = filled.data();
+    uint32_t* colour_filled = filled.data() + block_count / 2;
+
+    const uint8_t* pos = data + header_size + 8;
+    const bool mirrored = compression & 0x10 && info.width == 256 && info.height == 256 && format_code == FORMAT_DXT3;
+    if (compression) {
+        BitReader reader;
+        reader.pos = pos;
+        reader.end = pos + (data_size - 8) / 4 * 4;
+        if (reader.pos != reader.end) {
+            reader.cur = LoadWord(reader.pos);
+            reader.pos += 4;
+        }
+        if (mirrored) {
+            MarkMirroredBlocks(alpha_filled, colour_filled, block_count);
+        }
+        if (compression & 1 && dxt1) {
+            // Runs of fully transparent blocks
+            RunLengthPass(reader, colour_filled, block_count, [&] { return reader.Read(1); }, [&](const uint32_t i, const uint32_t mode) {
+                if (mode) {
+                    out[i * block_words] = 0xFFFFFFFE;
+                    out[i * block_words + 1] = 0xFFFFFFFF;
+                    SetBit(colour_filled, i);
+                    SetBit(alpha_filled, i);
+                }
+            });
+        }
+        if (compression & 2 && format_code == FORMAT_DXT3) {
+            // Runs of blocks with no alpha, or a single 4 bit alpha value
+            const uint32_t nibble = reader.Read(4);
+            const uint32_t solid[3][2] = {{0, 0}, {0, 0}, {nibble * 0x11111111, nibble * 0x11111111}};
+            RunLengthPass(reader, colour_filled, block_count, [&] { return reader.Read(1) ? 1 + reader.Read(1) : 0; }, [&](const uint32_t i, const uint32_t mode) {
+                if (mode) {
+                    out[i * block_words] = solid[mode][0];
+                    out[i * block_words + 1] = solid[mode][1];
+                    SetBit(alpha_filled, i);
+                }
+            });
+        }
+        if (compression & 4 && (format_code == FORMAT_DXTL || format_code == FORMAT_DXT5)) {
+            // Same again for DXT5 alpha blocks, with an 8 bit value
+            const uint32_t value = reader.Read(8);
+            const uint32_t solid[3][2] = {{0, 0}, {0, 0}, {value | value << 8, 0}};
+            RunLengthPass(reader, colour_filled, block_count, [&] { return reader.Read(1) ? 1 + reader.Read(1) : 0; }, [&](const uint32_t i, const uint32_t mode) {
+                if (mode) {
+                    out[i * block_words] = solid[mode][0];
+                    out[i * block_words + 1] = solid[mode][1];
+                    SetBit(alpha_filled, i);
+                }
+            });
+        }
+        if (compression & 8) {
+            // Runs of blocks sharing a single 24 bit colour
+            const uint32_t rgb = reader.Read(24) | 0xFF000000;
+            uint32_t solid[2];
+            EncodeSolidColour(rgb, dxt1, solid);
+            uint32_t* colour_out = out + alpha_words;
+            RunLengthPass(reader, colour_filled, block_count, [&] { return reader.Read(1); }, [&](const uint32_t i, const uint32_t mode) {
+                if (mode) {
+                    colour_out[i * block_words] = solid[0];
+                    colour_out[i * block_words + 1] = solid[1];
+                    SetBit(colour_filled, i);
+                }
+            });
+        }
+        // The reader always holds one word it hasn't consumed yet
+        pos = reader.pos - 4;
+    }
+
+    // Everything the passes above didn't cover is stored raw: all the alpha words, then the colour endpoints, then the colour indices
+    const uint8_t* end = data + size;
+    const auto copy_words = [&](uint32_t* dst, const uint32_t count) {
+        if (static_cast<size_t>(end - pos) < count * 4) {
+            return false;
+        }
+        memcpy(dst, pos, count * 4);
+        pos += count * 4;
+        return true;
+    };
+    if (alpha_words) {
+        for (uint32_t i = 0; i < block_count; i++) {
+            if (!TestBit(alpha_filled, i) && !copy_words(out + i * block_words, alpha_words)) {
+                return false;
+            }
+        }
+    }
+    for (uint32_t word = 0; word < 2; word++) {
+        for (uint32_t i = 0; i < block_count; i++) {
+            if (!TestBit(colour_filled, i) && !copy_words(out + i * block_words + alpha_words + word, 1)) {
+                return false;
+            }
+        }
+    }
+
+    if (mirrored) {
+        CopyMirroredBlocks(out, block_count);
+    }
+    return true;
+}
+
+void AtexDecoder::DecodeBlocksScalar(const Format format, const uint32_t* blocks, const uint32_t width, const uint32_t height, const uint32_t first_row, const uint32_t num_rows, uint32_t* pixels)
+{
+    DecodeBlockRows(DecodeBlockScalar, format, blocks, width, height, first_row, num_rows, pixels);
+}
+
+void AtexDecoder::DecodeBlocks(const Format format, const uint32_t* blocks, const uint32_t width, const uint32_t height, const uint32_t first_row, const uint32_t num_rows, uint32_t* pixels)
+{
+#ifdef ATEX_SSE2
+    if (format != Format::DXTL) {
+        DecodeBlockRows(DecodeBlockSSE2, format, blocks, width, height, first_row, num_rows, pixels);
+        return;
+    }
+#endif
+    DecodeBlocksScalar(format, blocks, width, height, first_row, num_rows, pixels);
+}
+
+bool AtexDecoder::Decode(const uint8_t* data, const size_t size, std::vector<uint32_t>& pixels, ImageInfo* info, size_t num_threads)
+{
+    ImageInfo header;
+    if (!ReadHeader(data, size, &header)) {
+        return false;
+    }
+    std::vector<uint32_t> blocks;
+    if (!Decompress(data, size, header, blocks)) {
+        return false;
+    }
+    pixels.assign(static_cast<size_t>(header.width) * header.height, 0);
+
+    // Not worth spinning up a thread for less than 16k pixels
+    const uint32_t block_rows = header.height / 4;
+    num_threads = std::clamp<size_t>(std::min<size_t>(num_threads, pixels.size() / (256 * 64)), 1, block_rows ? block_rows : 1);
+    const uint32_t rows_per_thread = static_cast<uint32_t>((block_rows + num_threads - 1) / num_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; t++) {
+        threads.emplace_back(DecodeBlocks, header.format, blocks.data(), header.width, header.height, static_cast<uint32_t>(t) * rows_per_thread, rows_per_thread, pixels.data());
+    }
+    DecodeBlocks(header.format, blocks.data(), header.width, header.height, 0, rows_per_thread, pixels.data());
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (info) {
+        *info = header;
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Decoder for the ATEX/ATTX textures stored in Gw.dat; a portable port of the naked asm the game (and Unused/GWDatBrowser) used.
+// Decoding happens in two stages: the ATEX run-length pass that rebuilds plain DXT blocks, then the DXT block kernels that expand
+// those into ARGB pixels. No game or windows dependencies, so textures can be decoded on any thread without calling into game code.
+namespace AtexDecoder {
+    enum class Format : uint8_t {
+        Unknown,
+        DXT1,
+        DXT3,
+        DXT5,
+        // DXT5 with the colour premultiplied by alpha
+        DXTL
+    };
+
+    struct ImageInfo {
+        Format format = Format::Unknown;
+        uint16_t width = 0;
+        uint16_t height = 0;
+    };
+
+    // Parse the header of an ATEX/ATTX file. Returns false if it isn't a DXT texture we know how to decode.
+    bool ReadHeader(const uint8_t* data, size_t size, ImageInfo* info);
+
+    // 2 words per DXT1 block, 4 words for everything else.
+    uint32_t BlockWords(Format format);
+
+    // Undo the ATEX compression, leaving plain DXT blocks in out_blocks (row major, BlockWords() per block).
+    // Returns false if the file is truncated or malformed.
+    bool Decompress(const uint8_t* data, size_t size, const ImageInfo& info, std::vector<uint32_t>& out_blocks);
+
+    // Expand block rows [first_row, first_row + num_rows) of a DXT image into ARGB pixels (width * height, row major).
+    // DecodeBlocks uses the SSE2 kernels when the build has them; DecodeBlocksScalar is the reference they're checked against.
+    void DecodeBlocks(Format format, const uint32_t* blocks, uint32_t width, uint32_t height, uint32_t first_row, uint32_t num_rows, uint32_t* pixels);
+    void DecodeBlocksScalar(Format format, const uint32_t* blocks, uint32_t width, uint32_t height, uint32_t first_row, uint32_t num_rows, uint32_t* pixels);
+
+    // Decompress + decode an ATEX/ATTX file into ARGB pixels. Block rows are split across num_threads threads (including the caller) for big images.
+    bool Decode(const uint8_t* data, size_t size, std::vector<uint32_t>& pixels, ImageInfo* info = nullptr, size_t num_threads = 1);
+}
@@ -0,0 +1,45 @@
+#include <stdafx.h>
+
+#include "ByteRing.h"
+
+void ByteRing::Init(size_t _capacity)
+{
+    capacity = 1;
+    while (capacity < _capacity) {
+        capacity <<= 1;
+    }
+    buffer = std::make_unique<uint8_t[]>(capacity);
+    write_pos = 0;
+    read_pos = 0;
+    dropped = 0;
+}
+
+void ByteRing::Copy(const size_t pos, const void* data, const size_t size)
+{
+    const size_t offset = pos & (capacity - 1);
+    const size_t first = std::min(size, capacity - offset);
+    memcpy(buffer.get() + offset, data, first);
+    if (first < size) {
+        memcpy(buffer.get(), static_cast<const uint8_t*>(data) + first, size - first);
+    }
+}
+
+bool ByteRing::Write(const void* header, const size_t header_size, const void* data, const size_t data_size)
+{
+    const size_t head = write_pos.load(std::memory_order_relaxed);
+    const size_t tail = read_pos.load(std::memory_order_acquire);
+    if (!buffer || capacity - (head - tail) < header_size + data_size) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Copy(head, header, header_size);
+    Copy(head + header_size, data, data_size);
+    write_pos.store(head + header_size + data_size, std::memory_order_release);
+    return true;
+}
+
+void ByteRing::Discard()
+{
+    read_pos.store(write_pos.load(std::memory_order_acquire), std::memory_order_release);
+    dropped = 0;
+}
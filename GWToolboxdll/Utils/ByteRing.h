@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Lock-free single producer, single consumer ring of bytes. The producer appends whole records (never split or partially
+// visible); the consumer drains whatever has been published as up to two contiguous spans. Nothing allocates after Init(),
+// so Write() is safe to call from a game hook.
+class ByteRing {
+public:
+    ByteRing() = default;
+    ByteRing(const ByteRing&) = delete;
+    ByteRing& operator=(const ByteRing&) = delete;
+
+    // Allocate the buffer; capacity is rounded up to a power of 2. Only call while neither side is running.
+    void Init(size_t capacity);
+    [[nodiscard]] size_t Capacity() const { return capacity; }
+
+    // Producer. Appends header then data as one record; returns false and counts a drop if there isn't room for both.
+    bool Write(const void* header, size_t header_size, const void* data, size_t data_size);
+    [[nodiscard]] uint32_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Consumer. Pass everything published so far to sink(const uint8_t* data, size_t size), then release the space.
+    template <typename Sink>
+    size_t Drain(Sink&& sink)
+    {
+        const size_t tail = read_pos.load(std::memory_order_relaxed);
+        const size_t head = write_pos.load(std::memory_order_acquire);
+        const size_t available = head - tail;
+        if (!available) {
+            return 0;
+        }
+        const size_t offset = tail & (capacity - 1);
+        const size_t first = std::min(available, capacity - offset);
+        sink(buffer.get() + offset, first);
+        if (first < available) {
+            sink(buffer.get(), available - first);
+        }
+        read_pos.store(head, std::memory_order_release);
+        return available;
+    }
+    // Consumer. Throw away anything published so far, and reset the drop count.
+    void Discard();
+
+private:
+    void Copy(size_t pos, const void* data, size_t size);
+
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t capacity = 0;
+    // Both only ever increase; masked with capacity - 1 to index buffer
+    alignas(64) std::atomic<size_t> write_pos = 0;
+    alignas(64) std::atomic<size_t> read_pos = 0;
+    std::atomic<uint32_t> dropped = 0;
+};
@@ -0,0 +1,339 @@
+#include <stdafx.h>
+
+#include <File.h>
+#include <share.h>
+
+#include "ChatJournal.h"
+
+namespace {
+    constexpr char journal_magic[4] = {'G', 'W', 'C', 'J'};
+    constexpr char index_magic[4] = {'G', 'W', 'C', 'I'};
+    constexpr uint32_t file_version = 1;
+    constexpr size_t file_header_size = sizeof(journal_magic) + sizeof(file_version);
+
+#pragma pack(push, 1)
+    struct RecordHeader {
+        uint16_t length;
+        ChatJournal::Kind kind;
+        uint32_t channel;
+        uint64_t timestamp;
+        uint32_t address;
+    };
+#pragma pack(pop)
+
+    bool HasHeader(const uint8_t* data, const size_t size, const char (&magic)[4])
+    {
+        return size >= file_header_size && memcmp(data, magic, sizeof(magic)) == 0
+               && memcmp(data + sizeof(magic), &file_version, sizeof(file_version)) == 0;
+    }
+
+    // The journal is read back through its own mapping while it's open for appending, so don't lock others out of it
+    FILE* OpenShared(const std::filesystem::path& path, const wchar_t* mode)
+    {
+        return _wfsopen(path.wstring().c_str(), mode, _SH_DENYNO);
+    }
+
+    bool WriteHeader(FILE* file, const char (&magic)[4])
+    {
+        return fwrite(magic, sizeof(magic), 1, file) == 1 && fwrite(&file_version, sizeof(file_version), 1, file) == 1;
+    }
+
+    // Calls callback(header, text, offset) for each whole record in [begin, end) of the mapped journal; returns where it stopped
+    template <typename Callback>
+    uint64_t ReadRecords(const MappedFile& journal, uint64_t begin, uint64_t end, Callback callback)
+    {
+        const uint8_t* data = journal.GetData();
+        end = std::min<uint64_t>(end, journal.GetSize());
+        while (end - begin >= sizeof(RecordHeader)) {
+            RecordHeader header;
+            memcpy(&header, data + begin, sizeof(header));
+            const size_t text_size = header.length * sizeof(wchar_t);
+            if (end - begin - sizeof(header) < text_size) {
+                break;
+            }
+            if (!callback(header, reinterpret_cast<const wchar_t*>(data + begin + sizeof(header)), begin)) {
+                return begin;
+            }
+            begin += sizeof(header) + text_size;
+        }
+        return begin;
+    }
+
+    ChatJournal::Message ToMessage(const RecordHeader& header, const wchar_t* text)
+    {
+        ChatJournal::Message message;
+        message.kind = header.kind;
+        message.channel = header.channel;
+        message.timestamp = header.timestamp;
+        message.address = header.address;
+        message.text.assign(text, header.length);
+        return message;
+    }
+}
+
+ChatJournal::~ChatJournal()
+{
+    Close();
+}
+
+void ChatJournal::Close()
+{
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    if (index_file) {
+        fclose(index_file);
+        index_file = nullptr;
+    }
+    checkpoints.clear();
+    pending = {};
+    pending_count = 0;
+    message_count = 0;
+    file_size = 0;
+    unflushed = 0;
+    write_failed = false;
+}
+
+bool ChatJournal::Flush()
+{
+    if (file && unflushed) {
+        write_failed = fflush(file) != 0 || write_failed;
+        unflushed = 0;
+    }
+    return file && !write_failed;
+}
+
+void ChatJournal::AddToCheckpoint(const Message& message, const uint64_t offset)
+{
+    if (!pending_count) {
+        pending = {offset, message.timestamp, message.timestamp, 0, 0, 0};
+    }
+    pending.first_time = std::min(pending.first_time, message.timestamp);
+    pending.last_time = std::max(pending.last_time, message.timestamp);
+    pending.channels |= ChannelBit(message.channel);
+    (message.kind == Kind::Sent ? pending.sent : pending.received)++;
+    pending_count++;
+    message_count++;
+}
+
+bool ChatJournal::WriteCheckpoint()
+{
+    checkpoints.push_back(pending);
+    pending = {};
+    pending_count = 0;
+    // The messages it covers have to be on disk before the checkpoint is
+    write_failed = fflush(file) != 0 || write_failed;
+    unflushed = 0;
+    if (write_failed) {
+        return false;
+    }
+    const bool ok = fwrite(&checkpoints.back(), sizeof(Checkpoint), 1, index_file) == 1;
+    fflush(index_file);
+    return ok;
+}
+
+bool ChatJournal::Open(const std::filesystem::path& path)
+{
+    Close();
+    file_path = path;
+    index_path = path;
+    index_path += L".idx";
+
+    std::vector<uint8_t> index_data;
+    if (std::ifstream in(index_path, std::ios::binary); in) {
+        index_data.assign(std::istreambuf_iterator(in), std::istreambuf_iterator<char>());
+    }
+
+    bool rewrite_index = true;
+    {
+        MappedFile journal;
+        // Empty files can't be mapped, same as missing ones
+        if (journal.Open(file_path.wstring().c_str()) && HasHeader(journal.GetData(), journal.GetSize(), journal_magic)) {
+            // Checkpoints up to the first one that doesn't fit the journal. The last one may have been written for
+            // messages that didn't all make it to disk, so it's counted again along with everything after it.
+            size_t valid = 0;
+            if (HasHeader(index_data.data(), index_data.size(), index_magic)) {
+                const size_t stored = (index_data.size() - file_header_size) / sizeof(Checkpoint);
+                checkpoints.resize(stored);
+                if (stored) {
+                    memcpy(checkpoints.data(), index_data.data() + file_header_size, stored * sizeof(Checkpoint));
+                }
+                uint64_t previous = 0;
+                while (valid < stored && checkpoints[valid].offset > previous && checkpoints[valid].offset < journal.GetSize()
+                       && checkpoints[valid].received + checkpoints[valid].sent == checkpoint_interval) {
+                    previous = checkpoints[valid++].offset;
+                }
+                rewrite_index = valid != stored || index_data.size() != file_header_size + stored * sizeof(Checkpoint);
+            }
+            const size_t kept = valid ? valid - 1 : 0;
+            const uint64_t scan_from = valid ? checkpoints[kept].offset : file_header_size;
+            checkpoints.resize(kept);
+            message_count = kept * checkpoint_interval;
+
+            file_size = ReadRecords(journal, scan_from, journal.GetSize(), [&](const RecordHeader& header, const wchar_t*, const uint64_t offset) {
+                if (pending_count == checkpoint_interval) {
+                    checkpoints.push_back(pending);
+                    pending_count = 0;
+                }
+                AddToCheckpoint({header.kind, header.channel, header.timestamp, header.address, {}}, offset);
+                return true;
+            });
+            if (pending_count == checkpoint_interval) {
+                checkpoints.push_back(pending);
+                pending_count = 0;
+            }
+            rewrite_index = rewrite_index || checkpoints.size() != valid;
+
+            const bool torn = file_size != journal.GetSize();
+            journal.Close();
+            if (torn) {
+                // Whatever gets appended next would be read as part of the broken record
+                std::error_code ec;
+                std::filesystem::resize_file(file_path, file_size, ec);
+                if (ec) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (!file_size) {
+        checkpoints.clear();
+        file = OpenShared(file_path, L"wb");
+        if (!file || !WriteHeader(file, journal_magic)) {
+            Close();
+            return false;
+        }
+        file_size = file_header_size;
+    }
+    else {
+        file = OpenShared(file_path, L"ab");
+        if (!file) {
+            Close();
+            return false;
+        }
+    }
+
+    if (rewrite_index) {
+        index_file = OpenShared(index_path, L"wb");
+        if (!index_file || !WriteHeader(index_file, index_magic)
+            || (!checkpoints.empty() && fwrite(checkpoints.data(), sizeof(Checkpoint), checkpoints.size(), index_file) != checkpoints.size())) {
+            Close();
+            return false;
+        }
+        fflush(index_file);
+    }
+    else {
+        index_file = OpenShared(index_path, L"ab");
+        if (!index_file) {
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChatJournal::Append(const Message& message)
+{
+    if (!file) {
+        return false;
+    }
+    RecordHeader header;
+    header.length = static_cast<uint16_t>(std::min<size_t>(message.text.size(), 0xffff));
+    header.kind = message.kind;
+    header.channel = message.channel;
+    header.timestamp = message.timestamp;
+    header.address = message.address;
+    if (fwrite(&header, sizeof(header), 1, file) != 1
+        || fwrite(message.text.data(), sizeof(wchar_t), header.length, file) != header.length) {
+        write_failed = true;
+        return false;
+    }
+    AddToCheckpoint(message, file_size);
+    file_size += sizeof(header) + header.length * sizeof(wchar_t);
+    if (pending_count == checkpoint_interval) {
+        return WriteCheckpoint();
+    }
+    if (++unflushed >= 32) {
+        Flush();
+    }
+    return true;
+}
+
+size_t ChatJournal::Tail(const Kind kind, const size_t count, std::vector<Message>& out)
+{
+    out.clear();
+    if (!file || !count) {
+        return 0;
+    }
+    const auto kind_count = [kind](const Checkpoint& checkpoint) {
+        return kind == Kind::Sent ? checkpoint.sent : checkpoint.received;
+    };
+    // Walk back through the checkpoints until there are enough messages of this kind after them
+    size_t available = pending_count ? kind_count(pending) : 0;
+    size_t first_block = checkpoints.size();
+    while (available < count && first_block) {
+        available += kind_count(checkpoints[--first_block]);
+    }
+    const uint64_t begin = first_block < checkpoints.size() ? checkpoints[first_block].offset : pending.offset;
+    if (!available) {
+        return 0;
+    }
+
+    Flush();
+    MappedFile journal;
+    if (!journal.Open(file_path.wstring().c_str())) {
+        return 0;
+    }
+    size_t skip = available > count ? available - count : 0;
+    out.reserve(std::min(available, count));
+    ReadRecords(journal, begin, file_size, [&](const RecordHeader& header, const wchar_t* text, uint64_t) {
+        if (header.kind != kind) {
+            return true;
+        }
+        if (skip) {
+            skip--;
+            return true;
+        }
+        out.push_back(ToMessage(header, text));
+        return true;
+    });
+    return out.size();
+}
+
+size_t ChatJournal::Find(const Kind kind, const uint64_t from, const uint64_t to, const uint64_t channel_mask, const size_t max_results, std::vector<Message>& out)
+{
+    out.clear();
+    if (!file || !max_results) {
+        return 0;
+    }
+    Flush();
+    MappedFile journal;
+    if (!journal.Open(file_path.wstring().c_str())) {
+        return 0;
+    }
+    const size_t block_count = checkpoints.size() + (pending_count ? 1 : 0);
+    for (size_t i = 0; i < block_count && out.size() < max_results; i++) {
+        const Checkpoint& block = i < checkpoints.size() ? checkpoints[i] : pending;
+        const uint32_t kind_count = kind == Kind::Sent ? block.sent : block.received;
+        if (!kind_count || block.last_time < from || block.first_time > to || !(block.channels & channel_mask)) {
+            continue;
+        }
+        // Up to where the next block starts
+        uint64_t end = file_size;
+        if (i + 1 < checkpoints.size()) {
+            end = checkpoints[i + 1].offset;
+        }
+        else if (i + 1 == checkpoints.size() && pending_count) {
+            end = pending.offset;
+        }
+        ReadRecords(journal, block.offset, end, [&](const RecordHeader& header, const wchar_t* text, uint64_t) {
+            if (header.kind == kind && header.timestamp >= from && header.timestamp <= to && (ChannelBit(header.channel) & channel_mask)) {
+                out.push_back(ToMessage(header, text));
+            }
+            return out.size() < max_results;
+        });
+    }
+    return out.size();
+}
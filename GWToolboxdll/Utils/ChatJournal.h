@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Complete chat history of one account, received and sent, appended to a file as messages arrive.
+// Every checkpoint_interval messages a checkpoint is appended to a side file (<journal>.idx) with where that block of
+// messages starts, its time range, which channels it has and how many of each kind. Loading only scans back as far as
+// the checkpoints say it needs to for the most recent messages, and searches skip blocks that can't match.
+// Not thread safe.
+class ChatJournal {
+public:
+    enum class Kind : uint8_t {
+        Received,
+        Sent
+    };
+
+    struct Message {
+        Kind kind = Kind::Received;
+        uint32_t channel = 0;
+        // FILETIME as one number; when it was sent, for sent messages
+        uint64_t timestamp = 0;
+        // Where GW kept a sent message, to tell repeats apart
+        uint32_t address = 0;
+        std::wstring text;
+    };
+
+    static constexpr uint32_t checkpoint_interval = 256;
+
+    ChatJournal() = default;
+    ChatJournal(const ChatJournal&) = delete;
+    ChatJournal& operator=(const ChatJournal&) = delete;
+    ~ChatJournal();
+
+    // Creates the journal if it doesn't exist. A torn write at the end from a crash is cut off; the index is rebuilt
+    // from the journal if it's missing or behind.
+    bool Open(const std::filesystem::path& path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return file != nullptr; }
+
+    bool Append(const Message& message);
+    // False if anything appended since Open didn't make it to the file
+    bool Flush();
+
+    // The last count messages of a kind, oldest first
+    size_t Tail(Kind kind, size_t count, std::vector<Message>& out);
+    // Messages of a kind in [from, to] on any of the channels in channel_mask (bit n for channel n, bit 63 for
+    // anything past it), oldest first, up to max_results
+    size_t Find(Kind kind, uint64_t from, uint64_t to, uint64_t channel_mask, size_t max_results, std::vector<Message>& out);
+
+    [[nodiscard]] size_t size() const { return message_count; }
+    [[nodiscard]] uint64_t FileSize() const { return file_size; }
+
+    static uint64_t ChannelBit(uint32_t channel) { return 1ull << std::min<uint32_t>(channel, 63); }
+
+private:
+#pragma pack(push, 1)
+    struct Checkpoint {
+        uint64_t offset;
+        uint64_t first_time;
+        uint64_t last_time;
+        uint64_t channels;
+        uint32_t received;
+        uint32_t sent;
+    };
+#pragma pack(pop)
+
+    void AddToCheckpoint(const Message& message, uint64_t offset);
+    bool WriteCheckpoint();
+
+    std::filesystem::path file_path;
+    std::filesystem::path index_path;
+    FILE* file = nullptr;
+    FILE* index_file = nullptr;
+    uint64_t file_size = 0;
+    uint32_t unflushed = 0;
+    bool write_failed = false;
+    size_t message_count = 0;
+
+    std::vector<Checkpoint> checkpoints;
+    // Block being filled, i.e. the messages since the last checkpoint
+    Checkpoint pending{};
+    uint32_t pending_count = 0;
+};
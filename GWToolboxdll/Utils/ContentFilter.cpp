@@ -0,0 +1,288 @@
+#include <stdafx.h>
+
+#include "ContentFilter.h"
+
+namespace {
+    bool IsAsciiAlnum(const wchar_t c)
+    {
+        return (c >= L'0' && c <= L'9') || (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z');
+    }
+
+    // Index of the last character of the escape code whose letter or digit is at expression[letter], e.g. the last hex
+    // digit of \x41 or \u0041, the letter of \cJ, or the last digit of a back reference like \12
+    size_t SkipEscapeCode(const std::wstring_view expression, const size_t letter)
+    {
+        const auto is_hex = [](const wchar_t c) {
+            return (c >= L'0' && c <= L'9') || (c >= L'a' && c <= L'f') || (c >= L'A' && c <= L'F');
+        };
+        const auto skip_while = [&](const size_t max, auto pred) {
+            size_t i = letter;
+            while (i + 1 < expression.size() && i - letter < max && pred(expression[i + 1])) {
+                i++;
+            }
+            return i;
+        };
+        switch (expression[letter]) {
+            case L'x':
+                return skip_while(2, is_hex);
+            case L'u':
+                return skip_while(4, is_hex);
+            case L'c':
+                return skip_while(1, IsAsciiAlnum);
+            default:
+                if (expression[letter] >= L'0' && expression[letter] <= L'9') {
+                    return skip_while(expression.size(), [](const wchar_t c) {
+                        return c >= L'0' && c <= L'9';
+                    });
+                }
+                return letter;
+        }
+    }
+
+    // Index of the character that closes the bracket expression starting at open, or the end of the expression
+    size_t SkipClass(const std::wstring_view expression, size_t open)
+    {
+        size_t i = open + 1;
+        if (i < expression.size() && expression[i] == L'^') {
+            i++;
+        }
+        for (; i < expression.size(); i++) {
+            if (expression[i] == L'\\') {
+                i++;
+            }
+            else if (expression[i] == L']') {
+                return i;
+            }
+        }
+        return expression.size();
+    }
+
+    // Index of the parenthesis that closes the group starting at open, or the end of the expression
+    size_t SkipGroup(const std::wstring_view expression, const size_t open)
+    {
+        size_t depth = 0;
+        for (size_t i = open; i < expression.size(); i++) {
+            switch (expression[i]) {
+                case L'\\':
+                    i++;
+                    break;
+                case L'[':
+                    i = SkipClass(expression, i);
+                    break;
+                case L'(':
+                    depth++;
+                    break;
+                case L')':
+                    if (--depth == 0) {
+                        return i;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return expression.size();
+    }
+}
+
+std::wstring ContentFilter::RequiredLiteral(const std::wstring_view expression, const bool ignore_case)
+{
+    // Walk the top level of the expression collecting runs of literal characters. Anything that isn't a plain character
+    // (classes, groups, anchors, escapes like \d) ends the current run. A quantifier that allows zero repeats takes its
+    // character back out of the run, since a match might not contain it.
+    std::wstring best;
+    std::wstring run;
+    bool last_was_literal = false;
+    const auto end_run = [&] {
+        if (run.size() > best.size()) {
+            best = run;
+        }
+        run.clear();
+    };
+    const auto add_literal = [&](wchar_t c) {
+        if (ignore_case) {
+            if (c > 0x7f) {
+                end_run();
+                last_was_literal = false;
+                return;
+            }
+            if (c >= L'A' && c <= L'Z') {
+                c = static_cast<wchar_t>(c - L'A' + L'a');
+            }
+        }
+        run.push_back(c);
+        last_was_literal = true;
+    };
+
+    for (size_t i = 0; i < expression.size(); i++) {
+        const wchar_t c = expression[i];
+        switch (c) {
+            case L'|':
+                // Alternation at the top level; no literal is required by every branch
+                return {};
+            case L'*':
+            case L'?':
+            case L'{':
+                if (last_was_literal && !run.empty()) {
+                    run.pop_back();
+                }
+                if (c == L'{') {
+                    const auto close = expression.find(L'}', i);
+                    i = close == std::wstring_view::npos ? expression.size() : close;
+                }
+                end_run();
+                last_was_literal = false;
+                break;
+            case L'+': {
+                // Keeps its character unless something else is stacked on top of it, e.g. a+* (a lone ? just makes it lazy)
+                size_t stacked = i + 1;
+                while (stacked < expression.size() && std::wstring_view(L"*+?{").find(expression[stacked]) != std::wstring_view::npos) {
+                    stacked++;
+                }
+                const auto count = stacked - i - 1;
+                if (last_was_literal && !run.empty() && count && !(count == 1 && expression[i + 1] == L'?')) {
+                    run.pop_back();
+                }
+                end_run();
+                last_was_literal = false;
+                break;
+            }
+            case L'\\':
+                if (i + 1 >= expression.size() || IsAsciiAlnum(expression[i + 1])) {
+                    // Character class, back reference, boundary or escape code
+                    i = i + 1 < expression.size() ? SkipEscapeCode(expression, i + 1) : i + 1;
+                    end_run();
+                    last_was_literal = false;
+                }
+                else {
+                    add_literal(expression[++i]);
+                }
+                break;
+            case L'[':
+                i = SkipClass(expression, i);
+                end_run();
+                last_was_literal = false;
+                break;
+            case L'(':
+                i = SkipGroup(expression, i);
+                end_run();
+                last_was_literal = false;
+                break;
+            case L'.':
+            case L'^':
+            case L'$':
+            case L')':
+            case L']':
+            case L'}':
+                end_run();
+                last_was_literal = false;
+                break;
+            default:
+                add_literal(c);
+                break;
+        }
+    }
+    end_run();
+    return best;
+}
+
+void ContentFilter::AddWord(const std::wstring_view word)
+{
+    if (word.empty()) {
+        return;
+    }
+    const auto first_regex = std::ranges::find_if(rules, [](const Rule& rule) {
+        return rule.is_regex;
+    });
+    Rule rule;
+    rule.source = word;
+    rule.required_literal = word;
+    rule.literal_ignores_case = true;
+    rules.insert(first_regex, std::move(rule));
+    dirty = true;
+}
+
+void ContentFilter::AddRegex(const std::wstring& expression, const std::regex_constants::syntax_option_type flags)
+{
+    using namespace std::regex_constants;
+    regexes.emplace_back(expression, flags);
+    Rule rule;
+    rule.source = expression;
+    rule.is_regex = true;
+    // Only ECMAScript (the default) is parsed for literals
+    if (!(flags & (basic | extended | awk | grep | egrep))) {
+        rule.literal_ignores_case = (flags & icase) != 0;
+        rule.required_literal = RequiredLiteral(expression, rule.literal_ignores_case);
+    }
+    rules.push_back(std::move(rule));
+    dirty = true;
+}
+
+void ContentFilter::ClearWords()
+{
+    std::erase_if(rules, [](const Rule& rule) {
+        return !rule.is_regex;
+    });
+    dirty = true;
+}
+
+void ContentFilter::ClearRegexes()
+{
+    std::erase_if(rules, [](const Rule& rule) {
+        return rule.is_regex;
+    });
+    regexes.clear();
+    dirty = true;
+}
+
+void ContentFilter::ResetHits()
+{
+    for (auto& rule : rules) {
+        rule.hits = 0;
+    }
+}
+
+void ContentFilter::Compile()
+{
+    lowercase_matcher.Clear();
+    exact_matcher.Clear();
+    rule_patterns.clear();
+    for (const auto& rule : rules) {
+        auto& matcher = rule.literal_ignores_case ? lowercase_matcher : exact_matcher;
+        rule_patterns.push_back(matcher.Add(rule.required_literal));
+    }
+    dirty = false;
+}
+
+const ContentFilter::Rule* ContentFilter::Match(const std::wstring_view sanitized, const std::wstring_view lowercase)
+{
+    if (rules.empty()) {
+        return nullptr;
+    }
+    if (dirty) {
+        Compile();
+    }
+    lowercase_matcher.FindAll(lowercase, found_lowercase);
+    exact_matcher.FindAll(sanitized, found_exact);
+
+    size_t regex_index = 0;
+    for (size_t i = 0; i < rules.size(); i++) {
+        auto& rule = rules[i];
+        const uint32_t pattern = rule_patterns[i];
+        const bool literal_found = pattern != StringReplacer::NO_PATTERN && (rule.literal_ignores_case ? found_lowercase : found_exact)[pattern];
+        bool matched;
+        if (!rule.is_regex) {
+            matched = literal_found;
+        }
+        else {
+            const auto& regex = regexes[regex_index++];
+            matched = (literal_found || pattern == StringReplacer::NO_PATTERN)
+                      && std::regex_search(sanitized.begin(), sanitized.end(), regex);
+        }
+        if (matched) {
+            rule.hits++;
+            return &rule;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Utils/StringReplacer.h>
+
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Matches chat messages against a list of plain words and regular expressions.
+// All the words go into one multi-pattern matcher, so checking a message costs one pass over it however many words there are.
+// Regexes are still std::wregex, but each one is pre-filtered: a literal that every match has to contain is pulled out of the
+// pattern when compiling, all of those literals are searched for in the same pass as the words, and a regex only runs when its
+// literal was found. Regexes with no usable literal (alternation at the top level, non-ECMAScript syntax) run on every message.
+class ContentFilter {
+public:
+    struct Rule {
+        std::wstring source;
+        bool is_regex = false;
+        // Literal every match must contain; empty if the rule has to run on every message
+        std::wstring required_literal;
+        bool literal_ignores_case = false;
+        uint32_t hits = 0;
+    };
+
+    // Words are matched case insensitively; pass them already lowercased
+    void AddWord(std::wstring_view word);
+    // Throws std::regex_error if the expression doesn't compile, like std::wregex does
+    void AddRegex(const std::wstring& expression, std::regex_constants::syntax_option_type flags);
+    void ClearWords();
+    void ClearRegexes();
+
+    // Returns the first rule (words before regexes) that matches, or nullptr. Bumps that rule's hit counter.
+    // lowercase is sanitized run through GuiUtils::ToLower.
+    const Rule* Match(std::wstring_view sanitized, std::wstring_view lowercase);
+
+    [[nodiscard]] bool empty() const { return rules.empty(); }
+    [[nodiscard]] const std::vector<Rule>& Rules() const { return rules; }
+    void ResetHits();
+
+    // Longest literal that every match of an ECMAScript expression must contain, or empty if there isn't one we can prove.
+    // With ignore_case the literal is lowercased, and stops at any non-ASCII character.
+    static std::wstring RequiredLiteral(std::wstring_view expression, bool ignore_case);
+
+private:
+    void Compile();
+
+    std::vector<Rule> rules;
+    // Parallel to the regex rules in rules
+    std::vector<std::wregex> regexes;
+    // Pattern index of each rule in its matcher, or NO_PATTERN
+    std::vector<uint32_t> rule_patterns;
+    bool dirty = false;
+
+    StringReplacer lowercase_matcher;
+    StringReplacer exact_matcher;
+    std::vector<bool> found_lowercase;
+    std::vector<bool> found_exact;
+};
@@ -0,0 +1,317 @@
+#include <stdafx.h>
+
+#include <GWCA/Managers/UIMgr.h>
+
+#include <Timer.h>
+
+#include "EncStringCache.h"
+
+namespace {
+    constexpr char file_magic[4] = {'G', 'W', 'D', 'S'};
+    constexpr uint32_t file_version = 2;
+    // Ask the game again if it hasn't answered by then; it never calls back for some invalid strings
+    constexpr clock_t retry_after_ms = 5000;
+    // Strings with player entered text in them (chat messages etc) are one-offs; don't grow the cache without limit
+    constexpr size_t max_entries = 100000;
+
+    struct Entry {
+        std::wstring decoded;
+        std::wstring without_tags;
+        clock_t requested_at = 0;
+        uint32_t language = 0;
+        // Decodes sent to the game that it hasn't answered yet; a retry can leave more than one out at once
+        uint32_t in_flight = 0;
+        bool ready = false;
+        bool has_without_tags = false;
+    };
+
+    // The game may call back straight away from inside AsyncDecodeStr
+    std::recursive_mutex mutex;
+    // Language as the first character, then the encoded string
+    std::unordered_map<std::wstring, Entry> entries;
+    EncStringCache::Stats stats;
+
+    std::wstring MakeKey(const std::wstring_view encoded, const GW::Constants::TextLanguage language)
+    {
+        std::wstring key;
+        key.reserve(encoded.size() + 1);
+        key.push_back(static_cast<wchar_t>(language));
+        key.append(encoded);
+        return key;
+    }
+
+    // Decoded in whatever the client's text language is (the default for GuiUtils::EncString), which can be different next
+    // session; only strings decoded in a fixed language are saved
+    bool InClientLanguage(const std::wstring_view key)
+    {
+        return key.front() == static_cast<wchar_t>(static_cast<GW::Constants::TextLanguage>(-1));
+    }
+
+    // Contains a literal string segment i.e. text typed by a player rather than looked up from the game's string table
+    bool HasLiteral(const std::wstring_view encoded)
+    {
+        return encoded.find(static_cast<wchar_t>(0x107)) != std::wstring_view::npos;
+    }
+
+    const std::wstring* Result(Entry& entry, const bool remove_tags)
+    {
+        if (!remove_tags) {
+            return &entry.decoded;
+        }
+        if (!entry.has_without_tags) {
+            entry.without_tags = EncStringCache::RemoveTags(entry.decoded);
+            entry.has_without_tags = true;
+        }
+        return &entry.without_tags;
+    }
+
+    // ReSharper disable once CppParameterMayBeConst
+    void OnStringDecoded(void* param, wchar_t* decoded)
+    {
+        std::lock_guard lock(mutex);
+        const auto entry = static_cast<Entry*>(param);
+        entry->in_flight--;
+        if (entry->ready) {
+            return; // Answer to a retry; callers may already have the first one
+        }
+        entry->decoded = decoded ? decoded : L"";
+        entry->ready = true;
+    }
+
+    void RequestDecode(const std::wstring& key, Entry& entry)
+    {
+        entry.requested_at = TIMER_INIT();
+        // Map nodes don't move, and entries aren't erased while the game has a decode of theirs in flight (see Erasable),
+        // so the game can hold onto the pointer
+        entry.in_flight++;
+        GW::UI::AsyncDecodeStr(key.c_str() + 1, OnStringDecoded, &entry, entry.language);
+    }
+
+    bool Erasable(const std::pair<const std::wstring, Entry>& it)
+    {
+        return it.second.ready && !it.second.in_flight;
+    }
+
+    void TrimLocked()
+    {
+        if (entries.size() < max_entries) {
+            return;
+        }
+        std::erase_if(entries, Erasable);
+    }
+
+    template <typename T>
+    bool Read(std::ifstream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    bool ReadString(std::ifstream& in, std::wstring& value)
+    {
+        uint32_t length = 0;
+        if (!Read(in, length) || length > 0xffff) {
+            return false;
+        }
+        value.resize(length);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(value.data()), length * sizeof(wchar_t)));
+    }
+
+    void WriteString(std::ofstream& out, const std::wstring& value)
+    {
+        const auto length = static_cast<uint32_t>(value.size());
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(reinterpret_cast<const char*>(value.data()), length * sizeof(wchar_t));
+    }
+
+    // Identifies the game build the strings were decoded with
+    uint64_t GetGameBuildStamp()
+    {
+        wchar_t exe_path[MAX_PATH];
+        if (!GetModuleFileNameW(nullptr, exe_path, _countof(exe_path))) {
+            return 0;
+        }
+        std::error_code ec;
+        const auto write_time = std::filesystem::last_write_time(exe_path, ec);
+        const auto size = std::filesystem::file_size(exe_path, ec);
+        if (ec) {
+            return 0;
+        }
+        return static_cast<uint64_t>(write_time.time_since_epoch().count()) ^ (static_cast<uint64_t>(size) << 32);
+    }
+}
+
+namespace EncStringCache {
+    std::wstring RemoveTags(const std::wstring_view decoded)
+    {
+        std::wstring out;
+        out.reserve(decoded.size());
+        size_t i = 0;
+        while (i < decoded.size()) {
+            const size_t open = decoded.find(L'<', i);
+            if (open == std::wstring_view::npos) {
+                break;
+            }
+            // Same as matching <[^>]+>: everything up to the next >, as long as there's something in between
+            const size_t close = decoded.find(L'>', open + 1);
+            if (close == std::wstring_view::npos) {
+                break; // No more tags can be closed
+            }
+            if (close == open + 1) {
+                out.append(decoded.substr(i, close - i));
+                i = close;
+                continue;
+            }
+            out.append(decoded.substr(i, open - i));
+            i = close + 1;
+        }
+        out.append(decoded.substr(std::min(i, decoded.size())));
+        return out;
+    }
+
+    const std::wstring* Decode(const std::wstring_view encoded, const GW::Constants::TextLanguage language, const bool remove_tags)
+    {
+        if (encoded.empty()) {
+            return nullptr;
+        }
+        auto key = MakeKey(encoded, language);
+        std::lock_guard lock(mutex);
+        const auto found = entries.find(key);
+        if (found == entries.end()) {
+            TrimLocked();
+            stats.misses++;
+            const auto inserted = entries.emplace(std::move(key), Entry()).first;
+            inserted->second.language = static_cast<uint32_t>(language);
+            RequestDecode(inserted->first, inserted->second);
+            return nullptr;
+        }
+        auto& entry = found->second;
+        if (entry.ready) {
+            stats.hits++;
+            return Result(entry, remove_tags);
+        }
+        stats.coalesced++;
+        if (TIMER_DIFF(entry.requested_at) > retry_after_ms) {
+            RequestDecode(found->first, entry);
+        }
+        return nullptr;
+    }
+
+    const std::wstring* Find(const std::wstring_view encoded, const GW::Constants::TextLanguage language, const bool remove_tags, bool* missing)
+    {
+        if (missing) {
+            *missing = false;
+        }
+        if (encoded.empty()) {
+            return nullptr;
+        }
+        std::lock_guard lock(mutex);
+        const auto found = entries.find(MakeKey(encoded, language));
+        if (found == entries.end()) {
+            if (missing) {
+                *missing = true;
+            }
+            return nullptr;
+        }
+        auto& entry = found->second;
+        if (entry.ready) {
+            return Result(entry, remove_tags);
+        }
+        if (TIMER_DIFF(entry.requested_at) > retry_after_ms) {
+            RequestDecode(found->first, entry);
+        }
+        return nullptr;
+    }
+
+    void Clear()
+    {
+        std::lock_guard lock(mutex);
+        std::erase_if(entries, Erasable);
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard lock(mutex);
+        auto out = stats;
+        out.entries = entries.size();
+        return out;
+    }
+
+    bool Load(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        char magic[4];
+        uint32_t version = 0;
+        uint64_t build = 0;
+        uint32_t count = 0;
+        if (!(in.read(magic, sizeof(magic)) && memcmp(magic, file_magic, sizeof(magic)) == 0 && Read(in, version) && version == file_version)) {
+            return false;
+        }
+        if (!(Read(in, build) && build == GetGameBuildStamp() && Read(in, count))) {
+            return false; // Game has updated since; strings may have changed
+        }
+        std::vector<std::pair<std::wstring, std::wstring>> loaded;
+        loaded.reserve(std::min<uint32_t>(count, max_entries));
+        for (uint32_t i = 0; i < count && loaded.size() < max_entries; i++) {
+            auto& [key, decoded] = loaded.emplace_back();
+            if (!(ReadString(in, key) && ReadString(in, decoded)) || key.size() < 2) {
+                loaded.pop_back();
+                break; // Truncated; keep what we've got
+            }
+            if (InClientLanguage(key)) {
+                loaded.pop_back();
+            }
+        }
+        std::lock_guard lock(mutex);
+        for (auto& [key, decoded] : loaded) {
+            // Anything requested before the file was loaded wins
+            auto [it, inserted] = entries.try_emplace(std::move(key));
+            if (inserted) {
+                it->second.decoded = std::move(decoded);
+                it->second.ready = true;
+                stats.loaded++;
+            }
+        }
+        return true;
+    }
+
+    bool Save(const std::filesystem::path& path)
+    {
+        std::vector<std::pair<std::wstring, std::wstring>> to_save;
+        {
+            std::lock_guard lock(mutex);
+            to_save.reserve(entries.size());
+            for (const auto& [key, entry] : entries) {
+                if (entry.ready && !InClientLanguage(key) && !HasLiteral(std::wstring_view(key).substr(1))) {
+                    to_save.emplace_back(key, entry.decoded);
+                }
+            }
+        }
+        auto tmp_path = path;
+        tmp_path += L".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                return false;
+            }
+            const uint64_t build = GetGameBuildStamp();
+            const auto count = static_cast<uint32_t>(to_save.size());
+            out.write(file_magic, sizeof(file_magic));
+            out.write(reinterpret_cast<const char*>(&file_version), sizeof(file_version));
+            out.write(reinterpret_cast<const char*>(&build), sizeof(build));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& [key, decoded] : to_save) {
+                WriteString(out, key);
+                WriteString(out, decoded);
+            }
+            if (!out) {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        return !ec;
+    }
+}
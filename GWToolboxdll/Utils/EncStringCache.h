@@ -0,0 +1,44 @@
+#pragma once
+
+#include <GWCA/Constants/Constants.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// Process wide cache of decoded strings, keyed by encoded string and language, shared by every GuiUtils::EncString.
+// The same map, skill and NPC names are decoded all over toolbox; each is only sent to the game to decode once, and any
+// requests made while that decode is in flight wait for the same result. The result is stored with <tags> removed too.
+// Ready results can be saved and loaded between sessions; they're thrown away when the game executable changes. Strings decoded
+// in the client's own text language aren't saved, since the language may have changed by the next session.
+namespace EncStringCache {
+    struct Stats {
+        size_t entries = 0;
+        // Already decoded
+        uint64_t hits = 0;
+        // Had to ask the game to decode
+        uint64_t misses = 0;
+        // Waited on a decode another request had already started
+        uint64_t coalesced = 0;
+        // Entries read from disk at startup
+        size_t loaded = 0;
+    };
+
+    // Decoded string, or nullptr if it isn't ready yet, in which case the game is asked to decode it; call Find() until it is.
+    // Copy the result straight away; the cache drops decoded strings when it grows too big.
+    const std::wstring* Decode(std::wstring_view encoded, GW::Constants::TextLanguage language, bool remove_tags);
+    // Like Decode(), but never starts a decode and doesn't count towards the stats. Sets *missing if the string isn't cached at
+    // all, e.g. because it was dropped to make room before it was picked up; Decode() it again then.
+    const std::wstring* Find(std::wstring_view encoded, GW::Constants::TextLanguage language, bool remove_tags, bool* missing = nullptr);
+
+    // Remove <...> markup from a decoded string in one pass
+    std::wstring RemoveTags(std::wstring_view decoded);
+
+    bool Load(const std::filesystem::path& path);
+    bool Save(const std::filesystem::path& path);
+    // Forget everything that isn't waiting on the game
+    void Clear();
+
+    Stats GetStats();
+}
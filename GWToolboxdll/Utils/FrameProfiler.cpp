@@ -0,0 +1,230 @@
+#include "stdafx.h"
+
+#include "FrameProfiler.h"
+
+namespace FrameProfiler {
+    std::atomic<bool> enabled = false;
+}
+
+namespace {
+    using namespace FrameProfiler;
+
+    struct ZoneData {
+        Phase phase;
+        std::string name;
+        uint64_t calls = 0;
+        // Durations in ticks, a ring of the last sample_count
+        std::array<uint32_t, sample_count> samples{};
+        size_t next_sample = 0;
+    };
+
+    struct TraceEvent {
+        int64_t start;
+        uint32_t duration;
+        uint32_t zone;
+        uint32_t thread;
+    };
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ZoneData>> zones;
+    std::unordered_map<uint64_t, uint32_t> zone_by_key;
+    std::vector<TraceEvent> trace;
+    size_t trace_next = 0;
+
+    int64_t Frequency()
+    {
+        static const int64_t frequency = [] {
+            LARGE_INTEGER li;
+            QueryPerformanceFrequency(&li);
+            return li.QuadPart;
+        }();
+        return frequency;
+    }
+
+    float TicksToMs(const uint64_t ticks)
+    {
+        return static_cast<float>(static_cast<double>(ticks) * 1000.0 / static_cast<double>(Frequency()));
+    }
+
+    uint32_t GetZone(const Phase phase, const uintptr_t key, const char* name)
+    {
+        const uint64_t id = static_cast<uint64_t>(phase) << 56 ^ key;
+        const auto found = zone_by_key.find(id);
+        if (found != zone_by_key.end()) {
+            return found->second;
+        }
+        auto zone = std::make_unique<ZoneData>();
+        zone->phase = phase;
+        if (name) {
+            zone->name = name;
+        }
+        else {
+            StrSprintf(zone->name, "%s %u", PhaseName(phase), static_cast<uint32_t>(key));
+        }
+        const auto index = static_cast<uint32_t>(zones.size());
+        zones.push_back(std::move(zone));
+        zone_by_key.emplace(id, index);
+        return index;
+    }
+
+    void WriteJsonString(FILE* file, const std::string& str)
+    {
+        fputc('"', file);
+        for (const char c : str) {
+            if (c == '"' || c == '\\') {
+                fputc('\\', file);
+                fputc(c, file);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                fprintf(file, "\\u%04x", c);
+            }
+            else {
+                fputc(c, file);
+            }
+        }
+        fputc('"', file);
+    }
+}
+
+void FrameProfiler::SetEnabled(const bool enable)
+{
+    if (enable) {
+        std::lock_guard lock(mutex);
+        trace.reserve(trace_capacity);
+    }
+    enabled = enable;
+}
+
+void FrameProfiler::Reset()
+{
+    std::lock_guard lock(mutex);
+    zones.clear();
+    zone_by_key.clear();
+    trace.clear();
+    trace_next = 0;
+}
+
+int64_t FrameProfiler::Now()
+{
+    LARGE_INTEGER li;
+    QueryPerformanceCounter(&li);
+    return li.QuadPart;
+}
+
+void FrameProfiler::Record(const Phase phase, const uintptr_t key, const char* name, const int64_t start)
+{
+    const int64_t end = Now();
+    const auto duration = static_cast<uint32_t>(std::min<int64_t>(end - start, UINT32_MAX));
+
+    std::lock_guard lock(mutex);
+    const uint32_t index = GetZone(phase, key, name);
+    ZoneData& zone = *zones[index];
+    zone.samples[zone.next_sample] = duration;
+    zone.next_sample = (zone.next_sample + 1) % sample_count;
+    zone.calls++;
+
+    const TraceEvent event = {start, duration, index, GetCurrentThreadId()};
+    if (trace.size() < trace_capacity) {
+        trace.push_back(event);
+    }
+    else {
+        trace[trace_next] = event;
+        trace_next = (trace_next + 1) % trace_capacity;
+    }
+}
+
+const char* FrameProfiler::PhaseName(const Phase phase)
+{
+    switch (phase) {
+        case Phase::Frame:
+            return "Frame";
+        case Phase::Update:
+            return "Update";
+        case Phase::Draw:
+            return "Draw";
+        case Phase::WndProc:
+            return "WndProc";
+        case Phase::StoC:
+            return "StoC";
+        default:
+            return "Unknown";
+    }
+}
+
+void FrameProfiler::GetStats(std::vector<ZoneStats>& out)
+{
+    out.clear();
+    std::vector<uint32_t> sorted;
+    std::lock_guard lock(mutex);
+    out.reserve(zones.size());
+    for (const auto& zone : zones) {
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(zone->calls, sample_count));
+        sorted.assign(zone->samples.begin(), zone->samples.begin() + count);
+        // Percentiles only need the elements at their rank in place, not the whole ring sorted
+        const size_t p50_rank = count / 2;
+        const size_t p99_rank = (count * 99 + 99) / 100 - 1;
+        std::ranges::nth_element(sorted, sorted.begin() + p99_rank);
+        const uint32_t p99 = sorted[p99_rank];
+        std::nth_element(sorted.begin(), sorted.begin() + p50_rank, sorted.begin() + p99_rank);
+        const uint32_t p50 = sorted[p50_rank];
+        const uint32_t max = *std::max_element(sorted.begin() + p99_rank, sorted.end());
+        uint64_t total = 0;
+        for (const uint32_t sample : sorted) {
+            total += sample;
+        }
+        out.push_back({zone->phase, zone->name, zone->calls, TicksToMs(p50), TicksToMs(p99), TicksToMs(max), TicksToMs(total)});
+    }
+}
+
+size_t FrameProfiler::TraceSize()
+{
+    std::lock_guard lock(mutex);
+    return trace.size();
+}
+
+bool FrameProfiler::ExportTrace(const std::filesystem::path& path)
+{
+    std::vector<TraceEvent> events;
+    std::vector<std::pair<Phase, std::string>> names;
+    {
+        std::lock_guard lock(mutex);
+        // Oldest first
+        events.reserve(trace.size());
+        events.insert(events.end(), trace.begin() + trace_next, trace.end());
+        events.insert(events.end(), trace.begin(), trace.begin() + trace_next);
+        names.reserve(zones.size());
+        for (const auto& zone : zones) {
+            names.emplace_back(zone->phase, zone->name);
+        }
+    }
+
+    auto tmp_path = path;
+    tmp_path += L".tmp";
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, tmp_path.c_str(), L"wb") != 0 || !file) {
+        return false;
+    }
+    // Timestamps are microseconds from the first event
+    const int64_t base = events.empty() ? 0 : events.front().start;
+    const double us_per_tick = 1000000.0 / static_cast<double>(Frequency());
+    const DWORD pid = GetCurrentProcessId();
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& event = events[i];
+        const auto& [phase, name] = names[event.zone];
+        fputs(i ? ",\n{\"name\":" : "\n{\"name\":", file);
+        WriteJsonString(file, name);
+        fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%u}",
+                PhaseName(phase), static_cast<double>(event.start - base) * us_per_tick,
+                static_cast<double>(event.duration) * us_per_tick, pid, event.thread);
+    }
+    fputs("\n]}\n", file);
+    const bool ok = !ferror(file);
+    if (fclose(file) != 0 || !ok) {
+        _wremove(tmp_path.c_str());
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    return !ec;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Timing of what toolbox does every frame: each module's Update, Draw and WndProc, and the StoC packets it handles.
+// A zone is a named span of time (e.g. "Minimap" in Draw); each keeps its last sample_count durations for percentiles,
+// and every span is also recorded in a fixed size trace that can be written out as Chrome trace JSON, to be looked
+// at in chrome://tracing or Perfetto.
+// Nothing is recorded while it's disabled, which is the default; a zone then costs a flag check. Thread safe.
+namespace FrameProfiler {
+    enum class Phase : uint8_t {
+        Frame,
+        Update,
+        Draw,
+        WndProc,
+        StoC,
+        Count
+    };
+
+    struct ZoneStats {
+        Phase phase;
+        std::string name;
+        uint64_t calls;
+        // Milliseconds, over the last sample_count calls
+        float p50;
+        float p99;
+        float max;
+        float total;
+    };
+
+    constexpr size_t sample_count = 600;
+    constexpr size_t trace_capacity = 1 << 18;
+
+    extern std::atomic<bool> enabled;
+
+    inline bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+    void SetEnabled(bool enable);
+    // Forget all samples and the trace
+    void Reset();
+
+    // QueryPerformanceCounter
+    int64_t Now();
+    // Record a zone that started at start (from Now()) and ends now. key tells zones of the same phase apart, e.g. the
+    // module or the packet header; name is only read the first time the key is seen, nullptr for "<phase> <key>".
+    void Record(Phase phase, uintptr_t key, const char* name, int64_t start);
+
+    // Times its own lifetime
+    class Zone {
+    public:
+        Zone(const Phase phase, const void* key, const char* name)
+            : phase(phase), key(reinterpret_cast<uintptr_t>(key)), name(name), start(IsEnabled() ? Now() : 0) { }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+        ~Zone()
+        {
+            if (start) {
+                Record(phase, key, name, start);
+            }
+        }
+
+    private:
+        Phase phase;
+        uintptr_t key;
+        const char* name;
+        int64_t start;
+    };
+
+    const char* PhaseName(Phase phase);
+    void GetStats(std::vector<ZoneStats>& out);
+    // Spans in the trace; once it's full, the oldest are overwritten
+    size_t TraceSize();
+    bool ExportTrace(const std::filesystem::path& path);
+}
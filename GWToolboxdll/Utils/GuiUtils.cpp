@@ -8,6 +8,7 @@
 #include <Utf8.h>
 #include <fonts/fontawesome5.h>
 #include <Modules/Resources.h>
+#include <Utils/EncStringCache.h>
 
 #include "GuiUtils.h"
 
@@ -927,36 +928,38 @@ namespace GuiUtils {
 
     std::wstring& EncString::wstring()
     {
-        if (!decoded && !decoding && !encoded_ws.empty()) {
+        if (!decoded && !encoded_ws.empty()) {
+            // sanitised is only false here if it was asked for
+            bool missing = !decoding;
+            const std::wstring* result = decoding ? EncStringCache::Find(encoded_ws, language_id, !sanitised, &missing) : nullptr;
+            if (missing) {
+                // Not asked for yet, or dropped from the cache before we picked it up
+                result = EncStringCache::Decode(encoded_ws, language_id, !sanitised);
+            }
             decoding = true;
-            GW::UI::AsyncDecodeStr(encoded_ws.c_str(), OnStringDecoded, this, static_cast<uint32_t>(language_id));
+            if (result) {
+                decoded_ws = *result;
+                decoded = true;
+                decoding = false;
+            }
         }
         sanitise();
         return decoded_ws;
     }
 
-    void EncString::sanitise()
+    bool EncString::IsDecoding()
     {
-        if (!sanitised && !decoded_ws.empty()) {
-            sanitised = true;
-            static const std::wregex sanitiser(L"<[^>]+>");
-            decoded_ws = std::regex_replace(decoded_ws, sanitiser, L"");
+        if (decoding) {
+            wstring();
         }
+        return decoding && decoded_ws.empty();
     }
 
-    // ReSharper disable once CppParameterMayBeConst
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    void EncString::OnStringDecoded(void* param, wchar_t* decoded)
+    void EncString::sanitise()
     {
-        const auto context = static_cast<EncString*>(param);
-        if (!(context && context->decoding && !context->decoded)) {
-            return; // Not expecting a decoded string; may have been reset() before response was received.
-        }
-        if (decoded && decoded[0]) {
-            context->decoded_ws = decoded;
+        if (!sanitised && !decoded_ws.empty()) {
+            sanitised = true;
         }
-        context->decoded = true;
-        context->decoding = false;
     }
 
     std::string format(const char* msg, ...)
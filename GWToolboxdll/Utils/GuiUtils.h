@@ -142,14 +142,15 @@ namespace GuiUtils {
         bool decoding = false;
         bool decoded = false;
         bool sanitised = false;
+        // Tags are already removed by the decoded string cache; override to clean up the decoded string further
         virtual void sanitise();
         GW::Constants::TextLanguage language_id = static_cast<GW::Constants::TextLanguage>(-1);
-        static void OnStringDecoded(void* param, wchar_t* decoded);
 
     public:
         // Set the language for decoding this encoded string. If the language has changed, resets the decoded result. Returns this for chaining.
         EncString* language(GW::Constants::TextLanguage l = static_cast<GW::Constants::TextLanguage>(-1));
-        bool IsDecoding() const { return decoding && decoded_ws.empty(); };
+        // Picks up the result if the decode has finished since it was started
+        bool IsDecoding();
         // Recycle this EncString by passing a new encoded string id to decode.
         // Set sanitise to true to automatically remove guild tags etc from the string
         void reset(uint32_t _enc_string_id = 0, bool sanitise = true);
@@ -0,0 +1,485 @@
+#include <stdafx.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "GwDatArchive.h"
+
+namespace {
+    // On-disk layout of Gw.dat
+
+#pragma pack(push, 1)
+    struct DatHeader {
+        uint8_t magic[4];
+        uint32_t header_size;
+        uint32_t sector_size;
+        uint32_t crc;
+        uint64_t mft_offset;
+        uint32_t mft_size;
+        uint32_t flags;
+    };
+
+    struct MftHeader {
+        uint8_t magic[4];
+        uint32_t unk1;
+        uint32_t unk2;
+        uint32_t entry_count;
+        uint32_t unk3;
+        uint32_t unk4;
+    };
+
+    struct MftEntry {
+        uint64_t offset;
+        uint32_t size;
+        uint16_t compression;
+        uint8_t flags;
+        uint8_t unk;
+        uint32_t next;
+        uint32_t crc;
+    };
+
+    struct MftHashEntry {
+        uint32_t file_id;
+        uint32_t mft_index;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(MftHeader) == sizeof(MftEntry), "The MFT header takes the place of entry 0");
+
+    constexpr uint8_t dat_magic[4] = {'3', 'A', 'N', 0x1A};
+    constexpr uint8_t mft_magic[4] = {'M', 'f', 't', 0x1A};
+    // MFT entry 1 holds the file id -> MFT index table; entries below 16 are reserved for the archive itself
+    constexpr uint32_t MFT_HASH_TABLE = 1;
+    constexpr uint32_t MFT_FIRST_FILE = 16;
+
+    // Huffman + LZ decompressor for dat records, ported from xentax.cpp in the old dat browser. Works on caller-owned buffers so
+    // nothing is allocated per record once the arena has grown to fit.
+
+    // Code length table used to read the Huffman trees themselves: {lowest code with this length, symbol index base}
+    constexpr uint32_t tree_code_ranges[][2] = {
+        {0xA0000000, 0x02}, {0x60000000, 0x06}, {0x40000000, 0x0A}, {0x20000000, 0x12}, {0x12000000, 0x19}, {0x0C000000, 0x1F}, {0x07000000, 0x29},
+        {0x03000000, 0x39}, {0x01600000, 0x46}, {0x00F00000, 0x4D}, {0x00C00000, 0x53}, {0x00B00000, 0x57}, {0x00A00000, 0x5F}, {0x00000000, 0xFF},
+    };
+
+    // (repeat count - 1) << 5 | code length, for each symbol of the tree description
+    constexpr uint8_t tree_symbols[256] = {
+        0x08, 0x09, 0x0A, 0x00, 0x07, 0x0B, 0x0C, 0x06, 0x29, 0x2A, 0xE0, 0x04, 0x05, 0x20, 0x28, 0x2B, 0x2C, 0x40, 0x4A, 0x03, 0x0D, 0x25, 0x26, 0x27, 0x48, 0x49,
+        0x24, 0x47, 0x4B, 0x4C, 0x69, 0x6A, 0x23, 0x46, 0x60, 0x63, 0x67, 0x68, 0x88, 0x89, 0xA0, 0xE8, 0x01, 0x02, 0x2D, 0x43, 0x44, 0x45, 0x65, 0x66, 0x80, 0x87,
+        0x8A, 0xA8, 0xA9, 0xC0, 0xC9, 0xE9, 0x0E, 0x4D, 0x64, 0x6B, 0x6C, 0x84, 0x85, 0x8B, 0xA4, 0xA5, 0xAA, 0xC8, 0xE5, 0x83, 0x86, 0xA6, 0xA7, 0xC7, 0xCA, 0xE7,
+        0x22, 0x2E, 0x8C, 0xC4, 0xE4, 0xE6, 0x4E, 0x6D, 0xC6, 0xEC, 0x0F, 0x10, 0x11, 0x8D, 0xAB, 0xAC, 0xCC, 0xEA, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+        0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x21, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x41, 0x42,
+        0x4F, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F, 0x61, 0x62, 0x6E, 0x6F, 0x70, 0x71, 0x72, 0x73, 0x74,
+        0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F, 0x81, 0x82, 0x8E, 0x8F, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A,
+        0x9B, 0x9C, 0x9D, 0x9E, 0x9F, 0xA1, 0xA2, 0xA3, 0xAD, 0xAE, 0xAF, 0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE,
+        0xBF, 0xC1, 0xC2, 0xC3, 0xC5, 0xCB, 0xCD, 0xCE, 0xCF, 0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDE, 0xDF, 0xE1,
+        0xE2, 0xE3, 0xEB, 0xED, 0xEE, 0xEF, 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
+    };
+
+    // Literal/length symbols >= 0x100 are match lengths: base + extra bits
+    constexpr uint8_t length_base[36] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 255, 0, 0, 0, 0, 1, 2, 3};
+    constexpr uint8_t length_extra_bits[36] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0, 0, 0, 0, 0, 0, 0, 0};
+    constexpr uint8_t distance_extra_bits[32] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14};
+    constexpr uint16_t distance_base[32] = {0, 1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384, 24576, 256, 770};
+
+    constexpr uint32_t NO_SYMBOL = 0xFFFFFFFF;
+
+    uint32_t LoadWord(const uint8_t* p)
+    {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        return word;
+    }
+
+    // MSB-first bit reader with a 64 bit window in cur:next
+    struct BitReader {
+        const uint8_t* pos = nullptr;
+        const uint8_t* end = nullptr;
+        uint32_t avail = 0;
+        uint32_t cur = 0;
+        uint32_t next = 0;
+
+        void Skip(const uint32_t n)
+        {
+            if (n) {
+                cur = (next >> (32 - n)) | (cur << n);
+            }
+            if (n <= avail) {
+                next <<= n;
+                avail -= n;
+            }
+            else if (pos == end) {
+                next = 0;
+                avail = 0;
+            }
+            else {
+                const uint32_t word = LoadWord(pos);
+                pos += 4;
+                const uint32_t remaining = avail - n + 32;
+                cur |= word >> remaining;
+                next = word << (n - avail);
+                avail = remaining;
+            }
+        }
+
+        uint32_t Read(const uint32_t n)
+        {
+            const uint32_t value = cur >> (32 - n);
+            Skip(n);
+            return value;
+        }
+    };
+
+    struct HuffmanTable {
+        // {code length, symbol} for every 8 bit prefix; length NO_SYMBOL means the code is longer and lives in long_codes
+        uint32_t prefix[0x200];
+        // {lowest code, last index into symbols, code length} per code length above 8
+        uint32_t long_codes[0x48];
+        std::vector<uint32_t>* symbols;
+
+        bool Decode(BitReader& bits, uint32_t& symbol) const
+        {
+            const uint32_t i = (bits.cur >> 24) * 2;
+            uint32_t length = prefix[i];
+            symbol = prefix[i + 1];
+            if (length == NO_SYMBOL) {
+                size_t k = 0;
+                while (bits.cur < long_codes[k]) {
+                    k += 3;
+                    if (k + 2 >= _countof(long_codes)) {
+                        return false;
+                    }
+                }
+                length = long_codes[k + 2];
+                // Shift count masked like the x86 original, so a zero length entry doesn't shift at all
+                const uint32_t index = long_codes[k + 1] - ((bits.cur - long_codes[k]) >> ((32 - length) & 31));
+                if (index >= symbols->size()) {
+                    return false;
+                }
+                symbol = (*symbols)[index];
+            }
+            if (length >= 32) {
+                return false;
+            }
+            bits.Skip(length);
+            return true;
+        }
+
+        // Read a tree description from the stream. Mirrors the game's decoder, including leaving the previous block's table in place
+        // for the (degenerate) descriptions it bails out of early.
+        bool Build(BitReader& bits, std::vector<uint32_t>& links)
+        {
+            symbols->clear();
+            const uint32_t count = bits.Read(16);
+            links.assign(count, 0);
+
+            // Symbols with each code length form a linked list through links; heads[length] is the last symbol added
+            uint32_t heads[0x20];
+            std::fill(std::begin(heads), std::end(heads), NO_SYMBOL);
+            uint32_t total = 0;
+
+            uint32_t symbol = count - 1;
+            while (symbol != NO_SYMBOL) {
+                size_t i = 0;
+                while (bits.cur < tree_code_ranges[i][0]) {
+                    i++;
+                }
+                const uint32_t code_bits = static_cast<uint32_t>(i * 8 + 0x18) >> 3;
+                const uint32_t index = tree_code_ranges[i][1] - ((bits.cur - tree_code_ranges[i][0]) >> (32 - code_bits));
+                if (index >= _countof(tree_symbols)) {
+                    return false;
+                }
+                const uint32_t value = tree_symbols[index];
+                bits.Skip(code_bits);
+
+                uint32_t repeat = value >> 5;
+                const uint32_t length = value & 0x1F;
+                if (repeat > symbol) {
+                    return true;
+                }
+                if (length || count < 2) {
+                    total += repeat + 1;
+                    do {
+                        if (symbol >= count) {
+                            return false;
+                        }
+                        links[symbol] = heads[length];
+                        heads[length] = symbol;
+                        symbol--;
+                    } while (repeat-- && symbol != NO_SYMBOL);
+                }
+                else {
+                    symbol -= repeat + 1;
+                }
+            }
+
+            if (count && !total) {
+                links[count - 1] = heads[0];
+                heads[0] = count - 1;
+                total = 1;
+            }
+
+            // Codes up to 8 bits go straight into the prefix table, every prefix that starts with the code pointing at its symbol
+            memset(prefix, 0, sizeof(prefix));
+            uint32_t assigned = 0;
+            uint32_t code = 0;
+            uint32_t length = 0;
+            for (; length <= 8; length++, code = code * 2 + 1) {
+                for (uint32_t s = heads[length]; s != NO_SYMBOL; s = links[s], assigned++, code--) {
+                    if (code >= 1u << length || s >= count) {
+                        return true;
+                    }
+                    const uint32_t base = code << (8 - length);
+                    for (uint32_t fill = 0; fill < 1u << (8 - length); fill++) {
+                        prefix[(base | fill) * 2] = length;
+                        prefix[(base | fill) * 2 + 1] = s;
+                    }
+                }
+            }
+            if (assigned > total) {
+                return false;
+            }
+            if (assigned == total) {
+                return true;
+            }
+
+            // Longer codes get a range per length in long_codes, with their symbols in order in the symbols array
+            symbols->resize(total - assigned, 0);
+            uint32_t* long_code = long_codes;
+            uint32_t index = 0;
+            for (; length <= 0x1F; length++, code = code * 2 + 1) {
+                if (heads[length] == NO_SYMBOL) {
+                    continue;
+                }
+                for (uint32_t s = heads[length]; s != NO_SYMBOL; s = links[s], index++, code--) {
+                    if (code > 1u << length || s >= count) {
+                        return true;
+                    }
+                    const uint32_t prefix_index = code >> (length - 8);
+                    if (prefix_index >= 0x100 || index >= symbols->size()) {
+                        return false;
+                    }
+                    prefix[prefix_index * 2] = NO_SYMBOL;
+                    (*symbols)[index] = s;
+                }
+                long_code[0] = (code + 1) << (32 - length);
+                long_code[1] = index - 1;
+                long_code[2] = length;
+                long_code += 3;
+            }
+            return true;
+        }
+    };
+
+    bool DecompressRecord(const uint8_t* input, const size_t input_size, uint8_t* output, const size_t output_size, std::vector<uint32_t> (&scratch)[3])
+    {
+        if (input_size < 12) {
+            return false;
+        }
+        BitReader bits;
+        bits.pos = input + 8;
+        bits.end = input + input_size / 4 * 4;
+        const uint32_t first = LoadWord(input);
+        const uint32_t second = LoadWord(input + 4);
+        bits.cur = first << 4 | second >> 28;
+        bits.next = second << 4;
+        bits.avail = 28;
+
+        const uint32_t min_match = bits.Read(4);
+        if (!output_size) {
+            return true;
+        }
+
+        HuffmanTable literals{};
+        HuffmanTable distances{};
+        literals.symbols = &scratch[0];
+        distances.symbols = &scratch[1];
+        std::vector<uint32_t>& links = scratch[2];
+
+        uint8_t* out = output;
+        uint8_t* const out_end = output + output_size;
+        while (out != out_end) {
+            if (!literals.Build(bits, links) || !distances.Build(bits, links)) {
+                return false;
+            }
+            for (uint32_t remaining = (bits.Read(4) + 1) << 12; remaining && out != out_end; remaining--) {
+                uint32_t symbol;
+                if (!literals.Decode(bits, symbol)) {
+                    return false;
+                }
+                if (symbol < 0x100) {
+                    *out++ = static_cast<uint8_t>(symbol);
+                    continue;
+                }
+                symbol -= 0x100;
+                if (symbol >= _countof(length_base)) {
+                    return false;
+                }
+                uint32_t length = length_base[symbol];
+                if (const uint32_t extra = length_extra_bits[symbol]) {
+                    length |= bits.Read(extra);
+                }
+                length += min_match + 1;
+
+                if (!distances.Decode(bits, symbol) || symbol >= _countof(distance_base)) {
+                    return false;
+                }
+                uint32_t distance = distance_base[symbol];
+                if (const uint32_t extra = distance_extra_bits[symbol]) {
+                    distance = distance_base[symbol] | bits.Read(extra);
+                }
+                if (length > static_cast<size_t>(out_end - out) || distance >= static_cast<size_t>(out - output)) {
+                    return false;
+                }
+                // Byte by byte; matches can overlap their own output
+                const uint8_t* from = out - distance - 1;
+                for (uint32_t i = 0; i < length; i++) {
+                    *out++ = *from++;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+bool GwDatArchive::Open(const wchar_t* path)
+{
+    Close();
+    if (!file.Open(path)) {
+        return false;
+    }
+    const auto fail = [this] {
+        Close();
+        return false;
+    };
+
+    const auto header_view = file.Map(0, sizeof(DatHeader));
+    if (!header_view) {
+        return fail();
+    }
+    DatHeader header;
+    memcpy(&header, header_view.GetData(), sizeof(header));
+    if (memcmp(header.magic, dat_magic, sizeof(dat_magic)) != 0 || header.mft_size < sizeof(MftHeader)) {
+        return fail();
+    }
+
+    const auto mft_view = file.Map(header.mft_offset, header.mft_size);
+    if (!mft_view) {
+        return fail();
+    }
+    MftHeader mft_header;
+    memcpy(&mft_header, mft_view.GetData(), sizeof(mft_header));
+    if (memcmp(mft_header.magic, mft_magic, sizeof(mft_magic)) != 0) {
+        return fail();
+    }
+    // The header doubles as entry 0, so MFT indices can be used directly
+    const size_t entry_count = std::min<size_t>(mft_header.entry_count, header.mft_size / sizeof(MftEntry));
+    const auto entries = reinterpret_cast<const MftEntry*>(mft_view.GetData());
+    if (entry_count <= MFT_FIRST_FILE) {
+        return fail();
+    }
+
+    // Map file ids onto MFT entries; an entry can be referenced by more than one id
+    std::vector<MftHashEntry> hashes;
+    {
+        MftEntry hash_entry;
+        memcpy(&hash_entry, &entries[MFT_HASH_TABLE], sizeof(hash_entry));
+        const auto hash_view = file.Map(hash_entry.offset, hash_entry.size);
+        if (!hash_view) {
+            return fail();
+        }
+        hashes.resize(hash_view.GetSize() / sizeof(MftHashEntry));
+        memcpy(hashes.data(), hash_view.GetData(), hashes.size() * sizeof(MftHashEntry));
+    }
+
+    std::vector<bool> referenced(entry_count, false);
+    records.reserve(hashes.size());
+    const auto add_record = [&](const uint32_t file_id, const uint32_t mft_index) {
+        MftEntry entry;
+        memcpy(&entry, &entries[mft_index], sizeof(entry));
+        if (!entry.size) {
+            return;
+        }
+        records.push_back({file_id, mft_index, entry.offset, entry.size, entry.crc, entry.compression, entry.flags});
+    };
+    for (const auto& [file_id, mft_index] : hashes) {
+        if (mft_index < MFT_FIRST_FILE || mft_index >= entry_count) {
+            continue;
+        }
+        referenced[mft_index] = true;
+        add_record(file_id, mft_index);
+    }
+    for (uint32_t i = MFT_FIRST_FILE; i < entry_count; i++) {
+        if (!referenced[i]) {
+            add_record(0, i);
+        }
+    }
+    std::ranges::sort(records, [](const Record& a, const Record& b) {
+        return a.file_id < b.file_id || (a.file_id == b.file_id && a.mft_index < b.mft_index);
+    });
+    records.shrink_to_fit();
+    return true;
+}
+
+void GwDatArchive::Close()
+{
+    file.Close();
+    records.clear();
+    records.shrink_to_fit();
+}
+
+const GwDatArchive::Record* GwDatArchive::Find(const uint32_t file_id) const
+{
+    if (!file_id) {
+        return nullptr;
+    }
+    const auto found = std::ranges::lower_bound(records, file_id, {}, &Record::file_id);
+    return found != records.end() && found->file_id == file_id ? &*found : nullptr;
+}
+
+bool GwDatArchive::Read(const Record& record, Arena& arena) const
+{
+    const auto view = file.Map(record.offset, record.size);
+    if (!view) {
+        return false;
+    }
+    if (!record.compression) {
+        arena.output.assign(view.GetData(), view.GetData() + view.GetSize());
+        return true;
+    }
+    // Compressed records end with their unpacked size
+    if (view.GetSize() < 4) {
+        return false;
+    }
+    const uint32_t unpacked_size = LoadWord(view.GetData() + view.GetSize() - 4);
+    arena.output.resize(unpacked_size);
+    return DecompressRecord(view.GetData(), view.GetSize(), arena.output.data(), arena.output.size(), arena.scratch);
+}
+
+size_t GwDatArchive::ReadParallel(const Record* to_read, const size_t count, size_t num_threads, const RecordCallback& callback) const
+{
+    std::atomic<size_t> next = 0;
+    std::atomic<size_t> succeeded = 0;
+    const auto worker = [&] {
+        Arena arena;
+        for (size_t i = next++; i < count; i = next++) {
+            if (!Read(to_read[i], arena)) {
+                continue;
+            }
+            succeeded++;
+            if (callback) {
+                callback(to_read[i], arena.output.data(), arena.output.size());
+            }
+        }
+    };
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(count, 1));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return succeeded;
+}
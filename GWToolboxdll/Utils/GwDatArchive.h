@@ -0,0 +1,59 @@
+#pragma once
+
+#include <File.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Read-only access to the records in Gw.dat. The MFT is parsed once on Open() into an index sorted by file id; record data is only
+// mapped while it's being read, so this works on the whole archive from a 32 bit process. Reads are safe from any number of threads.
+class GwDatArchive {
+public:
+    struct Record {
+        // Id the game uses to look the file up; 0 for records nothing references by id
+        uint32_t file_id;
+        uint32_t mft_index;
+        uint64_t offset;
+        // Size on disk, before decompression
+        uint32_t size;
+        uint32_t crc;
+        uint16_t compression;
+        uint8_t flags;
+    };
+
+    // Buffers reused between reads so that decompressing many records doesn't allocate for each one. Use one per thread.
+    struct Arena {
+        std::vector<uint8_t> output;
+        // Huffman tree working space
+        std::vector<uint32_t> scratch[3];
+    };
+
+    using RecordCallback = std::function<void(const Record& record, const uint8_t* data, size_t size)>;
+
+    GwDatArchive() = default;
+    GwDatArchive(const GwDatArchive&) = delete;
+    GwDatArchive& operator=(const GwDatArchive&) = delete;
+
+    bool Open(const wchar_t* path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return file.IsOpen(); }
+
+    // Records sorted by file id
+    [[nodiscard]] const std::vector<Record>& Records() const { return records; }
+    [[nodiscard]] std::vector<Record>::const_iterator begin() const { return records.cbegin(); }
+    [[nodiscard]] std::vector<Record>::const_iterator end() const { return records.cend(); }
+    [[nodiscard]] size_t size() const { return records.size(); }
+    [[nodiscard]] const Record* Find(uint32_t file_id) const;
+
+    // Decompress a record into arena.output, resized to fit. Returns false if the record is corrupt or can't be mapped.
+    bool Read(const Record& record, Arena& arena) const;
+
+    // Read count records spread across num_threads threads, each with its own arena. callback runs on the reading thread, and the
+    // data it gets is only valid until it returns. Returns how many records were read successfully.
+    size_t ReadParallel(const Record* to_read, size_t count, size_t num_threads, const RecordCallback& callback) const;
+
+private:
+    FileMapping file;
+    std::vector<Record> records;
+};
@@ -0,0 +1,128 @@
+#include <stdafx.h>
+
+#include <GWCA/GameEntities/Pathing.h>
+#include <GWCA/Managers/MapMgr.h>
+
+#include <Modules/Resources.h>
+#include <Utils/NavMesh.h>
+#include <Utils/PathingIndex.h>
+
+#include "MapPathing.h"
+
+namespace {
+    // Navigation meshes for maps visited recently, so that going back and forth between two maps doesn't rebuild them
+    constexpr size_t max_cached_meshes = 3;
+
+    struct CachedMesh {
+        uint32_t map_id;
+        std::shared_ptr<const PathingIndex> index;
+        std::shared_ptr<const NavMesh> mesh;
+    };
+
+    std::mutex mutex;
+    std::shared_ptr<const PathingIndex> current_index;
+    std::shared_ptr<const NavMesh> current_mesh;
+    uint32_t current_map_id = 0;
+    const GW::PathingMapArray* current_source = nullptr;
+    // Most recent last
+    std::vector<CachedMesh> cached_meshes;
+    // Bumped on every map change, so that a mesh finished after the map changed again isn't used for the wrong map
+    uint32_t generation = 0;
+
+    bool SameTrapezoids(const PathingIndex& a, const PathingIndex& b)
+    {
+        const auto& ta = a.Trapezoids();
+        const auto& tb = b.Trapezoids();
+        return ta.size() == tb.size() && (ta.empty() || memcmp(ta.data(), tb.data(), ta.size() * sizeof(ta[0])) == 0);
+    }
+
+    void BuildNavMesh(std::shared_ptr<const PathingIndex> index, const uint32_t map_id)
+    {
+        for (auto it = cached_meshes.begin(); it != cached_meshes.end(); ++it) {
+            if (it->map_id == map_id && SameTrapezoids(*it->index, *index)) {
+                current_mesh = it->mesh;
+                std::rotate(it, it + 1, cached_meshes.end());
+                return;
+            }
+        }
+        Resources::EnqueueWorkerTask([index = std::move(index), map_id, for_generation = generation] {
+            auto mesh = std::make_shared<const NavMesh>(index);
+            std::lock_guard lock(mutex);
+            if (cached_meshes.size() >= max_cached_meshes) {
+                cached_meshes.erase(cached_meshes.begin());
+            }
+            cached_meshes.push_back({map_id, index, mesh});
+            if (generation == for_generation) {
+                current_mesh = std::move(mesh);
+            }
+        });
+    }
+}
+
+std::shared_ptr<const PathingIndex> MapPathing::GetIndex()
+{
+    const GW::PathingMapArray* pathing_map = GW::Map::GetPathingMap();
+    if (pathing_map == nullptr || pathing_map->size() == 0) {
+        return nullptr;
+    }
+    const auto map_id = static_cast<uint32_t>(GW::Map::GetMapID());
+    std::lock_guard lock(mutex);
+    if (current_index && current_map_id == map_id && current_source == pathing_map) {
+        return current_index;
+    }
+    auto index = std::make_shared<PathingIndex>();
+    for (uint32_t plane = 0; plane < pathing_map->size(); plane++) {
+        const GW::PathingMap& pmap = (*pathing_map)[plane];
+        for (size_t j = 0; j < pmap.trapezoid_count; j++) {
+            const GW::PathingTrapezoid& trap = pmap.trapezoids[j];
+            index->Add(plane, {trap.XTL, trap.XTR, trap.YT, trap.XBL, trap.XBR, trap.YB, plane, trap.id});
+        }
+    }
+    index->Index();
+    // Keep a copy of each map's trapezoids for looking at pathing outside of the game
+    const auto cache_file = Resources::GetPath(L"cache\\pathing") / std::format(L"{}.dat", map_id);
+    Resources::EnqueueWorkerTask([index, cache_file, map_id] {
+        std::error_code ec;
+        if (!std::filesystem::exists(cache_file, ec) && Resources::EnsureFolderExists(cache_file.parent_path())) {
+            index->Save(cache_file, map_id);
+        }
+    });
+    generation++;
+    current_index = std::move(index);
+    current_mesh = nullptr;
+    current_map_id = map_id;
+    current_source = pathing_map;
+    BuildNavMesh(current_index, map_id);
+    return current_index;
+}
+
+std::shared_ptr<const NavMesh> MapPathing::GetNavMesh()
+{
+    if (!GetIndex()) {
+        return nullptr;
+    }
+    std::lock_guard lock(mutex);
+    return current_mesh;
+}
+
+float MapPathing::WalkDistance(const GW::Vec2f from, const GW::Vec2f to)
+{
+    const auto mesh = GetNavMesh();
+    return mesh ? mesh->WalkDistance(from, to) : -1.f;
+}
+
+bool MapPathing::FindPath(const GW::Vec2f from, const GW::Vec2f to, std::vector<GW::Vec2f>& path, float* length)
+{
+    const auto mesh = GetNavMesh();
+    return mesh && mesh->FindPath(from, to, path, length);
+}
+
+void MapPathing::Terminate()
+{
+    std::lock_guard lock(mutex);
+    generation++;
+    current_index = nullptr;
+    current_mesh = nullptr;
+    current_source = nullptr;
+    cached_meshes.clear();
+}
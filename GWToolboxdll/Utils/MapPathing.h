@@ -0,0 +1,26 @@
+#pragma once
+
+#include <GWCA/GameContainers/GamePos.h>
+
+#include <memory>
+#include <vector>
+
+class NavMesh;
+class PathingIndex;
+
+// Pathing data for the map you're in, shared by everything that needs to know where you can walk.
+// The index is built on first use after a map change; the navigation mesh takes longer, so it's built on a worker thread
+// and kept for the last few maps visited. Call from the render or game thread.
+namespace MapPathing {
+    // Point location over the current map's pathing trapezoids, or nullptr if the map isn't loaded
+    std::shared_ptr<const PathingIndex> GetIndex();
+    // Navigation mesh for the current map, or nullptr while it's still being built
+    std::shared_ptr<const NavMesh> GetNavMesh();
+
+    // Walking distance between two points in the current map, or -1 if it isn't known (yet)
+    float WalkDistance(GW::Vec2f from, GW::Vec2f to);
+    // Walking path between two points in the current map, both ends included; false if it isn't known (yet)
+    bool FindPath(GW::Vec2f from, GW::Vec2f to, std::vector<GW::Vec2f>& path, float* length = nullptr);
+
+    void Terminate();
+}
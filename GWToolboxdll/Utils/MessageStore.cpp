@@ -0,0 +1,698 @@
+#include <stdafx.h>
+
+#include <numeric>
+
+#include "MessageStore.h"
+
+namespace {
+    constexpr char file_magic[4] = {'G', 'W', 'M', 'S'};
+    constexpr uint32_t file_version = 1;
+    // Long words are usually spam; no point indexing more than this much of them
+    constexpr size_t max_token_length = 32;
+
+#pragma pack(push, 1)
+    struct RecordHeader {
+        uint32_t timestamp;
+        uint16_t name_length;
+        uint16_t message_length;
+    };
+#pragma pack(pop)
+
+    bool IsTokenChar(const char c)
+    {
+        const auto u = static_cast<unsigned char>(c);
+        return (u >= '0' && u <= '9') || (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || u == '.' || u >= 0x80;
+    }
+
+    bool IsDigit(const char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    // Bare numbers are only useful as prices, and would otherwise make up most of the index
+    bool IsSearchable(const std::string_view token)
+    {
+        return std::ranges::any_of(token, [](const char c) {
+            return !IsDigit(c) && c != '.';
+        });
+    }
+
+    // Split a token like "1.5k" into its number and what follows it
+    size_t NumberLength(const std::string_view token)
+    {
+        size_t i = 0;
+        while (i < token.size() && (IsDigit(token[i]) || token[i] == '.')) {
+            i++;
+        }
+        return i;
+    }
+}
+
+MessageStore::~MessageStore()
+{
+    Close();
+}
+
+bool MessageStore::IsOpen() const
+{
+    std::lock_guard lock(mutex);
+    return file != nullptr;
+}
+
+void MessageStore::Close()
+{
+    std::lock_guard lock(mutex);
+    // Anything still loading or compacting is thrown away when it finishes
+    generation++;
+    loading = false;
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    ResetIndex();
+}
+
+void MessageStore::Flush()
+{
+    std::lock_guard lock(mutex);
+    if (file && unflushed) {
+        fflush(file);
+        unflushed = 0;
+    }
+}
+
+size_t MessageStore::size() const
+{
+    std::lock_guard lock(mutex);
+    return messages.size();
+}
+
+size_t MessageStore::IndexSize() const
+{
+    std::lock_guard lock(mutex);
+    // Hash map nodes carry a next pointer and cached hash alongside the pair
+    size_t total = messages.capacity() * sizeof(StoredMessage) + text.capacity() + prices.capacity() * sizeof(Price);
+    for (const auto& [token, postings] : index) {
+        total += sizeof(void*) * 2 + sizeof(token) + token.capacity() + sizeof(postings) + postings.capacity() * sizeof(uint32_t);
+    }
+    total += index.bucket_count() * sizeof(void*) + sorted_words.capacity() * sizeof(std::string_view);
+    total += hashes.size() * (sizeof(uint64_t) + sizeof(void*) * 2);
+    return total;
+}
+
+void MessageStore::ResetIndex()
+{
+    messages.clear();
+    text.clear();
+    prices.clear();
+    index.clear();
+    sorted_words.clear();
+    sorted_count = 0;
+    hashes.clear();
+    backfilled.clear();
+    newest_timestamp = 0;
+}
+
+uint64_t MessageStore::Hash(const uint32_t timestamp, const std::string_view name, const std::string_view message)
+{
+    uint64_t hash = std::hash<std::string_view>{}(message);
+    hash ^= std::hash<std::string_view>{}(name) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    hash ^= timestamp + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+void MessageStore::Tokenize(const std::string_view text, std::vector<std::string>& tokens)
+{
+    tokens.clear();
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !IsTokenChar(text[i])) {
+            i++;
+        }
+        const size_t start = i;
+        while (i < text.size() && IsTokenChar(text[i])) {
+            i++;
+        }
+        auto token = text.substr(start, i - start);
+        // Dots only matter inside numbers like 1.5k
+        while (!token.empty() && token.back() == '.') {
+            token.remove_suffix(1);
+        }
+        while (!token.empty() && token.front() == '.') {
+            token.remove_prefix(1);
+        }
+        if (token.empty()) {
+            continue;
+        }
+        auto& out = tokens.emplace_back(token.substr(0, max_token_length));
+        for (auto& c : out) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+    }
+}
+
+bool MessageStore::ParsePrice(const std::string_view number, const std::string_view unit, Price* price)
+{
+    char buf[16];
+    if (number.empty() || number.size() >= _countof(buf) || !IsDigit(number.front())) {
+        return false;
+    }
+    memcpy(buf, number.data(), number.size());
+    buf[number.size()] = 0;
+    const double value = strtod(buf, nullptr);
+
+    double multiplier;
+    if (unit == "k" || unit == "p" || unit == "plat" || unit == "platinum") {
+        price->currency = Currency::Gold;
+        multiplier = 1000.0;
+    }
+    else if (unit == "g" || unit == "gp" || unit == "gold") {
+        price->currency = Currency::Gold;
+        multiplier = 1.0;
+    }
+    else if (unit == "e" || unit == "ec" || unit == "ecto" || unit == "ectos") {
+        price->currency = Currency::Ecto;
+        multiplier = 1000.0;
+    }
+    else {
+        return false;
+    }
+    const double scaled = value * multiplier;
+    if (!(scaled >= 0.0 && scaled < 4e9)) {
+        return false;
+    }
+    price->value = static_cast<uint32_t>(scaled + 0.5);
+    return true;
+}
+
+void MessageStore::Index(const uint32_t timestamp, std::string_view name, std::string_view message)
+{
+    name = name.substr(0, 0xffff);
+    message = message.substr(0, 0xffff);
+    const auto message_index = static_cast<uint32_t>(messages.size());
+    auto& stored = messages.emplace_back();
+    stored.timestamp = timestamp;
+    stored.text_offset = static_cast<uint32_t>(text.size());
+    stored.name_length = static_cast<uint16_t>(name.size());
+    stored.message_length = static_cast<uint16_t>(message.size());
+    stored.price_offset = static_cast<uint32_t>(prices.size());
+    text.append(name);
+    text.append(message);
+    hashes.insert(Hash(timestamp, name, message));
+    if (timestamp < newest_timestamp) {
+        backfilled.push_back(message_index);
+    }
+    newest_timestamp = std::max(newest_timestamp, timestamp);
+
+    static thread_local std::vector<std::string> tokens;
+    static thread_local std::vector<std::string> name_tokens;
+    Tokenize(message, tokens);
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const std::string_view token = tokens[i];
+        const size_t number_length = NumberLength(token);
+        if (!number_length) {
+            continue;
+        }
+        // "5k" or "5 k"
+        std::string_view unit = token.substr(number_length);
+        if (unit.empty() && i + 1 < tokens.size()) {
+            unit = tokens[i + 1];
+        }
+        Price price;
+        if (ParsePrice(token.substr(0, number_length), unit, &price)) {
+            prices.push_back(price);
+        }
+    }
+    stored.price_count = static_cast<uint32_t>(prices.size()) - stored.price_offset;
+
+    Tokenize(name, name_tokens);
+    tokens.insert(tokens.end(), name_tokens.begin(), name_tokens.end());
+    std::erase_if(tokens, [](const std::string& token) {
+        return !IsSearchable(token);
+    });
+    std::ranges::sort(tokens);
+    const auto [first, last] = std::ranges::unique(tokens);
+    tokens.erase(first, last);
+    for (const auto& token : tokens) {
+        auto [found, added] = index.try_emplace(token);
+        if (added) {
+            // Node based, so the key stays put when the table rehashes
+            sorted_words.push_back(found->first);
+        }
+        found->second.push_back(message_index);
+    }
+}
+
+bool MessageStore::WriteRecord(FILE* to, const uint32_t timestamp, std::string_view name, std::string_view message)
+{
+    name = name.substr(0, 0xffff);
+    message = message.substr(0, 0xffff);
+    const RecordHeader header = {timestamp, static_cast<uint16_t>(name.size()), static_cast<uint16_t>(message.size())};
+    if (fwrite(&header, sizeof(header), 1, to) != 1
+        || fwrite(name.data(), 1, name.size(), to) != name.size()
+        || fwrite(message.data(), 1, message.size(), to) != message.size()) {
+        return false;
+    }
+    file_size += sizeof(header) + name.size() + message.size();
+    return true;
+}
+
+MessageStore::Entry MessageStore::GetEntry(const size_t index) const
+{
+    const auto& stored = messages[index];
+    Entry entry;
+    entry.timestamp = stored.timestamp;
+    entry.name.assign(text, stored.text_offset, stored.name_length);
+    entry.message.assign(text, stored.text_offset + stored.name_length, stored.message_length);
+    return entry;
+}
+
+bool MessageStore::Rewrite(const size_t first_message)
+{
+    // Pull the messages we're keeping out of the index before rebuilding it. first_message counts in timestamp order, and
+    // they're written back in that order so nothing is backfilled afterwards.
+    std::vector<uint32_t> order(messages.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (!backfilled.empty()) {
+        std::ranges::stable_sort(order, [this](const uint32_t a, const uint32_t b) {
+            return messages[a].timestamp < messages[b].timestamp;
+        });
+    }
+    std::vector<Entry> keep;
+    keep.reserve(messages.size() - std::min(first_message, messages.size()));
+    for (size_t i = first_message; i < order.size(); i++) {
+        keep.push_back(GetEntry(order[i]));
+    }
+    ResetIndex();
+
+    FILE* tmp = nullptr;
+    if (_wfopen_s(&tmp, TempPath().wstring().c_str(), L"wb") != 0 || !tmp) {
+        return false;
+    }
+    bool ok = fwrite(file_magic, sizeof(file_magic), 1, tmp) == 1 && fwrite(&file_version, sizeof(file_version), 1, tmp) == 1;
+    file_size = sizeof(file_magic) + sizeof(file_version);
+    for (const auto& entry : keep) {
+        ok = ok && WriteRecord(tmp, entry.timestamp, entry.name, entry.message);
+        Index(entry.timestamp, entry.name, entry.message);
+    }
+    ok = fclose(tmp) == 0 && ok;
+    if (!ok) {
+        RemoveTemp();
+    }
+    return ok;
+}
+
+bool MessageStore::ReplaceFile()
+{
+    std::error_code ec;
+    std::filesystem::rename(TempPath(), file_path, ec);
+    if (ec) {
+        RemoveTemp();
+        return false;
+    }
+    return _wfopen_s(&file, file_path.wstring().c_str(), L"ab") == 0 && file;
+}
+
+std::filesystem::path MessageStore::TempPath() const
+{
+    auto tmp_path = file_path;
+    tmp_path += L".tmp";
+    return tmp_path;
+}
+
+void MessageStore::RemoveTemp() const
+{
+    std::error_code ec;
+    std::filesystem::remove(TempPath(), ec);
+}
+
+bool MessageStore::Load(const size_t max_bytes)
+{
+    std::vector<char> data;
+    if (std::ifstream in(file_path, std::ios::binary | std::ios::ate); in) {
+        const auto end = in.tellg();
+        if (end > 0) {
+            data.resize(std::min(static_cast<size_t>(end), max_bytes));
+            in.seekg(0);
+            in.read(data.data(), static_cast<std::streamsize>(data.size()));
+            data.resize(static_cast<size_t>(in.gcount()));
+        }
+    }
+    size_t pos = sizeof(file_magic) + sizeof(file_version);
+    bool valid = data.size() >= pos && memcmp(data.data(), file_magic, sizeof(file_magic)) == 0
+                 && *reinterpret_cast<const uint32_t*>(data.data() + sizeof(file_magic)) == file_version;
+    if (valid) {
+        while (data.size() - pos >= sizeof(RecordHeader)) {
+            RecordHeader header;
+            memcpy(&header, data.data() + pos, sizeof(header));
+            const size_t length = header.name_length + header.message_length;
+            if (data.size() - pos - sizeof(header) < length) {
+                break;
+            }
+            const std::string_view name(data.data() + pos + sizeof(header), header.name_length);
+            const std::string_view message(name.data() + name.size(), header.message_length);
+            Index(header.timestamp, name, message);
+            pos += sizeof(header) + length;
+        }
+        // A torn write at the end would corrupt whatever gets appended after it
+        valid = pos == data.size();
+    }
+    file_size = valid ? data.size() : 0;
+    return valid;
+}
+
+void MessageStore::Merge(MessageStore& loaded, const size_t first_new)
+{
+    for (size_t i = first_new; i < messages.size(); i++) {
+        const auto entry = GetEntry(i);
+        if (loaded.hashes.contains(Hash(entry.timestamp, entry.name, entry.message))) {
+            continue;
+        }
+        if (loaded.file) {
+            loaded.WriteRecord(loaded.file, entry.timestamp, entry.name, entry.message);
+        }
+        loaded.Index(entry.timestamp, entry.name, entry.message);
+    }
+    if (loaded.file) {
+        fflush(loaded.file);
+    }
+    if (file) {
+        fclose(file);
+    }
+    file = loaded.file;
+    loaded.file = nullptr;
+    file_size = loaded.file_size;
+    unflushed = 0;
+    messages.swap(loaded.messages);
+    text.swap(loaded.text);
+    prices.swap(loaded.prices);
+    index.swap(loaded.index);
+    sorted_words.swap(loaded.sorted_words);
+    std::swap(sorted_count, loaded.sorted_count);
+    hashes.swap(loaded.hashes);
+    backfilled.swap(loaded.backfilled);
+    std::swap(newest_timestamp, loaded.newest_timestamp);
+}
+
+bool MessageStore::Open(const std::filesystem::path& path, const size_t max_file_size)
+{
+    uint32_t open_generation;
+    {
+        std::lock_guard lock(mutex);
+        if (file) {
+            fclose(file);
+            file = nullptr;
+        }
+        ResetIndex();
+        file_path = path;
+        max_size = max_file_size;
+        loading = true;
+        open_generation = ++generation;
+    }
+
+    // Read and indexed without the lock, so that messages can still be added and searched for meanwhile
+    MessageStore loaded;
+    loaded.file_path = path;
+    loaded.max_size = max_file_size;
+    const bool valid = loaded.Load(SIZE_MAX);
+    const bool rewrite = !valid || loaded.file_size > max_file_size;
+    bool ok = !rewrite || loaded.Rewrite(loaded.file_size > max_file_size ? loaded.messages.size() / 2 : 0);
+
+    std::lock_guard lock(mutex);
+    if (generation != open_generation) {
+        // Closed or opened again since
+        if (rewrite && ok) {
+            loaded.RemoveTemp();
+        }
+        return false;
+    }
+    loading = false;
+    if (rewrite) {
+        ok = ok && loaded.ReplaceFile();
+    }
+    else {
+        ok = _wfopen_s(&loaded.file, path.wstring().c_str(), L"ab") == 0 && loaded.file;
+    }
+    if (!ok) {
+        return false;
+    }
+    Merge(loaded, 0);
+    return true;
+}
+
+bool MessageStore::NeedsCompaction()
+{
+    std::lock_guard lock(mutex);
+    if (!file || compacting || file_size <= max_size) {
+        return false;
+    }
+    compacting = true;
+    return true;
+}
+
+bool MessageStore::Compact()
+{
+    MessageStore compacted;
+    size_t first_new;
+    size_t flushed_size;
+    uint32_t compact_generation;
+    {
+        std::lock_guard lock(mutex);
+        if (!file) {
+            compacting = false;
+            return false;
+        }
+        fflush(file);
+        unflushed = 0;
+        compacted.file_path = file_path;
+        compacted.max_size = max_size;
+        first_new = messages.size();
+        flushed_size = file_size;
+        compact_generation = generation;
+    }
+
+    // The file is only ever appended to, so the part that's already flushed can be read while more is added
+    const bool ok = compacted.Load(flushed_size) && compacted.Rewrite(compacted.messages.size() / 2);
+
+    std::lock_guard lock(mutex);
+    compacting = false;
+    if (generation != compact_generation || !file) {
+        if (ok) {
+            compacted.RemoveTemp();
+        }
+        return false;
+    }
+    if (!ok) {
+        return false;
+    }
+    // Can't replace it while it's open
+    fclose(file);
+    file = nullptr;
+    if (!compacted.ReplaceFile()) {
+        // The old file is still there; keep appending to it
+        _wfopen_s(&file, file_path.wstring().c_str(), L"ab");
+        return false;
+    }
+    Merge(compacted, first_new);
+    return true;
+}
+
+bool MessageStore::Add(const Entry& entry)
+{
+    std::lock_guard lock(mutex);
+    if (!file && !loading) {
+        return false;
+    }
+    const std::string_view name = std::string_view(entry.name).substr(0, 0xffff);
+    const std::string_view message = std::string_view(entry.message).substr(0, 0xffff);
+    if (hashes.contains(Hash(entry.timestamp, name, message))) {
+        return false;
+    }
+    // While loading, it's only kept in memory until Open() writes it out
+    if (file && !WriteRecord(file, entry.timestamp, name, message)) {
+        return false;
+    }
+    Index(entry.timestamp, name, message);
+    if (file && ++unflushed >= 32) {
+        fflush(file);
+        unflushed = 0;
+    }
+    return true;
+}
+
+bool MessageStore::PricesMatch(const StoredMessage& message, const std::vector<PriceFilter>& filters) const
+{
+    for (const auto& filter : filters) {
+        bool matched = false;
+        for (uint32_t i = 0; i < message.price_count && !matched; i++) {
+            const auto& price = prices[message.price_offset + i];
+            matched = price.currency == filter.currency && price.value >= filter.min && price.value <= filter.max;
+        }
+        if (!matched) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MessageStore::IsNewer(const uint32_t a, const uint32_t b) const
+{
+    const uint32_t a_time = messages[a].timestamp;
+    const uint32_t b_time = messages[b].timestamp;
+    return a_time > b_time || (a_time == b_time && a > b);
+}
+
+void MessageStore::Newest(const std::vector<uint32_t>* candidates, const std::vector<PriceFilter>& filters, const size_t max_results, std::vector<Entry>& out) const
+{
+    out.clear();
+    // Newest first from the end, leaving out backfilled messages
+    std::vector<uint32_t> in_order;
+    size_t next_backfilled = backfilled.size();
+    const auto add_in_order = [&](const uint32_t index) {
+        while (next_backfilled && backfilled[next_backfilled - 1] > index) {
+            next_backfilled--;
+        }
+        if (!(next_backfilled && backfilled[next_backfilled - 1] == index) && PricesMatch(messages[index], filters)) {
+            in_order.push_back(index);
+        }
+        return in_order.size() < max_results;
+    };
+    if (candidates) {
+        for (auto it = candidates->rbegin(); it != candidates->rend(); ++it) {
+            if (!add_in_order(*it)) {
+                break;
+            }
+        }
+    }
+    else {
+        for (auto i = static_cast<uint32_t>(messages.size()); i > 0; i--) {
+            if (!add_in_order(i - 1)) {
+                break;
+            }
+        }
+    }
+
+    // Backfilled messages could be from any time
+    std::vector<uint32_t> late;
+    for (const uint32_t index : backfilled) {
+        if ((!candidates || std::ranges::binary_search(*candidates, index)) && PricesMatch(messages[index], filters)) {
+            late.push_back(index);
+        }
+    }
+    const auto is_newer = [this](const uint32_t a, const uint32_t b) {
+        return IsNewer(a, b);
+    };
+    const auto late_end = late.begin() + std::min(late.size(), max_results);
+    std::partial_sort(late.begin(), late_end, late.end(), is_newer);
+
+    std::vector<uint32_t> newest;
+    std::merge(in_order.begin(), in_order.end(), late.begin(), late_end, std::back_inserter(newest), is_newer);
+    for (size_t i = 0; i < newest.size() && i < max_results; i++) {
+        out.push_back(GetEntry(newest[i]));
+    }
+}
+
+size_t MessageStore::Search(const std::string_view query, const size_t max_results, std::vector<Entry>& out) const
+{
+    out.clear();
+    std::vector<std::string> words;
+    std::vector<PriceFilter> filters;
+    std::vector<std::string> part_tokens;
+
+    // Split on whitespace first so that price comparisons can be picked out before tokenizing
+    size_t i = 0;
+    while (i < query.size()) {
+        while (i < query.size() && isspace(static_cast<unsigned char>(query[i]))) {
+            i++;
+        }
+        const size_t start = i;
+        while (i < query.size() && !isspace(static_cast<unsigned char>(query[i]))) {
+            i++;
+        }
+        std::string_view part = query.substr(start, i - start);
+        if (!part.empty() && (part[0] == '<' || part[0] == '>')) {
+            const bool less = part[0] == '<';
+            const bool inclusive = part.size() > 1 && part[1] == '=';
+            part.remove_prefix(inclusive ? 2 : 1);
+            std::string lower(part);
+            std::ranges::transform(lower, lower.begin(), [](const char c) {
+                return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+            });
+            const std::string_view price_text = lower;
+            const size_t number_length = NumberLength(price_text);
+            Price price;
+            if (ParsePrice(price_text.substr(0, number_length), price_text.substr(number_length), &price)) {
+                PriceFilter filter = {price.currency, 0, 0xffffffff};
+                if (less) {
+                    filter.max = inclusive ? price.value : (price.value ? price.value - 1 : 0);
+                }
+                else {
+                    filter.min = inclusive ? price.value : price.value + 1;
+                }
+                filters.push_back(filter);
+                continue;
+            }
+        }
+        Tokenize(part, part_tokens);
+        std::ranges::copy_if(part_tokens, std::back_inserter(words), IsSearchable);
+    }
+
+    std::lock_guard lock(mutex);
+    if (words.empty() && filters.empty()) {
+        return 0;
+    }
+    if (sorted_count < sorted_words.size()) {
+        const auto middle = sorted_words.begin() + sorted_count;
+        std::sort(middle, sorted_words.end());
+        std::inplace_merge(sorted_words.begin(), middle, sorted_words.end());
+        sorted_count = sorted_words.size();
+    }
+
+    if (words.empty()) {
+        Newest(nullptr, filters, max_results, out);
+        return out.size();
+    }
+
+    // Every message containing a word starting with each query word, then intersect them
+    std::vector<uint32_t> matches;
+    std::vector<uint32_t> word_matches;
+    std::vector<uint32_t> intersection;
+    for (size_t w = 0; w < words.size(); w++) {
+        const auto& word = words[w];
+        word_matches.clear();
+        size_t ranges = 0;
+        for (auto it = std::ranges::lower_bound(sorted_words, std::string_view(word)); it != sorted_words.end() && it->starts_with(word); ++it) {
+            const auto& postings = index.find(std::string(*it))->second;
+            word_matches.insert(word_matches.end(), postings.begin(), postings.end());
+            ranges++;
+        }
+        if (ranges > 1) {
+            std::ranges::sort(word_matches);
+            const auto [first, last] = std::ranges::unique(word_matches);
+            word_matches.erase(first, last);
+        }
+        if (w == 0) {
+            matches.swap(word_matches);
+        }
+        else {
+            intersection.clear();
+            std::ranges::set_intersection(matches, word_matches, std::back_inserter(intersection));
+            matches.swap(intersection);
+        }
+        if (matches.empty()) {
+            return 0;
+        }
+    }
+    Newest(&matches, filters, max_results, out);
+    return out.size();
+}
+
+size_t MessageStore::Latest(const size_t max_results, std::vector<Entry>& out) const
+{
+    std::lock_guard lock(mutex);
+    Newest(nullptr, {}, max_results, out);
+    return out.size();
+}
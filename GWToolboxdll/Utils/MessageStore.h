@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Persistent history of chat messages (e.g. the trade feed) with a local word index, so searches have results before a server answers.
+// Messages are appended to a file as they arrive and indexed in memory by every word in the message and sender's name. When
+// the file grows past its size limit, Compact() drops the oldest half of the history and rewrites the file. Messages can be added
+// out of order (e.g. older search results filling in a gap), so results are ordered by their timestamps, not when they were added.
+// All public functions are thread safe. Open() and Compact() do their reading and writing without holding the lock, so they
+// can run on a worker thread while messages are added and searched for; anything added meanwhile is merged in when they finish.
+class MessageStore {
+public:
+    struct Entry {
+        uint32_t timestamp = 0;
+        std::string name;
+        std::string message;
+    };
+
+    MessageStore() = default;
+    MessageStore(const MessageStore&) = delete;
+    MessageStore& operator=(const MessageStore&) = delete;
+    ~MessageStore();
+
+    // Load and index the history in path, creating the file if it doesn't exist. Messages added while it loads are kept.
+    bool Open(const std::filesystem::path& path, size_t max_file_size);
+    // Also makes a load or compaction that's under way throw away its result
+    void Close();
+    [[nodiscard]] bool IsOpen() const;
+
+    // Returns false if the message is already stored (the feed resends recent messages when reconnecting)
+    bool Add(const Entry& entry);
+    void Flush();
+    // True once each time the file grows past its size limit; the caller should then run Compact(), e.g. on a worker thread
+    bool NeedsCompaction();
+    // Drop the oldest half of the history and rewrite the file
+    bool Compact();
+
+    // Newest first by timestamp. Each word in the query has to match the start of a word in the message or sender's name; bare numbers are ignored.
+    // Terms like <5k, >=100k or <=2e filter on prices in the message: k, g, gold and plat are gold, e and ecto are ectos.
+    size_t Search(std::string_view query, size_t max_results, std::vector<Entry>& out) const;
+    // Most recent messages by timestamp, newest first
+    size_t Latest(size_t max_results, std::vector<Entry>& out) const;
+
+    [[nodiscard]] size_t size() const;
+    // Rough memory used by the index, in bytes
+    [[nodiscard]] size_t IndexSize() const;
+
+private:
+    enum class Currency : uint8_t {
+        Gold,
+        Ecto
+    };
+
+    struct Price {
+        Currency currency;
+        // Gold, or thousandths of an ecto
+        uint32_t value;
+    };
+
+    struct StoredMessage {
+        uint32_t timestamp;
+        uint32_t text_offset;
+        uint16_t name_length;
+        uint16_t message_length;
+        uint32_t price_offset;
+        uint32_t price_count;
+    };
+
+    struct PriceFilter {
+        Currency currency;
+        uint32_t min;
+        uint32_t max;
+    };
+
+    void Index(uint32_t timestamp, std::string_view name, std::string_view message);
+    void ResetIndex();
+    // The rest only touch a store that nothing else can see yet, apart from Merge which needs the lock of the store merged into.
+    // Read up to max_bytes of file_path into the index; returns false if the file is missing or corrupt.
+    bool Load(size_t max_bytes);
+    // Rebuild the index from first_message on in timestamp order, writing those messages to a temp file for ReplaceFile()
+    bool Rewrite(size_t first_message);
+    // Move the temp file over file_path and open it for appending
+    bool ReplaceFile();
+    [[nodiscard]] std::filesystem::path TempPath() const;
+    void RemoveTemp() const;
+    // Add the messages from first_new on that loaded doesn't have, then take over its file and index
+    void Merge(MessageStore& loaded, size_t first_new);
+    bool WriteRecord(FILE* file, uint32_t timestamp, std::string_view name, std::string_view message);
+    [[nodiscard]] Entry GetEntry(size_t index) const;
+    [[nodiscard]] bool PricesMatch(const StoredMessage& message, const std::vector<PriceFilter>& filters) const;
+    [[nodiscard]] bool IsNewer(uint32_t a, uint32_t b) const;
+    // Up to max_results of candidates (ascending indices, or every message if null) whose prices match, newest first by timestamp
+    void Newest(const std::vector<uint32_t>* candidates, const std::vector<PriceFilter>& filters, size_t max_results, std::vector<Entry>& out) const;
+
+    static uint64_t Hash(uint32_t timestamp, std::string_view name, std::string_view message);
+    static void Tokenize(std::string_view text, std::vector<std::string>& tokens);
+    static bool ParsePrice(std::string_view number, std::string_view unit, Price* price);
+
+    mutable std::mutex mutex;
+    std::filesystem::path file_path;
+    FILE* file = nullptr;
+    size_t file_size = 0;
+    size_t max_size = 0;
+    uint32_t unflushed = 0;
+    // Open() is reading the file; messages added meanwhile are only indexed, and written once it's done
+    bool loading = false;
+    bool compacting = false;
+    // Bumped by Open() and Close(), so a load or compaction that started before can tell its result is stale
+    uint32_t generation = 0;
+
+    std::vector<StoredMessage> messages;
+    // Sender name followed by message, for every message
+    std::string text;
+    std::vector<Price> prices;
+    // Word => indices of the messages containing it, ascending
+    std::unordered_map<std::string, std::vector<uint32_t>> index;
+    // Keys of index, so that prefix lookups are a range. Words added since the last search are appended unsorted and merged in
+    // by the next search, rather than paying for an ordered insert on every message.
+    mutable std::vector<std::string_view> sorted_words;
+    mutable size_t sorted_count = 0;
+    std::unordered_set<uint64_t> hashes;
+    // Messages older than one added before them, ascending. Every other message is newer than all the messages before it, so
+    // those can be walked from the end in timestamp order.
+    std::vector<uint32_t> backfilled;
+    uint32_t newest_timestamp = 0;
+};
@@ -0,0 +1,315 @@
+#include <stdafx.h>
+
+#include "NavMesh.h"
+
+namespace {
+    using Trapezoid = PathingIndex::Trapezoid;
+
+    // Edges shorter than this aren't something you can walk through
+    constexpr float min_portal_width = 1.f;
+
+    float Cross(const GW::Vec2f& a, const GW::Vec2f& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    GW::Vec2f Centre(const Trapezoid& t)
+    {
+        return {(t.XTL + t.XTR + t.XBL + t.XBR) / 4.f, (t.YT + t.YB) / 2.f};
+    }
+
+    GW::Vec2f ClosestPointOnSegment(const GW::Vec2f& p, const GW::Vec2f& a, const GW::Vec2f& b)
+    {
+        const GW::Vec2f ab = b - a;
+        const float length_sqr = ab.x * ab.x + ab.y * ab.y;
+        if (length_sqr == 0.f) {
+            return a;
+        }
+        const float t = std::clamp(((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / length_sqr, 0.f, 1.f);
+        return {a.x + ab.x * t, a.y + ab.y * t};
+    }
+
+    struct HorizontalEdge {
+        float y;
+        float x0;
+        float x1;
+        uint32_t trapezoid;
+    };
+
+    struct SideEdge {
+        float top;
+        float bottom;
+        float x_top;
+        float x_bottom;
+
+        bool operator==(const SideEdge&) const = default;
+    };
+
+    struct SideEdgeHash {
+        size_t operator()(const SideEdge& e) const
+        {
+            size_t hash = std::hash<float>()(e.top);
+            hash = hash * 31 + std::hash<float>()(e.bottom);
+            hash = hash * 31 + std::hash<float>()(e.x_top);
+            return hash * 31 + std::hash<float>()(e.x_bottom);
+        }
+    };
+}
+
+NavMesh::NavMesh(std::shared_ptr<const PathingIndex> index)
+    : index(std::move(index))
+{
+    Link();
+}
+
+void NavMesh::Link()
+{
+    const auto& trapezoids = index->Trapezoids();
+    // Portal per direction, as (from, portal)
+    std::vector<std::pair<uint32_t, Portal>> links;
+    const auto link = [&links](const uint32_t from, const uint32_t to, const GW::Vec2f a, const GW::Vec2f b) {
+        links.emplace_back(from, Portal{a, b, to});
+        links.emplace_back(to, Portal{a, b, from});
+    };
+
+    // The top edge of one trapezoid against the bottom edges of those above it
+    std::vector<HorizontalEdge> bottoms;
+    bottoms.reserve(trapezoids.size());
+    float max_width = 0.f;
+    for (uint32_t i = 0; i < trapezoids.size(); i++) {
+        const auto& t = trapezoids[i];
+        bottoms.push_back({t.YB, t.XBL, t.XBR, i});
+        max_width = std::max(max_width, t.XBR - t.XBL);
+    }
+    std::ranges::sort(bottoms, [](const HorizontalEdge& a, const HorizontalEdge& b) {
+        return a.y < b.y || (a.y == b.y && a.x0 < b.x0);
+    });
+    for (uint32_t i = 0; i < trapezoids.size(); i++) {
+        const auto& t = trapezoids[i];
+        // Anything starting further left than this is too narrow to reach this edge
+        const HorizontalEdge key = {t.YT, t.XTL - max_width, 0.f, 0};
+        auto it = std::ranges::lower_bound(bottoms, key, [](const HorizontalEdge& a, const HorizontalEdge& b) {
+            return a.y < b.y || (a.y == b.y && a.x0 < b.x0);
+        });
+        for (; it != bottoms.end() && it->y == t.YT && it->x0 < t.XTR; ++it) {
+            const float x0 = std::max(it->x0, t.XTL);
+            const float x1 = std::min(it->x1, t.XTR);
+            if (x1 - x0 >= min_portal_width && it->trapezoid != i) {
+                link(i, it->trapezoid, {x0, t.YT}, {x1, t.YT});
+            }
+        }
+    }
+
+    // The right edge of one trapezoid against the left edge of the one beside it
+    std::unordered_multimap<SideEdge, uint32_t, SideEdgeHash> lefts;
+    lefts.reserve(trapezoids.size());
+    for (uint32_t i = 0; i < trapezoids.size(); i++) {
+        const auto& t = trapezoids[i];
+        if (t.YT != t.YB) {
+            lefts.emplace(SideEdge{t.YT, t.YB, t.XTL, t.XBL}, i);
+        }
+    }
+    for (uint32_t i = 0; i < trapezoids.size(); i++) {
+        const auto& t = trapezoids[i];
+        if (t.YT == t.YB) {
+            continue;
+        }
+        const auto [begin, end] = lefts.equal_range(SideEdge{t.YT, t.YB, t.XTR, t.XBR});
+        for (auto it = begin; it != end; ++it) {
+            if (it->second != i) {
+                link(i, it->second, {t.XTR, t.YT}, {t.XBR, t.YB});
+            }
+        }
+    }
+
+    std::ranges::sort(links, [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    portal_start.assign(trapezoids.size() + 1, 0);
+    portals.clear();
+    portals.reserve(links.size());
+    for (const auto& [from, portal] : links) {
+        portal_start[from + 1]++;
+        portals.push_back(portal);
+    }
+    for (size_t i = 1; i < portal_start.size(); i++) {
+        portal_start[i] += portal_start[i - 1];
+    }
+}
+
+bool NavMesh::FindCorridor(const GW::Vec2f from, const GW::Vec2f to, std::vector<uint32_t>& corridor) const
+{
+    auto& s = search;
+    const auto& trapezoids = index->Trapezoids();
+    s.starts.clear();
+    s.goals.clear();
+    if (!index->LocateTrapezoids(from, s.starts) || !index->LocateTrapezoids(to, s.goals)) {
+        return false;
+    }
+    if (s.cost.size() != trapezoids.size()) {
+        s.cost.resize(trapezoids.size());
+        s.entry.resize(trapezoids.size());
+        s.parent.resize(trapezoids.size());
+        s.parent_portal.resize(trapezoids.size());
+        s.visited.assign(trapezoids.size(), 0);
+        s.closed.assign(trapezoids.size(), 0);
+        s.generation = 0;
+    }
+    if (++s.generation == 0) {
+        std::ranges::fill(s.visited, 0);
+        std::ranges::fill(s.closed, 0);
+        s.generation = 1;
+    }
+    const uint32_t generation = s.generation;
+    constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+    // Min-heap on estimated total cost
+    const auto heap_order = [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+        return a.first > b.first;
+    };
+    s.open.clear();
+    for (const uint32_t start : s.starts) {
+        s.cost[start] = 0.f;
+        s.entry[start] = from;
+        s.parent[start] = none;
+        s.parent_portal[start] = none;
+        s.visited[start] = generation;
+        s.open.emplace_back(GetDistance(from, to), start);
+    }
+    std::ranges::make_heap(s.open, heap_order);
+
+    // Costs are measured between the points where the path enters each trapezoid, taken as the closest point on the
+    // portal to the previous entry point. It's an estimate; the exact length comes from pulling the path tight afterwards.
+    uint32_t found = none;
+    while (!s.open.empty()) {
+        std::ranges::pop_heap(s.open, heap_order);
+        const uint32_t current = s.open.back().second;
+        s.open.pop_back();
+        if (s.closed[current] == generation) {
+            continue;
+        }
+        s.closed[current] = generation;
+        if (std::ranges::find(s.goals, current) != s.goals.end()) {
+            found = current;
+            break;
+        }
+        const GW::Vec2f entry = s.entry[current];
+        const float cost = s.cost[current];
+        for (uint32_t p = portal_start[current]; p < portal_start[current + 1]; p++) {
+            const Portal& portal = portals[p];
+            if (s.closed[portal.to] == generation) {
+                continue;
+            }
+            const GW::Vec2f next_entry = ClosestPointOnSegment(entry, portal.a, portal.b);
+            const float next_cost = cost + GetDistance(entry, next_entry);
+            if (s.visited[portal.to] == generation && s.cost[portal.to] <= next_cost) {
+                continue;
+            }
+            s.visited[portal.to] = generation;
+            s.cost[portal.to] = next_cost;
+            s.entry[portal.to] = next_entry;
+            s.parent[portal.to] = current;
+            s.parent_portal[portal.to] = p;
+            s.open.emplace_back(next_cost + GetDistance(next_entry, to), portal.to);
+            std::ranges::push_heap(s.open, heap_order);
+        }
+    }
+    if (found == none) {
+        return false;
+    }
+    corridor.clear();
+    for (uint32_t i = found; s.parent[i] != none; i = s.parent[i]) {
+        corridor.push_back(s.parent_portal[i]);
+    }
+    std::ranges::reverse(corridor);
+    return true;
+}
+
+void NavMesh::PullString(const GW::Vec2f from, const GW::Vec2f to, const std::vector<uint32_t>& corridor, std::vector<GW::Vec2f>& path) const
+{
+    // Funnel algorithm ("simple stupid funnel"). Each portal's ends are put in order as seen walking through it,
+    // left meaning anticlockwise of the direction of travel.
+    const auto& trapezoids = index->Trapezoids();
+    auto& funnel = search.funnel;
+    funnel.clear();
+    funnel.emplace_back(from, from);
+    // Each portal leads out of the trapezoid the previous one led into; the first leads out of the start trapezoid
+    uint32_t inside = corridor.empty() ? 0 : search.parent[portals[corridor.front()].to];
+    for (const uint32_t p : corridor) {
+        const Portal& portal = portals[p];
+        const GW::Vec2f middle = (portal.a + portal.b) * 0.5f;
+        const GW::Vec2f direction = middle - Centre(trapezoids[inside]);
+        if (Cross(direction, portal.a - middle) > 0.f) {
+            funnel.emplace_back(portal.a, portal.b);
+        }
+        else {
+            funnel.emplace_back(portal.b, portal.a);
+        }
+        inside = portal.to;
+    }
+    funnel.emplace_back(to, to);
+
+    path.clear();
+    path.push_back(from);
+    GW::Vec2f apex = from;
+    GW::Vec2f left = from;
+    GW::Vec2f right = from;
+    size_t left_index = 0;
+    size_t right_index = 0;
+    for (size_t i = 1; i < funnel.size(); i++) {
+        const auto& [next_left, next_right] = funnel[i];
+        // Move the right side in if the new point is inside the funnel
+        if (Cross(right - apex, next_right - apex) >= 0.f) {
+            if ((apex.x == right.x && apex.y == right.y) || Cross(left - apex, next_right - apex) < 0.f) {
+                right = next_right;
+                right_index = i;
+            }
+            else {
+                // Crossed over the left side; that corner is on the path
+                apex = left;
+                path.push_back(apex);
+                right = left = apex;
+                i = right_index = left_index;
+                continue;
+            }
+        }
+        if (Cross(left - apex, next_left - apex) <= 0.f) {
+            if ((apex.x == left.x && apex.y == left.y) || Cross(right - apex, next_left - apex) > 0.f) {
+                left = next_left;
+                left_index = i;
+            }
+            else {
+                apex = right;
+                path.push_back(apex);
+                left = right = apex;
+                i = left_index = right_index;
+                continue;
+            }
+        }
+    }
+    if (path.back().x != to.x || path.back().y != to.y) {
+        path.push_back(to);
+    }
+}
+
+bool NavMesh::FindPath(const GW::Vec2f from, const GW::Vec2f to, std::vector<GW::Vec2f>& path, float* length) const
+{
+    std::lock_guard lock(search_mutex);
+    if (!FindCorridor(from, to, corridor_scratch)) {
+        return false;
+    }
+    PullString(from, to, corridor_scratch, path);
+    if (length) {
+        *length = 0.f;
+        for (size_t i = 1; i < path.size(); i++) {
+            *length += GetDistance(path[i - 1], path[i]);
+        }
+    }
+    return true;
+}
+
+float NavMesh::WalkDistance(const GW::Vec2f from, const GW::Vec2f to) const
+{
+    std::vector<GW::Vec2f> path;
+    float length = -1.f;
+    return FindPath(from, to, path, &length) ? length : -1.f;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Utils/PathingIndex.h>
+
+#include <GWCA/GameContainers/GamePos.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Walking paths over a map's pathing trapezoids, for when straight line distance isn't good enough (e.g. around walls).
+// Trapezoids that share an edge, on the same plane or not, are linked through a portal along that edge. Paths are found
+// with A* over the trapezoids, then pulled tight through the portals with the funnel algorithm, so the result is the
+// shortest polyline through that corridor. No game dependencies; build it from a PathingIndex.
+// Queries are serialised internally, so a mesh can be shared between threads once built.
+class NavMesh {
+public:
+    struct Portal {
+        // Edge shared with the neighbouring trapezoid
+        GW::Vec2f a;
+        GW::Vec2f b;
+        uint32_t to;
+    };
+
+    explicit NavMesh(std::shared_ptr<const PathingIndex> index);
+
+    [[nodiscard]] const PathingIndex& Index() const { return *index; }
+    [[nodiscard]] size_t PortalCount() const { return portals.size(); }
+    // Portals leading out of trapezoid i, as indices into the PathingIndex
+    [[nodiscard]] const Portal* PortalsBegin(const uint32_t i) const { return portals.data() + portal_start[i]; }
+    [[nodiscard]] const Portal* PortalsEnd(const uint32_t i) const { return portals.data() + portal_start[i + 1]; }
+
+    // Shortest walking path from one point to another, both ends included. False if either point is off the pathing map,
+    // or there's no way between them.
+    bool FindPath(GW::Vec2f from, GW::Vec2f to, std::vector<GW::Vec2f>& path, float* length = nullptr) const;
+    // Length of FindPath(), or -1 if there isn't one
+    [[nodiscard]] float WalkDistance(GW::Vec2f from, GW::Vec2f to) const;
+
+private:
+    struct Search {
+        std::vector<float> cost;
+        std::vector<GW::Vec2f> entry;
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> parent_portal;
+        // cost etc are only valid for trapezoids with visited == generation
+        std::vector<uint32_t> visited;
+        std::vector<uint32_t> closed;
+        uint32_t generation = 0;
+        std::vector<std::pair<float, uint32_t>> open;
+        std::vector<uint32_t> starts;
+        std::vector<uint32_t> goals;
+        std::vector<std::pair<GW::Vec2f, GW::Vec2f>> funnel;
+    };
+
+    void Link();
+    bool FindCorridor(GW::Vec2f from, GW::Vec2f to, std::vector<uint32_t>& corridor) const;
+    void PullString(GW::Vec2f from, GW::Vec2f to, const std::vector<uint32_t>& corridor, std::vector<GW::Vec2f>& path) const;
+
+    std::shared_ptr<const PathingIndex> index;
+    // portal_start[i]..portal_start[i + 1] indexes portals for trapezoid i
+    std::vector<uint32_t> portal_start;
+    std::vector<Portal> portals;
+
+    mutable std::mutex search_mutex;
+    mutable Search search;
+    mutable std::vector<uint32_t> corridor_scratch;
+};
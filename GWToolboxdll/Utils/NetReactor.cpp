@@ -0,0 +1,385 @@
+#include <stdafx.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define closesocket(s) ::close(s)
+using SOCKET = int;
+constexpr SOCKET INVALID_SOCKET = -1;
+#endif
+
+#include <easywsclient.hpp>
+
+#include "NetReactor.h"
+
+using easywsclient::WebSocket;
+
+namespace {
+    constexpr uintptr_t no_socket = static_cast<uintptr_t>(-1);
+
+    // Longest select() waits between checks; nothing should need it, short of a wake up getting lost
+    constexpr long max_wait_ms = 1000;
+    // ...unless some messages didn't fit in a queue, in which case keep an eye out for its owner making room
+    constexpr long overflow_wait_ms = 10;
+
+    SOCKET ToSocket(const uintptr_t socket)
+    {
+        return static_cast<SOCKET>(socket);
+    }
+
+    void SetNonBlocking(const SOCKET socket)
+    {
+#ifdef _WIN32
+        u_long on = 1;
+        ioctlsocket(socket, FIONBIO, &on);
+#else
+        fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    }
+
+    // Udp socket on the loopback interface that's connected to itself, so whatever is sent to it shows up as readable
+    uintptr_t CreateWakeSocket()
+    {
+        const SOCKET wake = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (wake == INVALID_SOCKET) {
+            return no_socket;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addr_len = sizeof(addr);
+        if (bind(wake, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+            || getsockname(wake, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0
+            || connect(wake, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            closesocket(wake);
+            return no_socket;
+        }
+        SetNonBlocking(wake);
+        return static_cast<uintptr_t>(wake);
+    }
+
+    // Send the close frame and give the socket a moment to take it
+    void CloseAndDelete(WebSocket* ws)
+    {
+        if (!ws) {
+            return;
+        }
+        ws->close();
+        for (int i = 0; i < 10 && ws->getReadyState() != WebSocket::CLOSED; i++) {
+            ws->poll(10);
+        }
+        delete ws;
+    }
+}
+
+bool NetReactor::Websocket::Poll(Event& out)
+{
+    return inbound.Pop(out);
+}
+
+bool NetReactor::Websocket::Send(std::string message)
+{
+    if (state == State::Closed || close_requested) {
+        return false;
+    }
+    if (!outbound.Push(message)) {
+        return false;
+    }
+    reactor->Wake();
+    return true;
+}
+
+void NetReactor::Websocket::Close()
+{
+    if (close_requested.exchange(true)) {
+        return;
+    }
+    reactor->Wake();
+}
+
+void NetReactor::Websocket::FlushOverflow()
+{
+    while (!inbound_overflow.empty() && inbound.Push(inbound_overflow.front())) {
+        inbound_overflow.pop_front();
+    }
+}
+
+void NetReactor::Websocket::Publish(const Event::Type type, nlohmann::json json)
+{
+    Event event{type, std::move(json)};
+    FlushOverflow();
+    if (!inbound_overflow.empty() || !inbound.Push(event)) {
+        inbound_overflow.push_back(std::move(event));
+    }
+}
+
+NetReactor::~NetReactor()
+{
+    Stop();
+}
+
+void NetReactor::Start(RunBlocking _run_blocking)
+{
+    std::lock_guard lock(mutex);
+    if (running) {
+        return;
+    }
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        return;
+    }
+#endif
+    wake_socket = CreateWakeSocket();
+    if (wake_socket == no_socket) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return;
+    }
+    run_blocking = std::move(_run_blocking);
+    running = true;
+    thread = std::thread([this] {
+        Loop();
+    });
+}
+
+void NetReactor::Stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    Wake();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    closesocket(ToSocket(wake_socket));
+    wake_socket = no_socket;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void NetReactor::Wake() const
+{
+    if (wake_socket == no_socket) {
+        return;
+    }
+    constexpr char wake = 0;
+    send(ToSocket(wake_socket), &wake, 1, 0);
+}
+
+NetReactor::WebsocketPtr NetReactor::Connect(const std::string& url)
+{
+    auto websocket = std::make_shared<Websocket>(this, url);
+    if (!running) {
+        websocket->state = Websocket::State::Closed;
+        websocket->Publish(Websocket::Event::Type::Closed);
+        return websocket;
+    }
+    run_blocking([this, websocket] {
+        WebSocket* ws = nullptr;
+        if (running && !websocket->close_requested) {
+            ws = WebSocket::from_url(websocket->url);
+        }
+        Adopt(websocket, ws);
+    });
+    return websocket;
+}
+
+void NetReactor::Adopt(const WebsocketPtr& websocket, WebSocket* ws)
+{
+    {
+        std::lock_guard lock(mutex);
+        if (ws && ws->getReadyState() == WebSocket::OPEN && running) {
+            // The reactor thread hasn't seen it yet, so this is still the only producer
+            websocket->ws = ws;
+            websocket->state = Websocket::State::Open;
+            websocket->Publish(Websocket::Event::Type::Opened);
+            adopted.push_back(websocket);
+            Wake();
+            return;
+        }
+    }
+    // Never handed over, so nothing else can be touching it
+    CloseAndDelete(ws);
+    websocket->state = Websocket::State::Closed;
+    websocket->Publish(Websocket::Event::Type::Closed);
+}
+
+bool NetReactor::Watch(const uintptr_t socket, OnReadable on_readable)
+{
+    std::lock_guard lock(mutex);
+    if (!running) {
+        return false;
+    }
+    watched[socket] = std::make_shared<OnReadable>(std::move(on_readable));
+    Wake();
+    return true;
+}
+
+void NetReactor::Unwatch(const uintptr_t socket)
+{
+    std::unique_lock lock(mutex);
+    watched.erase(socket);
+    Wake();
+    if (std::this_thread::get_id() == reactor_thread) {
+        return;
+    }
+    call_done.wait(lock, [&] {
+        return calling != socket;
+    });
+}
+
+NetReactor::Stats NetReactor::GetStats()
+{
+    std::lock_guard lock(mutex);
+    return {websocket_count, watched.size(), messages, wakeups};
+}
+
+bool NetReactor::Service(const WebsocketPtr& websocket)
+{
+    WebSocket* ws = websocket->ws;
+    if (websocket.use_count() == 1) {
+        // Nobody is left to read from it
+        websocket->close_requested = true;
+    }
+    std::string message;
+    while (websocket->outbound.Pop(message)) {
+        ws->send(message);
+    }
+    if (websocket->close_requested) {
+        ws->close();
+    }
+    ws->poll(0);
+    ws->dispatch([&](const std::string& data) {
+        messages++;
+        websocket->Publish(Websocket::Event::Type::Message, nlohmann::json::parse(data, nullptr, false));
+    });
+    websocket->FlushOverflow();
+    if (ws->getReadyState() != WebSocket::CLOSED) {
+        return true;
+    }
+    delete ws;
+    websocket->ws = nullptr;
+    websocket->state = Websocket::State::Closed;
+    websocket->Publish(Websocket::Event::Type::Closed);
+    return false;
+}
+
+void NetReactor::CallIfWatched(const uintptr_t socket, const std::shared_ptr<OnReadable>& on_readable)
+{
+    const auto still_watched = [&] {
+        const auto found = watched.find(socket);
+        return found != watched.end() && found->second == on_readable;
+    };
+    {
+        std::lock_guard lock(mutex);
+        if (!still_watched()) {
+            return; // Unwatched since we started waiting
+        }
+        calling = socket;
+    }
+    const bool keep_watching = (*on_readable)();
+    {
+        std::lock_guard lock(mutex);
+        calling = no_socket;
+        if (!keep_watching && still_watched()) {
+            watched.erase(socket);
+        }
+    }
+    call_done.notify_all();
+}
+
+void NetReactor::Loop()
+{
+    const SOCKET wake = ToSocket(wake_socket);
+    WatchedMap watching;
+    {
+        std::lock_guard lock(mutex);
+        reactor_thread = std::this_thread::get_id();
+    }
+    while (true) {
+        {
+            std::lock_guard lock(mutex);
+            if (!running) {
+                break;
+            }
+            websockets.insert(websockets.end(), adopted.begin(), adopted.end());
+            adopted.clear();
+            watching = watched;
+        }
+
+        fd_set read_set;
+        fd_set write_set;
+        FD_ZERO(&read_set);
+        FD_ZERO(&write_set);
+        FD_SET(wake, &read_set);
+        SOCKET max_socket = wake;
+        long wait_ms = max_wait_ms;
+        for (size_t i = 0; i < websockets.size();) {
+            const auto& websocket = websockets[i];
+            if (!Service(websocket)) {
+                websockets.erase(websockets.begin() + static_cast<ptrdiff_t>(i));
+                continue;
+            }
+            const auto socket = ToSocket(static_cast<uintptr_t>(websocket->ws->getSocket()));
+            FD_SET(socket, &read_set);
+            if (websocket->ws->hasPendingSend()) {
+                FD_SET(socket, &write_set);
+            }
+            if (!websocket->inbound_overflow.empty()) {
+                wait_ms = overflow_wait_ms;
+            }
+            max_socket = std::max(max_socket, socket);
+            i++;
+        }
+        websocket_count = websockets.size();
+        for (const auto socket : watching | std::views::keys) {
+            FD_SET(ToSocket(socket), &read_set);
+            max_socket = std::max(max_socket, ToSocket(socket));
+        }
+
+        // First argument is ignored on windows
+        timeval timeout = {wait_ms / 1000, (wait_ms % 1000) * 1000};
+        const int ready = select(static_cast<int>(max_socket) + 1, &read_set, &write_set, nullptr, &timeout);
+        wakeups++;
+        if (ready <= 0) {
+            // Timed out, or a socket was closed while we were waiting on it; the sets are rebuilt either way
+            continue;
+        }
+        if (FD_ISSET(wake, &read_set)) {
+            char buf[64];
+            while (recv(wake, buf, sizeof(buf), 0) > 0) { }
+        }
+        for (const auto& [socket, on_readable] : watching) {
+            if (FD_ISSET(ToSocket(socket), &read_set)) {
+                CallIfWatched(socket, on_readable);
+            }
+        }
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        websockets.insert(websockets.end(), adopted.begin(), adopted.end());
+        adopted.clear();
+        watched.clear();
+        reactor_thread = {};
+    }
+    for (const auto& websocket : websockets) {
+        CloseAndDelete(websocket->ws);
+        websocket->ws = nullptr;
+        websocket->state = Websocket::State::Closed;
+        websocket->Publish(Websocket::Event::Type::Closed);
+    }
+    websockets.clear();
+    websocket_count = 0;
+}
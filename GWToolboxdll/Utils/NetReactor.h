@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <Utils/SpscQueue.h>
+
+namespace easywsclient {
+    class WebSocket;
+}
+
+// One thread that owns toolbox's long-lived sockets. It waits on all of them at once with select(), and does the websocket
+// framing, TLS and JSON parsing, so the game thread only ever pops ready-made messages off a lock-free queue per connection.
+// easywsclient can only connect blocking (DNS, TCP, TLS and HTTP upgrade), so that part is handed to run_blocking;
+// the socket is passed to the reactor thread once it's open.
+// No game dependencies; keep it that way so it can be built and profiled outside of the dll.
+class NetReactor {
+public:
+    class Websocket;
+    using WebsocketPtr = std::shared_ptr<Websocket>;
+    // Run a task that may block for a while e.g. on a worker thread
+    using RunBlocking = std::function<void(std::function<void()>)>;
+    // Called on the reactor thread when the socket has data to read; return false to stop watching it
+    using OnReadable = std::function<bool()>;
+
+    NetReactor() = default;
+    ~NetReactor();
+    NetReactor(const NetReactor&) = delete;
+    NetReactor& operator=(const NetReactor&) = delete;
+
+    // Spin up the reactor thread. No-op if already running.
+    void Start(RunBlocking run_blocking);
+    // Close every websocket, stop watching every raw socket, and join the reactor thread.
+    void Stop();
+    [[nodiscard]] bool IsRunning() const { return running; }
+
+    // Start connecting to a ws:// or wss:// url; returns straight away. Closed from the start if the reactor isn't running.
+    WebsocketPtr Connect(const std::string& url);
+
+    // Call on_readable on the reactor thread whenever socket has data; the caller still owns the socket.
+    // Returns false if the reactor isn't running.
+    bool Watch(uintptr_t socket, OnReadable on_readable);
+    // Waits for a call to on_readable that's already under way, so the socket can be closed as soon as this returns.
+    // Never blocks on the reactor thread, so it can be called from on_readable itself.
+    void Unwatch(uintptr_t socket);
+
+    struct Stats {
+        size_t websockets = 0;
+        size_t watched = 0;
+        uint64_t messages = 0;
+        uint64_t wakeups = 0;
+    };
+    [[nodiscard]] Stats GetStats();
+
+private:
+    using WatchedMap = std::map<uintptr_t, std::shared_ptr<OnReadable>>;
+
+    void Loop();
+    void Wake() const;
+    // Reactor thread. Returns false once the connection is done with.
+    bool Service(const WebsocketPtr& websocket);
+    void Adopt(const WebsocketPtr& websocket, easywsclient::WebSocket* ws);
+    void CallIfWatched(uintptr_t socket, const std::shared_ptr<OnReadable>& on_readable);
+
+    RunBlocking run_blocking;
+    std::thread thread;
+    std::atomic_bool running = false;
+    // Only ever held for a moment, never while calling out; only Unwatch waits on the reactor thread, and only for on_readable
+    std::mutex mutex;
+    // Guarded by mutex; notified when on_readable returns
+    std::condition_variable call_done;
+    // Guarded by mutex; the socket whose on_readable is running on the reactor thread, if any
+    uintptr_t calling = static_cast<uintptr_t>(-1);
+    // Guarded by mutex
+    std::thread::id reactor_thread;
+    // Guarded by mutex; connected websockets that the reactor thread hasn't picked up yet
+    std::vector<WebsocketPtr> adopted;
+    // Guarded by mutex
+    WatchedMap watched;
+    // Reactor thread only
+    std::vector<WebsocketPtr> websockets;
+    // Loopback udp socket connected to itself; a byte sent to it wakes the reactor up from select()
+    uintptr_t wake_socket = static_cast<uintptr_t>(-1);
+    std::atomic<size_t> websocket_count = 0;
+    std::atomic<uint64_t> messages = 0;
+    std::atomic<uint64_t> wakeups = 0;
+};
+
+// A websocket connection serviced by a NetReactor. Everything here is meant to be called from one thread, the one that owns it
+// (i.e. the game thread); Poll() there is the only thing that touches the messages.
+class NetReactor::Websocket {
+public:
+    enum class State : uint8_t {
+        Connecting,
+        Open,
+        Closed
+    };
+
+    struct Event {
+        enum class Type : uint8_t {
+            Opened,
+            Message,
+            // Always the last event; also sent if it never managed to connect
+            Closed
+        } type = Type::Message;
+        // Parsed on the reactor thread; discarded if the message wasn't valid JSON
+        nlohmann::json json;
+    };
+
+    Websocket(NetReactor* _reactor, std::string _url) : reactor(_reactor), url(std::move(_url)) { }
+    Websocket(const Websocket&) = delete;
+    Websocket& operator=(const Websocket&) = delete;
+
+    [[nodiscard]] State GetState() const { return state; }
+    [[nodiscard]] bool IsOpen() const { return state == State::Open; }
+    [[nodiscard]] const std::string& Url() const { return url; }
+
+    // Pop the next event; returns false if there isn't one yet.
+    bool Poll(Event& out);
+    // Queue a text message; anything sent before it opens goes out once it does. Returns false if it's closed or the queue is full.
+    bool Send(std::string message);
+    // Close gracefully. Dropping the last reference to it does the same.
+    void Close();
+
+private:
+    friend class NetReactor;
+
+    NetReactor* reactor;
+    const std::string url;
+    std::atomic<State> state = State::Connecting;
+    std::atomic_bool close_requested = false;
+    // Reactor to owner
+    SpscQueue<Event> inbound{256};
+    // Owner to reactor
+    SpscQueue<std::string> outbound{64};
+
+    // Reactor thread only
+    easywsclient::WebSocket* ws = nullptr;
+    // Events that didn't fit in inbound, oldest first
+    std::deque<Event> inbound_overflow;
+    void FlushOverflow();
+    void Publish(Event::Type type, nlohmann::json json = {});
+};
@@ -0,0 +1,912 @@
+#include <stdafx.h>
+
+#include <charconv>
+#include <cmath>
+
+#include "ObserverExport.h"
+
+using namespace ObserverStats;
+
+namespace ObserverExport {
+    namespace {
+        // Every ObservedAction in SharedStats, by the name it's exported under
+        struct SharedAction {
+            const char* name;
+            ObservedAction SharedStats::* action;
+        };
+
+        constexpr SharedAction shared_actions[] = {
+            {"total_attacks_dealt", &SharedStats::total_attacks_dealt},
+            {"total_attacks_received", &SharedStats::total_attacks_received},
+            {"total_attacks_dealt_to_other_parties", &SharedStats::total_attacks_dealt_to_other_parties},
+            {"total_attacks_received_from_other_parties", &SharedStats::total_attacks_received_from_other_parties},
+            {"total_skills_used", &SharedStats::total_skills_used},
+            {"total_skills_received", &SharedStats::total_skills_received},
+            {"total_skills_used_on_own_party", &SharedStats::total_skills_used_on_own_party},
+            {"total_skills_used_on_other_parties", &SharedStats::total_skills_used_on_other_parties},
+            {"total_skills_received_from_own_party", &SharedStats::total_skills_received_from_own_party},
+            {"total_skills_received_from_other_parties", &SharedStats::total_skills_received_from_other_parties},
+            {"total_skills_used_on_own_team", &SharedStats::total_skills_used_on_own_team},
+            {"total_skills_used_on_other_teams", &SharedStats::total_skills_used_on_other_teams},
+            {"total_skills_received_from_own_team", &SharedStats::total_skills_received_from_own_team},
+            {"total_skills_received_from_other_teams", &SharedStats::total_skills_received_from_other_teams},
+        };
+
+        // Every ObservedAction in SkillStats, by the name it's exported under
+        struct SkillAction {
+            const char* name;
+            ObservedAction SkillStats::* action;
+        };
+
+        constexpr SkillAction skill_actions[] = {
+            {"total_usages", &SkillStats::total_usages},
+            {"total_self_usages", &SkillStats::total_self_usages},
+            {"total_other_usages", &SkillStats::total_other_usages},
+            {"total_own_party_usages", &SkillStats::total_own_party_usages},
+            {"total_other_party_usages", &SkillStats::total_other_party_usages},
+            {"total_own_team_usages", &SkillStats::total_own_team_usages},
+            {"total_other_team_usages", &SkillStats::total_other_team_usages},
+        };
+
+        // Ids are used as object keys
+        std::string IdKey(const uint32_t id)
+        {
+            return std::to_string(id);
+        }
+
+        void WriteAction(JsonWriter& json, const ObservedAction& action)
+        {
+            json.BeginObject();
+            json.Field("started", action.started);
+            json.Field("stopped", action.stopped);
+            json.Field("interrupted", action.interrupted);
+            json.Field("finished", action.finished);
+            json.Field("integrity", action.integrity);
+            json.EndObject();
+        }
+
+        // The scalar stats; the object is left open for whatever else the caller has
+        void WriteSharedStatFields(JsonWriter& json, const SharedStats& stats)
+        {
+            json.Field("total_crits_received", stats.total_crits_received);
+            json.Field("total_crits_dealt", stats.total_crits_dealt);
+            json.Field("total_party_crits_received", stats.total_party_crits_received);
+            json.Field("total_party_crits_dealt", stats.total_party_crits_dealt);
+            json.Field("knocked_down_count", stats.knocked_down_count);
+            json.Field("interrupted_count", stats.interrupted_count);
+            json.Field("interrupted_skills_count", stats.interrupted_skills_count);
+            json.Field("cancelled_count", stats.cancelled_count);
+            json.Field("cancelled_skills_count", stats.cancelled_skills_count);
+            json.Field("knocked_down_duration", stats.knocked_down_duration);
+            json.Field("deaths", stats.deaths);
+            json.Field("kills", stats.kills);
+            json.Field("kdr_str", stats.kdr_str);
+        }
+
+        void WriteSharedActionFields(JsonWriter& json, const SharedStats& stats)
+        {
+            for (const auto& [name, action] : shared_actions) {
+                json.Key(name);
+                WriteAction(json, stats.*action);
+            }
+        }
+
+        void WriteIds(JsonWriter& json, const std::vector<uint32_t>& ids)
+        {
+            json.BeginArray();
+            for (const uint32_t id : ids) {
+                json.Value(id);
+            }
+            json.EndArray();
+        }
+
+        // "skill_ids_used": [...], "skills_used": {"<skill_id>": {...action, "skill_id"}}
+        void WriteObservedSkills(JsonWriter& json, const std::string_view ids_key, const std::string_view by_id_key, const std::vector<ObservedSkill>& skills)
+        {
+            json.Key(ids_key);
+            json.BeginArray();
+            for (const ObservedSkill& skill : skills) {
+                json.Value(skill.skill_id);
+            }
+            json.EndArray();
+            if (skills.empty()) {
+                return;
+            }
+            json.Key(by_id_key);
+            json.BeginObject();
+            for (const ObservedSkill& skill : skills) {
+                json.Key(IdKey(skill.skill_id));
+                json.BeginObject();
+                json.Field("started", skill.started);
+                json.Field("stopped", skill.stopped);
+                json.Field("interrupted", skill.interrupted);
+                json.Field("finished", skill.finished);
+                json.Field("integrity", skill.integrity);
+                json.Field("skill_id", skill.skill_id);
+                json.EndObject();
+            }
+            json.EndObject();
+        }
+
+        // "<agent_id>": {"<skill_id>": {...action}} for every agent
+        template <typename SkillsWith>
+        void WriteSkillsByAgent(JsonWriter& json, const std::string_view key, const std::vector<uint32_t>& agent_ids, SkillsWith skills_with)
+        {
+            if (agent_ids.empty()) {
+                return;
+            }
+            json.Key(key);
+            json.BeginObject();
+            for (const uint32_t agent_id : agent_ids) {
+                json.Key(IdKey(agent_id));
+                json.BeginObject();
+                for (const ObservedSkill& skill : skills_with(agent_id)) {
+                    json.Key(IdKey(skill.skill_id));
+                    WriteAction(json, skill);
+                }
+                json.EndObject();
+            }
+            json.EndObject();
+        }
+
+        // "<agent_id>": {...action} for every agent
+        void WriteAttacksByAgent(JsonWriter& json, const std::string_view key, const std::vector<std::pair<uint32_t, ObservedAction>>& attacks)
+        {
+            if (attacks.empty()) {
+                return;
+            }
+            json.Key(key);
+            json.BeginObject();
+            for (const auto& [agent_id, action] : attacks) {
+                json.Key(IdKey(agent_id));
+                WriteAction(json, action);
+            }
+            json.EndObject();
+        }
+
+        // A CSV file written a row at a time
+        class CsvWriter {
+        public:
+            explicit CsvWriter(const std::filesystem::path& path)
+            {
+                if (_wfopen_s(&file, path.wstring().c_str(), L"wb") != 0) {
+                    file = nullptr;
+                }
+            }
+
+            CsvWriter(const CsvWriter&) = delete;
+            CsvWriter& operator=(const CsvWriter&) = delete;
+
+            ~CsvWriter()
+            {
+                if (file) {
+                    fclose(file);
+                }
+            }
+
+            [[nodiscard]] bool Good() const { return file && !ferror(file); }
+
+            void Header(const std::string_view column)
+            {
+                Text(column);
+            }
+
+            // ...started,...stopped,...interrupted,...finished,...integrity
+            void ActionHeader(const std::string_view prefix)
+            {
+                for (const char* field : {"started", "stopped", "interrupted", "finished", "integrity"}) {
+                    Separate();
+                    fwrite(prefix.data(), 1, prefix.size(), file);
+                    fputc('.', file);
+                    fputs(field, file);
+                }
+            }
+
+            void Text(const std::string_view value)
+            {
+                Separate();
+                if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+                    fwrite(value.data(), 1, value.size(), file);
+                    return;
+                }
+                fputc('"', file);
+                for (const char c : value) {
+                    if (c == '"') {
+                        fputc('"', file);
+                    }
+                    fputc(c, file);
+                }
+                fputc('"', file);
+            }
+
+            void Number(const uint64_t value)
+            {
+                Separate();
+                fprintf(file, "%llu", static_cast<unsigned long long>(value));
+            }
+
+            void Number(const int64_t value)
+            {
+                Separate();
+                fprintf(file, "%lld", static_cast<long long>(value));
+            }
+
+            void Number(const float value)
+            {
+                Separate();
+                if (!std::isfinite(value)) {
+                    return;
+                }
+                char buf[32];
+                const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+                fwrite(buf, 1, end - buf, file);
+            }
+
+            void Action(const ObservedAction& action)
+            {
+                Number(static_cast<uint64_t>(action.started));
+                Number(static_cast<uint64_t>(action.stopped));
+                Number(static_cast<uint64_t>(action.interrupted));
+                Number(static_cast<uint64_t>(action.finished));
+                Number(static_cast<int64_t>(action.integrity));
+            }
+
+            void EndRow()
+            {
+                fputc('\n', file);
+                row_started = false;
+            }
+
+        private:
+            void Separate()
+            {
+                if (row_started) {
+                    fputc(',', file);
+                }
+                row_started = true;
+            }
+
+            FILE* file = nullptr;
+            bool row_started = false;
+        };
+
+        void SharedStatsHeader(CsvWriter& csv)
+        {
+            for (const char* column : {"total_crits_received", "total_crits_dealt", "total_party_crits_received", "total_party_crits_dealt", "knocked_down_count",
+                                       "interrupted_count", "interrupted_skills_count", "cancelled_count", "cancelled_skills_count", "knocked_down_duration", "deaths",
+                                       "kills", "kdr"}) {
+                csv.Header(column);
+            }
+            for (const auto& [name, action] : shared_actions) {
+                csv.ActionHeader(name);
+            }
+        }
+
+        void SharedStatsRow(CsvWriter& csv, const SharedStats& stats)
+        {
+            for (const size_t value : {stats.total_crits_received, stats.total_crits_dealt, stats.total_party_crits_received, stats.total_party_crits_dealt,
+                                       stats.knocked_down_count, stats.interrupted_count, stats.interrupted_skills_count, stats.cancelled_count,
+                                       stats.cancelled_skills_count}) {
+                csv.Number(static_cast<uint64_t>(value));
+            }
+            csv.Number(stats.knocked_down_duration);
+            csv.Number(static_cast<uint64_t>(stats.deaths));
+            csv.Number(static_cast<uint64_t>(stats.kills));
+            csv.Number(stats.kdr_pc);
+            for (const auto& [name, action] : shared_actions) {
+                csv.Action(stats.*action);
+            }
+        }
+    }
+
+
+    void JsonWriter::Separate()
+    {
+        if (after_key) {
+            after_key = false;
+            return;
+        }
+        if (!depth) {
+            return;
+        }
+        const uint64_t bit = 1ull << ((depth - 1) & 63);
+        if (has_items & bit) {
+            fputc(',', file);
+        }
+        has_items |= bit;
+    }
+
+
+    void JsonWriter::BeginObject()
+    {
+        Separate();
+        fputc('{', file);
+        depth++;
+        has_items &= ~(1ull << ((depth - 1) & 63));
+    }
+
+
+    void JsonWriter::EndObject()
+    {
+        fputc('}', file);
+        depth--;
+    }
+
+
+    void JsonWriter::BeginArray()
+    {
+        Separate();
+        fputc('[', file);
+        depth++;
+        has_items &= ~(1ull << ((depth - 1) & 63));
+    }
+
+
+    void JsonWriter::EndArray()
+    {
+        fputc(']', file);
+        depth--;
+    }
+
+
+    JsonWriter& JsonWriter::Key(const std::string_view key)
+    {
+        String(key);
+        fputc(':', file);
+        after_key = true;
+        return *this;
+    }
+
+
+    void JsonWriter::String(const std::string_view value)
+    {
+        Separate();
+        fputc('"', file);
+        // write runs that don't need escaping in one go
+        size_t run = 0;
+        for (size_t i = 0; i < value.size(); i++) {
+            const auto c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            Raw(value.substr(run, i - run));
+            run = i + 1;
+            switch (c) {
+                case '"':
+                    Raw("\\\"");
+                    break;
+                case '\\':
+                    Raw("\\\\");
+                    break;
+                case '\b':
+                    Raw("\\b");
+                    break;
+                case '\f':
+                    Raw("\\f");
+                    break;
+                case '\n':
+                    Raw("\\n");
+                    break;
+                case '\r':
+                    Raw("\\r");
+                    break;
+                case '\t':
+                    Raw("\\t");
+                    break;
+                default:
+                    fprintf(file, "\\u%04x", c);
+                    break;
+            }
+        }
+        Raw(value.substr(run));
+        fputc('"', file);
+    }
+
+
+    void JsonWriter::Number(const uint64_t value)
+    {
+        Separate();
+        char buf[24];
+        const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        Raw({buf, static_cast<size_t>(end - buf)});
+    }
+
+
+    void JsonWriter::Number(const int64_t value)
+    {
+        Separate();
+        char buf[24];
+        const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        Raw({buf, static_cast<size_t>(end - buf)});
+    }
+
+
+    void JsonWriter::Number(const double value)
+    {
+        if (!std::isfinite(value)) {
+            return Null();
+        }
+        Separate();
+        char buf[32];
+        const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        Raw({buf, static_cast<size_t>(end - buf)});
+    }
+
+
+    void JsonWriter::Number(const float value)
+    {
+        if (!std::isfinite(value)) {
+            return Null();
+        }
+        Separate();
+        char buf[32];
+        const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        Raw({buf, static_cast<size_t>(end - buf)});
+    }
+
+
+    void JsonWriter::Bool(const bool value)
+    {
+        Separate();
+        Raw(value ? "true" : "false");
+    }
+
+
+    void JsonWriter::Null()
+    {
+        Separate();
+        Raw("null");
+    }
+
+
+    std::string MatchName(Match& match)
+    {
+        std::string name;
+        for (const uint32_t party_id : match.GetObservablePartyIds()) {
+            const Party* party = match.GetParty(party_id);
+            if (!party) {
+                continue;
+            }
+            if (!name.empty()) {
+                name.append(" vs ");
+            }
+            name.append(party->display_name);
+        }
+        return name;
+    }
+
+
+    // Version 0.1
+    bool WriteJSON_V_0_1(FILE* file, Match& match, const WriteHeader& header)
+    {
+        JsonWriter json(file);
+        json.BeginObject();
+        if (header) {
+            header(json);
+        }
+
+        json.Key("parties");
+        json.BeginArray();
+        for (const uint32_t party_id : match.GetObservablePartyIds()) {
+            // parties
+            const Party* party = match.GetParty(party_id);
+            if (!party) {
+                json.Null();
+                continue;
+            }
+            // parties -> party
+            json.BeginObject();
+            json.Field("party_id", party->party_id);
+            json.Key("stats");
+            json.BeginObject();
+            WriteSharedStatFields(json, party->stats);
+            json.EndObject();
+            json.Key("members");
+            json.BeginArray();
+            for (const uint32_t agent_id : party->agent_ids) {
+                // parties -> party -> agents
+                Agent* agent = match.GetAgent(agent_id);
+                if (!agent) {
+                    json.Null();
+                    continue;
+                }
+                // parties -> party -> agents -> agent
+                json.BeginObject();
+                json.Field("display_name", agent->DisplayName());
+                json.Field("raw_name", agent->RawName());
+                json.Field("debug_name", agent->DebugName());
+                json.Field("sanitized_name", agent->SanitizedName());
+                json.Field("party_id", agent->party_id);
+                json.Field("party_index", agent->party_index);
+                json.Field("primary", agent->primary);
+                json.Field("secondary", agent->secondary);
+                json.Field("profession", agent->profession);
+                json.Key("stats");
+                json.BeginObject();
+                WriteSharedStatFields(json, agent->stats);
+                json.EndObject();
+                json.Key("skills");
+                json.BeginArray();
+                for (const ObservedSkill& skill_used : agent->stats.SkillsUsed()) {
+                    // parties -> party -> agents -> agent -> skills
+                    Skill* skill = match.GetSkill(skill_used.skill_id);
+                    if (!skill) {
+                        json.Null();
+                        continue;
+                    }
+                    // parties -> party -> agents -> agent -> skills -> skill
+                    json.BeginObject();
+                    json.Field("name", skill->Name());
+                    json.EndObject();
+                }
+                json.EndArray();
+                json.EndObject();
+            }
+            json.EndArray();
+            json.EndObject();
+        }
+        json.EndArray();
+
+        json.EndObject();
+        return json.Good();
+    }
+
+
+    // Version 1.0
+    bool WriteJSON_V_1_0(FILE* file, Match& match, const WriteHeader& header, const WriteSkillDetails& skill_details)
+    {
+        JsonWriter json(file);
+        json.BeginObject();
+        if (header) {
+            header(json);
+        }
+
+        json.Field("name", MatchName(match));
+        json.Field("match_finished", match.match_finished);
+        json.Field("winning_party_id", match.winning_party_id);
+        json.Field("match_duration_ms_total", match.match_duration_ms_total.count());
+        json.Field("match_duration_ms", match.match_duration_ms.count());
+        json.Field("match_duration_secs", match.match_duration_secs.count());
+        json.Field("match_duration_mins", match.match_duration_mins.count());
+
+        json.Key("map");
+        if (Map* map = match.GetMap()) {
+            json.BeginObject();
+            json.Field("name", map->Name());
+            json.Field("description", map->Description());
+            json.Field("is_pvp", map->GetIsPvP());
+            json.Field("is_guild_hall", map->GetIsGuildHall());
+            json.Field("campaign", map->campaign);
+            json.Field("continent", map->continent);
+            json.Field("region", map->region);
+            json.Field("type", map->type);
+            json.Field("flags", map->flags);
+            json.Field("name_id", map->name_id);
+            json.Field("description_id", map->description_id);
+            json.EndObject();
+        }
+        else {
+            json.Null();
+        }
+
+        // guilds
+        const std::vector<uint32_t>& guild_ids = match.GetObservableGuildIds();
+        json.Key("guilds");
+        json.BeginObject();
+        json.Key("ids");
+        WriteIds(json, guild_ids);
+        json.Key("by_id");
+        json.BeginObject();
+        for (const uint32_t guild_id : guild_ids) {
+            json.Key(IdKey(guild_id));
+            const Guild* guild = match.GetGuild(guild_id);
+            if (!guild) {
+                json.Null();
+                continue;
+            }
+            json.BeginObject();
+            json.Field("guild_id", guild->guild_id);
+            json.Key("key");
+            json.BeginArray();
+            for (const uint32_t k : guild->key) {
+                json.Value(k);
+            }
+            json.EndArray();
+            json.Field("name", guild->name);
+            json.Field("tag", guild->tag);
+            json.Field("wrapped_tag", guild->wrapped_tag);
+            json.Field("rank", guild->rank);
+            json.Field("rating", guild->rating);
+            json.Field("faction", guild->faction);
+            json.Field("faction_point", guild->faction_point);
+            json.Field("qualifier_point", guild->qualifier_point);
+            json.Field("cape_trim", guild->cape_trim);
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        // skills
+        const std::vector<uint32_t>& skill_ids = match.GetObservableSkillIds();
+        json.Key("skills");
+        json.BeginObject();
+        json.Key("ids");
+        WriteIds(json, skill_ids);
+        json.Key("by_id");
+        json.BeginObject();
+        for (const uint32_t skill_id : skill_ids) {
+            json.Key(IdKey(skill_id));
+            Skill* skill = match.GetSkill(skill_id);
+            if (!skill) {
+                json.Null();
+                continue;
+            }
+            json.BeginObject();
+            json.Field("skill_id", skill->skill_id);
+            json.Field("name", skill->Name());
+            json.Key("stats");
+            json.BeginObject();
+            for (const auto& [name, action] : skill_actions) {
+                json.Key(name);
+                WriteAction(json, skill->stats.*action);
+            }
+            json.EndObject();
+            if (skill_details) {
+                skill_details(json, *skill);
+            }
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        // parties
+        const std::vector<uint32_t>& party_ids = match.GetObservablePartyIds();
+        json.Key("parties");
+        json.BeginObject();
+        json.Key("ids");
+        WriteIds(json, party_ids);
+        json.Key("by_id");
+        json.BeginObject();
+        for (const uint32_t party_id : party_ids) {
+            json.Key(IdKey(party_id));
+            const Party* party = match.GetParty(party_id);
+            if (!party) {
+                json.Null();
+                continue;
+            }
+            json.BeginObject();
+            json.Field("party_id", party->party_id);
+            json.Field("name", party->name);
+            json.Field("display_name", party->display_name);
+            json.Field("is_victorious", party->is_victorious);
+            json.Field("is_defeated", party->is_defeated);
+            json.Field("guild_id", party->guild_id);
+            json.Key("agent_ids");
+            WriteIds(json, party->agent_ids);
+            json.Field("rank", party->rank);
+            json.Field("rank_str", party->rank_str);
+            json.Field("rating", party->rating);
+            json.Key("stats");
+            json.BeginObject();
+            WriteSharedStatFields(json, party->stats);
+            WriteSharedActionFields(json, party->stats);
+            json.EndObject();
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        // agents
+        const std::vector<uint32_t>& agent_ids = match.GetObservableAgentIds();
+        json.Key("agents");
+        json.BeginObject();
+        json.Key("ids");
+        WriteIds(json, agent_ids);
+        json.Key("by_id");
+        json.BeginObject();
+        for (const uint32_t agent_id : agent_ids) {
+            json.Key(IdKey(agent_id));
+            Agent* agent = match.GetAgent(agent_id);
+            if (!agent) {
+                json.Null();
+                continue;
+            }
+            const AgentStats& stats = agent->stats;
+            json.BeginObject();
+            json.Field("agent_id", agent->agent_id);
+            json.Field("display_name", agent->DisplayName());
+            json.Field("raw_name", agent->RawName());
+            json.Field("debug_name", agent->DebugName());
+            json.Field("sanitized_name", agent->SanitizedName());
+            json.Field("party_id", agent->party_id);
+            json.Field("party_index", agent->party_index);
+            json.Field("primary", agent->primary);
+            json.Field("secondary", agent->secondary);
+            json.Field("profession", agent->profession);
+            json.Field("guild_id", agent->guild_id);
+            json.Key("stats");
+            json.BeginObject();
+            WriteSharedStatFields(json, stats);
+            WriteSharedActionFields(json, stats);
+
+            // attacks
+            WriteAttacksByAgent(json, "attacks_dealt_to_agents", stats.AttacksDealtToAgents());
+            WriteAttacksByAgent(json, "attacks_received_from_agents", stats.AttacksReceivedFromAgents());
+
+            // skills
+            WriteObservedSkills(json, "skill_ids_used", "skills_used", stats.SkillsUsed());
+            WriteObservedSkills(json, "skill_ids_received", "skills_received", stats.SkillsReceived());
+            WriteSkillsByAgent(json, "skills_used_on_agents", stats.AgentIdsSkillsUsedOn(), [&stats](const uint32_t target_id) {
+                return stats.SkillsUsedOn(target_id);
+            });
+            WriteSkillsByAgent(json, "skills_received_from_agents", stats.AgentIdsSkillsReceivedFrom(), [&stats](const uint32_t caster_id) {
+                return stats.SkillsReceivedFrom(caster_id);
+            });
+            json.EndObject();
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        json.EndObject();
+        return json.Good();
+    }
+
+
+    bool WriteTables(const std::filesystem::path& folder, Match& match)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(folder, ec);
+        // tables are written one after the other; each one is checked as it's closed
+        bool ok = true;
+
+        {
+            CsvWriter csv(folder / "match.csv");
+            if (!csv.Good()) {
+                return false;
+            }
+            for (const char* column : {"name", "map", "map_id", "match_finished", "winning_party_id", "match_duration_ms_total"}) {
+                csv.Header(column);
+            }
+            csv.EndRow();
+            Map* map = match.GetMap();
+            csv.Text(MatchName(match));
+            csv.Text(map ? map->Name() : "");
+            csv.Number(static_cast<uint64_t>(map ? map->name_id : 0));
+            csv.Number(static_cast<uint64_t>(match.match_finished));
+            csv.Number(static_cast<uint64_t>(match.winning_party_id));
+            csv.Number(static_cast<int64_t>(match.match_duration_ms_total.count()));
+            csv.EndRow();
+            ok &= csv.Good();
+        }
+
+        {
+            CsvWriter csv(folder / "parties.csv");
+            if (!csv.Good()) {
+                return false;
+            }
+            for (const char* column : {"party_id", "name", "display_name", "guild_id", "rank", "rating", "morale_boosts", "is_victorious", "is_defeated"}) {
+                csv.Header(column);
+            }
+            SharedStatsHeader(csv);
+            csv.EndRow();
+            for (const uint32_t party_id : match.GetObservablePartyIds()) {
+                const Party* party = match.GetParty(party_id);
+                if (!party) {
+                    continue;
+                }
+                csv.Number(static_cast<uint64_t>(party->party_id));
+                csv.Text(party->name);
+                csv.Text(party->display_name);
+                csv.Number(static_cast<uint64_t>(party->guild_id));
+                csv.Number(static_cast<uint64_t>(party->rank));
+                csv.Number(static_cast<uint64_t>(party->rating));
+                csv.Number(static_cast<uint64_t>(party->morale_boosts));
+                csv.Number(static_cast<uint64_t>(party->is_victorious));
+                csv.Number(static_cast<uint64_t>(party->is_defeated));
+                SharedStatsRow(csv, party->stats);
+                csv.EndRow();
+            }
+            ok &= csv.Good();
+        }
+
+        {
+            CsvWriter csv(folder / "agents.csv");
+            if (!csv.Good()) {
+                return false;
+            }
+            for (const char* column : {"agent_id", "name", "party_id", "party_index", "team_id", "guild_id", "primary", "secondary", "profession", "is_player", "is_npc"}) {
+                csv.Header(column);
+            }
+            SharedStatsHeader(csv);
+            csv.EndRow();
+            for (const uint32_t agent_id : match.GetObservableAgentIds()) {
+                Agent* agent = match.GetAgent(agent_id);
+                if (!agent) {
+                    continue;
+                }
+                csv.Number(static_cast<uint64_t>(agent->agent_id));
+                csv.Text(agent->RawName());
+                csv.Number(static_cast<uint64_t>(agent->party_id));
+                csv.Number(static_cast<uint64_t>(agent->party_index));
+                csv.Number(static_cast<uint64_t>(agent->team_id));
+                csv.Number(static_cast<uint64_t>(agent->guild_id));
+                csv.Number(static_cast<uint64_t>(agent->primary));
+                csv.Number(static_cast<uint64_t>(agent->secondary));
+                csv.Text(agent->profession);
+                csv.Number(static_cast<uint64_t>(agent->is_player));
+                csv.Number(static_cast<uint64_t>(agent->is_npc));
+                SharedStatsRow(csv, agent->stats);
+                csv.EndRow();
+            }
+            ok &= csv.Good();
+        }
+
+        {
+            CsvWriter csv(folder / "skills.csv");
+            if (!csv.Good()) {
+                return false;
+            }
+            csv.Header("skill_id");
+            csv.Header("name");
+            for (const auto& [name, action] : skill_actions) {
+                csv.ActionHeader(name);
+            }
+            csv.EndRow();
+            for (const uint32_t skill_id : match.GetObservableSkillIds()) {
+                Skill* skill = match.GetSkill(skill_id);
+                if (!skill) {
+                    continue;
+                }
+                csv.Number(static_cast<uint64_t>(skill->skill_id));
+                csv.Text(skill->Name());
+                for (const auto& [name, action] : skill_actions) {
+                    csv.Action(skill->stats.*action);
+                }
+                csv.EndRow();
+            }
+            ok &= csv.Good();
+        }
+
+        {
+            CsvWriter attacks(folder / "attacks.csv");
+            CsvWriter skills_used_on(folder / "skills_used_on.csv");
+            if (!attacks.Good() || !skills_used_on.Good()) {
+                return false;
+            }
+            attacks.Header("caster_id");
+            attacks.Header("target_id");
+            attacks.ActionHeader("attacks");
+            attacks.EndRow();
+            skills_used_on.Header("caster_id");
+            skills_used_on.Header("target_id");
+            skills_used_on.Header("skill_id");
+            skills_used_on.ActionHeader("skills");
+            skills_used_on.EndRow();
+            for (const uint32_t caster_id : match.GetObservableAgentIds()) {
+                const Agent* caster = match.GetAgent(caster_id);
+                if (!caster) {
+                    continue;
+                }
+                for (const auto& [target_id, action] : caster->stats.AttacksDealtToAgents()) {
+                    attacks.Number(static_cast<uint64_t>(caster_id));
+                    attacks.Number(static_cast<uint64_t>(target_id));
+                    attacks.Action(action);
+                    attacks.EndRow();
+                }
+                for (const uint32_t target_id : caster->stats.AgentIdsSkillsUsedOn()) {
+                    for (const ObservedSkill& skill : caster->stats.SkillsUsedOn(target_id)) {
+                        skills_used_on.Number(static_cast<uint64_t>(caster_id));
+                        skills_used_on.Number(static_cast<uint64_t>(target_id));
+                        skills_used_on.Number(static_cast<uint64_t>(skill.skill_id));
+                        skills_used_on.Action(skill);
+                        skills_used_on.EndRow();
+                    }
+                }
+            }
+            ok &= attacks.Good() && skills_used_on.Good();
+        }
+
+        return ok;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <Utils/ObserverMatch.h>
+
+// Writes a match out as it goes, rather than building the whole document in memory first; memory use stays flat
+// however big the match is. Works for the live match in ObserverModule and for one replayed from a journal alike.
+// No game dependencies; keep it that way so it can be built and profiled outside of the dll.
+namespace ObserverExport {
+    // JSON written straight to a file. Keys are written in the order they're given; nothing is checked for being
+    // well formed beyond where commas go, so objects and arrays have to be ended in order.
+    class JsonWriter {
+    public:
+        explicit JsonWriter(FILE* _file) : file(_file) { }
+
+        void BeginObject();
+        void EndObject();
+        void BeginArray();
+        void EndArray();
+        // Key of the next value in an object
+        JsonWriter& Key(std::string_view key);
+
+        void String(std::string_view value);
+        void Number(uint64_t value);
+        void Number(int64_t value);
+        // Shortest form that reads back the same; NaN and infinity are written as null
+        void Number(double value);
+        void Number(float value);
+        void Bool(bool value);
+        void Null();
+
+        void Value(const std::string& value) { String(value); }
+        void Value(const std::string_view value) { String(value); }
+        void Value(const char* value) { String(value); }
+        void Value(const bool value) { Bool(value); }
+        void Value(const float value) { Number(value); }
+        void Value(const double value) { Number(value); }
+        template <typename T>
+            requires std::is_integral_v<T> || std::is_enum_v<T>
+        void Value(const T value)
+        {
+            if constexpr (std::is_enum_v<T>) {
+                Value(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_signed_v<T>) {
+                Number(static_cast<int64_t>(value));
+            }
+            else {
+                Number(static_cast<uint64_t>(value));
+            }
+        }
+
+        template <typename T>
+        void Field(const std::string_view key, const T& value)
+        {
+            Key(key);
+            Value(value);
+        }
+
+        // False if anything failed to write
+        [[nodiscard]] bool Good() const { return !ferror(file); }
+
+    private:
+        void Separate();
+        void Raw(std::string_view text) const { fwrite(text.data(), 1, text.size(), file); }
+
+        FILE* file;
+        // One bit per open object/array, set once it has something in it; deeper than 64 isn't needed here
+        uint64_t has_items = 0;
+        unsigned depth = 0;
+        bool after_key = false;
+    };
+
+    // Fields of its own the caller wants in the top level object, e.g. when it was exported
+    using WriteHeader = std::function<void(JsonWriter&)>;
+    // Anything more that's known about a skill, written into its object
+    using WriteSkillDetails = std::function<void(JsonWriter&, ObserverStats::Skill&)>;
+
+    // e.g. "Guild A [AAA] vs Guild B [BBB]"
+    std::string MatchName(ObserverStats::Match& match);
+
+    // Same layout as the JSON exports always had, version 0.1 and 1.0
+    bool WriteJSON_V_0_1(FILE* file, ObserverStats::Match& match, const WriteHeader& header = {});
+    bool WriteJSON_V_1_0(FILE* file, ObserverStats::Match& match, const WriteHeader& header = {}, const WriteSkillDetails& skill_details = {});
+
+    // One CSV file per table, with a column per stat, into folder:
+    // match, parties, agents, skills, attacks (caster x target), skills_used_on (caster x target x skill).
+    // Flat tables like these load straight into pandas, a spreadsheet or a columnar database.
+    bool WriteTables(const std::filesystem::path& folder, ObserverStats::Match& match);
+}
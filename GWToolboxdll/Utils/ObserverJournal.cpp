@@ -0,0 +1,605 @@
+#include <stdafx.h>
+
+#include "ObserverJournal.h"
+
+using namespace ObserverStats;
+
+namespace {
+    constexpr char journal_magic[4] = {'G', 'W', 'O', 'J'};
+    constexpr uint32_t file_version = 1;
+    constexpr size_t file_header_size = sizeof(journal_magic) + sizeof(file_version);
+
+    // Records other than events; events are their EventType
+    enum class RecordType : uint8_t {
+        Agent = 0x40,
+        Skill,
+        Party,
+        Guild,
+        PartyMember,
+        Roster,
+        Map,
+        Name
+    };
+
+    // Which of an events fields are written, by EventType
+    constexpr uint8_t has_caster = 0x1;
+    constexpr uint8_t has_target = 0x2;
+    constexpr uint8_t has_value = 0x4;
+    constexpr uint8_t has_amount = 0x8;
+    constexpr uint8_t event_fields[] = {
+        has_caster | has_value,                           // AgentState
+        has_caster | has_target | has_value | has_amount, // DamageDone
+        has_caster | has_amount,                          // KnockedDown
+        has_caster,                                       // ProjectileLaunched
+        has_caster | has_target,                          // AttackStarted
+        has_caster,                                       // AttackFinished
+        has_caster,                                       // AttackStopped
+        has_caster,                                       // Interrupted
+        has_caster | has_target | has_value,              // InstantSkillActivated
+        has_caster | has_target | has_value,              // AttackSkillStarted
+        has_caster,                                       // AttackSkillFinished
+        has_caster,                                       // AttackSkillStopped
+        has_caster | has_target | has_value,              // SkillActivated
+        has_caster,                                       // SkillFinished
+        has_caster,                                       // SkillStopped
+        has_caster,                                       // MoraleBoost
+        has_caster,                                       // Victory
+    };
+    static_assert(std::size(event_fields) == static_cast<size_t>(EventType::Count));
+
+    void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Time can go back, e.g. if the instance changed under us
+    void PutSignedVarint(std::vector<uint8_t>& out, const int64_t value)
+    {
+        PutVarint(out, static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void PutFloat(std::vector<uint8_t>& out, const float value)
+    {
+        uint8_t bytes[sizeof(value)];
+        memcpy(bytes, &value, sizeof(value));
+        out.insert(out.end(), std::begin(bytes), std::end(bytes));
+    }
+
+    void PutString(std::vector<uint8_t>& out, const std::string_view value)
+    {
+        PutVarint(out, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+}
+
+ObserverJournal::~ObserverJournal()
+{
+    Close();
+}
+
+bool ObserverJournal::Open(const std::filesystem::path& path)
+{
+    Close();
+    if (_wfopen_s(&file, path.wstring().c_str(), L"wb") != 0 || !file) {
+        file = nullptr;
+        return false;
+    }
+    if (fwrite(journal_magic, sizeof(journal_magic), 1, file) != 1 || fwrite(&file_version, sizeof(file_version), 1, file) != 1) {
+        Close();
+        return false;
+    }
+    file_size = file_header_size;
+    return true;
+}
+
+void ObserverJournal::Close()
+{
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    file_size = 0;
+    record_count = 0;
+    unflushed = 0;
+    last_time = 0;
+}
+
+void ObserverJournal::Flush()
+{
+    if (file && unflushed) {
+        fflush(file);
+        unflushed = 0;
+    }
+}
+
+void ObserverJournal::Commit()
+{
+    if (fwrite(buffer.data(), buffer.size(), 1, file) != 1) {
+        // Out of disk or the like; stop here rather than leave a gap in the middle
+        Close();
+        return;
+    }
+    file_size += buffer.size();
+    record_count++;
+    // Events come in bursts of a few hundred a second in a big fight; let the FILE buffer soak most of them up
+    if (++unflushed >= 1024) {
+        Flush();
+    }
+}
+
+void ObserverJournal::Append(const Event& event)
+{
+    if (!file || event.type >= EventType::Count) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(event.type));
+    PutSignedVarint(buffer, static_cast<int64_t>(event.time) - last_time);
+    last_time = event.time;
+    const uint8_t fields = event_fields[static_cast<size_t>(event.type)];
+    if (fields & has_caster) {
+        PutVarint(buffer, event.caster_id);
+    }
+    if (fields & has_target) {
+        PutVarint(buffer, event.target_id);
+    }
+    if (fields & has_value) {
+        PutVarint(buffer, event.value);
+    }
+    if (fields & has_amount) {
+        PutFloat(buffer, event.amount);
+    }
+    Commit();
+}
+
+void ObserverJournal::AppendAgent(const AgentInfo& info)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Agent));
+    for (const uint32_t field : {info.agent_id, info.login_number, info.guild_id, info.team_id, info.primary, info.secondary}) {
+        PutVarint(buffer, field);
+    }
+    buffer.push_back(static_cast<uint8_t>((info.is_player ? 1 : 0) | (info.is_npc ? 2 : 0)));
+    Commit();
+}
+
+void ObserverJournal::AppendSkill(const SkillInfo& info)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Skill));
+    PutVarint(buffer, info.skill_id);
+    PutVarint(buffer, info.target);
+    Commit();
+}
+
+void ObserverJournal::AppendParty(const uint32_t party_id)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Party));
+    PutVarint(buffer, party_id);
+    Commit();
+}
+
+void ObserverJournal::AppendGuild(const Guild& guild)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Guild));
+    for (const uint32_t field : {guild.guild_id, guild.rank, guild.rating, guild.faction, guild.faction_point, guild.qualifier_point, guild.cape_trim}) {
+        PutVarint(buffer, field);
+    }
+    for (const uint32_t k : guild.key) {
+        PutVarint(buffer, k);
+    }
+    PutString(buffer, guild.name);
+    PutString(buffer, guild.tag);
+    Commit();
+}
+
+void ObserverJournal::AppendPartyMember(const uint32_t agent_id, const uint32_t party_id, const uint32_t party_index)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::PartyMember));
+    PutVarint(buffer, agent_id);
+    PutVarint(buffer, party_id);
+    PutVarint(buffer, party_index);
+    Commit();
+}
+
+void ObserverJournal::AppendRoster(const Party& party)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Roster));
+    PutVarint(buffer, party.party_id);
+    PutVarint(buffer, party.guild_id);
+    PutVarint(buffer, party.rank);
+    PutVarint(buffer, party.rating);
+    PutVarint(buffer, party.agent_ids.size());
+    for (const uint32_t agent_id : party.agent_ids) {
+        PutVarint(buffer, agent_id);
+    }
+    Commit();
+}
+
+void ObserverJournal::AppendMap(const MapInfo& map)
+{
+    if (!file) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Map));
+    for (const uint32_t field : {map.campaign, map.continent, map.region, map.type, map.flags, map.name_id, map.description_id}) {
+        PutVarint(buffer, field);
+    }
+    Commit();
+}
+
+void ObserverJournal::AppendName(const NameOf of, const uint32_t id, const std::string_view name)
+{
+    if (!file || name.empty()) {
+        return;
+    }
+    buffer.clear();
+    buffer.push_back(static_cast<uint8_t>(RecordType::Name));
+    buffer.push_back(static_cast<uint8_t>(of));
+    PutVarint(buffer, id);
+    PutString(buffer, name);
+    Commit();
+}
+
+// Reads records back; any read past the end leaves ok false, and the record it was in is dropped
+struct ObserverReplay::Reader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint8_t Byte()
+    {
+        if (pos == end) {
+            ok = false;
+            return 0;
+        }
+        return *pos++;
+    }
+
+    uint32_t Varint()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = Byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return static_cast<uint32_t>(value);
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t SignedVarint()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = Byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return static_cast<int64_t>(value >> 1 ^ (~(value & 1) + 1));
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    float Float()
+    {
+        float value = 0;
+        if (end - pos < static_cast<ptrdiff_t>(sizeof(value))) {
+            ok = false;
+            pos = end;
+            return value;
+        }
+        memcpy(&value, pos, sizeof(value));
+        pos += sizeof(value);
+        return value;
+    }
+
+    std::string String()
+    {
+        const uint32_t length = Varint();
+        if (!ok || static_cast<size_t>(end - pos) < length) {
+            ok = false;
+            pos = end;
+            return {};
+        }
+        std::string value(reinterpret_cast<const char*>(pos), length);
+        pos += length;
+        return value;
+    }
+};
+
+ObserverReplay::~ObserverReplay()
+{
+    Reset();
+}
+
+void ObserverReplay::Reset()
+{
+    map.reset();
+    guilds.Clear();
+    agents.Clear();
+    skills.Clear();
+    parties.Clear();
+    Clear();
+    event_count = 0;
+    bytes_read = 0;
+}
+
+bool ObserverReplay::Load(const std::filesystem::path& path)
+{
+    std::vector<uint8_t> data;
+    if (std::ifstream in(path, std::ios::binary); in) {
+        data.assign(std::istreambuf_iterator(in), std::istreambuf_iterator<char>());
+    }
+    else {
+        Reset();
+        return false;
+    }
+    return Load(data.data(), data.size());
+}
+
+bool ObserverReplay::Load(const uint8_t* data, const size_t size)
+{
+    Reset();
+    if (size < file_header_size || memcmp(data, journal_magic, sizeof(journal_magic)) != 0
+        || memcmp(data + sizeof(journal_magic), &file_version, sizeof(file_version)) != 0) {
+        return false;
+    }
+
+    Reader reader{data + file_header_size, data + size};
+    uint32_t time = 0;
+    while (reader.pos != reader.end) {
+        // Nothing is applied until the whole record has been read, so a torn one at the end is left out
+        const uint8_t type = reader.Byte();
+        if (type < static_cast<uint8_t>(EventType::Count)) {
+            Event event;
+            event.type = static_cast<EventType>(type);
+            event.time = static_cast<uint32_t>(time + reader.SignedVarint());
+            const uint8_t fields = event_fields[type];
+            if (fields & has_caster) {
+                event.caster_id = reader.Varint();
+            }
+            if (fields & has_target) {
+                event.target_id = reader.Varint();
+            }
+            if (fields & has_value) {
+                event.value = reader.Varint();
+            }
+            if (fields & has_amount) {
+                event.amount = reader.Float();
+            }
+            if (!reader.ok) {
+                break;
+            }
+            time = event.time;
+            Apply(event);
+            event_count++;
+        }
+        else {
+            switch (static_cast<RecordType>(type)) {
+                case RecordType::Agent: {
+                    AgentInfo info;
+                    info.agent_id = reader.Varint();
+                    info.login_number = reader.Varint();
+                    info.guild_id = reader.Varint();
+                    info.team_id = reader.Varint();
+                    info.primary = reader.Varint();
+                    info.secondary = reader.Varint();
+                    const uint8_t flags = reader.Byte();
+                    info.is_player = (flags & 1) != 0;
+                    info.is_npc = (flags & 2) != 0;
+                    if (!reader.ok) {
+                        break;
+                    }
+                    const Index index = AddAgent(info);
+                    if (index != no_index && index == agents.size()) {
+                        agents.Create(*this, index, info);
+                    }
+                    break;
+                }
+                case RecordType::Skill: {
+                    SkillInfo info;
+                    info.skill_id = reader.Varint();
+                    info.target = reader.Varint();
+                    if (!reader.ok) {
+                        break;
+                    }
+                    const Index index = AddSkill(info);
+                    if (index != no_index && index == skills.size()) {
+                        skills.Create(index, info);
+                    }
+                    break;
+                }
+                case RecordType::Party: {
+                    const uint32_t party_id = reader.Varint();
+                    if (!reader.ok) {
+                        break;
+                    }
+                    const Index index = AddParty(party_id);
+                    if (index != no_index && index == parties.size()) {
+                        parties.Create(party_id);
+                    }
+                    break;
+                }
+                case RecordType::Guild: {
+                    Guild guild;
+                    for (uint32_t* field : {&guild.guild_id, &guild.rank, &guild.rating, &guild.faction, &guild.faction_point, &guild.qualifier_point, &guild.cape_trim}) {
+                        *field = reader.Varint();
+                    }
+                    for (uint32_t& k : guild.key) {
+                        k = reader.Varint();
+                    }
+                    guild.name = reader.String();
+                    guild.tag = reader.String();
+                    guild.wrapped_tag = "[" + guild.tag + "]";
+                    if (!reader.ok) {
+                        break;
+                    }
+                    const Index index = AddGuild(guild);
+                    if (index != no_index && index == guilds.size()) {
+                        guilds.Create(std::move(guild));
+                    }
+                    break;
+                }
+                case RecordType::PartyMember: {
+                    const uint32_t agent_id = reader.Varint();
+                    const uint32_t party_id = reader.Varint();
+                    const uint32_t party_index = reader.Varint();
+                    if (!reader.ok) {
+                        break;
+                    }
+                    if (Agent* agent = GetAgent(agent_id)) {
+                        SetAgentParty(*agent, party_id, party_index);
+                    }
+                    break;
+                }
+                case RecordType::Roster: {
+                    const uint32_t party_id = reader.Varint();
+                    const uint32_t guild_id = reader.Varint();
+                    const uint32_t rank = reader.Varint();
+                    const uint32_t rating = reader.Varint();
+                    const uint32_t count = reader.Varint();
+                    std::vector<uint32_t> agent_ids;
+                    for (uint32_t i = 0; i < count && reader.ok; i++) {
+                        agent_ids.push_back(reader.Varint());
+                    }
+                    if (!reader.ok) {
+                        break;
+                    }
+                    if (Party* party = GetParty(party_id)) {
+                        party->guild_id = guild_id;
+                        party->rank = rank;
+                        party->rating = rating;
+                        party->rank_str = guild_id == no_guild ? "" : rank == no_rank ? "N/A" : std::to_string(rank);
+                        party->agent_ids = std::move(agent_ids);
+                    }
+                    break;
+                }
+                case RecordType::Map: {
+                    MapInfo info;
+                    for (uint32_t* field : {&info.campaign, &info.continent, &info.region, &info.type, &info.flags, &info.name_id, &info.description_id}) {
+                        *field = reader.Varint();
+                    }
+                    if (!reader.ok) {
+                        break;
+                    }
+                    map = std::make_unique<ReplayMap>(info);
+                    BeginMatch(*map);
+                    break;
+                }
+                case RecordType::Name: {
+                    const auto of = static_cast<ObserverJournal::NameOf>(reader.Byte());
+                    const uint32_t id = reader.Varint();
+                    std::string name = reader.String();
+                    if (!reader.ok) {
+                        break;
+                    }
+                    switch (of) {
+                        case ObserverJournal::NameOf::Agent:
+                            if (const Index index = agent_indices.Find(id); index != no_index) {
+                                agents[index].name = std::move(name);
+                            }
+                            break;
+                        case ObserverJournal::NameOf::AgentProfession:
+                            if (const Index index = agent_indices.Find(id); index != no_index) {
+                                agents[index].profession = std::move(name);
+                            }
+                            break;
+                        case ObserverJournal::NameOf::Skill:
+                            if (const Index index = skill_indices.Find(id); index != no_index) {
+                                skills[index].name = std::move(name);
+                            }
+                            break;
+                        case ObserverJournal::NameOf::Party:
+                            if (Party* party = GetParty(id)) {
+                                party->name = std::move(name);
+                            }
+                            break;
+                        case ObserverJournal::NameOf::PartyDisplay:
+                            if (Party* party = GetParty(id)) {
+                                party->display_name = std::move(name);
+                            }
+                            break;
+                        case ObserverJournal::NameOf::Map:
+                            if (map) {
+                                map->name = std::move(name);
+                            }
+                            break;
+                        case ObserverJournal::NameOf::MapDescription:
+                            if (map) {
+                                map->description = std::move(name);
+                            }
+                            break;
+                    }
+                    break;
+                }
+                default:
+                    // Written by a newer version; there's no telling how long it is
+                    reader.ok = false;
+                    break;
+            }
+            if (!reader.ok) {
+                break;
+            }
+        }
+        bytes_read = static_cast<size_t>(reader.pos - data);
+    }
+    if (!bytes_read) {
+        bytes_read = file_header_size;
+    }
+    return true;
+}
+
+Agent* ObserverReplay::GetAgent(const uint32_t agent_id)
+{
+    const Index index = agent_indices.Find(agent_id);
+    return index != no_index && index < agents.size() ? &agents[index] : nullptr;
+}
+
+Party* ObserverReplay::GetParty(const uint32_t party_id)
+{
+    const Index index = party_indices.Find(party_id);
+    return index != no_index && index < parties.size() ? &parties[index] : nullptr;
+}
+
+Skill* ObserverReplay::GetSkill(const uint32_t skill_id)
+{
+    const Index index = skill_indices.Find(skill_id);
+    return index != no_index && index < skills.size() ? &skills[index] : nullptr;
+}
+
+Guild* ObserverReplay::GetGuild(const uint32_t guild_id)
+{
+    const Index index = guild_indices.Find(guild_id);
+    return index != no_index && index < guilds.size() ? &guilds[index] : nullptr;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Utils/ObserverMatch.h>
+
+// Everything ObserverModule saw of one match, appended to a file as it happens: every event it reduced, and every agent,
+// skill, party and guild when it was first seen, so ObserverReplay can rebuild the exact same stats from it later on.
+// Records are a type byte followed by varints, so most events take 4 to 8 bytes; a 30 minute match is a couple of MB.
+// A crash only loses whatever was still buffered; the torn record at the end is ignored when reading.
+// Not thread safe.
+class ObserverJournal {
+public:
+    enum class NameOf : uint8_t {
+        Agent,
+        AgentProfession,
+        Skill,
+        Party,
+        PartyDisplay,
+        Map,
+        MapDescription
+    };
+
+    ObserverJournal() = default;
+    ObserverJournal(const ObserverJournal&) = delete;
+    ObserverJournal& operator=(const ObserverJournal&) = delete;
+    ~ObserverJournal();
+
+    // Starts a new journal, replacing anything already at path
+    bool Open(const std::filesystem::path& path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return file != nullptr; }
+    void Flush();
+
+    void Append(const ObserverStats::Event& event);
+    void AppendAgent(const ObserverStats::AgentInfo& info);
+    void AppendSkill(const ObserverStats::SkillInfo& info);
+    void AppendParty(uint32_t party_id);
+    void AppendGuild(const ObserverStats::Guild& guild);
+    void AppendPartyMember(uint32_t agent_id, uint32_t party_id, uint32_t party_index);
+    void AppendRoster(const ObserverStats::Party& party);
+    void AppendMap(const ObserverStats::MapInfo& map);
+    void AppendName(NameOf of, uint32_t id, std::string_view name);
+
+    [[nodiscard]] size_t size() const { return record_count; }
+    [[nodiscard]] uint64_t FileSize() const { return file_size; }
+
+private:
+    // Write out the record in buffer
+    void Commit();
+
+    FILE* file = nullptr;
+    uint64_t file_size = 0;
+    size_t record_count = 0;
+    uint32_t unflushed = 0;
+    // Events store their time relative to the one before
+    uint32_t last_time = 0;
+    // Record being put together; kept to save allocating one each time
+    std::vector<uint8_t> buffer;
+};
+
+// A match rebuilt from an ObserverJournal, e.g. to look at or export a match long after it was played.
+// It's a Match like the one ObserverModule keeps, fed the same events in the same order, so it ends up with the same stats.
+class ObserverReplay : public ObserverStats::Match {
+public:
+    ObserverReplay() = default;
+    ~ObserverReplay() override;
+
+    // Replay the journal at path from the start; anything replayed before is forgotten first.
+    // Returns false if it isn't a journal; one that's cut short is replayed as far as it goes.
+    bool Load(const std::filesystem::path& path);
+    // Same, from a journal in memory
+    bool Load(const uint8_t* data, size_t size);
+    void Reset();
+
+    ObserverStats::Agent* GetAgent(uint32_t agent_id) override;
+    ObserverStats::Party* GetParty(uint32_t party_id) override;
+    ObserverStats::Skill* GetSkill(uint32_t skill_id) override;
+    ObserverStats::Guild* GetGuild(uint32_t guild_id) override;
+    [[nodiscard]] ObserverStats::Map* GetMap() const override { return map.get(); }
+
+    [[nodiscard]] size_t EventCount() const { return event_count; }
+    // How far in the journal was read; short of its size if it was cut short
+    [[nodiscard]] size_t BytesRead() const { return bytes_read; }
+
+private:
+    class ReplayAgent : public ObserverStats::Agent {
+    public:
+        using Agent::Agent;
+        std::string name;
+        std::string DisplayName() override { return name; }
+        std::string RawName() override { return name; }
+        std::string DebugName() override { return "(" + std::to_string(agent_id) + ") \"" + name + "\""; }
+        std::string SanitizedName() override { return name; }
+    };
+
+    class ReplaySkill : public ObserverStats::Skill {
+    public:
+        using Skill::Skill;
+        std::string name;
+        std::string Name() override { return name; }
+    };
+
+    class ReplayMap : public ObserverStats::Map {
+    public:
+        using Map::Map;
+        std::string name;
+        std::string description;
+        std::string Name() override { return name; }
+        std::string Description() override { return description; }
+    };
+
+    struct Reader;
+
+    ObserverStats::ObjectArena<ObserverStats::Guild> guilds;
+    ObserverStats::ObjectArena<ReplayAgent> agents;
+    ObserverStats::ObjectArena<ReplaySkill> skills;
+    ObserverStats::ObjectArena<ObserverStats::Party> parties;
+    std::unique_ptr<ReplayMap> map;
+
+    size_t event_count = 0;
+    size_t bytes_read = 0;
+};
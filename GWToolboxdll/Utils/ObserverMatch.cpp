@@ -0,0 +1,1035 @@
+#include <stdafx.h>
+
+#include <cassert>
+
+#include <Utils/ObserverJournal.h>
+
+#include "ObserverMatch.h"
+
+namespace ObserverStats {
+    namespace {
+        // Keep sorted ids sorted
+        void InsertSorted(std::vector<uint32_t>& ids, const uint32_t id)
+        {
+            ids.insert(std::ranges::upper_bound(ids, id), id);
+        }
+
+        // skills with anything counted in a row of an agent x skill matrix, sorted by skill_id
+        std::vector<ObservedSkill> SkillsInRow(const ActionMatrix& matrix, const size_t row, const DenseIds& skill_indices)
+        {
+            std::vector<ObservedSkill> skills;
+            if (row >= matrix.Rows()) {
+                return skills;
+            }
+            for (size_t col = 0; col < matrix.Cols(); col++) {
+                if (matrix.Touched(row, col)) {
+                    skills.emplace_back(matrix.Get(row, col), skill_indices.Id(static_cast<Index>(col)));
+                }
+            }
+            std::ranges::sort(skills, {}, &ObservedSkill::skill_id);
+            return skills;
+        }
+
+        // skills in a caster x target x skill table between two agents, sorted by skill_id
+        std::vector<ObservedSkill> SkillsBetween(const ActionTable& table, const Index caster, const Index target, const DenseIds& skill_indices)
+        {
+            std::vector<ObservedSkill> skills;
+            const std::vector<uint64_t>& keys = table.Keys();
+            for (size_t row = 0; row < keys.size(); row++) {
+                if (keys[row] >> 16 == ActionTable::Key(caster, target, 0) >> 16) {
+                    const auto skill_index = static_cast<Index>(keys[row] & 0xFFFF);
+                    skills.emplace_back(table.Get(row), skill_indices.Id(skill_index));
+                }
+            }
+            std::ranges::sort(skills, {}, &ObservedSkill::skill_id);
+            return skills;
+        }
+
+        std::string KdrString(const float kdr_pc)
+        {
+            std::stringstream str;
+            str << std::fixed << std::setprecision(2) << kdr_pc;
+            return str.str();
+        }
+    }
+
+
+    // Constructor
+    Agent::Agent(const Match& match, const Index index, const AgentInfo& info)
+        : index(index)
+        , agent_id(info.agent_id)
+        , login_number(info.login_number)
+        , guild_id(info.guild_id)
+        , team_id(info.team_id)
+        , primary(info.primary)
+        , secondary(info.secondary)
+        , is_player(info.is_player)
+        , is_npc(info.is_npc)
+        , stats(match, index) { }
+
+
+    // fired when the Agent dies
+    void SharedStats::HandleDeath()
+    {
+        deaths += 1;
+        // recalculate kdr
+        kdr_pc = static_cast<float>(kills) / static_cast<float>(deaths);
+        // get kdr string
+        kdr_str = KdrString(kdr_pc);
+    }
+
+
+    // fired when the agent scores a kill
+    void SharedStats::HandleKill()
+    {
+        kills += 1;
+        // recalculate kdr
+        if (deaths < 1) {
+            kdr_pc = static_cast<float>(kills);
+        }
+        else {
+            kdr_pc = static_cast<float>(kills) / static_cast<float>(deaths);
+        }
+        // get kdr string
+        kdr_str = KdrString(kdr_pc);
+    }
+
+
+    // Get attacks dealt by this agent, by target agent_id
+    std::vector<std::pair<uint32_t, ObservedAction>> AgentStats::AttacksDealtToAgents() const
+    {
+        std::vector<std::pair<uint32_t, ObservedAction>> attacks_dealt;
+        for (size_t target = 0; target < match.attacks.Cols(); target++) {
+            if (match.attacks.Touched(index, target)) {
+                attacks_dealt.emplace_back(match.agent_indices.Id(static_cast<Index>(target)), match.attacks.Get(index, target));
+            }
+        }
+        std::ranges::sort(attacks_dealt, {}, &std::pair<uint32_t, ObservedAction>::first);
+        return attacks_dealt;
+    }
+
+
+    // Get attacks received by this agent, by caster agent_id
+    std::vector<std::pair<uint32_t, ObservedAction>> AgentStats::AttacksReceivedFromAgents() const
+    {
+        std::vector<std::pair<uint32_t, ObservedAction>> attacks_received;
+        for (size_t caster = 0; caster < match.attacks.Rows(); caster++) {
+            if (match.attacks.Touched(caster, index)) {
+                attacks_received.emplace_back(match.agent_indices.Id(static_cast<Index>(caster)), match.attacks.Get(caster, index));
+            }
+        }
+        std::ranges::sort(attacks_received, {}, &std::pair<uint32_t, ObservedAction>::first);
+        return attacks_received;
+    }
+
+
+    // Get skills used by this agent
+    std::vector<ObservedSkill> AgentStats::SkillsUsed() const
+    {
+        return SkillsInRow(match.skills_used, index, match.skill_indices);
+    }
+
+
+    // Get skills received by this agent
+    std::vector<ObservedSkill> AgentStats::SkillsReceived() const
+    {
+        return SkillsInRow(match.skills_received, index, match.skill_indices);
+    }
+
+
+    // Get the agents this agent used skills on
+    std::vector<uint32_t> AgentStats::AgentIdsSkillsUsedOn() const
+    {
+        std::vector<uint32_t> agent_ids;
+        for (const uint64_t key : match.skills_used_on.Keys()) {
+            if (key >> 32 == index) {
+                agent_ids.push_back(match.agent_indices.Id(static_cast<Index>(key >> 16 & 0xFFFF)));
+            }
+        }
+        std::ranges::sort(agent_ids);
+        const auto [first, last] = std::ranges::unique(agent_ids);
+        agent_ids.erase(first, last);
+        return agent_ids;
+    }
+
+
+    // Get skills used by this agent on another agent
+    std::vector<ObservedSkill> AgentStats::SkillsUsedOn(const uint32_t target_agent_id) const
+    {
+        const Index target = match.agent_indices.Find(target_agent_id);
+        if (target == no_index) {
+            return {};
+        }
+        return SkillsBetween(match.skills_used_on, index, target, match.skill_indices);
+    }
+
+
+    // Get the agents this agent received skills from
+    std::vector<uint32_t> AgentStats::AgentIdsSkillsReceivedFrom() const
+    {
+        std::vector<uint32_t> agent_ids;
+        for (const uint64_t key : match.skills_used_on.Keys()) {
+            if ((key >> 16 & 0xFFFF) == index) {
+                agent_ids.push_back(match.agent_indices.Id(static_cast<Index>(key >> 32)));
+            }
+        }
+        std::ranges::sort(agent_ids);
+        const auto [first, last] = std::ranges::unique(agent_ids);
+        agent_ids.erase(first, last);
+        return agent_ids;
+    }
+
+
+    // Get skills received by this agent from another agent
+    std::vector<ObservedSkill> AgentStats::SkillsReceivedFrom(const uint32_t caster_agent_id) const
+    {
+        const Index caster = match.agent_indices.Find(caster_agent_id);
+        if (caster == no_index) {
+            return {};
+        }
+        return SkillsBetween(match.skills_used_on, caster, index, match.skill_indices);
+    }
+
+
+    // Reduce an event into the stats
+    // The event is journaled after it's handled, so anything first seen while handling it is journaled before it
+    void Match::Apply(const Event& event)
+    {
+        switch (event.type) {
+            case EventType::AgentState:
+                HandleAgentState(event.caster_id, event.value);
+                break;
+            case EventType::DamageDone:
+                HandleDamageDone(event.caster_id, event.target_id, event.amount, event.value != 0);
+                break;
+            case EventType::KnockedDown:
+                HandleKnockedDown(event.caster_id, event.amount);
+                break;
+            case EventType::ProjectileLaunched:
+                HandleProjectileLaunched(event.caster_id);
+                break;
+            case EventType::AttackStarted:
+                HandleAttackStarted(event.caster_id, event.target_id);
+                break;
+            case EventType::AttackFinished:
+                HandleAttackFinished(event.caster_id);
+                break;
+            case EventType::AttackStopped:
+                HandleAttackStopped(event.caster_id);
+                break;
+            case EventType::Interrupted:
+                HandleInterrupted(event.caster_id);
+                break;
+            case EventType::InstantSkillActivated:
+                HandleInstantSkillActivated(event.caster_id, event.target_id, event.value);
+                break;
+            case EventType::AttackSkillStarted:
+                HandleAttackSkillStarted(event.caster_id, event.target_id, event.value);
+                break;
+            case EventType::AttackSkillFinished:
+                HandleAttackSkillFinished(event.caster_id);
+                break;
+            case EventType::AttackSkillStopped:
+                HandleAttackSkillStopped(event.caster_id);
+                break;
+            case EventType::SkillActivated:
+                HandleSkillActivated(event.caster_id, event.target_id, event.value);
+                break;
+            case EventType::SkillFinished:
+                HandleSkillFinished(event.caster_id);
+                break;
+            case EventType::SkillStopped:
+                HandleSkillStopped(event.caster_id);
+                break;
+            case EventType::MoraleBoost:
+                HandleMoraleBoost(GetParty(event.caster_id));
+                break;
+            case EventType::Victory:
+                HandleVictory(GetParty(event.caster_id), event.time);
+                break;
+            default:
+                return;
+        }
+        if (journal) {
+            journal->Append(event);
+        }
+    }
+
+
+    // Handle AgentState Packet
+    // Fired when the server notifies us of an agent state change
+    // Can tell us if the agent has just died
+    void Match::HandleAgentState(const uint32_t agent_id, const uint32_t state)
+    {
+        if (state != agent_state_dead) {
+            return;
+        }
+
+        // don't credit kills/deaths on parties that are already defeated
+        // after a party is defeated all their players die, but we don't
+        // count those deaths / kills
+        if (match_finished) {
+            return;
+        }
+
+        Agent* agent = GetAgent(agent_id);
+        if (!agent) {
+            return;
+        }
+
+        Party* party = GetParty(agent->party_id);
+        if (party && party->is_defeated) {
+            return;
+        }
+
+        // notify the player
+        agent->stats.HandleDeath();
+
+        // only grant a kill if the victim belonged to a party
+        // (don't count footmen/archer/bodyguard/lord/ghostly kills)
+        if (!party) {
+            return;
+        }
+        party->stats.HandleDeath();
+
+        // credit the kill to the last-hitter and their party,
+        Agent* killer = GetAgent(agent->last_hit_by);
+        if (!killer) {
+            return;
+        }
+        killer->stats.HandleKill();
+        Party* killer_party = GetParty(killer->party_id);
+        if (killer_party) {
+            killer_party->stats.HandleKill();
+        }
+    }
+
+
+    // Handle DamageDone (GenericModifier float Packet)
+    void Match::HandleDamageDone(const uint32_t caster_id, const uint32_t target_id, const float amount_pc, const bool is_crit)
+    {
+        Agent* caster = GetAgent(caster_id);
+        Agent* target = GetAgent(target_id);
+
+        // get last hit to credit the kill
+        if (target && caster && caster->party_id != no_party && amount_pc < 0) {
+            target->last_hit_by = caster->agent_id;
+        }
+
+        if (is_crit) {
+            Party* caster_party = nullptr;
+            Party* target_party = nullptr;
+            if (caster) {
+                caster_party = GetParty(caster->party_id);
+            }
+            if (target) {
+                target_party = GetParty(target->party_id);
+            }
+
+            // notify the caster
+            if (caster) {
+                caster->stats.total_crits_dealt += 1;
+                if (target_party) {
+                    caster->stats.total_party_crits_dealt += 1;
+                }
+            }
+
+            // notify the caster_party
+            if (caster_party) {
+                caster_party->stats.total_crits_dealt += 1;
+                if (target_party) {
+                    caster_party->stats.total_party_crits_dealt += 1;
+                }
+            }
+
+            // notify the target
+            if (target) {
+                target->stats.total_crits_received += 1;
+                if (caster_party) {
+                    target->stats.total_party_crits_received += 1;
+                }
+            }
+
+            // notify the target_party
+            if (target_party) {
+                target_party->stats.total_crits_received += 1;
+                if (caster_party) {
+                    target_party->stats.total_party_crits_received += 1;
+                }
+            }
+        }
+    }
+
+
+    // Handle AgentProjectileLaunched Packet
+    // can be used to determine when a ranged attack has finished
+    void Match::HandleProjectileLaunched(const uint32_t agent_id)
+    {
+        Agent* agent = GetAgent(agent_id);
+        // ensure the projectile was from an attack we're currently undertaking
+        if (!agent || !agent->current_target_action || !agent->current_target_action->is_attack) {
+            return;
+        }
+        ReduceAction(agent, ActionStage::Finished);
+    }
+
+
+    // Handle AttackFinished Packet
+    void Match::HandleAttackFinished(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Finished);
+    }
+
+    // Handle AttackStopped Packet
+    void Match::HandleAttackStopped(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Stopped);
+    }
+
+
+    // Handle AttackStarted Packet
+    void Match::HandleAttackStarted(const uint32_t caster_id, const uint32_t target_id)
+    {
+        TargetAction action(caster_id, target_id, true, false, no_skill);
+        ReduceAction(GetAgent(caster_id), ActionStage::Started, &action);
+    }
+
+
+    // Handle Interrupted Packet
+    void Match::HandleInterrupted(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Interrupted);
+    }
+
+    // Handle Attack SkillFinished Packet
+    void Match::HandleAttackSkillFinished(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Finished);
+    }
+
+
+    // Handle Attack SkillStopped Packet
+    void Match::HandleAttackSkillStopped(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Stopped);
+    }
+
+
+    // Handle InstantSkillActivated Packet
+    void Match::HandleInstantSkillActivated(const uint32_t caster_id, const uint32_t target_id, const uint32_t skill_id)
+    {
+        // assuming there are no instant attack skills...
+        TargetAction action(caster_id, target_id, false, true, skill_id);
+        ReduceAction(GetAgent(caster_id), ActionStage::Instant, &action);
+    }
+
+
+    // Handle AttackSkillActivated Packet
+    void Match::HandleAttackSkillStarted(const uint32_t caster_id, const uint32_t target_id, const uint32_t skill_id)
+    {
+        TargetAction action(caster_id, target_id, true, true, skill_id);
+        ReduceAction(GetAgent(caster_id), ActionStage::Started, &action);
+    }
+
+
+    // Handle AttackSkillFinished Packet
+    void Match::HandleSkillFinished(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Finished);
+    }
+
+
+    // Handle SkillFinished Packet
+    void Match::HandleSkillStopped(const uint32_t agent_id)
+    {
+        ReduceAction(GetAgent(agent_id), ActionStage::Stopped);
+    }
+
+
+    // Handle SkillActivated Packet
+    void Match::HandleSkillActivated(const uint32_t caster_id, const uint32_t target_id, const uint32_t skill_id)
+    {
+        TargetAction action(caster_id, target_id, false, true, skill_id);
+        ReduceAction(GetAgent(caster_id), ActionStage::Started, &action);
+    }
+
+
+    // Handle KnockedDown Packet
+    void Match::HandleKnockedDown(const uint32_t agent_id, const float duration)
+    {
+        // notify the agent
+        Agent* agent = GetAgent(agent_id);
+        if (!agent) {
+            return;
+        }
+        agent->stats.knocked_down_count += 1;
+        agent->stats.knocked_down_duration += duration;
+
+        // notify the agents party
+        Party* party = GetParty(agent->party_id);
+        if (!party) {
+            return;
+        }
+        party->stats.knocked_down_count += 1;
+        party->stats.knocked_down_duration += 1;
+    }
+
+
+    // Fired when a party receives a morale boost
+    void Match::HandleMoraleBoost(Party* boosting_party)
+    {
+        if (!boosting_party) {
+            return;
+        }
+        boosting_party->morale_boosts += 1;
+    }
+
+
+    // Fired when a party is victorious
+    void Match::HandleVictory(Party* winning_party, const uint32_t instance_time)
+    {
+        if (!winning_party) {
+            return;
+        }
+
+        // TODO: handle draws
+        // There is no JumboMessage for a draw so we don't get notified of it...
+
+        // Draws mess up:
+        //  - the kills/deaths since everyone dies at the end and we don't know that
+        //    the match is over... so we have to count all those as kills/deaths
+        //  - we can't set match_finished = true
+        //  - we can't get the match duration
+
+        // match has concluded
+        // save winner and match duration
+        match_finished = true;
+
+        // notify the winning party
+        winning_party_id = winning_party->party_id;
+        winning_party->is_defeated = false;
+        winning_party->is_victorious = true;
+
+        // note the final game duration
+        // don't count the first minute before the gates open...
+        const uint32_t ms = instance_time - 1000 * 60;
+        match_duration_ms_total = std::chrono::milliseconds(ms);
+        match_duration_ms = std::chrono::milliseconds(ms);
+        match_duration_secs = std::chrono::duration_cast<std::chrono::seconds>(match_duration_ms);
+        match_duration_ms -= std::chrono::duration_cast<std::chrono::milliseconds>(match_duration_secs);
+        match_duration_mins = std::chrono::duration_cast<std::chrono::minutes>(match_duration_secs);
+        match_duration_secs -= std::chrono::duration_cast<std::chrono::seconds>(match_duration_mins);
+
+        // notify other parties that they lost
+        for (const uint32_t party_id : party_ids) {
+            Party* losing_party = GetParty(party_id);
+            if (losing_party && losing_party->party_id != winning_party->party_id) {
+                losing_party->is_defeated = true;
+                losing_party->is_victorious = false;
+            }
+        }
+    }
+
+
+    void Match::ReduceAction(Agent* caster, const ActionStage stage, TargetAction* new_action)
+    {
+        if (!caster) {
+            return;
+        }
+
+        TargetAction* action;
+
+        // If starting a new action, replace the last stored action with this new action
+        if (new_action) {
+            assert(stage == ActionStage::Started || stage == ActionStage::Instant);
+            // starting a new action
+
+            // "instant" actions do not persist (don't received a "finished" packet) so we don't store them on the agent
+            // and they may be activateable while using other skills (e.g. shouts/stances) so we don't clear the current action
+            if (stage != ActionStage::Instant) {
+                // replace the previous blocking action
+                caster->current_target_action.emplace(*new_action);
+                action = &*caster->current_target_action;
+            }
+            else {
+                action = new_action;
+            }
+        }
+        else {
+            assert(!(stage == ActionStage::Started || stage == ActionStage::Instant));
+            // we are finishing the previous action
+            // we have to keep the current_target_action on the caster in-case we receive an "interrupted" packet next
+            // after a "stopped" package
+            action = caster->current_target_action ? &*caster->current_target_action : nullptr;
+        }
+
+        if (!action) {
+            return;
+        }
+
+        // if the action was already "finished" in a previous ReduceAction call, there's nothing else to do
+        // this is important for skills like Dual Shot, Barrage, etc, where one skill leads to
+        // multiple "AttackFinished" packets (via the "AgentProjectileLaunched" packet)
+        if (action->was_finished) {
+            return;
+        }
+
+        if (stage == ActionStage::Stopped) {
+            action->was_stopped = true;
+        }
+        if (stage == ActionStage::Finished) {
+            action->was_finished = true;
+        }
+
+        Agent* target = GetAgent(action->target_id);
+
+        Party* caster_party = GetParty(caster->party_id);
+        Party* target_party = nullptr;
+        if (target) {
+            target_party = GetParty(target->party_id);
+        }
+
+        // notify caster & caster_party of interrupt
+        //
+        // interrupt packet comes after cancelled packet most of the time.
+        //
+        // Can received a "cancelled" packet after a "finished" packet for attack skills where the target
+        // dies during the afterswing of a "finished" attack
+        // we don't count that as "stopped/cancelled"
+        if (stage == ActionStage::Interrupted) {
+            if (caster) {
+                if (action->was_stopped) {
+                    caster->stats.cancelled_count -= 1;
+                }
+                caster->stats.interrupted_count += 1;
+            }
+            if (caster_party) {
+                if (action->was_stopped) {
+                    caster_party->stats.cancelled_count -= 1;
+                }
+                caster_party->stats.interrupted_count += 1;
+            }
+            if (action->is_skill) {
+                if (caster) {
+                    if (action->was_stopped) {
+                        caster->stats.cancelled_skills_count -= 1;
+                    }
+                    caster->stats.interrupted_skills_count += 1;
+                }
+                if (caster_party) {
+                    if (action->was_stopped) {
+                        caster_party->stats.cancelled_skills_count -= 1;
+                    }
+                    caster_party->stats.interrupted_skills_count += 1;
+                }
+            }
+        }
+
+        // notify & caster_party caster of cancel
+        if (stage == ActionStage::Stopped) {
+            if (caster) {
+                caster->stats.cancelled_count += 1;
+            }
+            if (caster_party) {
+                caster_party->stats.cancelled_count += 1;
+            }
+            if (action->is_skill) {
+                if (caster) {
+                    caster->stats.cancelled_skills_count += 1;
+                }
+                if (caster_party) {
+                    caster_party->stats.cancelled_skills_count += 1;
+                }
+            }
+        }
+
+        // handle attack
+        if (action->is_attack) {
+            // update the caster
+            if (caster) {
+                caster->stats.total_attacks_dealt.Reduce(action, stage);
+                if (target) {
+                    // also counts as the attacks the target received from the caster
+                    attacks.Reduce(caster->index, target->index, *action, stage);
+                }
+                // if the target belonged to a party, the caster just attacked that other party
+                if (target_party) {
+                    caster->stats.total_attacks_dealt_to_other_parties.Reduce(action, stage);
+                }
+            }
+
+            // update the casters party
+            if (caster_party) {
+                caster_party->stats.total_attacks_dealt.Reduce(action, stage);
+                // if the target belonged to a party, the casters party just attacked that other party
+                if (target_party) {
+                    caster_party->stats.total_attacks_dealt_to_other_parties.Reduce(action, stage);
+                }
+            }
+
+            // update the target
+            if (target) {
+                target->stats.total_attacks_received.Reduce(action, stage);
+                // if the caster belonged to a party, the target was just attacked by that other party
+                if (caster_party) {
+                    target->stats.total_attacks_received_from_other_parties.Reduce(action, stage);
+                }
+            }
+
+            // update the targets party
+            if (target_party) {
+                target_party->stats.total_attacks_received.Reduce(action, stage);
+                // if the caster belonged to a party, the target_party was just attacked by that other party
+                if (caster_party) {
+                    target_party->stats.total_attacks_received_from_other_parties.Reduce(action, stage);
+                }
+            }
+        }
+
+        // handle skill
+        Skill* skill = action->is_skill ? GetSkill(action->skill_id) : nullptr;
+        if (skill) {
+            // Modify the effective `target` and `target_party`, based on the
+            // targetting type of the skill to make stats more intuitive.
+
+            // For example if using Heal Burst on yourself, the packet only
+            // includes a caster and no target.
+            // here we effectively set the
+            // target to the caster.
+            switch (skill->target) {
+                case static_cast<uint32_t>(TargetType::no_target): {
+                    // don't provide a target
+                    // e.g. flash enchantments, stances, whirlwind
+                    break;
+                }
+                case static_cast<uint32_t>(TargetType::anyone): {
+                    // Ensure we interpret the target correctly
+                    // e.g. Mirror of Ice, Stone Sheath
+                    if (action->target_id == no_agent) {
+                        target = caster;
+                        target_party = caster_party;
+                    }
+                    break;
+                }
+                case static_cast<uint32_t>(TargetType::ally): {
+                    // Ensure we interpret the target correctly
+                    // e.g. Healing Burst
+                    if (action->target_id == no_agent) {
+                        target = caster;
+                        target_party = caster_party;
+                    }
+                    break;
+                }
+                case static_cast<uint32_t>(TargetType::other_ally): {
+                    // should always have a target
+                    break;
+                }
+                case static_cast<uint32_t>(TargetType::enemy): {
+                    // should always have a target
+                    break;
+                }
+            }
+            const bool same_team = caster && target && caster->team_id != no_team && caster->team_id == target->team_id;
+            const bool same_party = target_party && caster_party && target_party->party_id == caster_party->party_id;
+
+            // notify the skill
+            skill->stats.total_usages.Reduce(action, stage);
+            if (target) {
+                // target usages
+                if (caster == target) {
+                    skill->stats.total_self_usages.Reduce(action, stage);
+                }
+                else {
+                    skill->stats.total_other_usages.Reduce(action, stage);
+                }
+
+                // team usages
+                if (same_team) {
+                    skill->stats.total_own_team_usages.Reduce(action, stage);
+                }
+                else {
+                    skill->stats.total_other_team_usages.Reduce(action, stage);
+                }
+            }
+            if (target_party) {
+                // party usages
+                if (caster_party == target_party) {
+                    skill->stats.total_own_party_usages.Reduce(action, stage);
+                }
+                else {
+                    skill->stats.total_other_party_usages.Reduce(action, stage);
+                }
+            }
+
+            // notify the caster
+            if (caster) {
+                caster->stats.total_skills_used.Reduce(action, stage);
+                skills_used.Reduce(caster->index, skill->index, *action, stage);
+
+                // used against a target?
+                if (target) {
+                    // use against agent
+                    // also counts as the skills the target received from the caster
+                    skills_used_on.Reduce(skills_used_on.Row(ActionTable::Key(caster->index, target->index, skill->index)), *action, stage);
+
+                    // team:
+                    // same team
+                    if (same_team) {
+                        caster->stats.total_skills_used_on_own_team.Reduce(action, stage);
+                    }
+                    // diff team
+                    else {
+                        caster->stats.total_skills_used_on_other_teams.Reduce(action, stage);
+                    }
+                }
+
+                // party:
+                if (target_party) {
+                    // same party
+                    if (same_party) {
+                        caster->stats.total_skills_used_on_own_party.Reduce(action, stage);
+                    }
+                    // diff party
+                    else {
+                        caster->stats.total_skills_used_on_other_parties.Reduce(action, stage);
+                    }
+                }
+            }
+
+            // notify the caster_party
+            if (caster_party) {
+                caster_party->stats.total_skills_used.Reduce(action, stage);
+
+                // team
+                // same team
+                if (same_team) {
+                    caster_party->stats.total_skills_used_on_own_team.Reduce(action, stage);
+                }
+                // diff team
+                else {
+                    caster_party->stats.total_skills_used_on_other_teams.Reduce(action, stage);
+                }
+
+                // party:
+                if (target_party) {
+                    // same party
+                    if (same_party) {
+                        caster_party->stats.total_skills_used_on_own_party.Reduce(action, stage);
+                    }
+                    // diff party
+                    else {
+                        caster_party->stats.total_skills_used_on_other_parties.Reduce(action, stage);
+                    }
+                }
+            }
+
+            // notify the target
+            if (target) {
+                target->stats.total_skills_received.Reduce(action, stage);
+                skills_received.Reduce(target->index, skill->index, *action, stage);
+                // used from a living caster? (redundant)
+                if (caster) {
+                    // team
+                    // same team
+                    if (same_team) {
+                        target->stats.total_skills_received_from_own_team.Reduce(action, stage);
+                    }
+                    // diff team
+                    else {
+                        target->stats.total_skills_received_from_other_teams.Reduce(action, stage);
+                    }
+                }
+
+                // party:
+                if (caster_party) {
+                    // same party
+                    if (same_party) {
+                        target->stats.total_skills_received_from_own_party.Reduce(action, stage);
+                    }
+                    // diff party
+                    else {
+                        target->stats.total_skills_received_from_other_parties.Reduce(action, stage);
+                    }
+                }
+            }
+
+            // notify the target_party
+            if (target_party) {
+                target_party->stats.total_skills_received.Reduce(action, stage);
+
+                // team:
+                // same team
+                if (same_team) {
+                    target_party->stats.total_skills_received_from_own_team.Reduce(action, stage);
+                }
+                // diff team
+                else {
+                    target_party->stats.total_skills_received_from_other_teams.Reduce(action, stage);
+                }
+
+                // party:
+                if (caster_party) {
+                    // same party
+                    if (same_party) {
+                        target_party->stats.total_skills_received_from_own_party.Reduce(action, stage);
+                    }
+                    // diff party
+                    else {
+                        target_party->stats.total_skills_received_from_other_parties.Reduce(action, stage);
+                    }
+                }
+            }
+        }
+    }
+
+
+    Index Match::AddAgent(const AgentInfo& info)
+    {
+        const Index index = agent_indices.Add(info.agent_id);
+        if (index == no_index || index < agent_ids.size()) {
+            return index;
+        }
+        InsertSorted(agent_ids, info.agent_id);
+        ResizeStatTables();
+        if (journal) {
+            journal->AppendAgent(info);
+        }
+        return index;
+    }
+
+
+    Index Match::AddSkill(const SkillInfo& info)
+    {
+        const Index index = skill_indices.Add(info.skill_id);
+        if (index == no_index || index < skill_ids.size()) {
+            return index;
+        }
+        InsertSorted(skill_ids, info.skill_id);
+        ResizeStatTables();
+        if (journal) {
+            journal->AppendSkill(info);
+        }
+        return index;
+    }
+
+
+    Index Match::AddParty(const uint32_t party_id)
+    {
+        const Index index = party_indices.Add(party_id);
+        if (index == no_index || index < party_ids.size()) {
+            return index;
+        }
+        InsertSorted(party_ids, party_id);
+        if (journal) {
+            journal->AppendParty(party_id);
+        }
+        return index;
+    }
+
+
+    Index Match::AddGuild(const Guild& guild)
+    {
+        const Index index = guild_indices.Add(guild.guild_id);
+        if (index == no_index || index < guild_ids.size()) {
+            return index;
+        }
+        InsertSorted(guild_ids, guild.guild_id);
+        if (journal) {
+            journal->AppendGuild(guild);
+        }
+        return index;
+    }
+
+
+    void Match::SetAgentParty(Agent& agent, const uint32_t party_id, const uint32_t party_index)
+    {
+        if (agent.party_id == party_id && agent.party_index == party_index) {
+            return;
+        }
+        agent.party_id = party_id;
+        agent.party_index = party_index;
+        if (journal) {
+            journal->AppendPartyMember(agent.agent_id, party_id, party_index);
+        }
+    }
+
+
+    void Match::SetPartyRoster(const Party& party)
+    {
+        if (journal) {
+            journal->AppendRoster(party);
+        }
+    }
+
+
+    void Match::BeginMatch(const Map& map)
+    {
+        match_finished = false;
+        winning_party_id = no_party;
+        match_duration_ms_total = std::chrono::milliseconds(0);
+        match_duration_ms = std::chrono::milliseconds(0);
+        match_duration_secs = std::chrono::seconds(0);
+        match_duration_mins = std::chrono::minutes(0);
+        if (journal) {
+            journal->AppendMap(map);
+        }
+    }
+
+
+    void Match::JournalNames()
+    {
+        if (!journal) {
+            return;
+        }
+        for (const uint32_t agent_id : agent_ids) {
+            if (Agent* agent = GetAgent(agent_id)) {
+                journal->AppendName(ObserverJournal::NameOf::Agent, agent_id, agent->RawName());
+                journal->AppendName(ObserverJournal::NameOf::AgentProfession, agent_id, agent->profession);
+            }
+        }
+        for (const uint32_t skill_id : skill_ids) {
+            if (Skill* skill = GetSkill(skill_id)) {
+                journal->AppendName(ObserverJournal::NameOf::Skill, skill_id, skill->Name());
+            }
+        }
+        for (const uint32_t party_id : party_ids) {
+            if (const Party* party = GetParty(party_id)) {
+                journal->AppendName(ObserverJournal::NameOf::Party, party_id, party->name);
+                journal->AppendName(ObserverJournal::NameOf::PartyDisplay, party_id, party->display_name);
+            }
+        }
+        if (Map* map = GetMap()) {
+            journal->AppendName(ObserverJournal::NameOf::Map, 0, map->Name());
+            journal->AppendName(ObserverJournal::NameOf::MapDescription, 0, map->Description());
+        }
+    }
+
+
+    void Match::Clear()
+    {
+        guild_ids.clear();
+        guild_indices.Clear();
+        skill_ids.clear();
+        skill_indices.Clear();
+        agent_ids.clear();
+        agent_indices.Clear();
+        party_ids.clear();
+        party_indices.Clear();
+
+        skills_used.Clear();
+        skills_received.Clear();
+        attacks.Clear();
+        skills_used_on.Clear();
+    }
+
+
+    // Make room in the stat tables for every observed agent and skill
+    void Match::ResizeStatTables()
+    {
+        const size_t agent_count = agent_ids.size();
+        const size_t skill_count = skill_ids.size();
+        skills_used.Resize(agent_count, skill_count);
+        skills_received.Resize(agent_count, skill_count);
+        attacks.Resize(agent_count, agent_count);
+    }
+}
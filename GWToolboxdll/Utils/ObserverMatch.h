@@ -0,0 +1,489 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <Utils/ObserverStats.h>
+
+class ObserverJournal;
+
+// Everything the observer knows about a match: the agents, parties, skills and guilds in it and what they did,
+// reduced from the events the game sends. Match only does the bookkeeping; where the agents etc. come from is up to
+// whoever derives from it. ObserverModule looks them up in the game as they're first seen, and journals every event
+// and every lookup as it goes; ObserverReplay reads them back from such a journal, and ends up with the same stats.
+// No game dependencies; keep it that way so it can be built and profiled outside of the dll.
+namespace ObserverStats {
+    constexpr uint32_t no_agent = 0;
+    constexpr uint32_t no_team = 0;
+    constexpr uint32_t no_party = 0;
+    constexpr uint32_t no_guild = 0;
+    constexpr uint32_t no_rank = 0;
+    constexpr uint32_t no_rating = 0;
+    constexpr uint32_t no_skill = 0;
+
+    // AgentState that means the agent died
+    constexpr uint32_t agent_state_dead = 16;
+
+    // TODO: push this to GWCA
+    // applies to skill.target
+    enum class TargetType {
+        no_target = 0,
+        anyone    = 1,
+        // 2?
+        ally       = 3,
+        other_ally = 4,
+        enemy      = 5,
+    };
+
+    // Every kind of event that changes the stats
+    enum class EventType : uint8_t {
+        // caster_id died if value is agent_state_dead
+        AgentState,
+        // caster_id hit target_id for amount (fraction of max health); value is 1 for a critical hit
+        DamageDone,
+        // caster_id was knocked down for amount seconds
+        KnockedDown,
+        // caster_id fired a projectile; finishes a ranged attack
+        ProjectileLaunched,
+        // caster_id started attacking target_id
+        AttackStarted,
+        AttackFinished,
+        AttackStopped,
+        Interrupted,
+        // caster_id used skill value on target_id
+        InstantSkillActivated,
+        AttackSkillStarted,
+        AttackSkillFinished,
+        AttackSkillStopped,
+        SkillActivated,
+        SkillFinished,
+        SkillStopped,
+        // caster_id is the party
+        MoraleBoost,
+        Victory,
+
+        Count
+    };
+
+    // One event, as handed to Match::Apply()
+    struct Event {
+        EventType type = EventType::AgentState;
+        // instance time in ms
+        uint32_t time = 0;
+        // agent the event is about; for party events, the party
+        uint32_t caster_id = 0;
+        uint32_t target_id = 0;
+        // skill_id, agent state, or whether a hit was critical
+        uint32_t value = 0;
+        // damage or knock down duration
+        float amount = 0;
+    };
+
+    // an agents statistics for an action (skill)
+    struct ObservedSkill : ObservedAction {
+        ObservedSkill(const ObservedAction& action, const uint32_t skill_id)
+            : ObservedAction(action)
+            , skill_id(skill_id) { }
+
+        uint32_t skill_id;
+    };
+
+    // What's known about an agent when it's first seen
+    struct AgentInfo {
+        uint32_t agent_id = no_agent;
+        uint32_t login_number = 0;
+        uint32_t guild_id = no_guild;
+        uint32_t team_id = no_team;
+        uint32_t primary = 0;
+        uint32_t secondary = 0;
+        bool is_player = false;
+        bool is_npc = false;
+    };
+
+    // What's known about a skill when it's first seen
+    struct SkillInfo {
+        uint32_t skill_id = no_skill;
+        // TargetType
+        uint32_t target = 0;
+    };
+
+    // closely related to GW::AreaInfo
+    struct MapInfo {
+        uint32_t campaign = 0;
+        uint32_t continent = 0;
+        uint32_t region = 0;
+        uint32_t type = 0;
+        uint32_t flags = 0;
+        uint32_t name_id = 0;
+        uint32_t description_id = 0;
+    };
+
+    class Match;
+
+    // Shared stats for an Agent or Team
+    class SharedStats {
+    public:
+        // ****
+        // misc
+        // ****
+
+        size_t total_crits_received = 0;
+        size_t total_crits_dealt = 0;
+
+        size_t total_party_crits_received = 0;
+        size_t total_party_crits_dealt = 0;
+
+        size_t knocked_down_count = 0;
+        size_t interrupted_count = 0;
+        size_t interrupted_skills_count = 0;
+        size_t cancelled_count = 0;
+        size_t cancelled_skills_count = 0;
+        float knocked_down_duration = 0;
+
+        // deaths: from AgentState packets
+        size_t deaths = 0;
+        // kills: player kills only, not npc kills
+        //        guessed from damage packets
+        size_t kills = 0;
+        float kdr_pc = 0;
+        std::string kdr_str = "0.00";
+
+        // attacks
+
+        ObservedAction total_attacks_dealt;
+        ObservedAction total_attacks_received;
+
+        // attacks done on other parties (not inc. npcs)
+        ObservedAction total_attacks_dealt_to_other_parties;
+        // attacks received from other parties (not inc. npcs)
+        ObservedAction total_attacks_received_from_other_parties;
+
+        // skills
+
+        // skills used on anyone
+        ObservedAction total_skills_used;
+        // skills received from anyone
+        ObservedAction total_skills_received;
+
+        // skills used on your own party (not inc. npcs)
+        ObservedAction total_skills_used_on_own_party;
+        // skills used on other parties (not inc. npcs)
+        ObservedAction total_skills_used_on_other_parties;
+
+        // skills received from your own party (not inc. npcs)
+        ObservedAction total_skills_received_from_own_party;
+        // skills received from other parties (not inc. npcs)
+        ObservedAction total_skills_received_from_other_parties;
+
+        // skills used on your own team (inc. npcs)
+        ObservedAction total_skills_used_on_own_team;
+        // skills used on other team (inc. npcs)
+        ObservedAction total_skills_used_on_other_teams;
+
+        // skills received from your own team (inc. npcs)
+        ObservedAction total_skills_received_from_own_team;
+        // skills received from other team (inc. npcs)
+        ObservedAction total_skills_received_from_other_teams;
+
+        // fired when the agent dies
+        void HandleDeath();
+
+        // fired when the agent scores a kill
+        void HandleKill();
+    };
+
+    // Stats for Agents
+    // Per agent and per skill stats are kept in the matches stat tables; these read them out
+    class AgentStats : public SharedStats {
+    public:
+        AgentStats(const Match& match, const Index index)
+            : match(match)
+            , index(index) { }
+
+        // attacks dealt to other agents, by target agent_id
+        [[nodiscard]] std::vector<std::pair<uint32_t, ObservedAction>> AttacksDealtToAgents() const;
+        // attacks received from other agents, by caster agent_id
+        [[nodiscard]] std::vector<std::pair<uint32_t, ObservedAction>> AttacksReceivedFromAgents() const;
+
+        // skills used on anyone, sorted by skill_id
+        [[nodiscard]] std::vector<ObservedSkill> SkillsUsed() const;
+        // skills received from anyone, sorted by skill_id
+        [[nodiscard]] std::vector<ObservedSkill> SkillsReceived() const;
+
+        // agent_ids of the agents this agent used skills on, sorted
+        [[nodiscard]] std::vector<uint32_t> AgentIdsSkillsUsedOn() const;
+        // skills used on one agent, sorted by skill_id
+        [[nodiscard]] std::vector<ObservedSkill> SkillsUsedOn(uint32_t target_agent_id) const;
+
+        // agent_ids of the agents this agent received skills from, sorted
+        [[nodiscard]] std::vector<uint32_t> AgentIdsSkillsReceivedFrom() const;
+        // skills received from one agent, sorted by skill_id
+        [[nodiscard]] std::vector<ObservedSkill> SkillsReceivedFrom(uint32_t caster_agent_id) const;
+
+    private:
+        const Match& match;
+        // the agents row/column in the stat tables
+        const Index index;
+    };
+
+    // Stats for Parties
+    class PartyStats : public SharedStats {
+    public:
+        //
+    };
+
+    class SkillStats {
+    public:
+        ObservedAction total_usages;
+
+        ObservedAction total_self_usages;
+        ObservedAction total_other_usages;
+
+        ObservedAction total_own_party_usages;
+        ObservedAction total_own_team_usages;
+
+        ObservedAction total_other_party_usages;
+        ObservedAction total_other_team_usages;
+    };
+
+    // An agent whose stats are tracked
+    // Includes players AND npc's
+    class Agent {
+    public:
+        Agent(const Match& match, Index index, const AgentInfo& info);
+        virtual ~Agent() = default;
+
+        // dense index into the stat tables, in the order agents were first seen
+        Index index;
+        uint32_t agent_id;
+        uint32_t login_number;
+
+        uint32_t guild_id;
+        uint32_t team_id;
+        // initialise to no party id
+        // let the party set the party_id
+        uint32_t party_id = no_party;
+        uint32_t party_index = 0;
+
+        // GW::Constants::Profession
+        uint32_t primary;
+        uint32_t secondary;
+        // e.g. "W/Mo"
+        std::string profession = "";
+
+        bool is_player;
+        bool is_npc;
+
+        // latest action (attack/skill) the agent was undertaking
+        std::optional<TargetAction> current_target_action;
+
+        // last_hit_by tells us who killed the player if they die
+        // MUST be a party_member (e.g. not a footman)
+        // Not literally who is responsible for the kill, but may help
+        // account for degen / npc steals / such.
+        // It's a for fun stat so don't take it too serious
+        uint32_t last_hit_by = no_agent;
+
+        // TODO: last_hit_at to limit the kill window
+
+        AgentStats stats;
+
+        // names, empty until known
+        virtual std::string DisplayName() = 0;
+        virtual std::string RawName() = 0;
+        virtual std::string DebugName() = 0;
+        virtual std::string SanitizedName() = 0;
+    };
+
+    // A skill whose usage is tracked
+    class Skill {
+    public:
+        Skill(const Index index, const SkillInfo& info)
+            : index(index)
+            , skill_id(info.skill_id)
+            , target(info.target) { }
+        virtual ~Skill() = default;
+
+        // dense index into the stat tables, in the order skills were first seen
+        Index index;
+        uint32_t skill_id;
+        // TargetType
+        uint32_t target;
+
+        SkillStats stats;
+
+        // empty until known
+        virtual std::string Name() = 0;
+    };
+
+    class Party {
+    public:
+        explicit Party(const uint32_t party_id)
+            : party_id(party_id) { }
+
+        uint32_t party_id;
+
+        // guild_id and name are inferred from the guilds members
+        // TODO: get the actual teams guild/name from memory,
+        // instead of guessing
+        uint32_t guild_id = no_guild;
+        uint32_t rating = no_rating;
+        uint32_t rank = no_rank;
+        std::string rank_str; // 0 -> "N/A"
+        std::string name = "";
+        std::string display_name = "";
+
+        uint32_t morale_boosts = 0;
+        bool is_victorious = false;
+        bool is_defeated = false;
+
+        PartyStats stats = PartyStats();
+
+        // agent_ids representing the players
+        std::vector<uint32_t> agent_ids = {};
+    };
+
+    class Guild {
+    public:
+        uint32_t guild_id = no_guild;
+        std::array<uint32_t, 4> key{};
+        std::string name;
+        std::string tag;
+        std::string wrapped_tag;
+        uint32_t rank = no_rank;
+        uint32_t rating = no_rating;
+        uint32_t faction = 0; // 0 - kurz, 1 - lux
+        uint32_t faction_point = 0;
+        uint32_t qualifier_point = 0;
+        uint32_t cape_trim = 0; // TODO: which is gold (1)?
+    };
+
+    class Map : public MapInfo {
+    public:
+        explicit Map(const MapInfo& info)
+            : MapInfo(info) { }
+        virtual ~Map() = default;
+
+        // empty until known
+        virtual std::string Name() = 0;
+        virtual std::string Description() = 0;
+        [[nodiscard]] bool GetIsPvP() const { return (flags & 0x1) != 0; }
+        [[nodiscard]] bool GetIsGuildHall() const { return (flags & 0x800000) != 0; }
+    };
+
+    class Match {
+    public:
+        Match() = default;
+        Match(const Match&) = delete;
+        Match& operator=(const Match&) = delete;
+        virtual ~Match() = default;
+
+        // Reduce an event into the stats, then journal it
+        void Apply(const Event& event);
+
+        // Lookups; may bring the agent etc. into the match the first time it's asked for
+        virtual Agent* GetAgent(uint32_t agent_id) = 0;
+        virtual Party* GetParty(uint32_t party_id) = 0;
+        virtual Skill* GetSkill(uint32_t skill_id) = 0;
+        virtual Guild* GetGuild(uint32_t guild_id) = 0;
+        [[nodiscard]] virtual Map* GetMap() const = 0;
+
+        // ids of everything in the match so far, sorted
+        const std::vector<uint32_t>& GetObservableGuildIds() const { return guild_ids; }
+        const std::vector<uint32_t>& GetObservableAgentIds() const { return agent_ids; }
+        const std::vector<uint32_t>& GetObservablePartyIds() const { return party_ids; }
+        const std::vector<uint32_t>& GetObservableSkillIds() const { return skill_ids; }
+
+        bool match_finished = false;
+        uint32_t winning_party_id = no_party;
+        std::chrono::milliseconds match_duration_ms_total{};
+        std::chrono::milliseconds match_duration_ms{};
+        std::chrono::seconds match_duration_secs{};
+        std::chrono::minutes match_duration_mins{};
+
+    protected:
+        // Everything from here on is also written to journal, if it's open; nullptr to stop
+        void SetJournal(ObserverJournal* _journal) { journal = _journal; }
+
+        // Give something first seen in the match its index, or no_index if it can't have one.
+        // The index is where the caller should keep it, and what Get...() should find it by.
+        Index AddAgent(const AgentInfo& info);
+        Index AddSkill(const SkillInfo& info);
+        Index AddParty(uint32_t party_id);
+        Index AddGuild(const Guild& guild);
+
+        // Move an agent into a party (or out of one, with no_party)
+        void SetAgentParty(Agent& agent, uint32_t party_id, uint32_t party_index);
+        // The party's members and guild were worked out again
+        void SetPartyRoster(const Party& party);
+        // Match is starting on map
+        void BeginMatch(const Map& map);
+        // Write the names of everything in the match to the journal; they may only be known once it's over
+        void JournalNames();
+
+        // Forget everything in the match. The caller forgets the agents etc. it was keeping;
+        // the memory of the stat tables is kept for the next match.
+        void Clear();
+
+        DenseIds guild_indices;
+        DenseIds agent_indices;
+        DenseIds skill_indices;
+        DenseIds party_indices;
+
+    private:
+        friend class AgentStats;
+
+        // generic handlers
+
+        void HandleInterrupted(uint32_t agent_id);
+        void HandleKnockedDown(uint32_t agent_id, float duration);
+        void HandleAgentState(uint32_t agent_id, uint32_t state);
+        void HandleDamageDone(uint32_t caster_id, uint32_t target_id, float amount_pc, bool is_crit);
+        void HandleProjectileLaunched(uint32_t agent_id);
+
+        void HandleAttackFinished(uint32_t agent_id);
+        void HandleAttackStopped(uint32_t agent_id);
+        void HandleAttackStarted(uint32_t caster_id, uint32_t target_id);
+
+        void HandleInstantSkillActivated(uint32_t caster_id, uint32_t target_id, uint32_t skill_id);
+
+        void HandleAttackSkillFinished(uint32_t agent_id);
+        void HandleAttackSkillStopped(uint32_t agent_id);
+        void HandleAttackSkillStarted(uint32_t caster_id, uint32_t target_id, uint32_t skill_id);
+
+        void HandleSkillFinished(uint32_t agent_id);
+        void HandleSkillStopped(uint32_t agent_id);
+        void HandleSkillActivated(uint32_t caster_id, uint32_t target_id, uint32_t skill_id);
+
+        static void HandleMoraleBoost(Party* boosting_party);
+        void HandleVictory(Party* winning_party, uint32_t instance_time);
+
+        // Update the state of the match based on an Action & Stage
+        // new_action is copied onto the caster unless it's instant
+        void ReduceAction(Agent* caster, ActionStage stage, TargetAction* new_action = nullptr);
+
+        // make room in the stat tables for every agent and skill
+        void ResizeStatTables();
+
+        ObserverJournal* journal = nullptr;
+
+        std::vector<uint32_t> guild_ids = {};
+        std::vector<uint32_t> agent_ids = {};
+        std::vector<uint32_t> skill_ids = {};
+        std::vector<uint32_t> party_ids = {};
+
+        // stat tables, by agent/skill index
+
+        // agent x skill
+        ActionMatrix skills_used;
+        ActionMatrix skills_received;
+        // caster x target; serves both the attackers and the targets side
+        ActionMatrix attacks;
+        // caster x target x skill; serves both the casters and the targets side
+        ActionTable skills_used_on;
+    };
+}
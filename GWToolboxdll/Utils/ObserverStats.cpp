@@ -0,0 +1,201 @@
+#include <stdafx.h>
+
+#include "ObserverStats.h"
+
+namespace ObserverStats {
+    namespace {
+        constexpr size_t min_stride = 16;
+        constexpr size_t min_rows = 16;
+        constexpr size_t min_slots = 64;
+
+        ObservedAction ToAction(const uint32_t started, const uint32_t stopped, const uint32_t finished, const uint32_t interrupted)
+        {
+            ObservedAction action;
+            action.started = started;
+            action.stopped = stopped;
+            action.finished = finished;
+            action.interrupted = interrupted;
+            action.integrity = static_cast<int>(static_cast<int64_t>(started) - finished - stopped - interrupted);
+            return action;
+        }
+
+        size_t Hash(uint64_t key)
+        {
+            key ^= key >> 29;
+            key *= 0xbf58476d1ce4e5b9ull;
+            key ^= key >> 32;
+            return static_cast<size_t>(key);
+        }
+    }
+
+    void ObservedAction::Reduce(const TargetAction* action, const ActionStage stage)
+    {
+        if (!action) {
+            return;
+        }
+        ObserverStats::Reduce(started, stopped, finished, interrupted, *action, stage);
+
+        // re-calculate integrity
+        integrity = static_cast<int>(started - finished - stopped - interrupted);
+    }
+
+    Index DenseIds::Add(const uint32_t id)
+    {
+        if (id >= max_id) {
+            return no_index;
+        }
+        if (id >= by_id.size()) {
+            by_id.resize(id + 1, no_index);
+        }
+        Index& index = by_id[id];
+        if (index == no_index) {
+            if (ids.size() >= no_index) {
+                return no_index;
+            }
+            index = static_cast<Index>(ids.size());
+            ids.push_back(id);
+        }
+        return index;
+    }
+
+    void DenseIds::Clear()
+    {
+        by_id.clear();
+        ids.clear();
+    }
+
+    void ActionMatrix::Resize(const size_t _rows, const size_t _cols)
+    {
+        if (stride == 0 || _cols > stride) {
+            // Lay the rows out again further apart; only the cells in use are worth copying
+            size_t new_stride = std::max(stride, min_stride);
+            while (new_stride < _cols) {
+                new_stride *= 2;
+            }
+            const size_t row_capacity = stride ? started.size() / stride : 0;
+            for (auto counter : {&started, &stopped, &finished, &interrupted}) {
+                std::vector<uint32_t> relaid(row_capacity * new_stride);
+                for (size_t row = 0; row < rows; row++) {
+                    std::copy_n(counter->begin() + static_cast<ptrdiff_t>(row * stride), cols, relaid.begin() + static_cast<ptrdiff_t>(row * new_stride));
+                }
+                *counter = std::move(relaid);
+            }
+            stride = new_stride;
+        }
+        if (_rows * stride > started.size()) {
+            size_t row_capacity = std::max(started.size() / stride, min_rows);
+            while (row_capacity < _rows) {
+                row_capacity *= 2;
+            }
+            for (auto counter : {&started, &stopped, &finished, &interrupted}) {
+                counter->resize(row_capacity * stride);
+            }
+        }
+        // Cells outside of rows x cols may still hold counts from a previous match
+        if (_cols > cols) {
+            ZeroCells(0, rows, cols, _cols);
+            cols = _cols;
+        }
+        if (_rows > rows) {
+            ZeroCells(rows, _rows, 0, cols);
+            rows = _rows;
+        }
+    }
+
+    void ActionMatrix::ZeroCells(const size_t row_begin, const size_t row_end, const size_t col_begin, const size_t col_end)
+    {
+        for (auto counter : {&started, &stopped, &finished, &interrupted}) {
+            for (size_t row = row_begin; row < row_end; row++) {
+                std::fill(counter->begin() + static_cast<ptrdiff_t>(row * stride + col_begin), counter->begin() + static_cast<ptrdiff_t>(row * stride + col_end), 0u);
+            }
+        }
+    }
+
+    void ActionMatrix::Clear()
+    {
+        rows = 0;
+        cols = 0;
+    }
+
+    ObservedAction ActionMatrix::Get(const size_t row, const size_t col) const
+    {
+        const size_t cell = row * stride + col;
+        return ToAction(started[cell], stopped[cell], finished[cell], interrupted[cell]);
+    }
+
+    size_t ActionTable::Find(const uint64_t key) const
+    {
+        if (slots.empty()) {
+            return npos;
+        }
+        const size_t mask = slots.size() - 1;
+        for (size_t i = Hash(key) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.generation != generation) {
+                return npos;
+            }
+            if (slot.key == key) {
+                return slot.row;
+            }
+        }
+    }
+
+    size_t ActionTable::Row(const uint64_t key)
+    {
+        // Keep at most half of the slots in use, so probes stay short and always end
+        if ((keys.size() + 1) * 2 > slots.size()) {
+            Grow();
+        }
+        const size_t mask = slots.size() - 1;
+        for (size_t i = Hash(key) & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (slot.generation == generation) {
+                if (slot.key == key) {
+                    return slot.row;
+                }
+                continue;
+            }
+            const size_t row = keys.size();
+            slot = {key, static_cast<uint32_t>(row), generation};
+            keys.push_back(key);
+            started.push_back(0);
+            stopped.push_back(0);
+            finished.push_back(0);
+            interrupted.push_back(0);
+            return row;
+        }
+    }
+
+    void ActionTable::Grow()
+    {
+        slots.assign(std::max(slots.size() * 2, min_slots), {0, 0, 0});
+        generation = 1;
+        const size_t mask = slots.size() - 1;
+        for (size_t row = 0; row < keys.size(); row++) {
+            size_t i = Hash(keys[row]) & mask;
+            while (slots[i].generation == generation) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = {keys[row], static_cast<uint32_t>(row), generation};
+        }
+    }
+
+    void ActionTable::Clear()
+    {
+        if (++generation == 0) {
+            // Wrapped around; forget every slot for real this once
+            slots.assign(slots.size(), {0, 0, 0});
+            generation = 1;
+        }
+        keys.clear();
+        started.clear();
+        stopped.clear();
+        finished.clear();
+        interrupted.clear();
+    }
+
+    ObservedAction ActionTable::Get(const size_t row) const
+    {
+        return ToAction(started[row], stopped[row], finished[row], interrupted[row]);
+    }
+}
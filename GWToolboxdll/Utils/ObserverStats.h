@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Storage for ObserverModule's per-match state.
+// Everything seen in a match (agents, skills, ...) is given a dense index in the order it's first seen, and stats
+// between them live in flat tables indexed by those, one array per counter. Memory is kept from match to match, so
+// after the first match nothing here allocates, and clearing the tables for the next one is O(1).
+// No game dependencies; keep it that way so it can be built and profiled outside of the dll.
+namespace ObserverStats {
+    using Index = uint16_t;
+    constexpr Index no_index = 0xFFFF;
+
+    enum class ActionStage {
+        // start
+        Started,
+
+        // both
+        Instant,
+
+        // finish
+        Stopped,
+        Finished,
+        Interrupted // "Interrupted" is received after "Stopped"
+    };
+
+    // An action between a caster and target
+    // Where an action can be a skill and/or attack
+    struct TargetAction {
+        TargetAction(const uint32_t caster_id,
+                     const uint32_t target_id,
+                     const bool is_attack,
+                     const bool is_skill,
+                     const uint32_t skill_id
+        )
+            : caster_id(caster_id)
+            , target_id(target_id)
+            , is_attack(is_attack)
+            , is_skill(is_skill)
+            , skill_id(skill_id) { }
+
+        const uint32_t caster_id;
+        const uint32_t target_id;
+        const bool is_attack;
+        const bool is_skill;
+        const uint32_t skill_id;
+
+        // if the action was interrupted after it was finished (e.g. an attack skill that gets interrupted
+        // in the aftersting [once the skill has completed activation]) then we don't count as "interrupted"
+        // even if receiving an "interrupted" signal
+        bool was_stopped = false;
+        bool was_finished = false;
+    };
+
+    // change counters based on an actions stage
+    template <typename Counter>
+    void Reduce(Counter& started, Counter& stopped, Counter& finished, Counter& interrupted, const TargetAction& action, const ActionStage stage)
+    {
+        switch (stage) {
+            case ActionStage::Instant:
+                started += 1;
+                finished += 1;
+                break;
+            case ActionStage::Started:
+                started += 1;
+                break;
+            case ActionStage::Stopped:
+                // nothing to do if the action was already finished
+                // we can get "cancelled" packet after a "finished" packet if for example; we're using
+                // an attack skill, the attack skill completes, we begin the afterswing, and the target dies
+                // then the afterswing is cancelled, even though the action completed
+                if (!action.was_finished) {
+                    stopped += 1;
+                }
+                break;
+            case ActionStage::Interrupted:
+                // nothing to do if the action was already finished
+                if (!action.was_finished) {
+                    // were we prepended by a fake "cancelled" packet?
+                    if (action.was_stopped) {
+                        stopped -= 1;
+                    }
+                    interrupted += 1;
+                }
+                break;
+            case ActionStage::Finished:
+                finished += 1;
+                break;
+        }
+    }
+
+    // an agents statistics for an action (attack)
+    class ObservedAction {
+    public:
+        size_t started = 0;
+        size_t stopped = 0;
+        size_t finished = 0;
+        size_t interrupted = 0;
+
+        // should be zero at all times except when an action is not yet concluded
+        // used to indicate there may be inaccuracies in the stats due to due to
+        // inaccuracies in our modelling of the game engine
+        int integrity = 0;
+
+        void Reduce(const TargetAction* action, ActionStage stage);
+    };
+
+    // Maps ids (agent ids, skill ids, ...) to dense indices with a direct lookup, and back.
+    // Ids are expected to be small; anything at or past max_id isn't given an index.
+    class DenseIds {
+    public:
+        static constexpr uint32_t max_id = 1 << 20;
+
+        [[nodiscard]] Index Find(const uint32_t id) const { return id < by_id.size() ? by_id[id] : no_index; }
+        // Index for id, added if it hasn't got one yet; no_index if it can't have one
+        Index Add(uint32_t id);
+        [[nodiscard]] uint32_t Id(const Index index) const { return ids[index]; }
+        [[nodiscard]] const std::vector<uint32_t>& Ids() const { return ids; }
+        [[nodiscard]] size_t size() const { return ids.size(); }
+        void Clear();
+
+    private:
+        std::vector<Index> by_id;
+        std::vector<uint32_t> ids;
+    };
+
+    // Action counters for every (row, col) pair, e.g. agent x skill, as one array per counter.
+    // Rows and columns are added in order and start at zero; the storage only ever grows.
+    class ActionMatrix {
+    public:
+        // Make sure there are at least rows x cols cells
+        void Resize(size_t _rows, size_t _cols);
+        // O(1); cells are zeroed again as rows and columns are added back
+        void Clear();
+
+        void Reduce(const size_t row, const size_t col, const TargetAction& action, const ActionStage stage)
+        {
+            const size_t cell = row * stride + col;
+            ObserverStats::Reduce(started[cell], stopped[cell], finished[cell], interrupted[cell], action, stage);
+        }
+        [[nodiscard]] ObservedAction Get(size_t row, size_t col) const;
+        // True if anything was ever counted for the cell
+        [[nodiscard]] bool Touched(const size_t row, const size_t col) const
+        {
+            const size_t cell = row * stride + col;
+            return (started[cell] | stopped[cell] | finished[cell] | interrupted[cell]) != 0;
+        }
+
+        [[nodiscard]] size_t Rows() const { return rows; }
+        [[nodiscard]] size_t Cols() const { return cols; }
+
+    private:
+        void ZeroCells(size_t row_begin, size_t row_end, size_t col_begin, size_t col_end);
+
+        size_t rows = 0;
+        size_t cols = 0;
+        // Row length in the arrays; at least cols
+        size_t stride = 0;
+        std::vector<uint32_t> started;
+        std::vector<uint32_t> stopped;
+        std::vector<uint32_t> finished;
+        std::vector<uint32_t> interrupted;
+    };
+
+    // Action counters for sparse keys, e.g. caster x target x skill, as one array per counter with a row per key
+    // in the order they were added. Rows are found through an open addressing hash of the key.
+    class ActionTable {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        static uint64_t Key(const Index a, const Index b, const Index c)
+        {
+            return static_cast<uint64_t>(a) << 32 | static_cast<uint64_t>(b) << 16 | c;
+        }
+
+        // Row for key, added if it isn't there yet
+        size_t Row(uint64_t key);
+        [[nodiscard]] size_t Find(uint64_t key) const;
+        // O(1); slots from before are told apart by their generation
+        void Clear();
+
+        void Reduce(const size_t row, const TargetAction& action, const ActionStage stage)
+        {
+            ObserverStats::Reduce(started[row], stopped[row], finished[row], interrupted[row], action, stage);
+        }
+        [[nodiscard]] ObservedAction Get(size_t row) const;
+
+        [[nodiscard]] size_t size() const { return keys.size(); }
+        [[nodiscard]] uint64_t KeyOf(const size_t row) const { return keys[row]; }
+        [[nodiscard]] const std::vector<uint64_t>& Keys() const { return keys; }
+
+    private:
+        struct Slot {
+            uint64_t key;
+            uint32_t row;
+            uint32_t generation;
+        };
+        void Grow();
+
+        std::vector<Slot> slots;
+        uint32_t generation = 1;
+
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> started;
+        std::vector<uint32_t> stopped;
+        std::vector<uint32_t> finished;
+        std::vector<uint32_t> interrupted;
+    };
+
+    // Objects that live until Clear(), constructed in place in chunks that are kept for reuse.
+    // Addresses never change, and objects can be looked up by the order they were created in.
+    template <typename T, size_t chunk_size = 64>
+    class ObjectArena {
+    public:
+        ObjectArena() = default;
+        ObjectArena(const ObjectArena&) = delete;
+        ObjectArena& operator=(const ObjectArena&) = delete;
+        ~ObjectArena() { Clear(); }
+
+        template <typename... Args>
+        T* Create(Args&&... args)
+        {
+            if (count == chunks.size() * chunk_size) {
+                chunks.push_back(std::make_unique<Chunk>());
+            }
+            T* obj = new(Slot(count)) T(std::forward<Args>(args)...);
+            count++;
+            return obj;
+        }
+
+        T& operator[](const size_t index) { return *std::launder(reinterpret_cast<T*>(Slot(index))); }
+        const T& operator[](const size_t index) const { return *std::launder(reinterpret_cast<const T*>(Slot(index))); }
+        [[nodiscard]] size_t size() const { return count; }
+
+        // Destroys everything, newest first; the memory is kept
+        void Clear()
+        {
+            if constexpr (std::is_trivially_destructible_v<T>) {
+                count = 0;
+            }
+            else {
+                while (count) {
+                    (*this)[--count].~T();
+                }
+            }
+        }
+
+    private:
+        struct Chunk {
+            alignas(T) std::byte storage[sizeof(T) * chunk_size];
+        };
+
+        std::byte* Slot(const size_t index) const { return chunks[index / chunk_size]->storage + sizeof(T) * (index % chunk_size); }
+
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        size_t count = 0;
+    };
+}
@@ -0,0 +1,250 @@
+#include <stdafx.h>
+
+#include "PathingIndex.h"
+
+namespace {
+    constexpr char file_magic[4] = {'G', 'W', 'P', 'I'};
+    constexpr uint32_t file_version = 1;
+    // Keep the grid from getting silly for maps with a few huge trapezoids or a very long thin layout
+    constexpr int max_cells_per_side = 512;
+    // Points on the shared edge of two trapezoids should be on both
+    constexpr float edge_tolerance = 1.f;
+
+    static_assert(sizeof(PathingIndex::Trapezoid) == 32, "Trapezoids are saved as-is");
+
+    template <typename T>
+    bool Read(std::ifstream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    template <typename T>
+    bool ReadVector(std::ifstream& in, std::vector<T>& values, const uint32_t max_count)
+    {
+        uint32_t count = 0;
+        if (!Read(in, count) || count > max_count) {
+            return false;
+        }
+        values.resize(count);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), count * sizeof(T)));
+    }
+
+    template <typename T>
+    void Write(std::ofstream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    void WriteVector(std::ofstream& out, const std::vector<T>& values)
+    {
+        Write(out, static_cast<uint32_t>(values.size()));
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    bool ReadHeader(std::ifstream& in, uint32_t* map_id)
+    {
+        char magic[4];
+        uint32_t version = 0;
+        return in.read(magic, sizeof(magic)) && memcmp(magic, file_magic, sizeof(magic)) == 0
+               && Read(in, version) && version == file_version
+               && Read(in, *map_id);
+    }
+}
+
+void PathingIndex::Clear()
+{
+    trapezoids.clear();
+    plane_count = 0;
+    columns = rows = 0;
+    cell_start.clear();
+    cell_trapezoids.clear();
+}
+
+void PathingIndex::Add(const uint32_t plane, const Trapezoid& trapezoid)
+{
+    auto& added = trapezoids.emplace_back(trapezoid);
+    added.plane = plane;
+    plane_count = std::max(plane_count, plane + 1);
+}
+
+int PathingIndex::CellX(const float x) const
+{
+    return std::clamp(static_cast<int>((x - origin_x) / cell_size), 0, columns - 1);
+}
+
+int PathingIndex::CellY(const float y) const
+{
+    return std::clamp(static_cast<int>((y - origin_y) / cell_size), 0, rows - 1);
+}
+
+void PathingIndex::Index()
+{
+    columns = rows = 0;
+    cell_start.clear();
+    cell_trapezoids.clear();
+    if (trapezoids.empty()) {
+        return;
+    }
+    float min_x = std::numeric_limits<float>::max();
+    float min_y = min_x;
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = max_x;
+    for (const auto& t : trapezoids) {
+        min_x = std::min({min_x, t.XTL, t.XBL});
+        max_x = std::max({max_x, t.XTR, t.XBR});
+        min_y = std::min({min_y, t.YB, t.YT});
+        max_y = std::max({max_y, t.YB, t.YT});
+    }
+    const float width = std::max(max_x - min_x, 1.f);
+    const float height = std::max(max_y - min_y, 1.f);
+    // Roughly one trapezoid per cell
+    cell_size = std::sqrt(width * height / static_cast<float>(trapezoids.size()));
+    cell_size = std::max({cell_size, width / max_cells_per_side, height / max_cells_per_side, 1.f});
+    origin_x = min_x;
+    origin_y = min_y;
+    columns = std::min(static_cast<int>(width / cell_size) + 1, max_cells_per_side);
+    rows = std::min(static_cast<int>(height / cell_size) + 1, max_cells_per_side);
+
+    // Counting sort of trapezoids into every cell their bounding box touches
+    const auto for_each_cell = [this](const Trapezoid& t, auto&& visit) {
+        const int x0 = CellX(std::min(t.XTL, t.XBL) - edge_tolerance);
+        const int x1 = CellX(std::max(t.XTR, t.XBR) + edge_tolerance);
+        const int y0 = CellY(std::min(t.YB, t.YT) - edge_tolerance);
+        const int y1 = CellY(std::max(t.YB, t.YT) + edge_tolerance);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                visit(static_cast<size_t>(y) * columns + x);
+            }
+        }
+    };
+    cell_start.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (const auto& t : trapezoids) {
+        for_each_cell(t, [this](const size_t cell) {
+            cell_start[cell + 1]++;
+        });
+    }
+    for (size_t i = 1; i < cell_start.size(); i++) {
+        cell_start[i] += cell_start[i - 1];
+    }
+    cell_trapezoids.resize(cell_start.back());
+    std::vector<uint32_t> next(cell_start.begin(), cell_start.end() - 1);
+    for (uint32_t i = 0; i < trapezoids.size(); i++) {
+        for_each_cell(trapezoids[i], [&](const size_t cell) {
+            cell_trapezoids[next[cell]++] = i;
+        });
+    }
+}
+
+bool PathingIndex::Contains(const Trapezoid& trapezoid, const GW::Vec2f pos)
+{
+    const float top = std::max(trapezoid.YT, trapezoid.YB);
+    const float bottom = std::min(trapezoid.YT, trapezoid.YB);
+    if (pos.y > top + edge_tolerance || pos.y < bottom - edge_tolerance) {
+        return false;
+    }
+    // Interpolate the left and right edges at pos.y
+    const float span = trapezoid.YT - trapezoid.YB;
+    const float t = span != 0.f ? std::clamp((pos.y - trapezoid.YB) / span, 0.f, 1.f) : 0.5f;
+    const float left = trapezoid.XBL + (trapezoid.XTL - trapezoid.XBL) * t;
+    const float right = trapezoid.XBR + (trapezoid.XTR - trapezoid.XBR) * t;
+    return pos.x >= left - edge_tolerance && pos.x <= right + edge_tolerance;
+}
+
+const PathingIndex::Trapezoid* PathingIndex::Find(const GW::Vec2f pos, const uint32_t plane) const
+{
+    if (!columns) {
+        return nullptr;
+    }
+    const size_t cell = static_cast<size_t>(CellY(pos.y)) * columns + CellX(pos.x);
+    for (uint32_t j = cell_start[cell]; j < cell_start[cell + 1]; j++) {
+        const auto& t = trapezoids[cell_trapezoids[j]];
+        if (t.plane == plane && Contains(t, pos)) {
+            return &t;
+        }
+    }
+    return nullptr;
+}
+
+size_t PathingIndex::Locate(const GW::Vec2f pos, std::vector<uint32_t>& out) const
+{
+    if (!columns) {
+        return 0;
+    }
+    const size_t first = out.size();
+    const size_t cell = static_cast<size_t>(CellY(pos.y)) * columns + CellX(pos.x);
+    for (uint32_t j = cell_start[cell]; j < cell_start[cell + 1]; j++) {
+        const auto& t = trapezoids[cell_trapezoids[j]];
+        if (Contains(t, pos)) {
+            out.push_back(t.plane);
+        }
+    }
+    // Neighbouring trapezoids on the same plane both match a point on their shared edge
+    const auto begin = out.begin() + static_cast<ptrdiff_t>(first);
+    std::sort(begin, out.end());
+    out.erase(std::unique(begin, out.end()), out.end());
+    return out.size() - first;
+}
+
+size_t PathingIndex::LocateTrapezoids(const GW::Vec2f pos, std::vector<uint32_t>& out) const
+{
+    if (!columns) {
+        return 0;
+    }
+    const size_t first = out.size();
+    const size_t cell = static_cast<size_t>(CellY(pos.y)) * columns + CellX(pos.x);
+    for (uint32_t j = cell_start[cell]; j < cell_start[cell + 1]; j++) {
+        if (Contains(trapezoids[cell_trapezoids[j]], pos)) {
+            out.push_back(cell_trapezoids[j]);
+        }
+    }
+    return out.size() - first;
+}
+
+void PathingIndex::Locate(const GW::Vec2f* points, const size_t count, std::vector<uint32_t>& planes, std::vector<uint32_t>& offsets) const
+{
+    planes.clear();
+    offsets.resize(count + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        Locate(points[i], planes);
+        offsets[i + 1] = static_cast<uint32_t>(planes.size());
+    }
+}
+
+bool PathingIndex::Save(const std::filesystem::path& path, const uint32_t map_id) const
+{
+    auto tmp_path = path;
+    tmp_path += L".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(file_magic, sizeof(file_magic));
+        Write(out, file_version);
+        Write(out, map_id);
+        WriteVector(out, trapezoids);
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    return !ec;
+}
+
+bool PathingIndex::Load(const std::filesystem::path& path, uint32_t* map_id)
+{
+    Clear();
+    std::ifstream in(path, std::ios::binary);
+    std::vector<Trapezoid> loaded;
+    if (!(in && ReadHeader(in, map_id) && ReadVector(in, loaded, 0x1000000))) {
+        return false;
+    }
+    for (const auto& t : loaded) {
+        Add(t.plane, t);
+    }
+    Index();
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <GWCA/GameContainers/GamePos.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Point location over the trapezoids of a map's pathing planes (GW::PathingMapArray), using a uniform grid.
+// Answers "which planes is this point on" without asking the game about every plane, so altitudes only need to be queried
+// for the planes that can actually have one. No game dependencies; the caller copies the trapezoids in with Add().
+// The trapezoids can be saved to disk so that maps can be looked at (and the index tested) without the game running.
+class PathingIndex {
+public:
+    struct Trapezoid {
+        // Named as in GW::PathingTrapezoid: top edge from XTL to XTR at YT, bottom edge from XBL to XBR at YB
+        float XTL, XTR, YT;
+        float XBL, XBR, YB;
+        uint32_t plane;
+        uint32_t id;
+    };
+
+    void Clear();
+    void Add(uint32_t plane, const Trapezoid& trapezoid);
+    // Build the grid; call after the last Add()
+    void Index();
+
+    [[nodiscard]] bool empty() const { return trapezoids.empty(); }
+    [[nodiscard]] size_t size() const { return trapezoids.size(); }
+    [[nodiscard]] uint32_t PlaneCount() const { return plane_count; }
+    [[nodiscard]] const std::vector<Trapezoid>& Trapezoids() const { return trapezoids; }
+
+    // Trapezoid on plane containing pos, or nullptr
+    [[nodiscard]] const Trapezoid* Find(GW::Vec2f pos, uint32_t plane) const;
+    // Planes with a trapezoid containing pos, ascending, appended to out. Returns the number added.
+    size_t Locate(GW::Vec2f pos, std::vector<uint32_t>& out) const;
+    // Indices into Trapezoids() of every trapezoid containing pos, on any plane, appended to out. Returns the number added.
+    size_t LocateTrapezoids(GW::Vec2f pos, std::vector<uint32_t>& out) const;
+    // Locate() for many points at once: planes for points[i] are planes[offsets[i]] up to planes[offsets[i + 1]]
+    void Locate(const GW::Vec2f* points, size_t count, std::vector<uint32_t>& planes, std::vector<uint32_t>& offsets) const;
+
+    // Only the trapezoids are saved; the grid is rebuilt on load, which is quicker than reading and checking a saved one
+    bool Save(const std::filesystem::path& path, uint32_t map_id) const;
+    bool Load(const std::filesystem::path& path, uint32_t* map_id);
+
+private:
+    [[nodiscard]] int CellX(float x) const;
+    [[nodiscard]] int CellY(float y) const;
+    static bool Contains(const Trapezoid& trapezoid, GW::Vec2f pos);
+
+    std::vector<Trapezoid> trapezoids;
+    uint32_t plane_count = 0;
+
+    // cell_start[c]..cell_start[c + 1] indexes cell_trapezoids for cell c
+    float origin_x = 0.f;
+    float origin_y = 0.f;
+    float cell_size = 1.f;
+    int columns = 0;
+    int rows = 0;
+    std::vector<uint32_t> cell_start;
+    std::vector<uint32_t> cell_trapezoids;
+};
@@ -0,0 +1,90 @@
+#include <stdafx.h>
+
+#include <GWCA/Utilities/Scanner.h>
+
+#include <Scan.h>
+
+#include <Modules/Resources.h>
+
+#include "SignatureCache.h"
+
+namespace {
+    std::mutex mutex;
+    bool loaded = false;
+    bool save_pending = false;
+    ScanCache cache;
+    const uint8_t* image = nullptr;
+    size_t image_size = 0;
+
+    std::filesystem::path CachePath()
+    {
+        return Resources::GetPath(L"cache\\signatures.dat");
+    }
+
+    // Call with mutex held
+    void Load()
+    {
+        if (loaded) {
+            return;
+        }
+        loaded = true;
+        const auto module = GetModuleHandleW(nullptr);
+        const auto dos_header = reinterpret_cast<const IMAGE_DOS_HEADER*>(module);
+        const auto nt_headers = reinterpret_cast<const IMAGE_NT_HEADERS*>(reinterpret_cast<const uint8_t*>(module) + dos_header->e_lfanew);
+        image = reinterpret_cast<const uint8_t*>(module);
+        image_size = nt_headers->OptionalHeader.SizeOfImage;
+
+        wchar_t exe_path[MAX_PATH];
+        uint64_t exe_hash;
+        if (GetModuleFileNameW(nullptr, exe_path, _countof(exe_path)) && HashFile(exe_path, &exe_hash)) {
+            cache.Load(CachePath(), exe_hash);
+        }
+    }
+
+    // Call with mutex held. Modules scan one after the other at startup; write them all out together once they're done.
+    void QueueSave()
+    {
+        if (save_pending || !cache.IsDirty()) {
+            return;
+        }
+        save_pending = true;
+        Resources::EnqueueWorkerTask([] {
+            std::lock_guard lock(mutex);
+            save_pending = false;
+            const auto path = CachePath();
+            if (Resources::EnsureFolderExists(path.parent_path())) {
+                cache.Save(path);
+            }
+        }, TaskPool::Priority::Low);
+    }
+}
+
+uintptr_t SignatureCache::Find(const char* pattern, const char* mask, const int offset)
+{
+    // GW::Scanner takes a missing mask to mean every byte up to the first zero has to match
+    std::string full_mask;
+    if (!mask) {
+        full_mask.assign(strlen(pattern), 'x');
+        mask = full_mask.c_str();
+    }
+    const ScanPattern scan_pattern = {pattern, mask, offset};
+
+    std::unique_lock lock(mutex);
+    Load();
+    uint32_t rva;
+    if (cache.Lookup(scan_pattern, &rva) && ScanMatches(image, image_size, rva, scan_pattern)) {
+        return reinterpret_cast<uintptr_t>(image) + rva + offset;
+    }
+    // Modules preload on several workers at once; let them scan in parallel
+    lock.unlock();
+    const uintptr_t address = GW::Scanner::Find(pattern, mask, offset);
+    lock.lock();
+    if (address) {
+        cache.Store(scan_pattern, static_cast<uint32_t>(address - offset - reinterpret_cast<uintptr_t>(image)));
+    }
+    else {
+        cache.Remove(scan_pattern);
+    }
+    QueueSave();
+    return address;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// Addresses found by byte pattern, remembered between sessions for each build of Gw.exe (told apart by a hash of the
+// executable). A remembered match is checked against the pattern before it's used; anything not remembered, or no
+// longer matching, is searched for with GW::Scanner as before.
+namespace SignatureCache {
+    // Drop-in for GW::Scanner::Find over the .text section
+    uintptr_t Find(const char* pattern, const char* mask = nullptr, int offset = 0);
+}
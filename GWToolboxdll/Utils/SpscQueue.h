@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Lock-free single producer, single consumer queue of T with a fixed capacity. Push and Pop move whole values in and
+// out; nothing allocates after construction apart from whatever T's move does.
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of 2
+    explicit SpscQueue(size_t _capacity)
+    {
+        capacity = 1;
+        while (capacity < _capacity) {
+            capacity <<= 1;
+        }
+        slots = std::make_unique<T[]>(capacity);
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer. Returns false, leaving value untouched, if the queue is full.
+    bool Push(T& value)
+    {
+        const size_t head = write_pos.load(std::memory_order_relaxed);
+        if (head - read_pos.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        slots[head & (capacity - 1)] = std::move(value);
+        write_pos.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer. Returns false if there's nothing to pop.
+    bool Pop(T& out)
+    {
+        const size_t tail = read_pos.load(std::memory_order_relaxed);
+        if (tail == write_pos.load(std::memory_order_acquire)) {
+            return false;
+        }
+        T& slot = slots[tail & (capacity - 1)];
+        out = std::move(slot);
+        slot = T();
+        read_pos.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool Empty() const { return read_pos.load(std::memory_order_acquire) == write_pos.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<T[]> slots;
+    size_t capacity = 0;
+    // Both only ever increase; masked with capacity - 1 to index slots
+    alignas(64) std::atomic<size_t> write_pos = 0;
+    alignas(64) std::atomic<size_t> read_pos = 0;
+};
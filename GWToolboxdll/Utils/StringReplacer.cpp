@@ -0,0 +1,147 @@
+#include <stdafx.h>
+
+#include "StringReplacer.h"
+
+uint32_t StringReplacer::Add(const std::wstring_view from, const std::wstring_view to)
+{
+    if (from.empty()) {
+        return NO_PATTERN;
+    }
+    if (nodes.empty()) {
+        nodes.emplace_back();
+    }
+    uint32_t node = 0;
+    for (const wchar_t c : from) {
+        auto& children = nodes[node].children;
+        const auto found = std::ranges::lower_bound(children, c, {}, &std::pair<wchar_t, uint32_t>::first);
+        if (found != children.end() && found->first == c) {
+            node = found->second;
+            continue;
+        }
+        const auto next = static_cast<uint32_t>(nodes.size());
+        children.emplace(found, c, next);
+        nodes.emplace_back();
+        node = next;
+        links_dirty = true;
+    }
+    if (nodes[node].pattern != NO_PATTERN) {
+        replacements[nodes[node].pattern].assign(to);
+        return nodes[node].pattern;
+    }
+    nodes[node].pattern = static_cast<uint32_t>(replacements.size());
+    pattern_lengths.push_back(static_cast<uint32_t>(from.size()));
+    replacements.emplace_back(to);
+    links_dirty = true;
+    return nodes[node].pattern;
+}
+
+void StringReplacer::Clear()
+{
+    nodes.clear();
+    pattern_lengths.clear();
+    replacements.clear();
+    links_dirty = false;
+}
+
+uint32_t StringReplacer::Child(const uint32_t node, const wchar_t c) const
+{
+    const auto& children = nodes[node].children;
+    const auto found = std::ranges::lower_bound(children, c, {}, &std::pair<wchar_t, uint32_t>::first);
+    return found != children.end() && found->first == c ? found->second : 0;
+}
+
+uint32_t StringReplacer::Step(uint32_t node, const wchar_t c) const
+{
+    uint32_t next;
+    while (!(next = Child(node, c)) && node) {
+        node = nodes[node].fail;
+    }
+    return next;
+}
+
+void StringReplacer::BuildLinks()
+{
+    // Breadth first, so every node's fail target is finished before its children need it
+    bfs_queue.clear();
+    for (const auto& [c, child] : nodes[0].children) {
+        nodes[child].fail = 0;
+        nodes[child].next_match = 0;
+        bfs_queue.push_back(child);
+    }
+    for (size_t i = 0; i < bfs_queue.size(); i++) {
+        const uint32_t node = bfs_queue[i];
+        for (const auto& [c, child] : nodes[node].children) {
+            const uint32_t target = Step(nodes[node].fail, c);
+            nodes[child].fail = target;
+            nodes[child].next_match = nodes[target].pattern != NO_PATTERN ? target : nodes[target].next_match;
+            bfs_queue.push_back(child);
+        }
+    }
+    links_dirty = false;
+}
+
+bool StringReplacer::Replace(const std::wstring_view in, std::wstring& out)
+{
+    if (empty() || in.empty()) {
+        return false;
+    }
+    if (links_dirty) {
+        BuildLinks();
+    }
+
+    match_at.assign(in.size(), NO_PATTERN);
+    bool matched = false;
+    uint32_t node = 0;
+    for (size_t i = 0; i < in.size(); i++) {
+        node = Step(node, in[i]);
+        // Every pattern ending here; keep the longest one for each start position
+        for (uint32_t m = nodes[node].pattern != NO_PATTERN ? node : nodes[node].next_match; m; m = nodes[m].next_match) {
+            const uint32_t pattern = nodes[m].pattern;
+            const size_t start = i + 1 - pattern_lengths[pattern];
+            auto& best = match_at[start];
+            if (best == NO_PATTERN || pattern_lengths[best] < pattern_lengths[pattern]) {
+                best = pattern;
+            }
+            matched = true;
+        }
+    }
+    if (!matched) {
+        return false;
+    }
+
+    // Build into our own buffer; in may point into out
+    buffer.clear();
+    for (size_t i = 0; i < in.size();) {
+        const uint32_t pattern = match_at[i];
+        if (pattern == NO_PATTERN) {
+            buffer.push_back(in[i++]);
+            continue;
+        }
+        buffer.append(replacements[pattern]);
+        i += pattern_lengths[pattern];
+    }
+    out.assign(buffer);
+    return true;
+}
+
+bool StringReplacer::FindAll(const std::wstring_view in, std::vector<bool>& found)
+{
+    found.assign(replacements.size(), false);
+    if (empty() || in.empty()) {
+        return false;
+    }
+    if (links_dirty) {
+        BuildLinks();
+    }
+
+    bool matched = false;
+    uint32_t node = 0;
+    for (const wchar_t c : in) {
+        node = Step(node, c);
+        for (uint32_t m = nodes[node].pattern != NO_PATTERN ? node : nodes[node].next_match; m; m = nodes[m].next_match) {
+            found[nodes[m].pattern] = true;
+            matched = true;
+        }
+    }
+    return matched;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Replaces any number of substrings in one pass over the input using an Aho-Corasick automaton, instead of a find/replace loop
+// per pattern. Where matches overlap, the one that starts first wins, then the longest; replaced text is never searched again.
+// Patterns can be added at any time; the automaton's links are rebuilt on the next Replace() after a change.
+// Not thread safe - Replace() reuses internal buffers to avoid allocating per call.
+class StringReplacer {
+public:
+    static constexpr uint32_t NO_PATTERN = 0xffffffff;
+
+    // Replace every occurrence of from with to. Adding a pattern that already exists updates its replacement.
+    // Returns the pattern's index, or NO_PATTERN if from is empty; patterns are numbered in the order they were first added.
+    uint32_t Add(std::wstring_view from, std::wstring_view to = {});
+    void Clear();
+    [[nodiscard]] bool empty() const { return replacements.empty(); }
+    [[nodiscard]] size_t size() const { return replacements.size(); }
+
+    // Write in to out with every pattern replaced. Returns false and leaves out untouched if nothing matched.
+    bool Replace(std::wstring_view in, std::wstring& out);
+
+    // Set found[i] for every pattern i that occurs in in, without replacing anything. found is resized to size().
+    // Returns false if nothing matched.
+    bool FindAll(std::wstring_view in, std::vector<bool>& found);
+
+private:
+    struct Node {
+        // Sorted by character
+        std::vector<std::pair<wchar_t, uint32_t>> children;
+        // Longest proper suffix that is also in the trie
+        uint32_t fail = 0;
+        // Nearest node on the fail chain that ends a pattern; 0 for none (the root never does)
+        uint32_t next_match = 0;
+        uint32_t pattern = NO_PATTERN;
+    };
+
+    [[nodiscard]] uint32_t Child(uint32_t node, wchar_t c) const;
+    [[nodiscard]] uint32_t Step(uint32_t node, wchar_t c) const;
+    void BuildLinks();
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> pattern_lengths;
+    std::vector<std::wstring> replacements;
+    bool links_dirty = false;
+
+    // Pattern matched at each position of the last input, NO_PATTERN for none
+    std::vector<uint32_t> match_at;
+    std::vector<uint32_t> bfs_queue;
+    std::wstring buffer;
+};
@@ -0,0 +1,150 @@
+#include <stdafx.h>
+
+#include "TaskPool.h"
+
+namespace {
+    // Index of the worker running on this thread, used to keep follow-up tasks local to the worker that spawned them
+    thread_local const TaskPool* current_pool = nullptr;
+    thread_local size_t current_worker = 0;
+}
+
+TaskPool::~TaskPool()
+{
+    Stop();
+}
+
+void TaskPool::Start(const size_t num_workers)
+{
+    std::unique_lock lock(wake_mutex);
+    if (!workers.empty() || !num_workers) {
+        return;
+    }
+    should_stop = false;
+    stop_when_idle = false;
+    for (size_t i = 0; i < num_workers; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // Anything enqueued before we started goes to the first worker; the others will steal it
+    for (auto& [priority, queued] : unassigned) {
+        workers[0]->queues[static_cast<size_t>(priority)].push_back(std::move(queued));
+        pending++;
+    }
+    unassigned.clear();
+    for (size_t i = 0; i < num_workers; i++) {
+        workers[i]->thread = std::thread([this, i] {
+            WorkerLoop(i);
+        });
+    }
+}
+
+void TaskPool::RequestStop()
+{
+    {
+        std::unique_lock lock(wake_mutex);
+        stop_when_idle = true;
+    }
+    wake_cv.notify_all();
+}
+
+void TaskPool::Stop()
+{
+    {
+        std::unique_lock lock(wake_mutex);
+        should_stop = true;
+    }
+    wake_cv.notify_all();
+    if (current_pool == this) {
+        // A worker can't join itself, and clearing workers would free the Worker it's still running on
+        return;
+    }
+    for (const auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    std::unique_lock lock(wake_mutex);
+    workers.clear();
+    unassigned.clear();
+    pending = 0;
+}
+
+void TaskPool::Enqueue(Task task, const Priority priority, CancellationToken token)
+{
+    if (!task) {
+        return;
+    }
+    {
+        std::unique_lock lock(wake_mutex);
+        if (workers.empty()) {
+            unassigned.emplace_back(priority, QueuedTask{std::move(task), std::move(token)});
+            return;
+        }
+        // Tasks spawned by a worker stay on that worker's deque; everything else is dealt out round robin
+        const size_t idx = current_pool == this ? current_worker : next_worker++ % workers.size();
+        const auto& worker = workers[idx];
+        {
+            std::unique_lock worker_lock(worker->mutex);
+            worker->queues[static_cast<size_t>(priority)].push_back({std::move(task), std::move(token)});
+        }
+        pending++;
+    }
+    wake_cv.notify_one();
+}
+
+bool TaskPool::TryPop(const size_t worker_idx, QueuedTask& out)
+{
+    const size_t num_workers = workers.size();
+    // Higher priority work anywhere in the pool beats lower priority work on our own deque
+    for (size_t p = 0; p < static_cast<size_t>(Priority::Count); p++) {
+        {
+            const auto& own = workers[worker_idx];
+            std::unique_lock lock(own->mutex);
+            auto& queue = own->queues[p];
+            if (!queue.empty()) {
+                out = std::move(queue.front());
+                queue.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < num_workers; i++) {
+            const auto& victim = workers[(worker_idx + i) % num_workers];
+            std::unique_lock lock(victim->mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                continue;
+            }
+            auto& queue = victim->queues[p];
+            if (!queue.empty()) {
+                out = std::move(queue.back());
+                queue.pop_back();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskPool::WorkerLoop(const size_t worker_idx)
+{
+    current_pool = this;
+    current_worker = worker_idx;
+    QueuedTask queued;
+    while (!should_stop) {
+        if (TryPop(worker_idx, queued)) {
+            pending--;
+            if (!(queued.token && *queued.token)) {
+                queued.task();
+            }
+            queued = {};
+            continue;
+        }
+        std::unique_lock lock(wake_mutex);
+        if (stop_when_idle && !pending) {
+            break;
+        }
+        // Enqueue bumps pending while holding wake_mutex, so checking it here can't miss a wakeup
+        wake_cv.wait(lock, [this] {
+            return should_stop || stop_when_idle || pending > 0;
+        });
+    }
+    current_pool = nullptr;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed size pool of worker threads. Each worker owns a deque of tasks per priority; idle workers steal from the back of
+// other workers' deques before blocking on a condition variable, so a freshly enqueued task starts as soon as any worker is free.
+// No game or windows dependencies; keep it that way so it can be built and profiled outside of the dll.
+class TaskPool {
+public:
+    // Lower value runs first. High is for anything the user is waiting to see e.g. texture fetches.
+    enum class Priority : uint8_t {
+        High,
+        Normal,
+        Low,
+        Count
+    };
+
+    // Set to true to skip a task that hasn't started yet; long-running tasks can poll it themselves.
+    using CancellationToken = std::shared_ptr<std::atomic_bool>;
+    using Task = std::function<void()>;
+
+    TaskPool() = default;
+    ~TaskPool();
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Spin up worker threads. No-op if already running.
+    void Start(size_t num_workers);
+    // Signal workers to exit after their current task, then join them. Any queued tasks are discarded.
+    // From one of the pool's own tasks this only signals; the owner still has to call Stop() (or destroy the pool) to join them.
+    void Stop();
+    // Ask workers to exit once they run out of work, without blocking the caller.
+    void RequestStop();
+
+    void Enqueue(Task task, Priority priority = Priority::Normal, CancellationToken token = nullptr);
+
+    [[nodiscard]] static CancellationToken MakeCancellationToken() { return std::make_shared<std::atomic_bool>(false); }
+    [[nodiscard]] size_t Pending() const { return pending; }
+    [[nodiscard]] bool IsRunning() const { return !workers.empty(); }
+
+private:
+    struct QueuedTask {
+        Task task;
+        CancellationToken token;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QueuedTask> queues[static_cast<size_t>(Priority::Count)];
+        std::thread thread;
+    };
+
+    bool TryPop(size_t worker_idx, QueuedTask& out);
+    void WorkerLoop(size_t worker_idx);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    // Tasks enqueued before Start() is called; handed to the first worker on startup. Guarded by wake_mutex.
+    std::deque<std::pair<Priority, QueuedTask>> unassigned;
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic<size_t> pending = 0;
+    std::atomic<size_t> next_worker = 0;
+    std::atomic_bool should_stop = false;
+    std::atomic_bool stop_when_idle = false;
+};
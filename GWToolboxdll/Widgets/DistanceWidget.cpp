@@ -7,9 +7,17 @@
 #include <GWCA/Managers/MapMgr.h>
 
 #include <Defines.h>
+#include <Timer.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/MapPathing.h>
 #include <Widgets/DistanceWidget.h>
 
+namespace {
+    // Walking distance is a path search, so don't redo it every frame
+    float walk_distance = -1.f;
+    clock_t walk_distance_updated = 0;
+}
+
 void DistanceWidget::DrawSettingsInternal()
 {
     ImGui::SameLine();
@@ -18,6 +26,9 @@ void DistanceWidget::DrawSettingsInternal()
     ImGui::Checkbox("Show percentage value", &show_perc_value);
     ImGui::SameLine();
     ImGui::Checkbox("Show absolute value", &show_abs_value);
+    ImGui::SameLine();
+    ImGui::Checkbox("Show walking distance", &show_walk_value);
+    ImGui::ShowHelp("Distance you'd have to walk to reach the target, going around walls and obstacles");
     Colors::DrawSettingHueWheel("Adjacent Range", &color_adjacent, 0);
     Colors::DrawSettingHueWheel("Nearby Range", &color_nearby, 0);
     Colors::DrawSettingHueWheel("Area Range", &color_area, 0);
@@ -33,6 +44,7 @@ void DistanceWidget::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(hide_in_outpost);
     LOAD_BOOL(show_perc_value);
     LOAD_BOOL(show_abs_value);
+    LOAD_BOOL(show_walk_value);
     LOAD_COLOR(color_adjacent);
     LOAD_COLOR(color_nearby);
     LOAD_COLOR(color_area);
@@ -48,6 +60,7 @@ void DistanceWidget::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(hide_in_outpost);
     SAVE_BOOL(show_perc_value);
     SAVE_BOOL(show_abs_value);
+    SAVE_BOOL(show_walk_value);
     SAVE_COLOR(color_adjacent);
     SAVE_COLOR(color_nearby);
     SAVE_COLOR(color_area);
@@ -65,7 +78,7 @@ void DistanceWidget::Draw(IDirect3DDevice9*)
     if (hide_in_outpost && GW::Map::GetInstanceType() == GW::Constants::InstanceType::Outpost) {
         return;
     }
-    if (!show_perc_value && !show_abs_value) {
+    if (!show_perc_value && !show_abs_value && !show_walk_value) {
         return;
     }
     ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0, 0, 0, 0));
@@ -77,6 +90,7 @@ void DistanceWidget::Draw(IDirect3DDevice9*)
             constexpr size_t buffer_size = 32;
             static char dist_perc[buffer_size];
             static char dist_abs[buffer_size];
+            static char dist_walk[buffer_size];
             const float dist = GetDistance(me->pos, target->pos);
             if (show_perc_value) {
                 snprintf(dist_perc, buffer_size, "%2.0f %s", dist * 100 / GW::Constants::Range::Compass, "%%");
@@ -84,6 +98,18 @@ void DistanceWidget::Draw(IDirect3DDevice9*)
             if (show_abs_value) {
                 snprintf(dist_abs, buffer_size, "%.0f", dist);
             }
+            if (show_walk_value) {
+                if (TIMER_DIFF(walk_distance_updated) > 250) {
+                    walk_distance_updated = TIMER_INIT();
+                    walk_distance = MapPathing::WalkDistance(me->pos, target->pos);
+                }
+                if (walk_distance >= 0.f) {
+                    snprintf(dist_walk, buffer_size, "Walk %.0f", walk_distance);
+                }
+                else {
+                    snprintf(dist_walk, buffer_size, "Walk -");
+                }
+            }
 
             ImColor color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
             if (dist <= GW::Constants::Range::Adjacent) {
@@ -139,6 +165,17 @@ void DistanceWidget::Draw(IDirect3DDevice9*)
                 ImGui::Text(dist_abs);
                 ImGui::PopFont();
             }
+
+            // walk
+            if (show_walk_value) {
+                ImGui::PushFont(GetFont(GuiUtils::FontSize::widget_label));
+                cur = ImGui::GetCursorPos();
+                ImGui::SetCursorPos(ImVec2(cur.x + 2, cur.y + 2));
+                ImGui::TextColored(background, dist_walk);
+                ImGui::SetCursorPos(cur);
+                ImGui::Text(dist_walk);
+                ImGui::PopFont();
+            }
         }
     }
     ImGui::End();
@@ -25,6 +25,8 @@ public:
     bool hide_in_outpost = false;
     bool show_abs_value = true;
     bool show_perc_value = true;
+    // Distance around walls etc, from the navigation mesh
+    bool show_walk_value = false;
 
     Color color_adjacent = 0xFFFFFFFF;
     Color color_nearby = 0xFFFFFFFF;
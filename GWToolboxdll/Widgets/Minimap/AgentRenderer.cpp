@@ -18,6 +18,7 @@
 #include <GWCA/Managers/StoCMgr.h>
 
 #include <Defines.h>
+#include <Utils/AgentSnapshot.h>
 #include <Utils/GuiUtils.h>
 
 #include <Modules/Resources.h>
@@ -694,30 +695,27 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
     }
 
     // 1. eoes
-    for (GW::Agent* agent_ptr : *agents) {
-        if (!agent_ptr) {
+    const auto& snapshot = AgentSnapshot::Get();
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        if (!snapshot.Is(i, AgentSnapshot::Living) || snapshot.Is(i, AgentSnapshot::Dead)) {
             continue;
         }
-        const GW::AgentLiving* agent = agent_ptr->GetAsAgentLiving();
-        if (!agent) {
-            continue;
-        }
-        if (agent->GetIsDead()) {
-            continue;
-        }
-        switch (agent->player_number) {
+        Color color;
+        switch (snapshot.model_ids[i]) {
             case GW::Constants::ModelID::EoE:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_eoe);
+                color = color_eoe;
                 break;
             case GW::Constants::ModelID::QZ:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_qz);
+                color = color_qz;
                 break;
             case GW::Constants::ModelID::Winnowing:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_winnowing);
+                color = color_winnowing;
                 break;
             default:
-                break;
+                continue;
         }
+        // Circles don't need the agent's rotation
+        Enqueue(BigCircle, RenderPosition{1.f, 0.f, snapshot.positions[i]}, GW::Constants::Range::Spirit, color, color_agent_modifier);
     }
     // 2. non-player agents
     static std::vector<std::pair<const GW::Agent*, const CustomAgent*>> custom_agents_to_draw;
@@ -0,0 +1,145 @@
+#include "stdafx.h"
+
+#include <Widgets/Minimap/AoeEffectPool.h>
+
+namespace {
+    struct UnitCircle {
+        float x[AoeEffectPool::circle_segments + 1];
+        float y[AoeEffectPool::circle_segments + 1];
+
+        UnitCircle()
+        {
+            for (size_t i = 0; i < AoeEffectPool::circle_segments; i++) {
+                const float angle = static_cast<float>(i) * (DirectX::XM_2PI / AoeEffectPool::circle_segments);
+                x[i] = std::cos(angle);
+                y[i] = std::sin(angle);
+            }
+            x[AoeEffectPool::circle_segments] = x[0];
+            y[AoeEffectPool::circle_segments] = y[0];
+        }
+    };
+
+    const UnitCircle unit_circle;
+}
+
+size_t AoeEffectPool::Add(const uint32_t effect_id, const GW::Vec2f pos, const float range, const uint32_t color, const clock_t now, const uint32_t duration)
+{
+    size_t slot;
+    if (free_slots.empty()) {
+        slot = slots.size();
+        slots.emplace_back();
+    }
+    else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+    Slot& s = slots[slot];
+    s.effect = {effect_id, pos, range, color, now, duration};
+    s.generation++;
+    s.active_index = active.size();
+    active.push_back(static_cast<uint32_t>(slot));
+    Schedule(slot);
+    return slot;
+}
+
+void AoeEffectPool::Retime(const size_t slot, const clock_t now, const uint32_t duration, const float range)
+{
+    Slot& s = slots[slot];
+    if (s.active_index == npos) {
+        return;
+    }
+    s.effect.start = now;
+    s.effect.duration = duration;
+    s.effect.range = range;
+    // The old heap entry is left in place and skipped when it comes up
+    s.generation++;
+    Schedule(slot);
+}
+
+bool AoeEffectPool::ExpiresLater(const Expiry& a, const Expiry& b)
+{
+    return a.end > b.end;
+}
+
+void AoeEffectPool::Schedule(const size_t slot)
+{
+    const Slot& s = slots[slot];
+    expiries.push_back({s.effect.start + static_cast<clock_t>(s.effect.duration), static_cast<uint32_t>(slot), s.generation});
+    std::ranges::push_heap(expiries, ExpiresLater);
+}
+
+void AoeEffectPool::Remove(const size_t slot)
+{
+    Slot& s = slots[slot];
+    // Swap with the last active slot
+    const uint32_t moved = active.back();
+    active[s.active_index] = moved;
+    slots[moved].active_index = s.active_index;
+    active.pop_back();
+    s.active_index = npos;
+    s.generation++;
+    free_slots.push_back(static_cast<uint32_t>(slot));
+}
+
+size_t AoeEffectPool::Expire(const clock_t now)
+{
+    size_t removed = 0;
+    // Same as TIMER_DIFF(start) > duration
+    while (!expiries.empty() && expiries.front().end < now) {
+        std::ranges::pop_heap(expiries, ExpiresLater);
+        const Expiry expiry = expiries.back();
+        expiries.pop_back();
+        if (slots[expiry.slot].generation != expiry.generation) {
+            continue; // Retimed or already removed
+        }
+        Remove(expiry.slot);
+        removed++;
+    }
+    return removed;
+}
+
+void AoeEffectPool::Clear()
+{
+    // Keep the generations so any handles held onto don't match a new effect
+    free_slots.clear();
+    for (size_t i = slots.size(); i-- > 0;) {
+        slots[i].active_index = npos;
+        slots[i].generation++;
+        free_slots.push_back(static_cast<uint32_t>(i));
+    }
+    active.clear();
+    expiries.clear();
+}
+
+size_t AoeEffectPool::FindNearest(const uint32_t effect_id, const GW::Vec2f pos, const float max_square_distance) const
+{
+    size_t closest = npos;
+    float closest_distance = max_square_distance;
+    for (const uint32_t slot : active) {
+        const Effect& effect = slots[slot].effect;
+        if (effect.effect_id != effect_id) {
+            continue;
+        }
+        const float distance = GetSquareDistance(pos, effect.pos);
+        if (distance > closest_distance) {
+            continue;
+        }
+        closest = slot;
+        closest_distance = distance;
+    }
+    return closest;
+}
+
+size_t AoeEffectPool::WriteVertices(D3DVertex* out, const size_t max_vertices) const
+{
+    const size_t count = std::min(active.size(), max_vertices / vertices_per_effect);
+    for (size_t i = 0; i < count; i++) {
+        const Effect& effect = slots[active[i]].effect;
+        for (size_t j = 0; j < circle_segments; j++) {
+            out[0] = {effect.pos.x + unit_circle.x[j] * effect.range, effect.pos.y + unit_circle.y[j] * effect.range, 0.f, effect.color};
+            out[1] = {effect.pos.x + unit_circle.x[j + 1] * effect.range, effect.pos.y + unit_circle.y[j + 1] * effect.range, 0.f, effect.color};
+            out += 2;
+        }
+    }
+    return count * vertices_per_effect;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <GWCA/GameContainers/GamePos.h>
+
+#include <Widgets/Minimap/D3DVertex.h>
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// Storage and geometry for the AoE rings drawn by EffectRenderer, kept free of any D3D device calls.
+// Effects live in a pool of reusable slots and are expired through a min-heap on their end time, so adding, retiming and
+// expiring an effect never shifts the others around. WriteVertices() turns every active effect into line list vertices
+// so that the renderer can draw them all with one call.
+// Not thread safe; EffectRenderer guards it with its own mutex.
+class AoeEffectPool {
+public:
+    struct Effect {
+        uint32_t effect_id = 0;
+        GW::Vec2f pos;
+        float range = 0.f;
+        uint32_t color = 0;
+        clock_t start = 0;
+        uint32_t duration = 0;
+    };
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    // Line segments per ring
+    static constexpr size_t circle_segments = 16;
+    static constexpr size_t vertices_per_effect = circle_segments * 2;
+
+    size_t Add(uint32_t effect_id, GW::Vec2f pos, float range, uint32_t color, clock_t now, uint32_t duration);
+    // Restart the effect in slot with a new duration and range, e.g. when a trap is triggered
+    void Retime(size_t slot, clock_t now, uint32_t duration, float range);
+    // Remove every effect that has run for longer than its duration; returns how many were removed
+    size_t Expire(clock_t now);
+    void Clear();
+
+    // Slot of the closest active effect with this id within sqrt(max_square_distance) of pos, or npos
+    [[nodiscard]] size_t FindNearest(uint32_t effect_id, GW::Vec2f pos, float max_square_distance) const;
+    [[nodiscard]] const Effect& Get(const size_t slot) const { return slots[slot].effect; }
+
+    [[nodiscard]] size_t size() const { return active.size(); }
+    [[nodiscard]] bool empty() const { return active.empty(); }
+
+    // Write up to max_vertices line list vertices for the active effects, in world coordinates. Only whole rings are written.
+    size_t WriteVertices(D3DVertex* out, size_t max_vertices) const;
+
+private:
+    struct Slot {
+        Effect effect;
+        // Bumped whenever the slot is retimed or reused, so stale heap entries can be told apart
+        uint32_t generation = 0;
+        // Position in active, or npos if the slot is free
+        size_t active_index = npos;
+    };
+
+    struct Expiry {
+        clock_t end;
+        uint32_t slot;
+        uint32_t generation;
+    };
+
+    static bool ExpiresLater(const Expiry& a, const Expiry& b);
+    void Schedule(size_t slot);
+    void Remove(size_t slot);
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> free_slots;
+    // Slots in use, unordered
+    std::vector<uint32_t> active;
+    // Min-heap on Expiry::end
+    std::vector<Expiry> expiries;
+};
@@ -13,6 +13,7 @@
 #include <Color.h>
 #include <Timer.h>
 #include <Utils/GuiUtils.h>
+#include <Widgets/Minimap/AoeEffectPool.h>
 #include <Widgets/Minimap/EffectRenderer.h>
 
 namespace {
@@ -33,32 +34,6 @@ namespace {
         Churning_earth       = 994
     };
 
-    class EffectCircle : public VBuffer {
-        void Initialize(IDirect3DDevice9* device) override;
-
-    public:
-        Color* color = nullptr;
-        float range = GW::Constants::Range::Adjacent;
-    };
-
-    struct Effect {
-        Effect(const uint32_t _effect_id, const float _x, const float _y, const uint32_t _duration,
-               const float range, Color* _color)
-            : start(TIMER_INIT())
-            , effect_id(_effect_id)
-            , pos(_x, _y)
-            , duration(_duration)
-        {
-            circle.range = range;
-            circle.color = _color;
-        }
-        clock_t start;
-        const uint32_t effect_id;
-        const GW::Vec2f pos;
-        uint32_t duration;
-        EffectCircle circle;
-    };
-
     struct pair_hash {
         template <class T1, class T2>
         size_t operator()(const std::pair<T1, T2>& pair) const
@@ -69,7 +44,9 @@ namespace {
 
     bool need_to_clear_effects = false;
 
-    std::recursive_mutex effects_mutex;
+    // Packet callbacks add effects from the game thread while the minimap draws them
+    std::mutex effects_mutex;
+    AoeEffectPool aoe_effects;
 
     struct EffectSettings {
         Color color = 0xFFFF0000;
@@ -97,13 +74,21 @@ namespace {
             : triggered_effect_id(_triggered_effect_id), duration(_duration), range(_range) { }
     };
 
-    std::vector<Effect*> aoe_effects;
     std::unordered_map<uint32_t, EffectSettings*> aoe_effect_settings;
     std::unordered_map<uint32_t, EffectTrigger*> aoe_effect_triggers;
 
     GW::HookEntry StoC_Hook;
 
-    unsigned int vertices_max = 0x1000; // max number of vertices to draw in one call
+    void ClearEffects()
+    {
+        std::lock_guard lock(effects_mutex);
+        aoe_effects.Clear();
+        for (const auto& trigger : aoe_effect_triggers) {
+            trigger.second->triggers_handled.clear();
+        }
+    }
+
+    size_t vertices_max = 0x1000; // grows when there are more effects than fit
 }
 
 void EffectRenderer::LoadDefaults()
@@ -140,13 +125,7 @@ void EffectRenderer::Terminate()
 void EffectRenderer::Invalidate()
 {
     VBuffer::Invalidate();
-    for (const auto p : aoe_effects) {
-        delete p;
-    }
-    aoe_effects.clear();
-    for (const auto& trigger : aoe_effect_triggers) {
-        trigger.second->triggers_handled.clear();
-    }
+    ClearEffects();
 }
 
 void EffectRenderer::LoadSettings(const ToolboxIni* ini, const char* section)
@@ -199,26 +178,11 @@ void EffectRenderer::RemoveTriggeredEffect(const uint32_t effect_id, GW::Vec2f*
     }
     trigger->triggers_handled.emplace(posp, TIMER_INIT());
     std::lock_guard lock(effects_mutex);
-    Effect* closest = nullptr;
-    float closestDistance = GW::Constants::SqrRange::Nearby;
-    for (size_t i = 0; i < aoe_effects.size(); i++) {
-        Effect* effect = aoe_effects[i];
-        if (!effect || effect->effect_id != settings->effect_id) {
-            continue;
-        }
-        // Need to estimate position; player may have moved on cast slightly.
-        const float newDistance = GetSquareDistance(*pos, effect->pos);
-        if (newDistance > closestDistance) {
-            continue;
-        }
-        closest = effect;
-        closestDistance = newDistance;
-    }
-    if (closest) {
+    // Need to estimate position; player may have moved on cast slightly.
+    const size_t closest = aoe_effects.FindNearest(settings->effect_id, *pos, GW::Constants::SqrRange::Nearby);
+    if (closest != AoeEffectPool::npos) {
         // Trigger this trap to time out in 2 seconds' time. Increase damage radius from adjacent to nearby.
-        closest->start = TIMER_INIT();
-        closest->duration = trigger->duration;
-        closest->circle.range = trigger->range;
+        aoe_effects.Retime(closest, TIMER_INIT(), trigger->duration, trigger->range);
     }
 }
 
@@ -243,7 +207,8 @@ void EffectRenderer::PacketCallback(const GW::Packet::StoC::GenericValue* pak) c
     if (!caster || caster->allegiance != GW::Constants::Allegiance::Enemy) {
         return;
     }
-    aoe_effects.push_back(new Effect(pak->value, caster->pos.x, caster->pos.y, settings->duration, settings->range, &settings->color));
+    std::lock_guard lock(effects_mutex);
+    aoe_effects.Add(pak->value, caster->pos, settings->range, settings->color, TIMER_INIT(), settings->duration);
 }
 
 void EffectRenderer::PacketCallback(const GW::Packet::StoC::GenericValueTarget* pak) const
@@ -274,7 +239,8 @@ void EffectRenderer::PacketCallback(const GW::Packet::StoC::GenericValueTarget*
     if (!target) {
         return;
     }
-    aoe_effects.push_back(new Effect(pak->value, target->pos.x, target->pos.y, settings->duration, settings->range, &settings->color));
+    std::lock_guard lock(effects_mutex);
+    aoe_effects.Add(pak->value, target->pos, settings->range, settings->color, TIMER_INIT(), settings->duration);
 }
 
 void EffectRenderer::PacketCallback(GW::Packet::StoC::PlayEffect* pak) const
@@ -297,7 +263,8 @@ void EffectRenderer::PacketCallback(GW::Packet::StoC::PlayEffect* pak) const
     if (!a || a->allegiance != GW::Constants::Allegiance::Enemy) {
         return;
     }
-    aoe_effects.push_back(new Effect(pak->effect_id, pak->coords.x, pak->coords.y, settings->duration, settings->range, &settings->color));
+    std::lock_guard lock(effects_mutex);
+    aoe_effects.Add(pak->effect_id, pak->coords, settings->range, settings->color, TIMER_INIT(), settings->duration);
 }
 
 void EffectRenderer::Initialize(IDirect3DDevice9* device)
@@ -311,7 +278,8 @@ void EffectRenderer::Initialize(IDirect3DDevice9* device)
     const HRESULT hr = device->CreateVertexBuffer(sizeof(D3DVertex) * vertices_max, 0,
                                                   D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
     if (FAILED(hr)) {
-        printf("Error setting up PingsLinesRenderer vertex buffer: HRESULT: 0x%lX\n", hr);
+        printf("Error setting up EffectRenderer vertex buffer: HRESULT: 0x%lX\n", hr);
+        buffer = nullptr;
     }
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(&StoC_Hook, [&](GW::HookStatus*, GW::Packet::StoC::GameSrvTransfer*) {
         need_to_clear_effects = true;
@@ -327,57 +295,45 @@ void EffectRenderer::Render(IDirect3DDevice9* device)
 void EffectRenderer::DrawAoeEffects(IDirect3DDevice9* device)
 {
     if (need_to_clear_effects) {
-        Invalidate();
+        ClearEffects();
         need_to_clear_effects = false;
     }
+    std::lock_guard lock(effects_mutex);
+    aoe_effects.Expire(TIMER_INIT());
     if (aoe_effects.empty()) {
         return;
     }
-    std::lock_guard lock(effects_mutex);
-    size_t effect_size = aoe_effects.size();
-    for (size_t i = 0; i < effect_size; i++) {
-        Effect* effect = aoe_effects[i];
-        if (!effect) {
-            continue;
+    const size_t vertices_needed = aoe_effects.size() * AoeEffectPool::vertices_per_effect;
+    if (vertices_needed > vertices_max) {
+        if (buffer) {
+            buffer->Release();
+            buffer = nullptr;
         }
-        if (TIMER_DIFF(effect->start) > static_cast<clock_t>(effect->duration)) {
-            aoe_effects.erase(aoe_effects.begin() + static_cast<int>(i));
-            delete effect;
-            i--;
-            effect_size--;
-            continue;
+        while (vertices_max < vertices_needed) {
+            vertices_max *= 2;
+        }
+        const HRESULT hr = device->CreateVertexBuffer(sizeof(D3DVertex) * vertices_max, 0,
+                                                      D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
+        if (FAILED(hr)) {
+            printf("Error resizing EffectRenderer vertex buffer: HRESULT: 0x%lX\n", hr);
+            buffer = nullptr;
         }
-        const auto translate = DirectX::XMMatrixTranslation(effect->pos.x, effect->pos.y, 0.0f);
-        const auto scale = DirectX::XMMatrixScaling(effect->circle.range, effect->circle.range, 1.0f);
-        auto world = scale * translate;
-        device->SetTransform(D3DTS_WORLD, reinterpret_cast<D3DMATRIX*>(&world));
-        effect->circle.Render(device);
     }
-}
-
-void EffectCircle::Initialize(IDirect3DDevice9* device)
-{
-    type = D3DPT_LINESTRIP;
-    count = 16; // polycount
-    const auto vertex_count = count + 1;
-    D3DVertex* vertices = nullptr;
-
-    if (buffer) {
-        buffer->Release();
+    if (!buffer) {
+        return;
     }
-    device->CreateVertexBuffer(sizeof(D3DVertex) * vertex_count, 0,
-                               D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-    buffer->Lock(0, sizeof(D3DVertex) * vertex_count,
-                 (VOID**)&vertices, D3DLOCK_DISCARD);
-
-    for (size_t i = 0; i < count; i++) {
-        const float angle = i * (DirectX::XM_2PI / count);
-        vertices[i].x = std::cos(angle);
-        vertices[i].y = std::sin(angle);
-        vertices[i].z = 0.0f;
-        vertices[i].color = *color;
+    D3DVertex* vertices = nullptr;
+    if (const HRESULT res = buffer->Lock(0, sizeof(D3DVertex) * vertices_max, reinterpret_cast<void**>(&vertices), D3DLOCK_DISCARD); FAILED(res)) {
+        printf("EffectRenderer Lock() error: HRESULT: 0x%lX\n", res);
+        return;
     }
-    vertices[count] = vertices[0];
-
+    const size_t vertices_count = aoe_effects.WriteVertices(vertices, vertices_max);
     buffer->Unlock();
+
+    // Rings are written in world coordinates, so every effect goes in the one draw call
+    const auto identity = DirectX::XMMatrixIdentity();
+    device->SetTransform(D3DTS_WORLD, reinterpret_cast<const D3DMATRIX*>(&identity));
+    device->SetFVF(D3DFVF_CUSTOMVERTEX);
+    device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
+    device->DrawPrimitive(type, 0, vertices_count / 2);
 }
@@ -9,6 +9,8 @@
 #include <GWCA/Managers/RenderMgr.h>
 
 #include <Defines.h>
+#include <Utils/MapPathing.h>
+#include <Utils/PathingIndex.h>
 #include <Widgets/Minimap/GameWorldRenderer.h>
 #include <Widgets/Minimap/Minimap.h>
 
@@ -117,38 +119,44 @@ void GameWorldRenderer::GenericPolyRenderable::Draw(IDirect3DDevice9* device)
     if (!all_altitudes_queried) {
         // altitudes (Z value) for each vertex can't be known until we are in the correct map,
         // so these are dynamically computed, one-time.
-        float altitude = ALTITUDE_UNKNOWN;
-
-        // in order to properly query altitudes, we have to use the pathing map
-        // to determine the number of Z planes in the current map.
-        const GW::PathingMapArray* pathing_map = GW::Map::GetPathingMap();
-        if (pathing_map != nullptr) {
-            const size_t pmap_size = pathing_map->size();
-            if (pmap_size > 0) {
-                for (size_t i = 0; i < vertices.size(); i++) {
-                    // until we have a better solution, all Z planes will be queried per vertex
-                    // to avoid a significant delay in the render thread, query one plane per frame
-                    // until all have been queried. this might result in some renderables shifting
-                    // not appearing for a while on first map load, but IMO is better than stalling.
-                    // It seems to take, even in most extreme cases, less time than it takes for agents
-                    // to appear.
-                    GW::Map::QueryAltitude({vertices[i].x, vertices[i].y, cur_altitude}, 0.1f, altitude);
+        // Only the planes that have a trapezoid under the vertex are asked for an altitude, so every vertex
+        // can be done in the same frame instead of spreading the queries for every plane over several frames.
+        if (const auto index = MapPathing::GetIndex()) {
+            std::vector<GW::Vec2f> positions(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++) {
+                positions[i] = {vertices[i].x, vertices[i].y};
+            }
+            std::vector<uint32_t> planes;
+            std::vector<uint32_t> offsets;
+            index->Locate(positions.data(), positions.size(), planes, offsets);
+            for (size_t i = 0; i < vertices.size(); i++) {
+                const auto query = [&](const uint32_t plane) {
+                    float altitude = ALTITUDE_UNKNOWN;
+                    GW::Map::QueryAltitude({vertices[i].x, vertices[i].y, plane}, 0.1f, altitude);
                     if (altitude < vertices[i].z) {
                         // recall that the Up camera component is inverted
                         vertices[i].z = altitude;
                     }
-                }
-                if (cur_altitude++ == pmap_size - 1) {
-                    all_altitudes_queried = true;
-                    // commit the completed vertices to vram
-                    void* mem_loc = nullptr;
-                    // map the vertex buffer memory and write vertices to it.
-                    if (vb->Lock(0, vertices.size() * sizeof(D3DVertex), &mem_loc, D3DLOCK_DISCARD) == S_OK && mem_loc != nullptr) {
-                        // this should avoid an invalid memcpy, if locking fails for some reason
-                        memcpy(mem_loc, vertices.data(), vertices.size() * sizeof(D3DVertex));
-                        vb->Unlock();
+                };
+                if (offsets[i] == offsets[i + 1]) {
+                    // Off the pathing map; fall back to asking every plane
+                    for (uint32_t plane = 0; plane < index->PlaneCount(); plane++) {
+                        query(plane);
                     }
+                    continue;
                 }
+                for (uint32_t j = offsets[i]; j < offsets[i + 1]; j++) {
+                    query(planes[j]);
+                }
+            }
+            all_altitudes_queried = true;
+            // commit the completed vertices to vram
+            void* mem_loc = nullptr;
+            // map the vertex buffer memory and write vertices to it.
+            if (vb->Lock(0, vertices.size() * sizeof(D3DVertex), &mem_loc, D3DLOCK_DISCARD) == S_OK && mem_loc != nullptr) {
+                // this should avoid an invalid memcpy, if locking fails for some reason
+                memcpy(mem_loc, vertices.data(), vertices.size() * sizeof(D3DVertex));
+                vb->Unlock();
             }
         }
     }
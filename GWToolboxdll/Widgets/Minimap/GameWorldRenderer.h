@@ -21,7 +21,6 @@ public:
         std::vector<GW::Vec2f> points{};
         std::vector<D3DVertex> vertices{};
         bool filled = false;
-        unsigned int cur_altitude = 0u;
         bool all_altitudes_queried = false;
     };
 
@@ -34,7 +34,10 @@
 #include <GWCA/Utilities/Scanner.h>
 #include <ImGuiAddons.h>
 #include <Logger.h>
+#include <Utils/AgentSnapshot.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/MapPathing.h>
+#include <Utils/SignatureCache.h>
 
 #include "Minimap.h"
 #include <Defines.h>
@@ -248,13 +251,14 @@ void Minimap::Terminate()
     custom_renderer.Terminate();
     effect_renderer.Terminate();
     GameWorldRenderer::Terminate();
+    MapPathing::Terminate();
 }
 
 void Minimap::Initialize()
 {
     ToolboxWidget::Initialize();
 
-    uintptr_t address = GW::Scanner::Find("\x00\x74\x16\x6A\x27\x68\x80\x00\x00\x00\x6A\x00\x68", "xxxxxxxxxxxxx", -0x51);
+    uintptr_t address = SignatureCache::Find("\x00\x74\x16\x6A\x27\x68\x80\x00\x00\x00\x6A\x00\x68", "xxxxxxxxxxxxx", -0x51);
     if (address) {
         address = *(uintptr_t*)address;
         MouseClickCaptureDataPtr = (MouseClickCaptureData*)address;
@@ -264,11 +268,11 @@ void Minimap::Initialize()
     Log::Log("[SCAN] CaptureMouseClickTypePtr = %p\n", CaptureMouseClickTypePtr);
     Log::Log("[SCAN] MouseClickCaptureDataPtr = %p\n", MouseClickCaptureDataPtr);
 
-    DrawCompassAgentsByType_Func = (DrawCompassAgentsByType_pt)GW::Scanner::Find("\x8b\x46\x08\x8d\x5e\x18\x53", "xxxxxxx", -0xb);
+    DrawCompassAgentsByType_Func = (DrawCompassAgentsByType_pt)SignatureCache::Find("\x8b\x46\x08\x8d\x5e\x18\x53", "xxxxxxx", -0xb);
     GW::HookBase::CreateHook(DrawCompassAgentsByType_Func, OnDrawCompassAgentsByType, (void**)&DrawCompassAgentsByType_Ret);
     GW::HookBase::EnableHooks(DrawCompassAgentsByType_Func);
 
-    address = GW::Scanner::Find("\xdd\xd8\x6a\x01\x52", "xxxxx");
+    address = SignatureCache::Find("\xdd\xd8\x6a\x01\x52", "xxxxx");
     if (address) {
         show_compass_quest_marker_patch.SetPatch(address, "\xEB\xEC", 2);
     }
@@ -1156,39 +1160,19 @@ GW::Vec2f Minimap::InterfaceToWorldVector(const Vec2i pos) const
 
 void Minimap::SelectTarget(const GW::Vec2f pos)
 {
-    const auto* agents = GW::Agents::GetAgentArray();
-    if (agents == nullptr) {
-        return;
-    }
-    auto distance = 600.0f * 600.0f;
-    const GW::Agent* closest = nullptr;
-
-    for (const auto* agent : *agents) {
-        if (agent == nullptr) {
-            continue;
-        }
-        const auto* living = agent->GetAsAgentLiving();
-        if (living && living->GetIsDead()) {
-            continue;
-        }
-        if (agent->GetIsItemType()) {
-            continue;
-        }
-        if (agent->GetIsGadgetType() && agent->GetAsAgentGadget()->gadget_id != 8141) {
-            continue; // allow locked chests
-        }
-        if (!GW::Agents::GetIsAgentTargettable(agent)) {
-            continue; // block all useless minis
+    const auto& agents = AgentSnapshot::Get();
+    const size_t closest = agents.Nearest(pos, 600.0f, [&agents](const size_t i) {
+        if (agents.Is(i, AgentSnapshot::Dead | AgentSnapshot::Item)) {
+            return false;
         }
-        const float newDistance = GetSquareDistance(pos, agent->pos);
-        if (distance > newDistance) {
-            distance = newDistance;
-            closest = agent;
+        if (agents.Is(i, AgentSnapshot::Gadget) && agents.model_ids[i] != 8141) {
+            return false; // allow locked chests
         }
-    }
+        return agents.Is(i, AgentSnapshot::Targettable); // block all useless minis
+    });
 
-    if (closest != nullptr) {
-        GW::Agents::ChangeTarget(closest);
+    if (closest != AgentSnapshot::npos) {
+        GW::Agents::ChangeTarget(agents.agent_ids[closest]);
     }
 }
 
@@ -14,6 +14,7 @@
 
 #include <Defines.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/MapPathing.h>
 #include <Widgets/Minimap/Minimap.h>
 
 void PingsLinesRenderer::LoadSettings(const ToolboxIni* ini, const char* section)
@@ -32,6 +33,7 @@ void PingsLinesRenderer::LoadSettings(const ToolboxIni* ini, const char* section
     maxrange_interp_begin = static_cast<float>(ini->GetDoubleValue(section, VAR_NAME(maxrange_interp_begin), maxrange_interp_begin));
     maxrange_interp_end = static_cast<float>(ini->GetDoubleValue(section, VAR_NAME(maxrange_interp_end), maxrange_interp_end));
     reduce_ping_spam = ini->GetBoolValue(section, VAR_NAME(reduce_ping_spam), reduce_ping_spam);
+    color_target_path = Colors::Load(ini, section, VAR_NAME(color_target_path), color_target_path);
     Invalidate();
 }
 
@@ -45,6 +47,7 @@ void PingsLinesRenderer::SaveSettings(ToolboxIni* ini, const char* section) cons
     ini->SetDoubleValue(section, "maxrange_interp_begin", maxrange_interp_begin);
     ini->SetDoubleValue(section, "maxrange_interp_end", maxrange_interp_end);
     ini->SetBoolValue(section, VAR_NAME(reduce_ping_spam), reduce_ping_spam);
+    Colors::Save(ini, section, VAR_NAME(color_target_path), color_target_path);
 }
 
 void PingsLinesRenderer::DrawSettings()
@@ -57,6 +60,7 @@ void PingsLinesRenderer::DrawSettings()
         marker.color = Colors::ARGB(200, 128, 0, 128);
         color_shadowstep_line = Colors::ARGB(48, 128, 0, 128);
         color_shadowstep_line_maxrange = Colors::ARGB(48, 128, 0, 128);
+        color_target_path = 0;
         changed = true;
     }
     changed |= Colors::DrawSettingHueWheel("Drawings", &color_drawings);
@@ -64,6 +68,8 @@ void PingsLinesRenderer::DrawSettings()
     changed |= Colors::DrawSettingHueWheel("Shadow Step Marker", &marker.color);
     changed |= Colors::DrawSettingHueWheel("Shadow Step Line", &color_shadowstep_line);
     changed |= Colors::DrawSettingHueWheel("Shadow Step Line (Max range)", &color_shadowstep_line_maxrange);
+    Colors::DrawSettingHueWheel("Walking path to target", &color_target_path);
+    ImGui::ShowHelp("Route around walls to your current target. Set alpha to 0 to disable.");
     if (ImGui::SliderFloat("Max range start", &maxrange_interp_begin, 0.0f, 1.0f)
         && maxrange_interp_end < maxrange_interp_begin) {
         maxrange_interp_end = maxrange_interp_begin;
@@ -198,6 +204,8 @@ void PingsLinesRenderer::Render(IDirect3DDevice9* device)
 
     DrawRecallLine(device);
 
+    DrawTargetPath(device);
+
     DrawDrawings(device);
 
     const auto i = DirectX::XMMatrixIdentity();
@@ -370,6 +378,34 @@ void PingsLinesRenderer::DrawRecallLine(IDirect3DDevice9*)
     EnqueueVertex(player->pos.x, player->pos.y, c);
 }
 
+void PingsLinesRenderer::DrawTargetPath(IDirect3DDevice9*)
+{
+    if ((color_target_path & IM_COL32_A_MASK) == 0) {
+        return;
+    }
+    const GW::Agent* player = GW::Agents::GetPlayer();
+    const GW::Agent* target = GW::Agents::GetTarget();
+    if (!player || !target || player == target) {
+        target_path.clear();
+        return;
+    }
+    if (TIMER_DIFF(target_path_found) > 250) {
+        target_path_found = TIMER_INIT();
+        if (!MapPathing::FindPath(player->pos, target->pos, target_path)) {
+            target_path.clear();
+        }
+    }
+    if (target_path.size() < 2) {
+        return;
+    }
+    // Start from where the player is now rather than where they were when the path was found
+    EnqueueVertex(player->pos.x, player->pos.y, color_target_path);
+    for (size_t i = 1; i < target_path.size() - 1; i++) {
+        EnqueueVertex(target_path[i].x, target_path[i].y, color_target_path);
+        EnqueueVertex(target_path[i].x, target_path[i].y, color_target_path);
+    }
+    EnqueueVertex(target->pos.x, target->pos.y, color_target_path);
+}
 
 void PingsLinesRenderer::PingCircle::Initialize(IDirect3DDevice9* device)
 {
@@ -128,6 +128,7 @@ private:
     void DrawShadowstepMarker(IDirect3DDevice9* device);
     void DrawShadowstepLine(IDirect3DDevice9* device);
     void DrawRecallLine(IDirect3DDevice9* device);
+    void DrawTargetPath(IDirect3DDevice9* device);
     void DrawDrawings(IDirect3DDevice9* device);
     void EnqueueVertex(float x, float y, Color color);
 
@@ -170,11 +171,17 @@ private:
     float maxrange_interp_begin = 0.85f;
     float maxrange_interp_end = 0.95f;
     bool reduce_ping_spam = false;
+    // Walking path to the current target; transparent to turn off
+    Color color_target_path = 0;
 
     // for markers
     Marker marker;
     DWORD recall_target = 0;
 
+    // for the path to the target; found again every so often rather than every frame
+    std::vector<GW::Vec2f> target_path{};
+    clock_t target_path_found = 0;
+
     // for the gpu
     D3DVertex* vertices = nullptr;   // vertices array
     unsigned int vertices_count = 0; // count of vertices
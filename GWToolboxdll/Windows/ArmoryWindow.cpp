@@ -12,6 +12,8 @@
 #include <GWCA/Managers/AgentMgr.h>
 #include <GWCA/Managers/ItemMgr.h>
 
+#include <Utils/SignatureCache.h>
+
 #include <Windows/ArmoryWindow_Constants.h>
 #include <Windows/ArmoryWindow.h>
 #include <ImGuiAddons.h>
@@ -909,28 +911,18 @@ void ArmoryWindow::Draw(IDirect3DDevice9*)
     ImGui::End();
 }
 
-void ArmoryWindow::Initialize()
+void ArmoryWindow::Preload()
 {
-    ToolboxWindow::Initialize();
-
     RedrawAgentEquipment_Func = (EquipmentSlotAction_pt)GW::Scanner::FindAssertion("p:\\code\\gw\\composite\\cpsplayer.cpp", "itemData.fileId",-0x1fc);
-    if (RedrawAgentEquipment_Func) {
-        GW::Hook::CreateHook(RedrawAgentEquipment_Func, OnRedrawAgentEquipment, (void**)&RedrawAgentEquipment_Ret);
-        GW::Hook::EnableHooks(RedrawAgentEquipment_Func);
-    }
-    UndrawAgentEquipment_Func = (EquipmentSlotAction_pt)GW::Scanner::Find("\x0f\xb7\x8f\xe0\x03\x00\x00\x0f\xb7\x87\xe2\x03\x00\x00", "xxxxxxxxxxxxxx",-0x2f);
-    if (UndrawAgentEquipment_Func) {
-        GW::Hook::CreateHook(UndrawAgentEquipment_Func, OnUndrawAgentEquipment, (void**)&UndrawAgentEquipment_Ret);
-        GW::Hook::EnableHooks(UndrawAgentEquipment_Func);
-    }
+    UndrawAgentEquipment_Func = (EquipmentSlotAction_pt)SignatureCache::Find("\x0f\xb7\x8f\xe0\x03\x00\x00\x0f\xb7\x87\xe2\x03\x00\x00", "xxxxxxxxxxxxxx",-0x2f);
 
-    uintptr_t address = GW::Scanner::Find("\x81\xc6\xa0\x00\x00\x00\x83\xf8\x17", "xxxxxxxxx", -0xb);
+    uintptr_t address = SignatureCache::Find("\x81\xc6\xa0\x00\x00\x00\x83\xf8\x17", "xxxxxxxxx", -0xb);
     if (address && GW::Scanner::IsValidPtr(*(uintptr_t*)address, GW::Scanner::Section::RDATA)) {
         address = *(uintptr_t*)address;
         address -= 0xC;
         costume_data_ptr = (CostumeData*)address;
     }
-    address = GW::Scanner::Find("\x83\xc1\x28\x83\xf8\x3b", "xxxxxx", -0xf);
+    address = SignatureCache::Find("\x83\xc1\x28\x83\xf8\x3b", "xxxxxx", -0xf);
     if (address) {
         address = *(uintptr_t*)address;
         address -= 0x28;
@@ -938,6 +930,20 @@ void ArmoryWindow::Initialize()
             festival_hat_data_ptr = (FestivalHatData*)address;
         }
     }
+}
+
+void ArmoryWindow::Initialize()
+{
+    ToolboxWindow::Initialize();
+
+    if (RedrawAgentEquipment_Func) {
+        GW::Hook::CreateHook(RedrawAgentEquipment_Func, OnRedrawAgentEquipment, (void**)&RedrawAgentEquipment_Ret);
+        GW::Hook::EnableHooks(RedrawAgentEquipment_Func);
+    }
+    if (UndrawAgentEquipment_Func) {
+        GW::Hook::CreateHook(UndrawAgentEquipment_Func, OnUndrawAgentEquipment, (void**)&UndrawAgentEquipment_Ret);
+        GW::Hook::EnableHooks(UndrawAgentEquipment_Func);
+    }
     const auto equip = GetPlayerEquipment();
     if (equip) {
         memcpy(original_armor_pieces, equip->items, sizeof(original_armor_pieces));
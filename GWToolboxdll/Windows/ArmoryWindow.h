@@ -13,6 +13,7 @@ public:
     [[nodiscard]] const char* Name() const override { return "Armory"; }
     [[nodiscard]] const char* Icon() const override { return ICON_FA_VEST; }
 
+    void Preload() override;
     void Initialize() override;
     void Terminate() override;
 
@@ -24,6 +24,7 @@
 #include <ImGuiAddons.h>
 #include <Keys.h>
 #include <Logger.h>
+#include <Utils/AgentSnapshot.h>
 
 #include <Modules/DialogModule.h>
 #include <Windows/BuildsWindow.h>
@@ -741,24 +742,16 @@ bool TBHotkey::IsInRangeOfNPC() const
     if (!(in_range_of_npc_id && in_range_of_distance > 0.f)) {
         return true;
     }
-    auto* agents = GW::Agents::GetAgentArray();
-    if (!agents) {
+    const auto& agents = AgentSnapshot::Get();
+    const size_t me = agents.MyIndex();
+    if (me == AgentSnapshot::npos) {
         return false;
     }
-    const auto* me = GW::Agents::GetPlayer();
-    for (const auto agent : *agents) {
-        if (!(agent && agent->type == 0xDB)) {
-            continue;
-        }
-        const auto* living = agent->GetAsAgentLiving();
-        if (living->login_number || living->player_number != static_cast<uint16_t>(in_range_of_npc_id)) {
-            continue;
-        }
-        if (GetDistance(agent->pos, me->pos) < in_range_of_distance) {
-            return true;
-        }
-    }
-    return false;
+    const size_t npc = agents.Nearest(agents.positions[me], in_range_of_distance, [&](const size_t i) {
+        return agents.Is(i, AgentSnapshot::Living) && !agents.Is(i, AgentSnapshot::Player)
+               && agents.model_ids[i] == static_cast<uint16_t>(in_range_of_npc_id);
+    });
+    return npc != AgentSnapshot::npos;
 }
 
 HotkeySendChat::HotkeySendChat(const ToolboxIni* ini, const char* section)
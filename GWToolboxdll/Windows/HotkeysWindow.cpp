@@ -13,6 +13,7 @@
 #include <GWCA/Managers/PlayerMgr.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/SignatureCache.h>
 #include <Keys.h>
 
 #include <Windows/HotkeysWindow.h>
@@ -63,7 +64,7 @@ namespace {
         loaded_action_labels = true;
 
         using GetActionLabel_pt = wchar_t*(__cdecl*)(GW::UI::ControlAction action);
-        const auto GetActionLabel_Func = reinterpret_cast<GetActionLabel_pt>(GW::Scanner::Find("\x83\xfe\x5b\x74\x27\x83\xfe\x5c\x74\x22\x83\xfe\x5d\x74\x1d", "xxxxxxxxxxxxxxx", -0x7));
+        const auto GetActionLabel_Func = reinterpret_cast<GetActionLabel_pt>(SignatureCache::Find("\x83\xfe\x5b\x74\x27\x83\xfe\x5c\x74\x22\x83\xfe\x5d\x74\x1d", "xxxxxxxxxxxxxxx", -0x7));
         GWCA_INFO("[SCAN] GetActionLabel_Func = %p\n", reinterpret_cast<void*>(GetActionLabel_Func));
         if (!GetActionLabel_Func) {
             return;
@@ -51,6 +51,7 @@
 #include <GWCA/Utilities/Hooker.h>
 #include <Modules/GwDatTextureModule.h>
 #include <Utils/ToolboxUtils.h>
+#include <Utils/SignatureCache.h>
 
 namespace {
     enum class Status {
@@ -591,7 +592,7 @@ namespace {
     bool RequestQuestInfo(const GW::Constants::QuestID quest_id)
     {
         if (!RequestQuestInfo_Func) {
-            const uintptr_t address = GW::Scanner::Find("\x68\x4a\x01\x00\x10\xff\x77\x04", "xxxxxxxx", 0x7a);
+            const uintptr_t address = SignatureCache::Find("\x68\x4a\x01\x00\x10\xff\x77\x04", "xxxxxxxx", 0x7a);
             RequestQuestInfo_Func = (GetQuestInfo_pt)GW::Scanner::FunctionFromNearCall(address);
         }
         return RequestQuestInfo_Func ? RequestQuestInfo_Func(quest_id), true : false;
@@ -99,12 +99,6 @@ void MaterialsWindow::Initialize()
 {
     ToolboxWindow::Initialize();
 
-    tex_essence = Resources::GetItemImage(L"Essence of Celerity");
-    tex_grail = Resources::GetItemImage(L"Grail of Might");
-    tex_armor = Resources::GetItemImage(L"Armor of Salvation");
-    tex_powerstone = Resources::GetItemImage(L"Powerstone of Courage");
-    tex_resscroll = Resources::GetItemImage(L"Scroll of Resurrection");
-
     for (int& i : price) {
         i = PRICE_DEFAULT;
     }
@@ -207,6 +201,15 @@ void MaterialsWindow::Initialize()
         });
 }
 
+void MaterialsWindow::InitializeContent()
+{
+    tex_essence = Resources::GetItemImage(L"Essence of Celerity");
+    tex_grail = Resources::GetItemImage(L"Grail of Might");
+    tex_armor = Resources::GetItemImage(L"Armor of Salvation");
+    tex_powerstone = Resources::GetItemImage(L"Powerstone of Courage");
+    tex_resscroll = Resources::GetItemImage(L"Scroll of Resurrection");
+}
+
 void MaterialsWindow::Terminate()
 {
     ToolboxWindow::Terminate();
@@ -70,6 +70,7 @@ public:
     [[nodiscard]] const char* Icon() const override { return ICON_FA_FEATHER_ALT; }
 
     void Initialize() override;
+    void InitializeContent() override;
     void Terminate() override;
 
     void DrawSettingsInternal() override;
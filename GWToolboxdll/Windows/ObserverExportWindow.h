@@ -2,6 +2,10 @@
 
 #include <ToolboxWindow.h>
 
+namespace ObserverStats {
+    class Match;
+}
+
 class ObserverExportWindow : public ToolboxWindow {
 public:
     ObserverExportWindow() = default;
@@ -19,9 +23,12 @@ public:
     };
 
     static std::string PadLeft(std::string input, uint8_t count, char c);
-    static nlohmann::json ToJSON_V_0_1();
-    static nlohmann::json ToJSON_V_1_0();
-    static void ExportToJSON(Version version);
+    static std::string ExportTime();
+    // Export the live match in ObserverModule, or one replayed from a journal
+    static void ExportToJSON(Version version, ObserverStats::Match& match);
+    static void ExportToTables(ObserverStats::Match& match);
+    // Replay the journal at path and export it as JSON 1.0 and CSV tables
+    static void ExportJournal(const std::filesystem::path& path);
 
     [[nodiscard]] const char* Name() const override { return "Observer Export"; };
     [[nodiscard]] const char* Icon() const override { return ICON_FA_EYE; }
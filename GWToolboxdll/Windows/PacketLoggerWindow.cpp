@@ -20,6 +20,8 @@
 #include <Utils/GuiUtils.h>
 
 #include <Modules/Resources.h>
+#include <Utils/ByteRing.h>
+#include <Utils/SignatureCache.h>
 #include <Windows/PacketLoggerWindow.h>
 
 namespace {
@@ -190,7 +192,7 @@ static void InitStoC()
         } * gs_codec;
     };
 
-    const uintptr_t address = GW::Scanner::Find("\x75\x04\x33\xC0\x5D\xC3\x8B\x41\x08\xA8\x01\x75", "xxxxxxxxxxxx", -6);
+    const uintptr_t address = SignatureCache::Find("\x75\x04\x33\xC0\x5D\xC3\x8B\x41\x08\xA8\x01\x75", "xxxxxxxxxxxx", -6);
     const uintptr_t StoCHandler_Addr = *(uintptr_t*)address;
 
     const auto addr = (GameServer* *)StoCHandler_Addr;
@@ -254,7 +256,19 @@ static FieldType GetField(const uint32_t type, const uint32_t size, const uint32
     return FieldType::Count;
 }
 
-static void PrintIndent(const uint32_t indent)
+// Printing to nullptr only walks the fields; that's how captures measure a packet without formatting it
+static void Print(FILE* out, const char* format, ...)
+{
+    if (!out) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    vfprintf(out, format, args);
+    va_end(args);
+}
+
+static void PrintIndent(FILE* out, const uint32_t indent)
 {
     char buffer[64];
     ASSERT(indent <= sizeof(buffer) - 1);
@@ -262,7 +276,7 @@ static void PrintIndent(const uint32_t indent)
         buffer[i] = ' ';
     }
     buffer[indent] = 0;
-    printf("%s", buffer);
+    Print(out, "%s", buffer);
 }
 
 static void GetHexS(char* buf, const uint8_t byte)
@@ -294,139 +308,140 @@ static void Serialize(uint8_t** bytes, T* val)
     *bytes = b + sizeof(T);
 }
 
-static void PrintString(const int length, const wchar_t* str)
+static void PrintString(FILE* out, const int length, const wchar_t* str)
 {
     for (auto i = 0; i < length && str[i]; i++) {
-        printf(i > 0 ? " %04x" : "%04x", str[i]);
+        Print(out, i > 0 ? " %04x" : "%04x", str[i]);
     }
 }
 
-static void PrintField(const FieldType field, const uint32_t count, uint8_t** bytes, const uint32_t indent)
+static void PrintField(FILE* out, const FieldType field, const uint32_t count, uint8_t** bytes, const uint32_t indent)
 {
     switch (field) {
         case FieldType::AgentId: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t agent_id;
             Serialize<uint32_t>(bytes, &agent_id);
-            printf("AgentId(%u)\n", agent_id);
+            Print(out, "AgentId(%u)\n", agent_id);
             break;
         }
         case FieldType::Float: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             float f;
             Serialize<float>(bytes, &f);
-            printf("Float(%f)\n", f);
+            Print(out, "Float(%f)\n", f);
             break;
         }
         case FieldType::Vect2: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             float x, y;
             Serialize<float>(bytes, &x);
             Serialize<float>(bytes, &y);
-            printf("Vect2(%f, %f)\n", x, y);
+            Print(out, "Vect2(%f, %f)\n", x, y);
             break;
         }
         case FieldType::Vect3: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             float x, y, z;
             Serialize<float>(bytes, &x);
             Serialize<float>(bytes, &y);
             Serialize<float>(bytes, &z);
-            printf("Vect3(%f, %f, %f)\n", x, y, z);
+            Print(out, "Vect3(%f, %f, %f)\n", x, y, z);
             break;
         }
         case FieldType::Byte: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t val;
             Serialize<uint32_t>(bytes, &val);
-            printf("Byte(%u)\n", val);
+            Print(out, "Byte(%u)\n", val);
             break;
         }
         case FieldType::Word: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t val;
             Serialize<uint32_t>(bytes, &val);
-            printf("Word(%u)\n", val);
+            Print(out, "Word(%u)\n", val);
             break;
         }
         case FieldType::Dword: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t val;
             Serialize<uint32_t>(bytes, &val);
-            printf("Dword(%u)\n", val);
+            Print(out, "Dword(%u)\n", val);
             break;
         }
         case FieldType::Blob: {
-            PrintIndent(indent);
-            printf("Blob(%u) => ", count);
+            PrintIndent(out, indent);
+            Print(out, "Blob(%u) => ", count);
             for (auto i = 0u; i < count; i++) {
                 char buf[3];
                 GetHexS(buf, **bytes);
-                printf("%s ", buf);
+                Print(out, "%s ", buf);
                 ++*bytes;
             }
-            printf("\n");
+            Print(out, "\n");
             break;
         }
         case FieldType::String16: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             const auto str = reinterpret_cast<wchar_t*>(*bytes);
             const size_t length = wcsnlen(str, count);
-            printf("String(%zu) \"", length);
-            PrintString(length, str);
-            printf("\"\n");
+            Print(out, "String(%zu) \"", length);
+            PrintString(out, length, str);
+            Print(out, "\"\n");
             *bytes += count * 2;
             break;
         }
         case FieldType::Array8: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t length;
             uint8_t* end = *bytes + count;
             Serialize<uint32_t>(bytes, &length);
-            printf("Array8(%u) {\n", length);
+            length = std::min(length, count);
+            Print(out, "Array8(%u) {\n", length);
             uint8_t val;
             for (size_t i = 0; i < length; i++) {
                 Serialize<uint8_t>(bytes, &val);
-                PrintIndent(indent + 4);
-                printf("[%zu] => %u,\n", i, val);
+                PrintIndent(out, indent + 4);
+                Print(out, "[%zu] => %u,\n", i, val);
             }
-            printf("}\n");
+            Print(out, "}\n");
             *bytes = end;
             break;
         }
         case FieldType::Array16: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t length = count;
             Serialize<uint32_t>(bytes, &length);
             uint8_t* end = *bytes + count * 2;
-            printf("Array16(%u of %u) {\n", length, count);
+            Print(out, "Array16(%u of %u) {\n", length, count);
             if (length < 64) {
                 uint16_t val;
-                for (size_t i = 0; i < length; i++) {
+                for (size_t i = 0; i < length && i < count; i++) {
                     Serialize<uint16_t>(bytes, &val);
-                    PrintIndent(indent + 4);
-                    printf("[%zu] => %u,\n", i, val);
+                    PrintIndent(out, indent + 4);
+                    Print(out, "[%zu] => %u,\n", i, val);
                 }
             }
-            printf("}\n");
+            Print(out, "}\n");
             *bytes = end;
             break;
         }
         case FieldType::Array32: {
-            PrintIndent(indent);
+            PrintIndent(out, indent);
             uint32_t length = count;
             Serialize<uint32_t>(bytes, &length);
             uint8_t* end = *bytes + count * 4;
-            printf("Array32(%u of %u) {\n", length, count);
+            Print(out, "Array32(%u of %u) {\n", length, count);
             if (length < 128) {
                 uint32_t val;
-                for (size_t i = 0; i < length; i++) {
+                for (size_t i = 0; i < length && i < count; i++) {
                     Serialize<uint32_t>(bytes, &val);
-                    PrintIndent(indent + 4);
-                    printf("[%zu] => %u,\n", i, val);
+                    PrintIndent(out, indent + 4);
+                    Print(out, "[%zu] => %u,\n", i, val);
                 }
             }
-            printf("}\n");
+            Print(out, "}\n");
             *bytes = end;
             break;
         }
@@ -435,12 +450,12 @@ static void PrintField(const FieldType field, const uint32_t count, uint8_t** by
     }
 }
 
-static void PrintNestedField(uint32_t* fields, const uint32_t n_fields,
+static void PrintNestedField(FILE* out, const uint32_t* fields, const uint32_t n_fields,
                              const uint32_t repeat, uint8_t** bytes, const uint32_t indent)
 {
     for (uint32_t rep = 0; rep < repeat; rep++) {
-        PrintIndent(indent);
-        printf("[%u] => {\n", rep);
+        PrintIndent(out, indent);
+        Print(out, "[%u] => {\n", rep);
         for (auto i = 0u; i < n_fields; i++) {
             const uint32_t field = fields[i];
             const uint32_t type = field >> 0 & 0xF;
@@ -456,28 +471,217 @@ static void PrintNestedField(uint32_t* fields, const uint32_t n_fields,
             }
 
             if (field_type != FieldType::NestedStruct) {
-                PrintField(field_type, count, bytes, indent + 4);
+                PrintField(out, field_type, count, bytes, indent + 4);
             }
             else {
                 const uint32_t next_field_index = i + 1;
 
                 uint32_t struct_count;
                 Serialize<uint32_t>(bytes, &struct_count);
+                // Never walk past the space the game reserves for the struct array, in case of a corrupt capture
+                struct_count = std::min(struct_count, count);
 
-                PrintIndent(indent + 4);
-                printf("NextedStruct(%u) {\n", struct_count);
-                PrintNestedField(fields + next_field_index,
+                PrintIndent(out, indent + 4);
+                Print(out, "NextedStruct(%u) {\n", struct_count);
+                PrintNestedField(out, fields + next_field_index,
                                  n_fields - next_field_index, struct_count, bytes, indent + 8);
-                PrintIndent(indent + 4);
-                printf("}\n");
+                PrintIndent(out, indent + 4);
+                Print(out, "}\n");
 
                 // This isn't necessary, but Guild Wars always have the nested struct at the end and once max
                 break;
             }
         }
-        PrintIndent(indent);
-        printf("}\n");
+        PrintIndent(out, indent);
+        Print(out, "}\n");
+    }
+}
+
+// Raw StoC capture. The packet hook only copies each packet into capture_ring; capture_thread streams the ring to disk, and
+// DecodeCapture turns a capture back into the same text the logger prints.
+//
+// File layout: CaptureFileHeader, then for each StoC header its field count and fields (so a capture can be decoded without
+// the game running), then CaptureRecords each followed by the raw packet.
+#pragma pack(push, 1)
+struct CaptureFileHeader {
+    char magic[4] = {'G', 'W', 'P', 'C'};
+    uint32_t version = 1;
+    uint32_t handler_count = 0;
+};
+
+struct CaptureRecord {
+    // Bytes of packet data following this record, including the header
+    uint32_t size;
+    uint32_t instance_time;
+    // FILETIME
+    uint64_t timestamp;
+};
+#pragma pack(pop)
+
+static ByteRing capture_ring;
+static constexpr size_t capture_ring_size = 4 * 1024 * 1024;
+static std::thread capture_thread;
+static std::atomic_bool capture_running = false;
+static std::filesystem::path capture_path;
+
+static void CapturePacket(GW::Packet::StoC::PacketBase* packet, const StoCHandler& handler)
+{
+    auto bytes = reinterpret_cast<uint8_t*>(packet) + sizeof(uint32_t);
+    PrintNestedField(nullptr, handler.fields + 1, handler.field_count - 1, 1, &bytes, 0);
+
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    const CaptureRecord record = {
+        static_cast<uint32_t>(bytes - reinterpret_cast<uint8_t*>(packet)),
+        GW::Map::GetInstanceTime(),
+        static_cast<uint64_t>(now.dwHighDateTime) << 32 | now.dwLowDateTime
+    };
+    capture_ring.Write(&record, sizeof(record), packet, record.size);
+}
+
+static bool WriteCaptureHeader(FILE* file)
+{
+    CaptureFileHeader header;
+    header.handler_count = static_cast<uint32_t>(game_server_handler->size());
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        return false;
+    }
+    for (size_t i = 0; i < game_server_handler->size(); i++) {
+        const auto& handler = game_server_handler->at(i);
+        if (fwrite(&handler.field_count, sizeof(handler.field_count), 1, file) != 1
+            || fwrite(handler.fields, sizeof(*handler.fields), handler.field_count, file) != handler.field_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void StopCapture()
+{
+    if (!capture_running) {
+        return;
+    }
+    capture_running = false;
+    if (capture_thread.joinable()) {
+        capture_thread.join();
     }
+    Log::Info("Packet capture saved to %ls", capture_path.c_str());
+}
+
+static bool StartCapture()
+{
+    if (capture_running) {
+        return true;
+    }
+    InitStoC();
+    if (!game_server_handler) {
+        return false;
+    }
+    const auto folder = Resources::GetPath(L"packet_captures");
+    if (!Resources::EnsureFolderExists(folder)) {
+        return false;
+    }
+    SYSTEMTIME time;
+    GetLocalTime(&time);
+    wchar_t filename[64];
+    swprintf(filename, _countof(filename), L"capture_%04d%02d%02d_%02d%02d%02d.gwpc", time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+    capture_path = folder / filename;
+
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, capture_path.wstring().c_str(), L"wb") != 0 || !file) {
+        Log::Error("Failed to open %ls for packet capture", capture_path.c_str());
+        return false;
+    }
+    if (!WriteCaptureHeader(file)) {
+        fclose(file);
+        return false;
+    }
+    if (!capture_ring.Capacity()) {
+        capture_ring.Init(capture_ring_size);
+    }
+    capture_ring.Discard();
+    capture_running = true;
+    capture_thread = std::thread([file] {
+        const auto drain = [file] {
+            capture_ring.Drain([file](const uint8_t* data, const size_t size) {
+                fwrite(data, 1, size, file);
+            });
+        };
+        while (capture_running) {
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        drain();
+        fclose(file);
+    });
+    return true;
+}
+
+// Write a capture out as text, in the same format the logger prints to the console.
+static bool DecodeCapture(const std::filesystem::path& in_path, const std::filesystem::path& out_path)
+{
+    std::ifstream in(in_path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator(in)), std::istreambuf_iterator<char>());
+
+    size_t pos = 0;
+    const auto read = [&](void* out, const size_t size) {
+        if (data.size() - pos < size) {
+            return false;
+        }
+        memcpy(out, data.data() + pos, size);
+        pos += size;
+        return true;
+    };
+
+    CaptureFileHeader header;
+    if (!read(&header, sizeof(header)) || memcmp(header.magic, CaptureFileHeader().magic, sizeof(header.magic)) != 0 || header.version != CaptureFileHeader().version) {
+        return false;
+    }
+    std::vector<std::vector<uint32_t>> schema(header.handler_count);
+    for (auto& fields : schema) {
+        uint32_t field_count;
+        if (!read(&field_count, sizeof(field_count)) || field_count > (data.size() - pos) / sizeof(uint32_t)) {
+            return false;
+        }
+        fields.resize(field_count);
+        read(fields.data(), field_count * sizeof(uint32_t));
+    }
+
+    FILE* out = nullptr;
+    if (_wfopen_s(&out, out_path.wstring().c_str(), L"w") != 0 || !out) {
+        return false;
+    }
+    // Records are copied out with some zeroed slack after them, so a corrupt packet can't walk off the end of the file
+    std::vector<uint8_t> packet;
+    CaptureRecord record;
+    while (read(&record, sizeof(record))) {
+        if (record.size < sizeof(uint32_t) || data.size() - pos < record.size) {
+            break;
+        }
+        packet.assign(record.size + 0x10000, 0);
+        read(packet.data(), record.size);
+        const uint32_t packet_header = *reinterpret_cast<uint32_t*>(packet.data());
+
+        FILETIME file_time = {static_cast<DWORD>(record.timestamp), static_cast<DWORD>(record.timestamp >> 32)};
+        FILETIME local_time;
+        SYSTEMTIME time;
+        FileTimeToLocalFileTime(&file_time, &local_time);
+        FileTimeToSystemTime(&local_time, &time);
+        const uint32_t instance_time = record.instance_time;
+        fprintf(out, "[%02d:%02d:%02d.%03d] [%02u:%02u:%02u.%03u] StoC packet(%u 0x%X) {\n", time.wHour, time.wMinute, time.wSecond, time.wMilliseconds,
+                instance_time / 3600000, instance_time / 60000 % 60, instance_time / 1000 % 60, instance_time % 1000, packet_header, packet_header);
+        if (packet_header < schema.size() && schema[packet_header].size() > 1) {
+            auto bytes = packet.data() + sizeof(uint32_t);
+            const auto& fields = schema[packet_header];
+            PrintNestedField(out, fields.data() + 1, static_cast<uint32_t>(fields.size() - 1), 1, &bytes, 4);
+        }
+        fprintf(out, "} endpacket(%u 0x%X)\n", packet_header, packet_header);
+    }
+    fclose(out);
+    return true;
 }
 
 void PacketLoggerWindow::CtoSHandler(const GW::HookStatus*, void* packet) const
@@ -512,6 +716,10 @@ void PacketLoggerWindow::PacketHandler(GW::HookStatus* status, GW::Packet::StoC:
     }
 
     const StoCHandler handler = game_server_handler->at(packet->header);
+    if (capture_running) {
+        CapturePacket(packet, handler);
+        return;
+    }
     auto packet_raw = reinterpret_cast<uint8_t*>(packet);
 
     uint8_t** bytes = &packet_raw;
@@ -521,7 +729,7 @@ void PacketLoggerWindow::PacketHandler(GW::HookStatus* status, GW::Packet::StoC:
 
     if (log_packet_content) {
         printf(PrefixTimestamp("StoC packet(%u 0x%X) {\n").c_str(), packet->header, packet->header);
-        PrintNestedField(handler.fields + 1, handler.field_count - 1, 1, bytes, 4);
+        PrintNestedField(stdout, handler.fields + 1, handler.field_count - 1, 1, bytes, 4);
         printf("} endpacket(%u 0x%X)\n", packet->header, packet->header);
     }
     else {
@@ -684,6 +892,38 @@ void PacketLoggerWindow::Draw(IDirect3DDevice9*)
     ImGui::SameLine();
     ImGui::Checkbox("Auto ignore incoming packets", &auto_ignore_packets);
     ImGui::ShowHelp("While ticked, any StoC packets received will be added to the ignore list.");
+    bool capture = capture_running;
+    if (ImGui::Checkbox("Capture to file", &capture)) {
+        if (capture) {
+            Enable();
+            StartCapture();
+        }
+        else {
+            StopCapture();
+        }
+    }
+    ImGui::ShowHelp("Save incoming packets to a capture file instead of printing them.\n"
+        "Much cheaper than logging packet content; use 'Decode Capture' afterwards to turn the capture into text.");
+    if (capture_running) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%u packets dropped", capture_ring.Dropped());
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Decode Capture...")) {
+        Resources::OpenFileDialog([](const char* path) {
+            if (!path) {
+                return;
+            }
+            auto out_path = std::filesystem::path(path);
+            out_path += ".txt";
+            if (DecodeCapture(path, out_path)) {
+                Log::Info("Decoded capture to %ls", out_path.c_str());
+            }
+            else {
+                Log::Error("Failed to decode capture %s", path);
+            }
+        }, "gwpc", Resources::GetPath(L"packet_captures").string().c_str());
+    }
     /*if ( ImGui::Button("Export Map Info")) {
         if (maps.empty()) {
             FetchMapInfo();
@@ -868,8 +1108,15 @@ void PacketLoggerWindow::LoadSettings(ToolboxIni* ini)
     }
 }
 
+void PacketLoggerWindow::Terminate()
+{
+    StopCapture();
+    ToolboxWindow::Terminate();
+}
+
 void PacketLoggerWindow::Disable()
 {
+    StopCapture();
     if (!logger_enabled || !game_server_handler) {
         return;
     }
@@ -22,6 +22,7 @@ public:
     void DrawSettingsInternal() override;
 
     void Initialize() override;
+    void Terminate() override;
     void SaveSettings(ToolboxIni* ini) override;
     void LoadSettings(ToolboxIni* ini) override;
     void Update(float delta) override;
@@ -36,9 +36,7 @@
 // After that, you can try every 30 seconds.
 static constexpr uint32_t COST_PER_CONNECTION_MS = 30 * 1000;
 static constexpr uint32_t COST_PER_CONNECTION_MAX_MS = 60 * 1000;
-using easywsclient::WebSocket;
 using nlohmann::json;
-using json_vec = std::vector<json>;
 
 static constexpr char ws_host[] = "wss://lfg.gwtoolbox.com";
 static constexpr char https_host[] = "https://lfg.gwtoolbox.com";
@@ -251,18 +249,6 @@ void PartySearchWindow::Initialize()
     party_advertisements.reserve(100);
     messages = CircularBuffer<Message>(100);
 
-    should_stop = false;
-    worker = std::thread([this] {
-        while (!should_stop) {
-            if (thread_jobs.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            else {
-                thread_jobs.front()();
-                thread_jobs.pop();
-            }
-        }
-    });
     // local messages
     GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_REMOVE, OnRegionPartyUpdated);
     GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_SIZE, OnRegionPartyUpdated);
@@ -467,32 +453,21 @@ void PartySearchWindow::OnRegionPartyUpdated(GW::HookStatus*, GW::Packet::StoC::
 void PartySearchWindow::SignalTerminate()
 {
     ToolboxWindow::SignalTerminate();
-    should_stop = true;
-    if (worker.joinable()) {
-        worker.join();
-    }
-    DeleteWebSocket(ws_window);
-    ws_window = nullptr;
-    if (wsaData.wVersion) {
-        WSACleanup();
+    if (ws_window) {
+        ws_window->Close();
+        ws_window = nullptr;
     }
 }
 
 void PartySearchWindow::Update(const float)
 {
-    if (ws_window && ws_window->getReadyState() == WebSocket::CLOSED) {
-        delete ws_window;
-        ws_window = nullptr;
-    }
-    if (ws_window && ws_window->getReadyState() != WebSocket::CLOSED) {
-        ws_window->poll();
-    }
     constexpr bool maintain_socket = false; // (visible && !collapsed) || (print_game_chat && GW::UI::GetCheckboxPreference(GW::UI::CheckboxPreference_ChannelTrade) == 0);
     if constexpr (maintain_socket) {
         AsyncWindowConnect();
     }
-    if (ws_window && ws_window->getReadyState() == WebSocket::OPEN) {
-        ws_window->close();
+    if (ws_window && ws_window->IsOpen()) {
+        ws_window->Close();
+        ws_window = nullptr;
         messages.clear();
         window_rate_limiter = RateLimiter(); // Deliberately closed; reset rate limiter.
     }
@@ -530,20 +505,29 @@ bool PartySearchWindow::parse_json_message(const json& js, Message* msg)
 
 void PartySearchWindow::fetch()
 {
-    if (!ws_window || ws_window->getReadyState() != WebSocket::OPEN) {
+    if (!ws_window) {
         return;
     }
 
-    ws_window->dispatch([this](const std::string& data) {
-        const json& res = json::parse(data.c_str(), nullptr, false);
+    // Messages arrive already parsed, from the network thread
+    NetReactor::Websocket::Event event;
+    while (ws_window && ws_window->Poll(event)) {
+        if (event.type == NetReactor::Websocket::Event::Type::Closed) {
+            ws_window = nullptr;
+            break;
+        }
+        if (event.type != NetReactor::Websocket::Event::Type::Message) {
+            continue;
+        }
+        const json& res = event.json;
         if (res == json::value_t::discarded) {
-            Log::Log("ERROR: Failed to parse res JSON from response in ws_window->dispatch\n");
-            return;
+            Log::Log("ERROR: Failed to parse res JSON from party search websocket message\n");
+            continue;
         }
         // Add to message feed
         Message msg;
         if (!parse_json_message(res, &msg)) {
-            return; // Not valid message object
+            continue; // Not valid message object
         }
         messages.add(msg);
 
@@ -558,36 +542,15 @@ void PartySearchWindow::fetch()
             swprintf(buffer, 512, L"<a=1>%s</a>: <c=#f96677><quote>%s", name_ws.c_str(), msg_ws.c_str());
             WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buffer);
         }
-    });
+    }
 }
 
-bool PartySearchWindow::IsLfpAlert(std::string& message) const
+bool PartySearchWindow::IsLfpAlert(const std::string& message)
 {
     if (!filter_alerts) {
         return true;
     }
-    std::regex word_regex;
-    std::smatch m;
-    static const auto regex_check = std::regex("^/(.*)/[a-z]?$", std::regex::ECMAScript | std::regex::icase);
-    for (const auto& word : alert_words) {
-        if (std::regex_search(word, m, regex_check)) {
-            try {
-                word_regex = std::regex(m._At(1).str(), std::regex::ECMAScript | std::regex::icase);
-            } catch (const std::exception&) {
-                // Silent fail; invalid regex
-            }
-            if (std::regex_search(message, word_regex)) {
-                return true;
-            }
-        }
-        else {
-            auto found = std::ranges::search(message, word, [](const char c1, const char c2) -> bool { return tolower(c1) == c2; }).begin();
-            if (found != message.end()) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return alerts.Matches(message);
 }
 
 void PartySearchWindow::Draw(IDirect3DDevice9*)
@@ -619,7 +582,7 @@ void PartySearchWindow::Draw(IDirect3DDevice9*)
     /* Main trade chat area */
 
     /* Connection checks */
-    /*if (!ws_window && !ws_window_connecting) {
+    /*if (!ws_window) {
         char buf[255];
         snprintf(buf, 255, "The connection to %s has timed out.", ws_host);
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize(buf).x) / 2);
@@ -630,7 +593,7 @@ void PartySearchWindow::Draw(IDirect3DDevice9*)
             AsyncWindowConnect(true);
         }
         display_messages = false;
-    } else if (ws_window_connecting || (ws_window && ws_window->getReadyState() == WebSocket::CONNECTING)) {
+    } else if (ws_window->GetState() == NetReactor::Websocket::State::Connecting) {
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize("Connecting...").x) / 2);
         ImGui::SetCursorPosY(ImGui::GetWindowHeight() / 2);
         ImGui::Text("Connecting...");
@@ -757,7 +720,7 @@ void PartySearchWindow::DrawAlertsWindowContent(bool)
     ImGui::TextDisabled("(Each line is a separate keyword. Not case sensitive.)");
     if (ImGui::InputTextMultiline("##alertfilter", alert_buf, ALERT_BUF_SIZE,
                                   ImVec2(-1.0f, 0.0f))) {
-        ParseBuffer(alert_buf, alert_words);
+        alerts.Compile(alert_buf);
         alertfile_dirty = true;
     }
 }
@@ -778,7 +741,7 @@ void PartySearchWindow::LoadSettings(ToolboxIni* ini)
     if (alert_file.is_open()) {
         alert_file.get(alert_buf, ALERT_BUF_SIZE, '\0');
         alert_file.close();
-        ParseBuffer(alert_buf, alert_words);
+        alerts.Compile(alert_buf);
     }
     alert_file.close();
 }
@@ -801,54 +764,13 @@ void PartySearchWindow::SaveSettings(ToolboxIni* ini)
     }
 }
 
-void PartySearchWindow::ParseBuffer(const char* text, std::vector<std::string>& words)
-{
-    words.clear();
-    std::istringstream stream(text);
-    std::string word;
-    while (std::getline(stream, word)) {
-        for (size_t i = 0; i < word.length(); i++) {
-            word[i] = static_cast<char>(tolower(word[i]));
-        }
-        words.push_back(word);
-    }
-}
-
 void PartySearchWindow::AsyncWindowConnect(const bool force)
 {
     if (ws_window) {
         return;
     }
-    if (ws_window_connecting) {
-        return;
-    }
     if (!force && !window_rate_limiter.AddTime(COST_PER_CONNECTION_MS, COST_PER_CONNECTION_MAX_MS)) {
         return;
     }
-    int res;
-    if (!wsaData.wVersion && (res = WSAStartup(MAKEWORD(2, 2), &wsaData)) != 0) {
-        printf("Failed to call WSAStartup: %d\n", res);
-        return;
-    }
-    ws_window_connecting = true;
-    thread_jobs.push([this] {
-        if ((ws_window = WebSocket::from_url(ws_host)) == nullptr) {
-            printf("Couldn't connect to the host '%s'", ws_host);
-        }
-        ws_window_connecting = false;
-    });
-}
-
-void PartySearchWindow::DeleteWebSocket(WebSocket* ws)
-{
-    if (!ws) {
-        return;
-    }
-    if (ws->getReadyState() == WebSocket::OPEN) {
-        ws->close();
-    }
-    while (ws->getReadyState() != WebSocket::CLOSED) {
-        ws->poll();
-    }
-    delete ws;
+    ws_window = Resources::GetNetReactor().Connect(ws_host);
 }
@@ -2,6 +2,8 @@
 
 #include <CircurlarBuffer.h>
 #include <ToolboxWindow.h>
+#include <Utils/AlertMatcher.h>
+#include <Utils/NetReactor.h>
 #include <Utils/RateLimiter.h>
 
 class PartySearchWindow : public ToolboxWindow {
@@ -75,8 +77,6 @@ private:
 
     std::unordered_map<std::wstring, TBParty*> party_advertisements{};
 
-    WSAData wsaData = {0};
-
     bool show_alert_window = false;
     std::recursive_mutex party_mutex;
 
@@ -90,13 +90,8 @@ private:
     bool print_game_chat = false;
     bool filter_alerts = false;
     char search_buffer[256] = {0};
-    std::vector<std::string> alert_words{};
+    AlertMatcher alerts;
     std::vector<std::string> searched_words{};
-    // tasks to be done async by the worker thread
-    std::queue<std::function<void()>> thread_jobs{};
-    bool should_stop = false;
-    std::thread worker;
-    bool ws_window_connecting = false;
 
     clock_t refresh_parties = 0;
     bool display_party_types[6] = {true, true, true, false, true, true};
@@ -104,7 +99,7 @@ private:
     bool ignore_party_types[6] = {false, false, false, false, false, false};
     uint32_t max_party_size = 0;
 
-    easywsclient::WebSocket* ws_window = nullptr;
+    NetReactor::WebsocketPtr ws_window;
     RateLimiter window_rate_limiter;
 
     CircularBuffer<Message> messages;
@@ -118,8 +113,6 @@ private:
     void AsyncWindowConnect(bool force = false);
     void fetch();
     static bool parse_json_message(const nlohmann::json& js, Message* msg);
-    static void ParseBuffer(const char* text, std::vector<std::string>& words);
-    static void DeleteWebSocket(easywsclient::WebSocket* ws);
-    bool IsLfpAlert(std::string& message) const;
+    bool IsLfpAlert(const std::string& message);
     static void OnRegionPartyUpdated(GW::HookStatus*, GW::Packet::StoC::PacketBase* packet);
 };
@@ -12,6 +12,7 @@
 #include <GWCA/Managers/PartyMgr.h>
 #include <GWCA/Managers/StoCMgr.h>
 
+#include <GWToolbox.h>
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
 
@@ -138,10 +139,19 @@ PconsWindow::PconsWindow()
     pcons.push_back(new PconRefiller(L"Zaishen Summoning Stone", 31156));
 }
 
+std::vector<ToolboxModule*> PconsWindow::GetDependencies()
+{
+    return {&AlcoholWidget::Instance()};
+}
+
 void PconsWindow::Initialize()
 {
     ToolboxWindow::Initialize();
-    AlcoholWidget::Instance().Initialize(); // Pcons depend on alcohol widget to track current drunk level.
+    // Pcons depend on alcohol widget to track current drunk level; if it's enabled, it's already been initialized.
+    const auto& widgets = GWToolbox::GetWidgets();
+    if (std::ranges::find(widgets, &AlcoholWidget::Instance()) == widgets.end()) {
+        AlcoholWidget::Instance().Initialize();
+    }
 
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentSetPlayer>(&AgentSetPlayer_Entry, [](GW::HookStatus*, const GW::Packet::StoC::AgentSetPlayer* pak) -> void {
         Pcon::player_id = pak->unk1;
@@ -24,6 +24,7 @@ public:
     [[nodiscard]] const char* Name() const override { return "Pcons"; }
     [[nodiscard]] const char* Icon() const override { return ICON_FA_BIRTHDAY_CAKE; }
 
+    std::vector<ToolboxModule*> GetDependencies() override;
     void Initialize() override;
     void Terminate() override;
 
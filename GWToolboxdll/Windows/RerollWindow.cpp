@@ -34,6 +34,7 @@
 
 #include <ImGuiAddons.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/SignatureCache.h>
 
 
 namespace {
@@ -382,7 +383,7 @@ void RerollWindow::Initialize()
         GW::Hook::EnableHooks(SetOnlineStatus_Func);
     }
 
-    const uintptr_t address = GW::Scanner::Find("\x8b\x35\x00\x00\x00\x00\x57\x69\xF8\x84\x00\x00\x00", "xx????xxxxxxx", 0x2);
+    const uintptr_t address = SignatureCache::Find("\x8b\x35\x00\x00\x00\x00\x57\x69\xF8\x84\x00\x00\x00", "xx????xxxxxxx", 0x2);
     if (address) {
         available_chars_ptr = *(GW::Array<AvailableCharacterInfo>**)address;
     }
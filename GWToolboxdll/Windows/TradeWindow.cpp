@@ -30,9 +30,12 @@
 constexpr uint32_t COST_PER_CONNECTION_MS = 30 * 1000;
 constexpr uint32_t COST_PER_CONNECTION_MAX_MS = 60 * 1000;
 static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
-using easywsclient::WebSocket;
 using nlohmann::json;
-using json_vec = std::vector<json>;
+
+// Oldest half of the history is dropped once the file gets this big
+constexpr size_t MAX_HISTORY_FILE_SIZE = 16 * 1024 * 1024;
+constexpr size_t MAX_DISPLAYED_MESSAGES = 100;
+constexpr size_t MAX_PRINTED_RESULTS = 5;
 
 constexpr char ws_host_kmd[] = "wss://kamadan.gwtoolbox.com";
 constexpr char https_host_kmd[] = "https://kamadan.gwtoolbox.com";
@@ -109,20 +112,17 @@ void TradeWindow::Initialize()
 {
     ToolboxWindow::Initialize();
 
-    messages = CircularBuffer<Message>(100);
-
-    should_stop = false;
-    worker = std::thread([this] {
-        while (!should_stop) {
-            if (thread_jobs.empty()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            else {
-                thread_jobs.front()();
-                thread_jobs.pop();
-            }
+    messages = CircularBuffer<Message>(MAX_DISPLAYED_MESSAGES);
+    history_closing = false;
+    EnqueueHistoryTask([this] {
+        if (!history_kamadan.Open(Resources::GetPath(L"trade_history_kamadan.dat"), MAX_HISTORY_FILE_SIZE)) {
+            Log::Log("Failed to open Kamadan trade history\n");
+        }
+        if (!history_ascalon.Open(Resources::GetPath(L"trade_history_ascalon.dat"), MAX_HISTORY_FILE_SIZE)) {
+            Log::Log("Failed to open Ascalon trade history\n");
         }
     });
+
     GW::Chat::CreateCommand(L"pc", CmdPricecheck);
     // local messages
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::MessageLocal>(&OnMessageLocal_Entry, OnMessageLocal);
@@ -146,14 +146,44 @@ void TradeWindow::Initialize()
 void TradeWindow::SignalTerminate()
 {
     ToolboxWindow::SignalTerminate();
-    should_stop = true;
-    if (worker.joinable()) {
-        worker.join();
+    if (ws_window) {
+        ws_window->Close();
+        ws_window = nullptr;
     }
-    DeleteWebSocket(ws_window);
-    ws_window = nullptr;
-    if (wsaData.wVersion) {
-        WSACleanup();
+    history_closing = true;
+}
+
+bool TradeWindow::CanTerminate()
+{
+    return !history_tasks_running;
+}
+
+void TradeWindow::Terminate()
+{
+    ToolboxWindow::Terminate();
+    history_kamadan.Close();
+    history_ascalon.Close();
+}
+
+void TradeWindow::EnqueueHistoryTask(std::function<void()> task)
+{
+    Resources::EnqueueWorkerTask([this, task = std::move(task)] {
+        // Counted from when it starts, so that a task the pool drops on shutdown isn't waited for
+        history_tasks_running++;
+        if (!history_closing) {
+            task();
+        }
+        history_tasks_running--;
+    });
+}
+
+void TradeWindow::AddToHistory(const Message& msg)
+{
+    MessageStore& history = History();
+    if (history.Add(msg) && history.NeedsCompaction()) {
+        EnqueueHistoryTask([&history] {
+            history.Compact();
+        });
     }
 }
 
@@ -185,20 +215,14 @@ bool TradeWindow::GetInAscalonAE1(const bool check_district)
 
 void TradeWindow::Update(const float)
 {
-    if (ws_window && ws_window->getReadyState() == WebSocket::CLOSED) {
-        delete ws_window;
-        ws_window = nullptr;
-    }
-    if (ws_window && ws_window->getReadyState() != WebSocket::CLOSED) {
-        ws_window->poll();
-    }
     const bool search_pending = !pending_query_string.empty();
     const bool maintain_socket = (visible && !collapsed) || ((print_game_chat || print_game_chat_asc) && GetPreference(GW::UI::FlagPreference::ChannelTrade) == 0) || search_pending;
     if (maintain_socket && !ws_window) {
         AsyncWindowConnect();
     }
-    if (!maintain_socket && ws_window && ws_window->getReadyState() == WebSocket::OPEN) {
-        ws_window->close();
+    if (!maintain_socket && ws_window && ws_window->IsOpen()) {
+        ws_window->Close();
+        ws_window = nullptr;
         messages.clear();
         window_rate_limiter = RateLimiter(); // Deliberately closed; reset rate limiter.
     }
@@ -238,11 +262,11 @@ bool TradeWindow::parse_json_message(const json& js, Message* msg)
 
 void TradeWindow::fetch()
 {
-    if (!ws_window || ws_window->getReadyState() != WebSocket::OPEN) {
+    if (!ws_window) {
         return;
     }
     const bool search_pending = !pending_query_sent && !pending_query_string.empty();
-    if (search_pending) {
+    if (search_pending && ws_window->IsOpen()) {
         //strcpy(search_buffer, pending_query_string.c_str());
         // Fill searched_words; query to lower to ease on-the-fly search in ::fetch
         ParseBuffer(search_buffer, searched_words);
@@ -251,133 +275,163 @@ void TradeWindow::fetch()
         json request;
         request["query"] = pending_query_string;
         pending_query_sent = clock();
-        ws_window->send(request.dump());
+        ws_window->Send(request.dump());
     }
 
-    ws_window->dispatch([this](const std::string& data) {
-        const json& res = json::parse(data.c_str(), nullptr, false);
-        if (res == json::value_t::discarded) {
-            Log::Log("ERROR: Failed to parse res JSON from response in ws_window->dispatch\n");
-            return;
-        }
-        if (res.find("query") != res.end() && res["query"].is_string()) {
-            auto query_string = res["query"].get<std::string>();
-            if (query_string != pending_query_string) {
-                return; // Different query has been made since this search.
-            }
-            pending_query_string.clear();
-            if (!(res.contains("num_results") && res["num_results"].is_number_unsigned())) {
-                Log::Log("ERROR: Failed to parse search results in TradeWindow::fetch\n");
-                print_search_results = false;
-                return;
-            }
-            size_t num_results = res["num_results"].get<size_t>();
-            if (print_search_results && !num_results) {
-                Log::Warning("No results found for %s", query_string.c_str());
-                print_search_results = false;
-                return;
-            }
-            if (!(res.contains("results") && res["results"].is_array())) {
-                Log::Log("ERROR: Failed to parse search results in TradeWindow::fetch\n");
-                print_search_results = false;
-                return;
-            }
-            auto results = res["results"].get<json_vec>();
-            messages.clear();
-            if (print_search_results && !results.size()) {
-                Log::Warning("No results found for %s", query_string.c_str());
-                print_search_results = false;
-                return;
-            }
-            size_t results_size = results.size();
-            for (size_t i = results_size - 1; i < results_size; i--) {
-                Message msg;
-                if (!parse_json_message(results[i], &msg)) {
-                    continue;
+    // Messages arrive already parsed, from the network thread
+    NetReactor::Websocket::Event event;
+    while (ws_window && ws_window->Poll(event)) {
+        switch (event.type) {
+            case NetReactor::Websocket::Event::Type::Opened:
+                if (messages.size() == 0 && pending_query_string.empty()) {
+                    search(""); // Initial draw, gets latest N messages
                 }
-                messages.add(msg);
-                if (print_search_results && i < 5) {
-                    std::wstring name_ws = GuiUtils::ToWstr(msg.name);
-                    std::wstring msg_ws = GuiUtils::ToWstr(msg.message);
-                    time_t ts = msg.timestamp;
-                    tm* local_tm = localtime(&ts);
-                    if (local_tm) {
-                        wchar_t buf[512];
-                        swprintf(buf, 512, L"<a=1>%s</a> @ %S %d, %02d:%02d: <c=#f96677><quote>%s", name_ws.c_str(), months[local_tm->tm_mon], local_tm->tm_mday, local_tm->tm_hour, local_tm->tm_min, msg_ws.c_str());
-                        WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buf);
-                    }
-                }
-            }
+                break;
+            case NetReactor::Websocket::Event::Type::Message:
+                OnWebsocketMessage(event.json);
+                break;
+            case NetReactor::Websocket::Event::Type::Closed:
+                ws_window = nullptr;
+                break;
+        }
+    }
+}
+
+void TradeWindow::OnWebsocketMessage(const json& res)
+{
+    if (res == json::value_t::discarded) {
+        Log::Log("ERROR: Failed to parse res JSON from trade websocket message\n");
+        return;
+    }
+    if (res.find("query") != res.end() && res["query"].is_string()) {
+        auto query_string = res["query"].get<std::string>();
+        if (query_string != pending_query_string) {
+            return; // Different query has been made since this search.
+        }
+        pending_query_string.clear();
+        if (!(res.contains("num_results") && res["num_results"].is_number_unsigned())) {
+            Log::Log("ERROR: Failed to parse search results in TradeWindow::fetch\n");
             print_search_results = false;
             return;
         }
-        // Add to message feed
-        Message msg;
-        if (!parse_json_message(res, &msg)) {
-            return; // Not valid message object
+        if (!(res.contains("results") && res["results"].is_array())) {
+            Log::Log("ERROR: Failed to parse search results in TradeWindow::fetch\n");
+            print_search_results = false;
+            return;
         }
-        bool add_to_window = searched_words.empty();
-        if (!add_to_window) {
-            // Currently showing a search term in-window. Only add if it matches all words.
-            add_to_window = true;
-            std::string input(msg.message);
-            std::ranges::transform(input, input.begin(),
-                                   [](const char c) -> char {
-                                       return static_cast<char>(tolower(c));
-                                   });
-            for (auto& term : searched_words) {
-                if (input.find(term) != std::string::npos) {
-                    continue; // Searched word no found; drop out
-                }
-                add_to_window = false;
-                break;
+        // Newest first
+        std::vector<Message> found;
+        for (const auto& result : res["results"]) {
+            Message msg;
+            if (!parse_json_message(result, &msg)) {
+                continue;
             }
+            // Fill in anything from before we started keeping history
+            AddToHistory(msg);
+            found.push_back(std::move(msg));
+        }
+        // The server and our own history can each have messages the other doesn't
+        std::vector<Message> local;
+        SearchHistory(query_string, local);
+        found.insert(found.end(), std::make_move_iterator(local.begin()), std::make_move_iterator(local.end()));
+        std::ranges::sort(found, [](const Message& a, const Message& b) {
+            return std::tie(b.timestamp, a.name, a.message) < std::tie(a.timestamp, b.name, b.message);
+        });
+        const auto [first, last] = std::ranges::unique(found, [](const Message& a, const Message& b) {
+            return a.timestamp == b.timestamp && a.name == b.name && a.message == b.message;
+        });
+        found.erase(first, last);
+        if (found.size() > MAX_DISPLAYED_MESSAGES) {
+            found.resize(MAX_DISPLAYED_MESSAGES);
         }
-        if (add_to_window) {
-            messages.add(msg);
+        if (print_search_results && found.empty()) {
+            Log::Warning("No results found for %s", query_string.c_str());
         }
+        ShowSearchResults(found, print_search_results);
+        print_search_results = false;
+        return;
+    }
+    // Add to message feed
+    Message msg;
+    if (!parse_json_message(res, &msg)) {
+        return; // Not valid message object
+    }
+    AddToHistory(msg);
+    bool add_to_window = searched_words.empty();
+    if (!add_to_window) {
+        // Currently showing a search term in-window. Only add if it matches all words.
+        add_to_window = true;
+        std::string input(msg.message);
+        std::ranges::transform(input, input.begin(),
+                               [](const char c) -> char {
+                                   return static_cast<char>(tolower(c));
+                               });
+        for (auto& term : searched_words) {
+            if (input.find(term) != std::string::npos) {
+                continue; // Searched word no found; drop out
+            }
+            add_to_window = false;
+            break;
+        }
+    }
+    if (add_to_window) {
+        messages.add(msg);
+    }
 
-        // Check alerts
-        // do not display trade chat while in kamadan AE district 1 or Pre-Searing Ascalon AE district 1
-        bool print_message = ((is_kamadan_chat && print_game_chat && !GetInKamadanAE1()) || (!is_kamadan_chat && print_game_chat_asc && !GetInAscalonAE1())) && IsTradeAlert(msg.message);
+    // Check alerts
+    // do not display trade chat while in kamadan AE district 1 or Pre-Searing Ascalon AE district 1
+    bool print_message = ((is_kamadan_chat && print_game_chat && !GetInKamadanAE1()) || (!is_kamadan_chat && print_game_chat_asc && !GetInAscalonAE1())) && IsTradeAlert(msg.message);
 
-        if (print_message) {
-            wchar_t buffer[512];
-            std::wstring name_ws = GuiUtils::ToWstr(msg.name);
-            std::wstring msg_ws = GuiUtils::ToWstr(msg.message);
-            swprintf(buffer, 512, L"<a=1>%s</a>: <c=#f96677><quote>%s", name_ws.c_str(), msg_ws.c_str());
-            WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buffer);
-        }
-    });
+    if (print_message) {
+        wchar_t buffer[512];
+        std::wstring name_ws = GuiUtils::ToWstr(msg.name);
+        std::wstring msg_ws = GuiUtils::ToWstr(msg.message);
+        swprintf(buffer, 512, L"<a=1>%s</a>: <c=#f96677><quote>%s", name_ws.c_str(), msg_ws.c_str());
+        WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buffer);
+    }
 }
 
-bool TradeWindow::IsTradeAlert(std::string& message) const
+bool TradeWindow::IsTradeAlert(const std::string& message)
 {
     if (!filter_alerts) {
         return true;
     }
-    std::regex word_regex;
-    std::smatch m;
-    static const auto regex_check = std::regex("^/(.*)/[a-z]?$", std::regex::ECMAScript | std::regex::icase);
-    for (const auto& word : alert_words) {
-        if (std::regex_search(word, m, regex_check)) {
-            try {
-                word_regex = std::regex(m._At(1).str(), std::regex::ECMAScript | std::regex::icase);
-            } catch (const std::exception&) {
-                // Silent fail; invalid regex
-            }
-            if (std::regex_search(message, word_regex)) {
-                return true;
-            }
-        }
-        else {
-            auto found = std::ranges::search(message, word, [](const char c1, const char c2) -> bool { return tolower(c1) == c2; }).begin();
-            if (found != message.end()) {
-                return true;
-            }
+    return alerts.Matches(message);
+}
+
+void TradeWindow::PrintSearchResult(const Message& msg)
+{
+    const std::wstring name_ws = GuiUtils::ToWstr(msg.name);
+    const std::wstring msg_ws = GuiUtils::ToWstr(msg.message);
+    const time_t ts = msg.timestamp;
+    const tm* local_tm = localtime(&ts);
+    if (local_tm) {
+        wchar_t buf[512];
+        swprintf(buf, 512, L"<a=1>%s</a> @ %S %d, %02d:%02d: <c=#f96677><quote>%s", name_ws.c_str(), months[local_tm->tm_mon], local_tm->tm_mday, local_tm->tm_hour, local_tm->tm_min, msg_ws.c_str());
+        WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buf);
+    }
+}
+
+size_t TradeWindow::SearchHistory(const std::string& query, std::vector<Message>& results)
+{
+    MessageStore& history = History();
+    if (query.find_first_not_of(' ') == std::string::npos) {
+        return history.Latest(MAX_DISPLAYED_MESSAGES, results);
+    }
+    return history.Search(query, MAX_DISPLAYED_MESSAGES, results);
+}
+
+void TradeWindow::ShowSearchResults(const std::vector<Message>& results, const bool print_results_in_chat)
+{
+    messages.clear();
+    for (size_t i = results.size(); i > 0; i--) {
+        messages.add(results[i - 1]);
+    }
+    if (print_results_in_chat) {
+        for (size_t i = std::min(results.size(), MAX_PRINTED_RESULTS); i > 0; i--) {
+            PrintSearchResult(results[i - 1]);
         }
     }
-    return false;
 }
 
 void TradeWindow::search(std::string query, const bool print_results_in_chat)
@@ -385,6 +439,15 @@ void TradeWindow::search(std::string query, const bool print_results_in_chat)
     pending_query_string = query.empty() ? " " : query;
     print_search_results = print_results_in_chat;
     pending_query_sent = 0;
+    ParseBuffer(search_buffer, searched_words);
+    // Show what we already have straight away; the server's results are merged in when they come back
+    std::vector<Message> local;
+    if (SearchHistory(pending_query_string, local)) {
+        // Without a connection there's nothing to wait for before printing
+        const bool print_now = print_results_in_chat && !ws_window;
+        ShowSearchResults(local, print_now);
+        print_search_results = print_search_results && !print_now;
+    }
 }
 
 void TradeWindow::FindPlayerPartySearch(GW::HookStatus*, void*)
@@ -526,7 +589,7 @@ void TradeWindow::Draw(IDirect3DDevice9*)
     /* Main trade chat area */
     ImGui::BeginChild("trade_scroll", ImVec2(0, -20.0f - ImGui::GetStyle().ItemInnerSpacing.y));
     /* Connection checks */
-    if (!ws_window && !ws_window_connecting) {
+    if (!ws_window) {
         char buf[255];
         snprintf(buf, 255, "The connection to %s has timed out.", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize(buf).x) / 2);
@@ -537,7 +600,7 @@ void TradeWindow::Draw(IDirect3DDevice9*)
             AsyncWindowConnect(true);
         }
     }
-    else if (ws_window_connecting || (ws_window && ws_window->getReadyState() == WebSocket::CONNECTING)) {
+    else if (ws_window->GetState() == NetReactor::Websocket::State::Connecting) {
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize("Connecting...").x) / 2);
         ImGui::SetCursorPosY(ImGui::GetWindowHeight() / 2);
         ImGui::Text("Connecting...");
@@ -649,7 +712,7 @@ void TradeWindow::DrawAlertsWindowContent(bool)
     ImGui::TextDisabled("(Each line is a separate keyword. Not case sensitive.)");
     if (ImGui::InputTextMultiline("##alertfilter", alert_buf, ALERT_BUF_SIZE,
                                   ImVec2(-1.0f, 0.0f))) {
-        ParseBuffer(alert_buf, alert_words);
+        alerts.Compile(alert_buf);
         alertfile_dirty = true;
     }
     DrawChatSettings(true);
@@ -686,7 +749,7 @@ void TradeWindow::LoadSettings(ToolboxIni* ini)
     if (alert_file.is_open()) {
         alert_file.get(alert_buf, ALERT_BUF_SIZE, '\0');
         alert_file.close();
-        ParseBuffer(alert_buf, alert_words);
+        alerts.Compile(alert_buf);
     }
     alert_file.close();
     SwitchSockets();
@@ -743,48 +806,19 @@ void TradeWindow::AsyncWindowConnect(const bool force)
     if (ws_window) {
         return;
     }
-    if (ws_window_connecting) {
-        return;
-    }
     if (!force && !window_rate_limiter.AddTime(COST_PER_CONNECTION_MS, COST_PER_CONNECTION_MAX_MS)) {
         return;
     }
-    int res;
-    if (!wsaData.wVersion && (res = WSAStartup(MAKEWORD(2, 2), &wsaData)) != 0) {
-        printf("Failed to call WSAStartup: %d\n", res);
-        return;
-    }
-    ws_window_connecting = true;
-    thread_jobs.push([this] {
-        if ((ws_window = WebSocket::from_url(is_kamadan_chat ? ws_host_kmd : ws_host_asc)) == nullptr) {
-            printf("Couldn't connect to the host '%s'", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
-        }
-        ws_window_connecting = false;
-        if (messages.size() == 0 && pending_query_string.empty()) {
-            search(""); // Initial draw, gets latest N messages
-        }
-    });
-}
-
-void TradeWindow::DeleteWebSocket(WebSocket* ws)
-{
-    if (!ws) {
-        return;
-    }
-    if (ws->getReadyState() == WebSocket::OPEN) {
-        ws->close();
-    }
-    while (ws->getReadyState() != WebSocket::CLOSED) {
-        ws->poll();
-    }
-    delete ws;
+    ws_window = Resources::GetNetReactor().Connect(is_kamadan_chat ? ws_host_kmd : ws_host_asc);
 }
 
 void TradeWindow::SwitchSockets()
 {
     refresh_footer = true;
-    DeleteWebSocket(ws_window);
-    ws_window = nullptr;
+    if (ws_window) {
+        ws_window->Close();
+        ws_window = nullptr;
+    }
     messages.clear();
     AsyncWindowConnect(true);
 }
@@ -6,6 +6,9 @@
 
 #include <CircurlarBuffer.h>
 #include <ToolboxWindow.h>
+#include <Utils/AlertMatcher.h>
+#include <Utils/MessageStore.h>
+#include <Utils/NetReactor.h>
 #include <Utils/RateLimiter.h>
 
 class TradeWindow : public ToolboxWindow {
@@ -27,10 +30,12 @@ public:
     static void CmdPricecheck(const wchar_t* message, int argc, const LPWSTR* argv);
     static void OnMessageLocal(GW::HookStatus* status, const GW::Packet::StoC::MessageLocal* pak);
 
-    bool IsTradeAlert(std::string& message) const;
+    bool IsTradeAlert(const std::string& message);
     void Update(float delta) override;
     void Draw(IDirect3DDevice9* pDevice) override;
     void SignalTerminate() override;
+    bool CanTerminate() override;
+    void Terminate() override;
     void RegisterSettingsContent() override;
 
     void LoadSettings(ToolboxIni* ini) override;
@@ -41,19 +46,13 @@ public:
     static void FindPlayerPartySearch(GW::HookStatus* status = nullptr, void* packet = nullptr);
 
 private:
-    struct Message {
-        uint32_t timestamp = 0;
-        std::string name;
-        std::string message;
-    };
+    using Message = MessageStore::Entry;
 
     GW::HookEntry OnMessageLocal_Entry;
     GW::HookEntry OnPartySearch_Entry;
     GW::PartySearch player_party_search = {0};
     char player_party_search_text[64] = {0};
 
-    WSAData wsaData = {0};
-
     bool is_kamadan_chat = true;
     bool refresh_footer = false;
 
@@ -66,7 +65,7 @@ private:
     bool print_game_chat = false;
     bool print_game_chat_asc = false;
 
-    // if enable, we won't print the messages containing word from alert_words
+    // if enable, we won't print the messages that don't match alerts
     bool filter_alerts = false;
 
     // if enabled, will also apply the trade alerts filter to incoming local trade chat messages.
@@ -83,7 +82,7 @@ private:
 
     char search_buffer[256] = {0};
 
-    std::vector<std::string> alert_words{};
+    AlertMatcher alerts;
     std::vector<std::string> searched_words{};
 
     void DrawAlertsWindowContent(bool ownwindow);
@@ -91,28 +90,37 @@ private:
     static bool GetInKamadanAE1(bool check_district = true);
     static bool GetInAscalonAE1(bool check_district = true);
 
-    // Since we are connecting in an other thread, the following attributes/methods avoid spamming connection requests
+    // Connects on the network thread; rate limited to avoid spamming connection requests
     void AsyncWindowConnect(bool force = false);
-    bool ws_window_connecting = false;
 
-    easywsclient::WebSocket* ws_window = nullptr;
+    NetReactor::WebsocketPtr ws_window;
 
     RateLimiter window_rate_limiter;
 
     void search(std::string, bool print_results_in_chat = false);
+    // Messages we've already received for a search (or the latest ones for a blank query), newest first
+    size_t SearchHistory(const std::string& query, std::vector<Message>& results);
+    // Fill the window with results, newest first
+    void ShowSearchResults(const std::vector<Message>& results, bool print_results_in_chat);
+    static void PrintSearchResult(const Message& msg);
     void fetch();
+    void OnWebsocketMessage(const nlohmann::json& res);
 
     static bool parse_json_message(const nlohmann::json& js, Message* msg);
     CircularBuffer<Message> messages;
 
-    // tasks to be done async by the worker thread
-    std::queue<std::function<void()>> thread_jobs{};
-    bool should_stop = false;
-    std::thread worker;
+    // Every message received from each trade feed, kept between sessions
+    MessageStore history_kamadan;
+    MessageStore history_ascalon;
+    MessageStore& History() { return is_kamadan_chat ? history_kamadan : history_ascalon; }
+    // Loading and compacting the history runs on worker threads; the stores are only closed once none of it is running
+    std::atomic<uint32_t> history_tasks_running = 0;
+    std::atomic_bool history_closing = false;
+    void EnqueueHistoryTask(std::function<void()> task);
+    void AddToHistory(const Message& msg);
 
     static void ParseBuffer(const char* text, std::vector<std::string>& words);
     static void ParseBuffer(std::fstream stream, std::vector<std::string>& words);
 
-    static void DeleteWebSocket(easywsclient::WebSocket* ws);
     void SwitchSockets();
 };
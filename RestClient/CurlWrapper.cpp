@@ -195,6 +195,11 @@ void CurlEasy::SetNoBody(const bool enable)
     CHECK_CURL_EASY_SETOPT(this, CURLOPT_NOBODY, static_cast<long>(enable));
 }
 
+void CurlEasy::SetResumeFrom(const int64_t offset)
+{
+    CHECK_CURL_EASY_SETOPT(this, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(offset));
+}
+
 void CurlEasy::SetTcpNoDelay(const bool enable)
 {
     CHECK_CURL_EASY_SETOPT(this, CURLOPT_TCP_NODELAY, static_cast<long>(enable));
@@ -306,6 +311,11 @@ void CurlEasy::SetUploadFile(const char* path)
     }
 }
 
+void CurlEasy::SetShare(const CurlShare* share)
+{
+    CHECK_CURL_EASY_SETOPT(this, CURLOPT_SHARE, share ? share->GetHandle() : nullptr);
+}
+
 void CurlEasy::Clear()
 {
     m_Header.clear();
@@ -374,6 +384,34 @@ const char* CurlEasy::GetStatusStr()
     }
 }
 
+bool CurlEasy::GetResponseHeader(const char* name, std::string& value) const
+{
+    curl_header* header = nullptr;
+    if (curl_easy_header(m_Handle, name, 0, CURLH_HEADER, -1, &header) != CURLHE_OK || !header) {
+        return false;
+    }
+    value = header->value;
+    return true;
+}
+
+int64_t CurlEasy::GetDownloadSize() const
+{
+    curl_off_t size = 0;
+    if (curl_easy_getinfo(m_Handle, CURLINFO_SIZE_DOWNLOAD_T, &size) != CURLE_OK) {
+        return 0;
+    }
+    return static_cast<int64_t>(size);
+}
+
+long CurlEasy::GetNewConnectionCount() const
+{
+    long count = 0;
+    if (curl_easy_getinfo(m_Handle, CURLINFO_NUM_CONNECTS, &count) != CURLE_OK) {
+        return 0;
+    }
+    return count;
+}
+
 void CurlEasy::UpdateStatus(const int CurlStatus)
 {
     m_StatusCode = 0;
@@ -485,6 +523,33 @@ void CurlEasy::HandleOptionError(CurlEasy* easy, const int code, const char* fil
     }
 }
 
+CurlShare::CurlShare()
+{
+    assert(InitializeCount > 0);
+    m_Handle = curl_share_init();
+    curl_share_setopt(m_Handle, CURLSHOPT_LOCKFUNC, Lock);
+    curl_share_setopt(m_Handle, CURLSHOPT_UNLOCKFUNC, Unlock);
+    curl_share_setopt(m_Handle, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_Handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_Handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // Not CURL_LOCK_DATA_CONNECT; libcurl doesn't support sharing a connection cache between handles running on different threads at once
+}
+
+CurlShare::~CurlShare()
+{
+    curl_share_cleanup(m_Handle);
+}
+
+void CurlShare::Lock(CURL*, const curl_lock_data data, curl_lock_access, void* userptr)
+{
+    static_cast<CurlShare*>(userptr)->m_Mutexes[data].lock();
+}
+
+void CurlShare::Unlock(CURL*, const curl_lock_data data, void* userptr)
+{
+    static_cast<CurlShare*>(userptr)->m_Mutexes[data].unlock();
+}
+
 CurlMulti::CurlMulti()
 {
     assert(InitializeCount > 0);
@@ -528,6 +593,22 @@ void CurlMulti::Perform() const
     }
 }
 
+void CurlMulti::Poll(const int TimeoutMs) const
+{
+    const CURLMcode code = curl_multi_poll(m_Handle, nullptr, 0, TimeoutMs, nullptr);
+    if (code != CURLM_OK) {
+        fprintf(stderr, "Error in 'CurlMulti::Poll': %s\n", curl_multi_strerror(code));
+    }
+}
+
+void CurlMulti::Wakeup() const
+{
+    const CURLMcode code = curl_multi_wakeup(m_Handle);
+    if (code != CURLM_OK) {
+        fprintf(stderr, "Error in 'CurlMulti::Wakeup': %s\n", curl_multi_strerror(code));
+    }
+}
+
 void ComposeUrl(std::string& url, const char* host, const char* path)
 {
     url.append(host);
@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <string>
 #include <initializer_list>
+#include <mutex>
 
 #if defined(CURL_STRICTER)
 typedef struct Curl_easy CURL;
@@ -52,6 +53,8 @@ enum class ResponseStatus {
 
 using ParamField = std::pair<const char*, const char*>;
 
+class CurlShare;
+
 class CurlEasy {
     friend class CurlMulti;
 
@@ -75,6 +78,8 @@ public:
     void SetLowSpeedLimit(int MinBytes, int TimeSec);
     void SetMaxRedirects(int amount);
     void SetNoBody(bool enable);
+    // Ask for the body starting at this byte (an HTTP range request); 0 for all of it
+    void SetResumeFrom(int64_t offset);
     void SetTcpNoDelay(bool enable);
     void SetVerifyPeer(bool enable);
     void SetVerifyHost(bool enable);
@@ -90,6 +95,9 @@ public:
     void SetUploadFile(FILE* file);
     void SetUploadFile(FILE* file, size_t size);
     void SetUploadFile(const char* path);
+    // Share DNS cache and TLS sessions with every other handle using the same CurlShare.
+    // The share must outlive this handle.
+    void SetShare(const CurlShare* share);
 
     // Clear the response data and status flag
     void Clear();
@@ -109,6 +117,13 @@ public:
 
     const char* GetStatusStr();
 
+    // Value of a response header from the last request (after redirects), returns false if it wasn't sent
+    bool GetResponseHeader(const char* name, std::string& value) const;
+    // Body bytes received by the last transfer
+    int64_t GetDownloadSize() const;
+    // Number of new connections the last transfer had to open, 0 if an existing one was reused
+    long GetNewConnectionCount() const;
+
 #ifndef _NDEBUG
     const char* GetErrorStr() const { return m_ErrorBuffer; }
 #endif
@@ -194,12 +209,36 @@ public:
 
     void Perform() const;
 
+    // Block until there is activity on one of the transfers, Wakeup is called or TimeoutMs elapsed
+    void Poll(int TimeoutMs) const;
+    // Interrupt a blocking Poll, this is thread-safe.
+    void Wakeup() const;
+
 protected:
     CURLM* m_Handle;
 
     CurlMulti& operator=(const CurlMulti&) = delete;
 };
 
+// Thread-safe curl share handle, used to reuse DNS lookups and TLS sessions between easy handles
+class CurlShare {
+public:
+    CurlShare();
+    virtual ~CurlShare();
+
+    CURLSH* GetHandle() const { return m_Handle; }
+
+protected:
+    static void Lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void Unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+    CURLSH* m_Handle;
+    std::mutex m_Mutexes[CURL_LOCK_DATA_LAST];
+
+    CurlShare(const CurlShare&) = delete;
+    CurlShare& operator=(const CurlShare&) = delete;
+};
+
 void ComposeUrl(std::string& url, const char* host, const char* path);
 void ComposeUrl(std::string& url, Protocol proto,
                 const char* host, const char* path);
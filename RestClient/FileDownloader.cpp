@@ -0,0 +1,206 @@
+#include "stdafx.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include <Sha256.h>
+#include <Str.h>
+
+#include "FileDownloader.h"
+
+FileDownloader::~FileDownloader()
+{
+    Abort();
+    ClosePartFile();
+}
+
+void FileDownloader::SetDestination(const std::filesystem::path& Path, const uint64_t ExpectedSize)
+{
+    m_Path = Path;
+    m_PartPath = Path;
+    m_PartPath += L".part";
+    m_ExpectedSize = ExpectedSize;
+}
+
+void FileDownloader::ClosePartFile()
+{
+    if (m_PartFile) {
+        if (fclose(m_PartFile) != 0) {
+            m_WriteFailed = true;
+        }
+        m_PartFile = nullptr;
+    }
+}
+
+bool FileDownloader::BeginAttempt()
+{
+    assert(!IsPending());
+    ClosePartFile();
+    m_Error.clear();
+    m_WriteFailed = false;
+    m_ResponseCode = 0;
+
+    std::error_code ec;
+    uint64_t Offset = std::filesystem::exists(m_PartPath, ec) ? std::filesystem::file_size(m_PartPath, ec) : 0;
+    if (ec || (m_ExpectedSize && Offset > m_ExpectedSize)) {
+        std::filesystem::remove(m_PartPath, ec);
+        Offset = 0;
+    }
+    m_PartFile = _wfopen(m_PartPath.c_str(), Offset ? L"ab" : L"wb");
+    if (!m_PartFile) {
+        m_Error = "Failed to open " + m_PartPath.string();
+        return false;
+    }
+    m_ResumedFrom = Offset;
+    m_Received = Offset;
+    SetResumeFrom(static_cast<int64_t>(Offset));
+    return true;
+}
+
+void FileDownloader::OnHeader(const char* bytes, const size_t count)
+{
+    // Status line of each response, including redirects: "HTTP/1.1 206 Partial Content"
+    if (count > 5 && memcmp(bytes, "HTTP/", 5) == 0) {
+        const char* Space = static_cast<const char*>(memchr(bytes, ' ', count));
+        m_ResponseCode = Space ? atoi(Space + 1) : 0;
+    }
+}
+
+void FileDownloader::OnContent(const char* bytes, const size_t count)
+{
+    // Error pages and redirect bodies aren't part of the file
+    if (!m_PartFile || m_WriteFailed || (m_ResponseCode != 200 && m_ResponseCode != 206)) {
+        return;
+    }
+    if (m_ResponseCode == 200 && m_Received && m_Received == m_ResumedFrom) {
+        // The server sent the whole thing rather than the rest of it
+        m_PartFile = _wfreopen(m_PartPath.c_str(), L"wb", m_PartFile);
+        m_Received = 0;
+        if (!m_PartFile) {
+            m_WriteFailed = true;
+            return;
+        }
+    }
+    if (fwrite(bytes, 1, count, m_PartFile) != count) {
+        m_WriteFailed = true;
+        return;
+    }
+    m_Received += count;
+}
+
+FileDownloader::Attempt FileDownloader::EndAttempt()
+{
+    ClosePartFile();
+    const uint64_t Received = m_Received;
+    std::error_code ec;
+    if (m_WriteFailed) {
+        m_Error = "Failed to write " + m_PartPath.string();
+        return Attempt::Failed;
+    }
+    if (m_Status == ResponseStatus::Aborted) {
+        m_Error = "Aborted";
+        return Attempt::Failed;
+    }
+    if (m_Status != ResponseStatus::Completed) {
+        if (m_StatusCode == 200 && m_ResumedFrom) {
+            // Server doesn't do range requests; next time, start from scratch
+            std::filesystem::remove(m_PartPath, ec);
+        }
+        StrSprintf(m_Error, "Transfer interrupted at %llu bytes (%s)", Received, GetStatusStr());
+        return Attempt::Interrupted;
+    }
+    if (m_StatusCode == 200 || m_StatusCode == 206 || m_StatusCode == 416) {
+        // 416 means there was nothing left to send, which is fine if we had it all already
+        if (m_ExpectedSize && Received != m_ExpectedSize) {
+            if (Received > m_ExpectedSize || m_StatusCode == 416) {
+                std::filesystem::remove(m_PartPath, ec);
+            }
+            StrSprintf(m_Error, "Received %llu of %llu bytes", Received, m_ExpectedSize);
+            return Attempt::Interrupted;
+        }
+        if (m_StatusCode == 416 && !m_ExpectedSize) {
+            std::filesystem::remove(m_PartPath, ec);
+            m_Error = "Server can't resume the download";
+            return Attempt::Interrupted;
+        }
+        return Attempt::Complete;
+    }
+    StrSprintf(m_Error, "HTTP status %d", m_StatusCode);
+    // Worth trying again later
+    if (m_StatusCode == 408 || m_StatusCode == 429 || m_StatusCode >= 500) {
+        return Attempt::Interrupted;
+    }
+    return Attempt::Failed;
+}
+
+bool FileDownloader::Run(const int MaxAttempts)
+{
+    for (int i = 0; i < MaxAttempts; i++) {
+        if (i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(250 * i));
+        }
+        if (!BeginAttempt()) {
+            return false;
+        }
+        Execute();
+        switch (EndAttempt()) {
+            case Attempt::Complete:
+                return true;
+            case Attempt::Failed:
+                return false;
+            case Attempt::Interrupted:
+                break;
+        }
+    }
+    return false;
+}
+
+bool FileDownloader::Verify(const std::string& ExpectedSha256)
+{
+    std::error_code ec;
+    const uint64_t Size = std::filesystem::file_size(m_PartPath, ec);
+    if (ec || (m_ExpectedSize && Size != m_ExpectedSize)) {
+        m_Error = "Downloaded file is the wrong size";
+        Discard();
+        return false;
+    }
+    if (ExpectedSha256.empty()) {
+        return true;
+    }
+    std::string Sha256;
+    if (!Sha256File(m_PartPath.c_str(), Sha256)) {
+        m_Error = "Failed to read " + m_PartPath.string();
+        return false;
+    }
+    std::string Expected = ExpectedSha256;
+    std::ranges::transform(Expected, Expected.begin(), [](const char c) {
+        return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    });
+    if (Sha256 != Expected) {
+        m_Error = "Downloaded file doesn't match its SHA-256";
+        Discard();
+        return false;
+    }
+    return true;
+}
+
+bool FileDownloader::Commit()
+{
+    std::error_code ec;
+    std::filesystem::rename(m_PartPath, m_Path, ec);
+    if (ec) {
+        m_Error = "Failed to move download to " + m_Path.string() + ": " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+void FileDownloader::Discard()
+{
+    assert(!IsPending());
+    ClosePartFile();
+    std::error_code ec;
+    std::filesystem::remove(m_PartPath, ec);
+    m_Received = 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <filesystem>
+
+#include "RestClient.h"
+
+// Download straight to disk rather than into memory. The body is written to "<path>.part" as it arrives; if the
+// transfer is cut short, the next attempt asks the server for the rest (a range request) instead of starting over.
+// The finished file can be checked against its published SHA-256 before it's moved into place.
+//
+// Each attempt is BeginAttempt, then Execute or ExecuteAsync, then EndAttempt once it's over; Run does that in a loop.
+class FileDownloader : public AsyncRestClient {
+public:
+    enum class Attempt {
+        Complete,
+        // What arrived was kept; another attempt carries on from there
+        Interrupted,
+        Failed,
+    };
+
+    FileDownloader() = default;
+    FileDownloader(const FileDownloader&) = delete;
+    FileDownloader& operator=(const FileDownloader&) = delete;
+
+    ~FileDownloader() override;
+
+    // ExpectedSize is 0 if it isn't known
+    void SetDestination(const std::filesystem::path& Path, uint64_t ExpectedSize = 0);
+
+    bool BeginAttempt();
+    Attempt EndAttempt();
+    // Blocking, with up to MaxAttempts attempts
+    bool Run(int MaxAttempts = 5);
+
+    // Whether the completed download has the expected SHA-256 (hex), if given, and size. It's deleted if it doesn't.
+    bool Verify(const std::string& ExpectedSha256);
+    // Move the completed download to the destination, replacing whatever is there
+    bool Commit();
+    // Delete whatever has been downloaded so far
+    void Discard();
+
+    const std::filesystem::path& GetPartPath() const { return m_PartPath; }
+    // Bytes downloaded so far, including previous attempts; safe to call while a transfer is running
+    uint64_t GetReceived() const { return m_Received.load(std::memory_order_relaxed); }
+    uint64_t GetExpectedSize() const { return m_ExpectedSize; }
+    const std::string& GetError() const { return m_Error; }
+
+protected:
+    void OnHeader(const char* bytes, size_t count) override;
+    void OnContent(const char* bytes, size_t count) override;
+
+private:
+    void ClosePartFile();
+
+    std::filesystem::path m_Path;
+    std::filesystem::path m_PartPath;
+    uint64_t m_ExpectedSize = 0;
+    FILE* m_PartFile = nullptr;
+    // Where this attempt started from
+    uint64_t m_ResumedFrom = 0;
+    // Status of the response being received; there's one per redirect
+    int m_ResponseCode = 0;
+    bool m_WriteFailed = false;
+    std::atomic<uint64_t> m_Received = 0;
+    std::string m_Error;
+};
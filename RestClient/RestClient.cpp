@@ -5,7 +5,7 @@
 #include "RestClient.h"
 
 class CurlMultiThread : public Thread {
-    using Container = std::deque<AsyncRestClient*>;
+    using Container = std::unordered_map<const CURL*, AsyncRestClient*>;
 
 public:
     CurlMultiThread()
@@ -16,6 +16,7 @@ public:
 
     void Start()
     {
+        m_Stopped = false;
         m_Running = true;
         StartThread();
 
@@ -30,88 +31,124 @@ public:
     void Stop()
     {
         m_Running = false;
+        m_pMulti->Wakeup();
         Join();
     }
 
     void Execute(AsyncRestClient* pClient)
     {
-        std::lock_guard Lock(m_Mutex);
-        m_Clients.push_back(pClient);
-        m_pMulti->AddHandle(pClient);
+        {
+            std::lock_guard Lock(m_Mutex);
+            m_Added.push_back(pClient);
+        }
+        // The multi handle isn't thread-safe, so the curl thread adds the handle itself once woken up
+        m_pMulti->Wakeup();
     }
 
     void Abort(AsyncRestClient* pClient)
     {
-        std::lock_guard Lock(m_Mutex);
-        const auto it = Search(pClient);
-        if (it != m_Clients.end()) {
-            m_pMulti->RemoveHandle(pClient);
-            m_Clients.erase(it);
+        std::unique_lock Lock(m_Mutex);
+        const auto added = std::ranges::find(m_Added, pClient);
+        if (added != m_Added.end()) {
+            m_Added.erase(added);
+            return;
+        }
+        if (m_Stopped || std::this_thread::get_id() == m_ThreadId) {
+            // e.g. called from a completion callback, we already own the multi handle. Once the curl thread is gone
+            // nothing else touches pClient either.
+            Remove(pClient);
+            return;
         }
+        // Caller may destroy pClient as soon as we return, so wait for the curl thread to let go of it
+        m_Aborted.push_back(pClient);
+        m_pMulti->Wakeup();
+        m_AbortDone.wait(Lock, [this, pClient] {
+            return std::ranges::find(m_Aborted, pClient) == m_Aborted.end();
+        });
     }
 
 private:
     void Run() override
     {
         CurlMulti m_Multi;
+        m_ThreadId = std::this_thread::get_id();
         m_pMulti = &m_Multi;
 
         while (m_Running) {
             {
                 std::lock_guard Lock(m_Mutex);
+                for (AsyncRestClient* pClient : m_Added) {
+                    m_Clients.emplace(pClient->GetHandle(), pClient);
+                    m_Multi.AddHandle(pClient);
+                }
+                m_Added.clear();
+                if (!m_Aborted.empty()) {
+                    for (AsyncRestClient* pClient : m_Aborted) {
+                        Remove(pClient);
+                    }
+                    m_Aborted.clear();
+                    m_AbortDone.notify_all();
+                }
+
                 m_Multi.Perform();
 
                 int MsgsLeft;
                 const CURLMsg* pMsg = curl_multi_info_read(m_Multi.GetHandle(), &MsgsLeft);
                 while (pMsg) {
-                    AsyncRestClient* pClient = SearchPop(pMsg->easy_handle);
-                    m_Multi.RemoveHandle(pClient);
-                    pClient->OnCompletion(pMsg->data.result);
-
+                    if (pMsg->msg == CURLMSG_DONE) {
+                        if (AsyncRestClient* pClient = Pop(pMsg->easy_handle)) {
+                            m_Multi.RemoveHandle(pClient);
+                            pClient->OnCompletion(pMsg->data.result);
+                        }
+                    }
                     pMsg = curl_multi_info_read(m_Multi.GetHandle(), &MsgsLeft);
                 }
             }
 
-            Sleep(16);
+            // Sleeps until a socket is ready, a transfer timer expires, or Execute/Abort/Stop wakes us up
+            m_Multi.Poll(1000);
         }
 
-        m_pMulti = nullptr;
-    }
-
-    Container::iterator Search(const CURL* pHandle)
-    {
-        Container::iterator it;
-        for (it = m_Clients.begin(); it != m_Clients.end(); ++it) {
-            if ((*it)->GetHandle() == pHandle) {
-                break;
-            }
+        // From here on Abort can't wait for us, so detach what's left and let it complete in place
+        std::lock_guard Lock(m_Mutex);
+        for (const auto& it : m_Clients) {
+            m_Multi.RemoveHandle(it.second);
         }
-        return it;
+        m_Clients.clear();
+        m_Aborted.clear();
+        m_AbortDone.notify_all();
+        m_ThreadId = {};
+        m_Stopped = true;
+        m_pMulti = nullptr;
     }
 
-    Container::iterator Search(const AsyncRestClient* pClient)
+    void Remove(AsyncRestClient* pClient)
     {
-        Container::iterator it;
-        for (it = m_Clients.begin(); it != m_Clients.end(); ++it) {
-            if (*it == pClient) {
-                break;
-            }
+        if (Pop(pClient->GetHandle())) {
+            m_pMulti->RemoveHandle(pClient);
         }
-        return it;
     }
 
-    AsyncRestClient* SearchPop(const CURL* pHandle)
+    AsyncRestClient* Pop(const CURL* pHandle)
     {
-        const auto it = Search(pHandle);
+        const auto it = m_Clients.find(pHandle);
         if (it == m_Clients.end()) {
             return nullptr;
         }
-        AsyncRestClient* pClient = *it;
+        AsyncRestClient* pClient = it->second;
         m_Clients.erase(it);
         return pClient;
     }
 
+    // Handles currently attached to the multi handle; only touched by the curl thread
     Container m_Clients;
+    // Requests from other threads, applied by the curl thread before its next Perform
+    std::vector<AsyncRestClient*> m_Added;
+    std::vector<AsyncRestClient*> m_Aborted;
+    std::condition_variable_any m_AbortDone;
+    std::thread::id m_ThreadId;
+    // Set once the curl thread has left its loop
+    bool m_Stopped = false;
     CurlMulti* m_pMulti;
     std::atomic<bool> m_Running;
     std::recursive_mutex m_Mutex;
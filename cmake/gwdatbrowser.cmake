@@ -3,8 +3,6 @@ include_guard()
 set(gwdatbrowser_folder "${PROJECT_SOURCE_DIR}/Dependencies/gwdatbrowser/")
 
 set(SOURCES 
-    "${gwdatbrowser_folder}/AtexAsm.h"
-    "${gwdatbrowser_folder}/AtexAsm.cpp"
     "${gwdatbrowser_folder}/AtexReader.h"
     "${gwdatbrowser_folder}/AtexReader.cpp"
     "${gwdatbrowser_folder}/GWUnpacker.h"